@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+"""Download the PlantCare reading log over the console UART.
+
+Host side of "pc export" (src/helpers/plantcare_export.h). Sends the
+command, decodes the COBS frames, checks each CRC and writes the records
+as CSV. A frame with a bad CRC is dropped, and the missing range is asked
+for again from the last good record. With --state, a later run continues
+where this one stopped.
+
+    pc_export.py /dev/ttyACM0 --state plantcare.seq -o log.csv
+    pc_export.py /dev/pts/5 --from 0            # native_sim pty
+
+Only the standard library is needed. The port can be a serial device or a
+pty, and it is put in raw mode at --baud.
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import termios
+import time
+import tty
+import zlib
+
+EXPORT_VERSION = 1
+
+INFO = struct.Struct("<BBHIIIII")
+DATA_HDR = struct.Struct("<IB")
+END = struct.Struct("<III")
+REC_FIXED = struct.Struct("<IIhHhhHBB")
+PLANT = struct.Struct("<hh")
+
+BAUDS = {
+    9600: termios.B9600,
+    19200: termios.B19200,
+    38400: termios.B38400,
+    57600: termios.B57600,
+    115200: termios.B115200,
+    230400: termios.B230400,
+}
+
+
+def cobs_decode(data):
+    """Decode one COBS frame (without the 0x00). None if malformed."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_frame(raw):
+    """Return (type, body) for a frame with a good CRC, else None."""
+    frame = cobs_decode(raw)
+    if frame is None or len(frame) < 6 or frame[0:1] != b"P":
+        return None
+    payload, crc = frame[:-4], struct.unpack("<I", frame[-4:])[0]
+    if zlib.crc32(payload) & 0xFFFFFFFF != crc:
+        return None
+    return chr(payload[1]), payload[2:]
+
+
+class Port:
+    def __init__(self, path, baud):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        if os.isatty(self.fd):
+            tty.setraw(self.fd)
+            attrs = termios.tcgetattr(self.fd)
+            attrs[4] = attrs[5] = BAUDS[baud]
+            termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+            termios.tcflush(self.fd, termios.TCIOFLUSH)
+
+    def write(self, data):
+        os.write(self.fd, data)
+
+    def read(self, timeout):
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        return os.read(self.fd, 4096) if ready else b""
+
+    def close(self):
+        os.close(self.fd)
+
+
+def frames(port, timeout):
+    """Yield decoded frames until timeout without any byte."""
+    buf = bytearray()
+    while True:
+        chunk = port.read(timeout)
+        if not chunk:
+            return
+        buf += chunk
+        while True:
+            end = buf.find(b"\x00")
+            if end < 0:
+                break
+            raw, buf = bytes(buf[:end]), buf[end + 1:]
+            if raw:
+                # Shell text between delimiters fails here and is skipped
+                yield parse_frame(raw)
+
+
+def records(body, rec_size, plants):
+    first, n = DATA_HDR.unpack_from(body)
+    for i in range(n):
+        off = DATA_HDR.size + i * rec_size
+        fixed = REC_FIXED.unpack_from(body, off)
+        per_plant = [PLANT.unpack_from(body, off + REC_FIXED.size + p * PLANT.size)
+                     for p in range(plants)]
+        yield first + i, fixed, per_plant
+
+
+def csv_header(plants):
+    cols = ["seq", "epoch_s", "uptime_s", "temp_x100", "hum_x100",
+            "acc_max_g100", "tilt_cdeg", "lux", "leaf_class", "valid_mask"]
+    for p in range(plants):
+        cols += ["soil%d_pct_x10" % p, "light%d_pct_x10" % p]
+    return ",".join(cols)
+
+
+def export_once(port, start, count, out, timeout):
+    """One "pc export". Returns (next_seq, got, info, end, bytes)."""
+    cmd = "pc export %d" % start + (" %d" % count if count else "")
+    port.write(cmd.encode() + b"\r\n")
+
+    info = end = None
+    rec_size = plants = 0
+    expect = start
+    got = nbytes = 0
+
+    for frame in frames(port, timeout):
+        if frame is None:
+            continue
+        kind, body = frame
+        nbytes += len(body) + 6
+        if kind == "I":
+            info = INFO.unpack_from(body)
+            if info[0] != EXPORT_VERSION:
+                sys.exit("device speaks export version %d" % info[0])
+            rec_size = info[1]
+            plants = (rec_size - REC_FIXED.size) // PLANT.size
+            expect = info[5]
+            if out.tell() == 0:
+                print(csv_header(plants), file=out)
+        elif kind == "D" and info is not None:
+            first = DATA_HDR.unpack_from(body)[0]
+            if first != expect:
+                # A frame was lost: ignore the rest, ask again from expect
+                continue
+            for seq, fixed, per_plant in records(body, rec_size, plants):
+                row = [seq] + list(fixed)
+                for soil, light in per_plant:
+                    row += [soil, light]
+                print(",".join(str(v) for v in row), file=out)
+                got += 1
+                expect = seq + 1
+        elif kind == "E":
+            end = END.unpack_from(body)
+            break
+
+    return expect, got, info, end, nbytes
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("port", help="serial device or pty")
+    ap.add_argument("--baud", type=int, default=115200, choices=sorted(BAUDS))
+    ap.add_argument("--from", dest="start", type=int,
+                    help="first seq (default: resume from --state, else oldest)")
+    ap.add_argument("--count", type=int, default=0, help="0 = up to the newest")
+    ap.add_argument("--state", help="file keeping the next seq between runs")
+    ap.add_argument("-o", "--out", help="CSV output (appended), default stdout")
+    ap.add_argument("--retries", type=int, default=5)
+    ap.add_argument("--timeout", type=float, default=2.0,
+                    help="seconds of silence that end a download")
+    args = ap.parse_args()
+
+    start = args.start
+    if start is None and args.state and os.path.exists(args.state):
+        with open(args.state) as f:
+            start = int(f.read().strip() or 0)
+    if start is None:
+        start = 0
+
+    out = open(args.out, "a") if args.out else sys.stdout
+    port = Port(args.port, args.baud)
+    t0 = time.monotonic()
+    total = total_bytes = 0
+    stop = start + args.count if args.count else None
+    ok = False
+
+    try:
+        for _ in range(args.retries + 1):
+            count = stop - start if stop is not None else 0
+            nxt, got, info, end, nbytes = export_once(
+                port, start, count, out, args.timeout)
+            total += got
+            total_bytes += nbytes
+
+            if info is None:
+                print("no answer, retrying", file=sys.stderr)
+                continue
+            oldest, newest = info[3], info[4]
+            if start > newest:
+                # The device was reset and its log started again at 0
+                print("device log restarted, resuming at %d" % oldest,
+                      file=sys.stderr)
+                start, stop = oldest, None
+                continue
+            if end is not None and nxt == end[0]:
+                if end[2]:
+                    print("%d record(s) were overwritten before they were "
+                          "sent" % end[2], file=sys.stderr)
+                start = nxt
+                ok = True
+                break
+            print("frame lost, resuming at %d" % nxt, file=sys.stderr)
+            start = nxt
+    finally:
+        port.close()
+        if args.state:
+            with open(args.state, "w") as f:
+                f.write("%d\n" % start)
+        if out is not sys.stdout:
+            out.close()
+
+    dt = time.monotonic() - t0
+    print("%d records, %d B of frames in %.2f s (%.0f B/s)%s" %
+          (total, total_bytes, dt, total_bytes / dt if dt else 0,
+           "" if ok else ", INCOMPLETE"), file=sys.stderr)
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
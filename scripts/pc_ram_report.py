@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+"""RAM budget of a PlantCare build, from the GNU ld map file.
+
+Build-time half of "pc mem" (src/helpers/plantcare_mem.h). Reads
+build/zephyr/zephyr.map and prints:
+
+  - RAM used against the RAM region's length;
+  - RAM per object file, largest first;
+  - the largest symbols. Zephyr builds with -fdata-sections, so static
+    variables show up by name (.bss.<name>) even though ld lists only
+    global symbols;
+  - the noinit sections, which hold the thread stacks. A stack's size
+    here is what "pc mem" reports as the size; the high-water mark is
+    only known at runtime.
+
+    pc_ram_report.py build/zephyr/zephyr.map [--top 20]
+
+The ram_report target in CMakeLists.txt runs it after every link. Only the
+standard library is needed.
+"""
+
+import argparse
+import os
+import re
+import sys
+from collections import defaultdict
+
+RAM_REGIONS = ("RAM", "SRAM", "SRAM1", "SRAM2")
+
+MEM_LINE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+SECTION_FULL = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(.*)$")
+SECTION_NAME = re.compile(r"^ (\S+)\s*$")
+SECTION_REST = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(.*)$")
+SYMBOL = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_][\w.$]*)\s*$")
+OUTPUT = re.compile(r"^([A-Za-z_.][\w.]*)\s")
+
+
+class Entry:
+    def __init__(self, out, name, addr, size, obj):
+        self.out = out
+        self.name = name
+        self.addr = addr
+        self.size = size
+        self.obj = obj
+        self.symbols = []
+
+
+def parse(path):
+    """Return ({region: (origin, length)}, [Entry])."""
+    regions = {}
+    entries = []
+    out = None
+    pending = None
+    in_mem = in_map = False
+
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+
+            if line.startswith("Memory Configuration"):
+                in_mem = True
+                continue
+            if line.startswith("Linker script and memory map"):
+                in_mem, in_map = False, True
+                continue
+            if in_mem:
+                m = MEM_LINE.match(line)
+                if m and m.group(1) != "Name":
+                    regions[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+                continue
+            if not in_map or not line.strip():
+                continue
+
+            if pending is not None:
+                m = SECTION_REST.match(line)
+                if m:
+                    entries.append(Entry(out, pending, int(m.group(1), 16),
+                                         int(m.group(2), 16), m.group(3).strip()))
+                pending = None
+                continue
+
+            if not line.startswith(" "):
+                m = OUTPUT.match(line + " ")
+                if m:
+                    out = m.group(1)
+                continue
+
+            m = SECTION_FULL.match(line)
+            if m:
+                entries.append(Entry(out, m.group(1), int(m.group(2), 16),
+                                     int(m.group(3), 16), m.group(4).strip()))
+                continue
+            m = SYMBOL.match(line)
+            if m:
+                if entries:
+                    entries[-1].symbols.append((int(m.group(1), 16), m.group(2)))
+                continue
+            m = SECTION_NAME.match(line)
+            if m and not m.group(1).startswith("*"):
+                # Long names put the address and size on the next line
+                pending = m.group(1)
+
+    return regions, entries
+
+
+def ram_region(regions):
+    for name in RAM_REGIONS:
+        if name in regions:
+            return name, regions[name]
+    sys.exit("no RAM region in the map file's memory configuration")
+
+
+def obj_name(obj):
+    """libapp.a(plantcare_log.c.obj) -> plantcare_log.c"""
+    m = re.search(r"\(([^)]+)\)$", obj)
+    name = m.group(1) if m else os.path.basename(obj)
+    return re.sub(r"\.(obj|o)$", "", name) or "(linker)"
+
+
+def var_name(entry):
+    """Best name for what an input section holds."""
+    name = entry.name
+    for prefix in (".bss.", ".data.", ".noinit.", ".sbss.", ".sdata."):
+        if name.startswith(prefix):
+            name = name[len(prefix):]
+            break
+    # .noinit."<path>/sensor_thread.c".0 -> sensor_thread.c.0
+    m = re.match(r'^"([^"]+)"\.?(\d*)$', name)
+    if m:
+        name = os.path.basename(m.group(1)) + ("." + m.group(2) if m.group(2) else "")
+    return name
+
+
+def symbols(entry):
+    """Split an input section by the global symbols ld lists inside it."""
+    syms = sorted(s for s in entry.symbols
+                  if entry.addr <= s[0] < entry.addr + entry.size)
+    if not syms:
+        return [(var_name(entry), entry.size)]
+    out = []
+    if syms[0][0] > entry.addr:
+        out.append((var_name(entry), syms[0][0] - entry.addr))
+    for i, (addr, name) in enumerate(syms):
+        end = syms[i + 1][0] if i + 1 < len(syms) else entry.addr + entry.size
+        if end > addr:
+            out.append((name, end - addr))
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("map", help="zephyr.map")
+    ap.add_argument("--top", type=int, default=20, help="rows per table")
+    args = ap.parse_args()
+
+    regions, entries = parse(args.map)
+    region, (origin, length) = ram_region(regions)
+    ram = [e for e in entries if origin <= e.addr < origin + length and e.size]
+
+    used = sum(e.size for e in ram)
+    print("RAM (%s): %d of %d B used (%d%%), %d B free" %
+          (region, used, length, used * 100 // length if length else 0,
+           length - used))
+
+    by_obj = defaultdict(int)
+    by_out = defaultdict(int)
+    for e in ram:
+        by_obj["padding" if e.name == "*fill*" else obj_name(e.obj)] += e.size
+        by_out[e.out] += e.size
+
+    print("\nby output section:")
+    for name, size in sorted(by_out.items(), key=lambda kv: -kv[1]):
+        print("  %-28s %7d" % (name, size))
+
+    print("\nby object file (top %d):" % args.top)
+    for name, size in sorted(by_obj.items(), key=lambda kv: -kv[1])[:args.top]:
+        print("  %-28s %7d" % (name, size))
+
+    syms = []
+    stacks = []
+    for e in ram:
+        if e.name == "*fill*":
+            continue
+        for name, size in symbols(e):
+            row = (size, name, obj_name(e.obj))
+            syms.append(row)
+            if "noinit" in e.out or "noinit" in e.name:
+                stacks.append(row)
+
+    print("\nlargest symbols (top %d):" % args.top)
+    for size, name, obj in sorted(syms, reverse=True)[:args.top]:
+        print("  %-36s %7d  %s" % (name, size, obj))
+
+    print("\nnoinit (thread stacks), %d B:" % sum(s[0] for s in stacks))
+    for size, name, obj in sorted(stacks, reverse=True):
+        print("  %-36s %7d  %s" % (name, size, obj))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
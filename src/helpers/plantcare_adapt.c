@@ -0,0 +1,200 @@
+// src/helpers/plantcare_adapt.c
+
+#include <zephyr/kernel.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "plantcare_adapt.h"
+#include "plantcare_alarm.h"
+#include "plantcare_drying.h"
+#include "plantcare_units.h"
+
+/* Up to 4 alarm channels per sensor group, per plant for the ADC */
+#define ADAPT_MAX_CHANNELS  4
+#define ADAPT_MAX_VALUES    (ADAPT_MAX_CHANNELS * PLANTCARE_PLANT_COUNT)
+
+/* What to watch in each group: alarm channel, noise band and how close
+ * to an alarm limit counts as "near" (both in the alarm channel's units).
+ */
+struct adapt_value {
+    uint8_t channel;        /* enum plantcare_channel */
+    int32_t noise;
+    int32_t margin;
+};
+
+struct adapt_desc {
+    uint8_t count;
+    struct adapt_value v[ADAPT_MAX_CHANNELS];
+    uint16_t read_uj;       /* energy of one read (per plant), see below */
+    bool per_plant;         /* values repeat for every plant */
+};
+
+/*
+ * Energy per read: rough datasheet figures for conversion + I2C/ADC +
+ * the MCU being awake for it, good enough to compare fixed and adaptive.
+ *   ADC:     two conversions + probe excitation     ~ 15 uJ per plant
+ *   Si7021:  RH (12 ms) + T (7 ms) at ~150 uA       ~ 30 uJ
+ *   MMA8451: 6-byte burst                           ~  5 uJ
+ *   TCS34725: 8-byte burst                          ~  5 uJ
+ */
+static const struct adapt_desc adapt_desc[PC_SENSOR_COUNT] = {
+    [PC_SENSOR_ADC] = {
+        2, { { PC_CH_SOIL,  10, 50 },       /* 1.0 %, 5.0 % */
+             { PC_CH_LIGHT, 10, 50 } }, 15, true,
+    },
+    /* VPD and the dew-point margin move with T and RH, but their own
+     * limits need the floor rate too
+     */
+    [PC_SENSOR_CLIMATE] = {
+        4, { { PC_CH_TEMP,       20,  100 },    /* 0.2 C, 1.0 C */
+             { PC_CH_HUM,        100, 300 },    /* 1 %RH, 3 %RH */
+             { PC_CH_VPD,        50,  150 },    /* 0.05 kPa, 0.15 kPa */
+             { PC_CH_DEW_MARGIN, 20,  100 } },  /* 0.2 C, 1.0 C */
+        30,
+    },
+    [PC_SENSOR_ACCEL] = {
+        2, { { PC_CH_ACCEL, 5, 30 },        /* 0.05 g, 0.30 g */
+             { PC_CH_TILT,  50, 300 } },    /* 0.5°, 3° */
+        5,
+    },
+    [PC_SENSOR_COLOR] = {
+        1, { { PC_CH_LEAF, 0, 0 } }, 5,
+    },
+    /* GPS: no controller, it streams anyway */
+};
+
+struct adapt_state {
+    bool     has_ref;
+    int32_t  ref[ADAPT_MAX_VALUES];     /* values at the last change */
+    uint32_t period_ms;
+    int64_t  last_ms;
+
+    /* statistics */
+    uint32_t reads;
+    uint64_t span_ms;                   /* time covered by those reads */
+    uint32_t floor_ms;
+};
+
+static struct adapt_state adapt[PC_SENSOR_COUNT];
+
+static uint8_t adapt_instances(const struct adapt_desc *desc)
+{
+    return desc->per_plant ? PLANTCARE_PLANT_COUNT : 1;
+}
+
+/* Current values of group s, in alarm channel units. Per-plant groups
+ * give desc->count values for plant 0, then for plant 1, and so on.
+ */
+static void adapt_values(enum plantcare_sensor s, const struct plantcare_data *d,
+                         int32_t *out)
+{
+    int32_t ax, ay, az;
+
+    switch (s) {
+    case PC_SENSOR_ADC:
+        for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+            out[2 * p]     = soil_raw_to_pct_x10(d->plants[p].soil_raw);
+            out[2 * p + 1] = light_raw_to_pct_x10(d->plants[p].light_raw);
+        }
+        break;
+    case PC_SENSOR_CLIMATE:
+        out[0] = d->temp_x100;
+        out[1] = d->hum_x100;
+        out[2] = d->vpd_pa;
+        out[3] = d->temp_x100 - d->dew_x100;
+        break;
+    case PC_SENSOR_ACCEL:
+        ax = d->acc_x_g100 < 0 ? -d->acc_x_g100 : d->acc_x_g100;
+        ay = d->acc_y_g100 < 0 ? -d->acc_y_g100 : d->acc_y_g100;
+        az = d->acc_z_g100 < 0 ? -d->acc_z_g100 : d->acc_z_g100;
+        out[0] = MAX(ax, MAX(ay, az));
+        out[1] = d->tilt.tilt_cdeg;
+        break;
+    case PC_SENSOR_COLOR:
+        out[0] = d->leaf_class;
+        break;
+    default:
+        break;
+    }
+}
+
+uint32_t plantcare_adapt_next_period(enum plantcare_sensor s,
+                                     const struct plantcare_data *d,
+                                     uint32_t floor_ms, uint32_t ceiling_ms,
+                                     int64_t now_ms)
+{
+    const struct adapt_desc *desc = &adapt_desc[s];
+    struct adapt_state *st = &adapt[s];
+    int32_t val[ADAPT_MAX_VALUES];
+    int nvals = desc->count * adapt_instances(desc);
+    bool fast = !st->has_ref;
+
+    if (desc->count == 0) {
+        return floor_ms;
+    }
+
+    ceiling_ms = MAX(ceiling_ms, floor_ms);
+
+    /* Statistics: time since the previous read, at this floor */
+    if (st->has_ref) {
+        st->span_ms += (uint64_t)(now_ms - st->last_ms);
+    }
+    st->reads++;
+    st->last_ms  = now_ms;
+    st->floor_ms = floor_ms;
+
+    adapt_values(s, d, val);
+
+    for (int i = 0; i < nvals; i++) {
+        const struct adapt_value *v = &desc->v[i % desc->count];
+        uint8_t inst = desc->per_plant ? (uint8_t)(i / desc->count) : 0;
+        int32_t delta = val[i] - st->ref[i];
+
+        /* Soil that keeps to its drying line is not news (plantcare_drying.h) */
+        if (v->channel == PC_CH_SOIL && st->has_ref &&
+            plantcare_drying_on_track(inst, v->noise)) {
+            delta = 0;
+        }
+
+        if (!st->has_ref || delta > v->noise || delta < -v->noise ||
+            plantcare_alarm_near(v->channel, inst, val[i], v->margin)) {
+            fast = true;
+        }
+    }
+
+    if (fast) {
+        memcpy(st->ref, val, sizeof(st->ref));
+        st->has_ref   = true;
+        st->period_ms = floor_ms;
+    } else {
+        st->period_ms = MIN(MAX(st->period_ms, floor_ms) * 2U, ceiling_ms);
+    }
+
+    return st->period_ms;
+}
+
+void plantcare_adapt_reset(void)
+{
+    for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+        adapt[s].has_ref = false;
+    }
+}
+
+void plantcare_adapt_get_stats(enum plantcare_sensor s,
+                               struct plantcare_adapt_stats *out)
+{
+    const struct adapt_state *st = &adapt[s];
+    const struct adapt_desc *desc = &adapt_desc[s];
+    uint32_t floor_reads = 0;
+
+    if (st->floor_ms) {
+        floor_reads = (uint32_t)(st->span_ms / st->floor_ms) + (st->reads ? 1 : 0);
+    }
+
+    out->period_ms   = st->period_ms;
+    out->reads       = st->reads;
+    out->floor_reads = floor_reads;
+    out->saved_uj    = (floor_reads > st->reads)
+                     ? (floor_reads - st->reads) * desc->read_uj *
+                       adapt_instances(desc) : 0;
+}
@@ -0,0 +1,40 @@
+#ifndef PLANTCARE_ADAPT_H
+#define PLANTCARE_ADAPT_H
+
+#include <stdint.h>
+
+#include "plantcare_config.h"
+#include "plantcare_state.h"
+
+/* Adaptive sampling, one controller per sensor group.
+ *
+ * After every good read the group's values are compared with the last
+ * value that counted as a change. Inside the noise band the period
+ * doubles, up to the ceiling; outside it, or when a value is close to an
+ * alarm limit, the period drops back to the floor. Soil moisture is
+ * compared with its fitted drying line instead (plantcare_drying.h), so a
+ * steady trend is not a change.
+ */
+
+struct plantcare_adapt_stats {
+    uint32_t period_ms;     /* current period */
+    uint32_t reads;         /* reads done while adaptive */
+    uint32_t floor_reads;   /* reads a fixed floor-rate would have done */
+    uint32_t saved_uj;      /* estimated energy saved, microjoules */
+};
+
+/* Period until the next read of group s, given the values just read.
+ * Sensors without a controller (GPS) always get floor_ms.
+ */
+uint32_t plantcare_adapt_next_period(enum plantcare_sensor s,
+                                     const struct plantcare_data *d,
+                                     uint32_t floor_ms, uint32_t ceiling_ms,
+                                     int64_t now_ms);
+
+/* Forget history (next read starts at the floor), keep the statistics */
+void plantcare_adapt_reset(void);
+
+void plantcare_adapt_get_stats(enum plantcare_sensor s,
+                               struct plantcare_adapt_stats *out);
+
+#endif /* PLANTCARE_ADAPT_H */
@@ -0,0 +1,432 @@
+// src/helpers/plantcare_alarm.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+
+#include "plantcare_alarm.h"
+#include "plantcare_bus.h"
+
+/* ---------- Default rules (NM7 comfortable ranges) ---------- */
+
+static const struct plantcare_alarm_rule default_rules[] = {
+    /* Temperature 15.0 – 30.0 °C, ±0.5 °C hysteresis */
+    { PC_CH_TEMP,       0, 1500,      3000, 50,  60000 },
+    /* Relative humidity 30.0 – 70.0 %, ±2 % hysteresis */
+    { PC_CH_HUM,        1, 3000,      7000, 200, 60000 },
+    /* VPD 0.40 – 1.60 kPa (vegetative to flowering), ±0.05 kPa hysteresis */
+    { PC_CH_VPD,        1, 400,       1600, 50,  60000 },
+    /* Condensation: air within 2.0 °C of its dew point */
+    { PC_CH_DEW_MARGIN, 1, 200,  INT32_MAX, 50,  60000 },
+    /* Ambient light 10.0 – 80.0 % */
+    { PC_CH_LIGHT,      2, 100,       800,  20,  60000 },
+    /* Soil moisture 20.0 – 80.0 % */
+    { PC_CH_SOIL,       3, 200,       800,  20,  60000 },
+    /* Soil predicted to reach its min within 2 h, held for 5 min */
+    { PC_CH_SOIL_DRY,   3, 120, INT32_MAX,  15,  300000 },
+    /* Acceleration: any axis above 2.00 g, no dwell (knocks are short) */
+    { PC_CH_ACCEL,      4, INT32_MIN, 200,  10,  0 },
+    /* Pot leaning more than 15° from its rest pose for 30 s, 2° hysteresis */
+    { PC_CH_TILT,       4, INT32_MIN, 1500, 200, 30000 },
+    /* Leaf colour: anything but PC_LEAF_HEALTHY (plantcare_color.h) */
+    { PC_CH_LEAF,       5, 1,         1,    0,   60000 },
+    /* Sensor fault found by the anomaly detector (plantcare_anomaly.c) */
+    { PC_CH_ANOMALY,    6, 0,         0,    0,   0 },
+};
+
+/* ---------- Engine state ---------- */
+
+struct rule_state {
+    bool    active;
+    bool    pending;        /* condition differs from active, waiting dwell */
+    int64_t pending_since_ms;
+};
+
+struct channel_state {
+    bool     has_value;
+    int32_t  last_value;
+    uint16_t pending_mask;  /* rules on this channel waiting for dwell */
+};
+
+BUILD_ASSERT(PLANTCARE_ALARM_MAX_RULES <= 16, "rule masks are 16 bits");
+
+/* Rules can be replaced from the shell while the mode thread updates */
+K_MUTEX_DEFINE(alarm_lock);
+
+static struct plantcare_alarm_rule rules[PLANTCARE_ALARM_MAX_RULES];
+static size_t rule_count;
+
+/* Bit i set if rules[i] is on this channel */
+static uint16_t ch_rule_mask[PC_CH_COUNT];
+
+/* State per rule / channel and instance. Only per-plant channels use
+ * instances above 0.
+ */
+static struct rule_state rule_state[PLANTCARE_ALARM_MAX_RULES]
+                                   [PLANTCARE_ALARM_MAX_INST];
+static struct channel_state ch_state[PC_CH_COUNT][PLANTCARE_ALARM_MAX_INST];
+
+static const char *const channel_names[PC_CH_COUNT] = {
+    [PC_CH_TEMP]       = "TEMP",
+    [PC_CH_HUM]        = "HUMIDITY",
+    [PC_CH_VPD]        = "VPD",
+    [PC_CH_DEW_MARGIN] = "CONDENSATION",
+    [PC_CH_LIGHT]      = "LIGHT",
+    [PC_CH_SOIL]       = "SOIL",
+    [PC_CH_SOIL_DRY]   = "SOIL DRYING",
+    [PC_CH_ACCEL]      = "ACCEL",
+    [PC_CH_TILT]       = "TILT",
+    [PC_CH_LEAF]       = "LEAF COLOUR",
+    [PC_CH_ANOMALY]    = "SENSOR FAULT",
+};
+
+const char *plantcare_alarm_channel_name(enum plantcare_channel ch)
+{
+    return (ch < PC_CH_COUNT) ? channel_names[ch] : "?";
+}
+
+uint8_t plantcare_alarm_channel_instances(enum plantcare_channel ch)
+{
+    return (ch == PC_CH_SOIL || ch == PC_CH_SOIL_DRY || ch == PC_CH_LIGHT) ?
+           PLANTCARE_ALARM_MAX_INST : 1;
+}
+
+/* Clears reported by a reset, published once alarm_lock is released.
+ * reset_lock keeps two resets (the shell and boot) off the same buffer.
+ */
+K_MUTEX_DEFINE(reset_lock);
+static struct plantcare_alarm_event reset_evts[PLANTCARE_ALARM_MAX_RULES *
+                                               PLANTCARE_ALARM_MAX_INST];
+
+/* Forget all state, filling evts with a clear for every raised rule so
+ * the observers do not keep showing it. Returns how many were filled.
+ * Caller holds alarm_lock.
+ */
+static size_t alarm_reset_locked(struct plantcare_alarm_event *evts,
+                                 int64_t now_ms)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < rule_count; i++) {
+        uint8_t ch = rules[i].channel;
+
+        for (uint8_t inst = 0; inst < plantcare_alarm_channel_instances(ch);
+             inst++) {
+            if (!rule_state[i][inst].active) {
+                continue;
+            }
+            evts[n++] = (struct plantcare_alarm_event){
+                .rule    = (uint8_t)i,
+                .channel = ch,
+                .inst    = inst,
+                .active  = false,
+                .value   = ch_state[ch][inst].last_value,
+                .time_ms = now_ms,
+            };
+        }
+    }
+
+    memset(rule_state, 0, sizeof(rule_state));
+    memset(ch_state, 0, sizeof(ch_state));
+    return n;
+}
+
+/* Outside alarm_lock: a slow observer must not hold up the shell or
+ * the other feeders
+ */
+static void alarm_publish(const struct plantcare_alarm_event *evts, size_t n)
+{
+    for (size_t e = 0; e < n; e++) {
+        (void)zbus_chan_pub(&pc_alarm_chan, &evts[e], K_MSEC(100));
+    }
+}
+
+/* True if rule i is raised for any instance. Caller holds alarm_lock. */
+static bool rule_any_active(size_t i)
+{
+    for (size_t n = 0; n < PLANTCARE_ALARM_MAX_INST; n++) {
+        if (rule_state[i][n].active) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void plantcare_alarm_reset(void)
+{
+    k_mutex_lock(&reset_lock, K_FOREVER);
+    k_mutex_lock(&alarm_lock, K_FOREVER);
+
+    size_t n = alarm_reset_locked(reset_evts, k_uptime_get());
+
+    k_mutex_unlock(&alarm_lock);
+    alarm_publish(reset_evts, n);
+    k_mutex_unlock(&reset_lock);
+}
+
+int plantcare_alarm_set_rules(const struct plantcare_alarm_rule *new_rules,
+                              size_t count)
+{
+    if (count > PLANTCARE_ALARM_MAX_RULES) {
+        return -EINVAL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (new_rules[i].channel >= PC_CH_COUNT) {
+            return -EINVAL;
+        }
+    }
+
+    k_mutex_lock(&reset_lock, K_FOREVER);
+    k_mutex_lock(&alarm_lock, K_FOREVER);
+
+    /* Clears go out under the old table's indices */
+    size_t n = alarm_reset_locked(reset_evts, k_uptime_get());
+
+    memcpy(rules, new_rules, count * sizeof(rules[0]));
+    rule_count = count;
+
+    /* Re-index: which rules belong to which channel */
+    memset(ch_rule_mask, 0, sizeof(ch_rule_mask));
+    for (size_t i = 0; i < count; i++) {
+        ch_rule_mask[rules[i].channel] |= (uint16_t)BIT(i);
+    }
+
+    k_mutex_unlock(&alarm_lock);
+    alarm_publish(reset_evts, n);
+    k_mutex_unlock(&reset_lock);
+    return 0;
+}
+
+size_t plantcare_alarm_get_rules(struct plantcare_alarm_rule *out, size_t max)
+{
+    k_mutex_lock(&alarm_lock, K_FOREVER);
+
+    size_t n = MIN(max, rule_count);
+    memcpy(out, rules, n * sizeof(rules[0]));
+
+    k_mutex_unlock(&alarm_lock);
+    return n;
+}
+
+void plantcare_alarm_init(void)
+{
+    (void)plantcare_alarm_set_rules(default_rules, ARRAY_SIZE(default_rules));
+}
+
+/* Desired state of one rule for this value, taking hysteresis into account */
+static bool rule_wants_active(const struct plantcare_alarm_rule *r,
+                              bool active, int32_t value)
+{
+    if (!active) {
+        return (value < r->min || value > r->max);
+    }
+
+    /* Already raised: only clear once clearly back inside the band.
+     * 64-bit so INT32_MIN / INT32_MAX limits do not overflow.
+     */
+    return ((int64_t)value < (int64_t)r->min + r->hysteresis ||
+            (int64_t)value > (int64_t)r->max - r->hysteresis);
+}
+
+/* Returns true and fills *evt if rule i changed state. Caller holds
+ * alarm_lock and publishes the event after releasing it.
+ */
+static bool rule_evaluate(size_t i, uint8_t inst, int32_t value,
+                          int64_t now_ms, struct plantcare_alarm_event *evt)
+{
+    const struct plantcare_alarm_rule *r = &rules[i];
+    struct rule_state *st = &rule_state[i][inst];
+    struct channel_state *ch = &ch_state[r->channel][inst];
+
+    bool want = rule_wants_active(r, st->active, value);
+
+    if (want == st->active) {
+        st->pending = false;
+        ch->pending_mask &= (uint16_t)~BIT(i);
+        return false;
+    }
+
+    if (!st->pending) {
+        st->pending = true;
+        st->pending_since_ms = now_ms;
+        ch->pending_mask |= (uint16_t)BIT(i);
+    }
+
+    if ((now_ms - st->pending_since_ms) < (int64_t)r->dwell_ms) {
+        return false;
+    }
+
+    st->active  = want;
+    st->pending = false;
+    ch->pending_mask &= (uint16_t)~BIT(i);
+
+    *evt = (struct plantcare_alarm_event){
+        .rule    = (uint8_t)i,
+        .channel = r->channel,
+        .inst    = inst,
+        .active  = want,
+        .value   = value,
+        .time_ms = now_ms,
+    };
+    return true;
+}
+
+void plantcare_alarm_update_inst(enum plantcare_channel ch, uint8_t inst,
+                                 int32_t value, int64_t now_ms)
+{
+    if (ch >= PC_CH_COUNT || inst >= plantcare_alarm_channel_instances(ch)) {
+        return;
+    }
+
+    struct channel_state *cs = &ch_state[ch][inst];
+    struct plantcare_alarm_event evts[PLANTCARE_ALARM_MAX_RULES];
+    size_t n = 0;
+
+    k_mutex_lock(&alarm_lock, K_FOREVER);
+
+    /* Unchanged value and nobody waiting on a dwell timer: nothing to do */
+    if (cs->has_value && cs->last_value == value && cs->pending_mask == 0) {
+        k_mutex_unlock(&alarm_lock);
+        return;
+    }
+
+    cs->has_value  = true;
+    cs->last_value = value;
+
+    uint32_t mask = ch_rule_mask[ch];
+    while (mask) {
+        size_t i = (size_t)__builtin_ctz(mask);
+        mask &= mask - 1U;
+        if (rule_evaluate(i, inst, value, now_ms, &evts[n])) {
+            n++;
+        }
+    }
+
+    k_mutex_unlock(&alarm_lock);
+    alarm_publish(evts, n);
+}
+
+bool plantcare_alarm_near(enum plantcare_channel ch, uint8_t inst,
+                          int32_t value, int32_t margin)
+{
+    bool near = false;
+
+    if (ch >= PC_CH_COUNT || inst >= plantcare_alarm_channel_instances(ch)) {
+        return false;
+    }
+
+    k_mutex_lock(&alarm_lock, K_FOREVER);
+
+    uint32_t mask = ch_rule_mask[ch];
+    while (mask && !near) {
+        size_t i = (size_t)__builtin_ctz(mask);
+        mask &= mask - 1U;
+
+        const struct plantcare_alarm_rule *r = &rules[i];
+        const struct rule_state *st = &rule_state[i][inst];
+
+        /* The limits that matter now: raising, or clearing past the
+         * hysteresis. 64-bit so INT32_MIN / INT32_MAX do not overflow.
+         */
+        int64_t lo = (int64_t)r->min + (st->active ? r->hysteresis : 0);
+        int64_t hi = (int64_t)r->max - (st->active ? r->hysteresis : 0);
+
+        near = st->pending ||
+               ((int64_t)value >= lo - margin && (int64_t)value <= lo + margin) ||
+               ((int64_t)value >= hi - margin && (int64_t)value <= hi + margin);
+    }
+
+    k_mutex_unlock(&alarm_lock);
+    return near;
+}
+
+int32_t plantcare_alarm_low_limit(enum plantcare_channel ch)
+{
+    int32_t limit = INT32_MIN;
+
+    if (ch >= PC_CH_COUNT) {
+        return limit;
+    }
+
+    k_mutex_lock(&alarm_lock, K_FOREVER);
+
+    uint32_t mask = ch_rule_mask[ch];
+    while (mask) {
+        size_t i = (size_t)__builtin_ctz(mask);
+        mask &= mask - 1U;
+        limit = MAX(limit, rules[i].min);
+    }
+
+    k_mutex_unlock(&alarm_lock);
+    return limit;
+}
+
+uint32_t plantcare_alarm_active_mask(void)
+{
+    uint32_t mask = 0;
+
+    k_mutex_lock(&alarm_lock, K_FOREVER);
+    for (size_t i = 0; i < rule_count; i++) {
+        if (rule_any_active(i)) {
+            mask |= BIT(rules[i].channel);
+        }
+    }
+    k_mutex_unlock(&alarm_lock);
+    return mask;
+}
+
+size_t plantcare_alarm_active_list(uint8_t *channels, size_t max)
+{
+    uint32_t listed = 0;
+    size_t n = 0;
+
+    k_mutex_lock(&alarm_lock, K_FOREVER);
+
+    /* Selection by priority; the table holds at most 16 rules */
+    while (n < max) {
+        int best = -1;
+
+        for (size_t i = 0; i < rule_count; i++) {
+            if (!rule_any_active(i) || (listed & BIT(rules[i].channel))) {
+                continue;
+            }
+            if (best < 0 || rules[i].priority < rules[best].priority) {
+                best = (int)i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+
+        listed |= BIT(rules[best].channel);
+        channels[n++] = rules[best].channel;
+    }
+
+    k_mutex_unlock(&alarm_lock);
+    return n;
+}
+
+size_t plantcare_alarm_ram_bytes(void)
+{
+    return sizeof(rules) + sizeof(rule_state) + sizeof(ch_state) +
+           sizeof(reset_evts);
+}
+
+int plantcare_alarm_highest(void)
+{
+    int best = -1;
+    uint8_t best_prio = 0;
+
+    k_mutex_lock(&alarm_lock, K_FOREVER);
+    for (size_t i = 0; i < rule_count; i++) {
+        if (rule_any_active(i) &&
+            (best < 0 || rules[i].priority < best_prio)) {
+            best_prio = rules[i].priority;
+            best = rules[i].channel;
+        }
+    }
+    k_mutex_unlock(&alarm_lock);
+    return best;
+}
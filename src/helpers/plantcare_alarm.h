@@ -0,0 +1,122 @@
+#ifndef PLANTCARE_ALARM_H
+#define PLANTCARE_ALARM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sensors/plant_adc.h"
+
+/* Channels the alarm engine knows about, with their units */
+enum plantcare_channel {
+    PC_CH_TEMP = 0,     /* °C * 100 */
+    PC_CH_HUM,          /* %RH * 100 */
+    PC_CH_VPD,          /* vapour-pressure deficit, Pa (plantcare_psychro.h) */
+    PC_CH_DEW_MARGIN,   /* temperature minus dew point, °C * 100 */
+    PC_CH_LIGHT,        /* % * 10, one instance per plant */
+    PC_CH_SOIL,         /* % * 10, one instance per plant */
+    PC_CH_SOIL_DRY,     /* minutes until SOIL's min, per plant (plantcare_drying.h) */
+    PC_CH_ACCEL,        /* largest |axis|, g * 100 */
+    PC_CH_TILT,         /* angle from the rest pose, centidegrees */
+    PC_CH_LEAF,         /* enum plantcare_leaf_class, never UNKNOWN */
+    PC_CH_ANOMALY,      /* bit n set if plantcare_an_channel n is anomalous */
+    PC_CH_COUNT,
+};
+
+/* One threshold rule.
+ * Raised when value < min or value > max for at least dwell_ms.
+ * Cleared when value is back inside [min + hysteresis, max - hysteresis]
+ * for at least dwell_ms.
+ */
+struct plantcare_alarm_rule {
+    uint8_t  channel;       /* enum plantcare_channel */
+    uint8_t  priority;      /* 0 = most important */
+    int32_t  min;
+    int32_t  max;
+    int32_t  hysteresis;
+    uint32_t dwell_ms;
+};
+
+#define PLANTCARE_ALARM_MAX_RULES  16
+
+/* Per-plant channels keep separate alarm state for each plant (instance);
+ * a rule on such a channel applies to every plant. The other channels
+ * only have instance 0.
+ */
+#define PLANTCARE_ALARM_MAX_INST   PLANTCARE_PLANT_COUNT
+
+struct plantcare_alarm_event {
+    uint8_t rule;           /* index into the active rule table */
+    uint8_t channel;
+    uint8_t inst;           /* plant index on per-plant channels, else 0 */
+    bool    active;         /* true = raised, false = cleared */
+    int32_t value;          /* value that completed the transition */
+    int64_t time_ms;
+};
+
+/* Load the default rule table. Call once at boot. */
+void plantcare_alarm_init(void);
+
+
+/* Replace the rule table at runtime. Clears all alarm state; every rule
+ * that was raised is reported cleared on pc_alarm_chan, and one whose
+ * condition still holds is raised again under the new table.
+ * Returns 0, or -EINVAL if count is too large or a channel is unknown.
+ */
+int plantcare_alarm_set_rules(const struct plantcare_alarm_rule *rules,
+                              size_t count);
+
+/* Copy out the active rule table; returns number of rules. */
+size_t plantcare_alarm_get_rules(struct plantcare_alarm_rule *out, size_t max);
+
+/* Forget all alarm state, reporting every raised rule as cleared */
+void plantcare_alarm_reset(void);
+
+/* Feed a new value for one channel. Only the rules of that channel are
+ * evaluated, and nothing is done if the value did not change and no rule
+ * is waiting for its dwell time. Transitions are published on
+ * pc_alarm_chan (plantcare_bus.h) once the engine's lock is released.
+ * Safe against rule changes from other threads (e.g. the shell).
+ * plantcare_alarm_feed.c calls it from the sensor group channels.
+ */
+void plantcare_alarm_update_inst(enum plantcare_channel ch, uint8_t inst,
+                                 int32_t value, int64_t now_ms);
+
+static inline void plantcare_alarm_update(enum plantcare_channel ch,
+                                          int32_t value, int64_t now_ms)
+{
+    plantcare_alarm_update_inst(ch, 0, value, now_ms);
+}
+
+/* True if value is within margin of a limit of any rule on channel ch
+ * (of its clear threshold once raised), or a rule on ch is waiting for
+ * its dwell time for this instance. A value far past a limit is not near:
+ * the alarm is settled until it comes back. Used to sample faster around
+ * the thresholds (plantcare_adapt.c).
+ */
+bool plantcare_alarm_near(enum plantcare_channel ch, uint8_t inst,
+                          int32_t value, int32_t margin);
+
+/* Highest min of the rules on channel ch, INT32_MIN if it has none */
+int32_t plantcare_alarm_low_limit(enum plantcare_channel ch);
+
+/* Number of instances of channel ch (1, or the plant count) */
+uint8_t plantcare_alarm_channel_instances(enum plantcare_channel ch);
+
+/* Bit n set if any rule on channel n is raised, for any instance */
+uint32_t plantcare_alarm_active_mask(void);
+
+/* Channels with a raised rule, most important first, each listed once.
+ * Returns how many were written to channels[].
+ */
+size_t plantcare_alarm_active_list(uint8_t *channels, size_t max);
+
+/* Channel of the highest-priority raised rule, or -1 if none */
+int plantcare_alarm_highest(void);
+
+const char *plantcare_alarm_channel_name(enum plantcare_channel ch);
+
+/* Static RAM of the rule table and alarm state, bytes (plantcare_mem.h) */
+size_t plantcare_alarm_ram_bytes(void);
+
+#endif /* PLANTCARE_ALARM_H */
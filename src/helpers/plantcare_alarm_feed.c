@@ -0,0 +1,131 @@
+// src/helpers/plantcare_alarm_feed.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/zbus/zbus.h>
+#include <stdint.h>
+
+#include "plantcare_alarm.h"
+#include "plantcare_anomaly.h"
+#include "plantcare_bus.h"
+#include "plantcare_color.h"
+#include "plantcare_drying.h"
+#include "plantcare_tilt.h"
+#include "plantcare_units.h"
+
+/*
+ * Feeds the alarm engine from the sensor group channels, in every mode.
+ * The listener runs in the sensor thread as each group is published, so
+ * only the rules of the channels that group drives are evaluated. A group
+ * that failed is not published and keeps its alarm state as it was rather
+ * than raising or clearing on stale values. Only instance 0 is fed, the
+ * sensors the snapshot holds.
+ *
+ * Sensor faults span groups and are fed once per cycle from the snapshot.
+ */
+
+static void feed_climate(const struct pc_msg_climate *m, int64_t now)
+{
+    plantcare_alarm_update(PC_CH_TEMP, m->temp_x100, now);
+    plantcare_alarm_update(PC_CH_HUM,  m->hum_x100,  now);
+    plantcare_alarm_update(PC_CH_VPD,  m->vpd_pa,    now);
+    plantcare_alarm_update(PC_CH_DEW_MARGIN, m->temp_x100 - m->dew_x100, now);
+}
+
+/* A soil probe found out of range in this scan says nothing about its
+ * plant's soil; the light sensor is read apart and still counts
+ */
+static void feed_adc(const struct pc_msg_adc *m, int64_t now)
+{
+    uint8_t kinds[PC_AN_CH_COUNT];
+
+    plantcare_anomaly_get(kinds, now);
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        plantcare_alarm_update_inst(PC_CH_LIGHT, p,
+                                    light_raw_to_pct_x10(m->plants[p].light_raw),
+                                    now);
+        if (kinds[PC_AN_CH_SOIL + p] == PC_AN_RANGE) {
+            continue;
+        }
+        plantcare_alarm_update_inst(PC_CH_SOIL, p,
+                                    soil_raw_to_pct_x10(m->plants[p].soil_raw),
+                                    now);
+        plantcare_alarm_update_inst(PC_CH_SOIL_DRY, p,
+                                    m->drying[p].valid ? m->drying[p].eta_min :
+                                    PLANTCARE_DRYING_ETA_MAX_MIN, now);
+    }
+}
+
+static void feed_accel(const struct pc_msg_accel *m, int64_t now)
+{
+    int32_t ax = m->x_g100 < 0 ? -m->x_g100 : m->x_g100;
+    int32_t ay = m->y_g100 < 0 ? -m->y_g100 : m->y_g100;
+    int32_t az = m->z_g100 < 0 ? -m->z_g100 : m->z_g100;
+
+    plantcare_alarm_update(PC_CH_ACCEL, MAX(ax, MAX(ay, az)), now);
+
+    /* No rest pose yet: nothing to lean away from */
+    if (m->tilt_cdeg != PLANTCARE_TILT_NO_REST) {
+        plantcare_alarm_update(PC_CH_TILT, m->tilt_cdeg, now);
+    }
+}
+
+static void feed_color(const struct pc_msg_color *m, int64_t now)
+{
+    /* In the dark the leaf cannot be judged: keep the alarm as it was */
+    if (m->res.leaf_class != PC_LEAF_UNKNOWN) {
+        plantcare_alarm_update(PC_CH_LEAF, m->res.leaf_class, now);
+    }
+}
+
+/* Always evaluated: an out-of-range sensor is also the reason its group
+ * was not published
+ */
+static void feed_anomaly(const struct plantcare_data *s, int64_t now)
+{
+    uint32_t mask = 0;
+
+    for (int ch = 0; ch < PC_AN_CH_COUNT; ch++) {
+        if (s->anomaly[ch] != PC_AN_NONE) {
+            mask |= BIT(ch);
+        }
+    }
+    plantcare_alarm_update(PC_CH_ANOMALY, (int32_t)mask, now);
+}
+
+static void alarm_feed_cb(const struct zbus_channel *chan)
+{
+    int64_t now = k_uptime_get();
+
+    if (chan == &pc_adc_chan) {
+        feed_adc(zbus_chan_const_msg(chan), now);
+    } else if (chan == &pc_climate_chan) {
+        const struct pc_msg_climate *m = zbus_chan_const_msg(chan);
+
+        if (m->inst == 0) {
+            feed_climate(m, now);
+        }
+    } else if (chan == &pc_accel_chan) {
+        const struct pc_msg_accel *m = zbus_chan_const_msg(chan);
+
+        if (m->inst == 0) {
+            feed_accel(m, now);
+        }
+    } else if (chan == &pc_color_chan) {
+        const struct pc_msg_color *m = zbus_chan_const_msg(chan);
+
+        if (m->inst == 0) {
+            feed_color(m, now);
+        }
+    } else if (chan == &pc_snapshot_chan) {
+        feed_anomaly(zbus_chan_const_msg(chan), now);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(alarm_feed_lis, alarm_feed_cb);
+ZBUS_CHAN_ADD_OBS(pc_adc_chan, alarm_feed_lis, 3);
+ZBUS_CHAN_ADD_OBS(pc_climate_chan, alarm_feed_lis, 3);
+ZBUS_CHAN_ADD_OBS(pc_accel_chan, alarm_feed_lis, 3);
+ZBUS_CHAN_ADD_OBS(pc_color_chan, alarm_feed_lis, 3);
+ZBUS_CHAN_ADD_OBS(pc_snapshot_chan, alarm_feed_lis, 3);
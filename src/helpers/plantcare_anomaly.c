@@ -0,0 +1,245 @@
+// src/helpers/plantcare_anomaly.c
+
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+
+#include "plantcare_anomaly.h"
+#include "plantcare_state.h"
+
+#define AN_FAST_SHIFT     4     /* alpha = 1/16   */
+#define AN_SLOW_SHIFT     9     /* alpha = 1/512  */
+#define AN_Q              8     /* means are kept in Q8 */
+#define AN_WARMUP         64    /* reads before jump/drift tests start */
+
+#define AN_TO_Q(x)        ((x) * (1 << AN_Q))
+
+/* Per channel tuning, in the channel's units.
+ * jump_dir / drift_dir: 0 = both ways, +1 = only upwards, -1 = only down.
+ * A zero stuck_n, jump_min or drift_h turns that test off.
+ *
+ * Environmental channels have no drift test: a day/night cycle or a pot
+ * drying out looks the same as a drifting sensor on one channel. Soil
+ * only flags downward jumps (watering is a legal upward jump, a probe
+ * pulled out of the soil is not). The accelerometer of a resting plant
+ * should be stationary, so any slow change of |g| is drift.
+ */
+struct an_params {
+    int32_t  min;
+    int32_t  max;
+    uint16_t stuck_n;
+    int32_t  jump_min;      /* minimum |x - mean| ... */
+    uint8_t  jump_z2;       /* ... and (x - mean)^2 > jump_z2 * variance */
+    int8_t   jump_dir;
+    int32_t  drift_k;       /* CUSUM slack */
+    int32_t  drift_h;       /* CUSUM threshold */
+    int8_t   drift_dir;
+};
+
+/* All soil channels share the PC_AN_CH_SOIL entry */
+static const struct an_params an_params[PC_AN_CH_SOIL + 1] = {
+    /* Si7021 range -40..125 °C; 0xFFFF reads as 128.86 °C */
+    [PC_AN_CH_TEMP]  = { -4000, 12500, 120, 300,  36, 0,  0,  0,    0 },
+    /* 0..100 %RH; 0xFFFF reads as 118.99 % */
+    [PC_AN_CH_HUM]   = { 0,     10000, 120, 1000, 36, 0,  0,  0,    0 },
+    /* At rest |x|+|y|+|z| is about 1 g; range ±2 g per axis */
+    [PC_AN_CH_ACCEL] = { 0,     600,   60,  0,    0,  0,  3,  60,   0 },
+    /* Open or shorted probe sits on an ADC rail */
+    [PC_AN_CH_SOIL]  = { 8,     4087,  120, 400,  36, -1, 0,  0,    0 },
+};
+
+struct an_state {
+    bool     init;
+    uint16_t reads;
+    uint16_t same;          /* consecutive identical values */
+    int32_t  last;
+    int32_t  mean_q;        /* fast EWMA, Q8 */
+    int32_t  slow_q;        /* slow EWMA, Q8 */
+    uint32_t var;           /* fast EWMA of (x - mean)^2 */
+    int32_t  cusum_pos;
+    int32_t  cusum_neg;
+    uint8_t  kind;          /* current finding */
+    int64_t  held_until_ms; /* for JUMP / DRIFT */
+};
+
+static struct an_state an_state[PC_AN_CH_COUNT];
+
+static const char *const channel_names[PC_AN_CH_SOIL] = {
+    [PC_AN_CH_TEMP]  = "TEMP",
+    [PC_AN_CH_HUM]   = "HUMIDITY",
+    [PC_AN_CH_ACCEL] = "ACCEL",
+};
+
+static const char *const soil_names[PLANTCARE_PLANT_MAX] = {
+    "SOIL0", "SOIL1", "SOIL2", "SOIL3", "SOIL4", "SOIL5", "SOIL6", "SOIL7",
+};
+
+BUILD_ASSERT(PLANTCARE_PLANT_COUNT <= ARRAY_SIZE(soil_names),
+             "a soil channel name per plant");
+
+static const char *const kind_names[] = {
+    [PC_AN_NONE]  = "none",
+    [PC_AN_RANGE] = "out of range",
+    [PC_AN_STUCK] = "stuck",
+    [PC_AN_JUMP]  = "jump",
+    [PC_AN_DRIFT] = "drift",
+};
+
+const char *plantcare_anomaly_channel_name(enum plantcare_an_channel ch)
+{
+    if (ch < PC_AN_CH_SOIL) {
+        return channel_names[ch];
+    }
+    if (ch < PC_AN_CH_COUNT) {
+        /* Keep the plain name on single-plant boards */
+        return (PLANTCARE_PLANT_COUNT == 1) ? "SOIL"
+                                            : soil_names[ch - PC_AN_CH_SOIL];
+    }
+    return "?";
+}
+
+const char *plantcare_anomaly_kind_name(enum plantcare_an_kind kind)
+{
+    return (kind < ARRAY_SIZE(kind_names)) ? kind_names[kind] : "?";
+}
+
+static bool dir_ok(int8_t dir, int32_t delta)
+{
+    return dir == 0 || (dir > 0 && delta > 0) || (dir < 0 && delta < 0);
+}
+
+/* One sample, constant time. Returns the finding for this sample. */
+static uint8_t an_step(enum plantcare_an_channel ch, int32_t x, int64_t now_ms)
+{
+    const struct an_params *p = &an_params[MIN(ch, PC_AN_CH_SOIL)];
+    struct an_state *st = &an_state[ch];
+    uint8_t kind = PC_AN_NONE;
+
+    /* Out of range values don't touch the statistics */
+    if (x < p->min || x > p->max) {
+        st->kind = PC_AN_RANGE;
+        return PC_AN_RANGE;
+    }
+
+    if (!st->init) {
+        st->init   = true;
+        st->last   = x;
+        st->mean_q = AN_TO_Q(x);
+        st->slow_q = AN_TO_Q(x);
+        st->kind   = PC_AN_NONE;
+        return PC_AN_NONE;
+    }
+
+    /* Stuck-at */
+    st->same = (x == st->last) ? (uint16_t)MIN(st->same + 1U, UINT16_MAX) : 0;
+    st->last = x;
+    if (p->stuck_n && st->same >= p->stuck_n) {
+        kind = PC_AN_STUCK;
+    }
+
+    int32_t delta = x - (st->mean_q >> AN_Q);
+    uint64_t d2 = (uint64_t)((int64_t)delta * delta);
+
+    if (st->reads >= AN_WARMUP) {
+        /* Sudden jump: far outside the recent noise */
+        if (p->jump_min && (delta > p->jump_min || delta < -p->jump_min) &&
+            d2 > (uint64_t)p->jump_z2 * st->var && dir_ok(p->jump_dir, delta)) {
+            kind = PC_AN_JUMP;
+            st->held_until_ms = now_ms + PLANTCARE_ANOMALY_HOLD_MS;
+
+            /* Restart around the new level, a step is not also a drift */
+            st->mean_q = AN_TO_Q(x);
+            st->slow_q = AN_TO_Q(x);
+            st->var    = 0;
+            st->cusum_pos = 0;
+            st->cusum_neg = 0;
+            delta = 0;
+            d2 = 0;
+        }
+
+        /* Drift: CUSUM of the fast mean against the slow baseline */
+        if (p->drift_h) {
+            int32_t r = (st->mean_q - st->slow_q) >> AN_Q;
+
+            st->cusum_pos = MAX(0, st->cusum_pos + r - p->drift_k);
+            st->cusum_neg = MAX(0, st->cusum_neg - r - p->drift_k);
+
+            if ((st->cusum_pos > p->drift_h && dir_ok(p->drift_dir, 1)) ||
+                (st->cusum_neg > p->drift_h && dir_ok(p->drift_dir, -1))) {
+                kind = PC_AN_DRIFT;
+                st->held_until_ms = now_ms + PLANTCARE_ANOMALY_HOLD_MS;
+                st->cusum_pos = 0;
+                st->cusum_neg = 0;
+                st->slow_q = st->mean_q;
+            }
+        }
+    } else if (++st->reads == AN_WARMUP) {
+        /* Baseline starts from the settled mean, not the first read */
+        st->slow_q = st->mean_q;
+    }
+
+    /* EWMA updates (arithmetic shifts, bounded: |x| < 2^16) */
+    st->mean_q += (AN_TO_Q(x) - st->mean_q) >> AN_FAST_SHIFT;
+    st->slow_q += (AN_TO_Q(x) - st->slow_q) >> AN_SLOW_SHIFT;
+
+    int64_t var = (int64_t)st->var + (((int64_t)MIN(d2, UINT32_MAX) -
+                                       (int64_t)st->var) >> AN_FAST_SHIFT);
+    st->var = (uint32_t)MAX(var, 0);
+
+    /* Jumps and drifts stay visible for a while */
+    if (kind == PC_AN_NONE && now_ms < st->held_until_ms &&
+        (st->kind == PC_AN_JUMP || st->kind == PC_AN_DRIFT)) {
+        kind = st->kind;
+    }
+
+    st->kind = kind;
+    return kind;
+}
+
+int plantcare_anomaly_update(enum plantcare_sensor s,
+                             const struct plantcare_data *d, int64_t now_ms)
+{
+    bool range = false;
+    int32_t ax, ay, az;
+    int bad;
+
+    switch (s) {
+    case PC_SENSOR_CLIMATE:
+        range |= an_step(PC_AN_CH_TEMP, d->temp_x100, now_ms) == PC_AN_RANGE;
+        range |= an_step(PC_AN_CH_HUM,  d->hum_x100,  now_ms) == PC_AN_RANGE;
+        break;
+    case PC_SENSOR_ADC:
+        bad = 0;
+        for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+            bad += an_step(PC_AN_CH_SOIL + p, d->plants[p].soil_raw,
+                           now_ms) == PC_AN_RANGE;
+        }
+        range = (bad == PLANTCARE_PLANT_COUNT);
+        break;
+    case PC_SENSOR_ACCEL:
+        ax = d->acc_x_g100 < 0 ? -d->acc_x_g100 : d->acc_x_g100;
+        ay = d->acc_y_g100 < 0 ? -d->acc_y_g100 : d->acc_y_g100;
+        az = d->acc_z_g100 < 0 ? -d->acc_z_g100 : d->acc_z_g100;
+        range |= an_step(PC_AN_CH_ACCEL, ax + ay + az, now_ms) == PC_AN_RANGE;
+        break;
+    default:
+        break;
+    }
+
+    return range ? -ERANGE : 0;
+}
+
+void plantcare_anomaly_get(uint8_t kinds[PC_AN_CH_COUNT], int64_t now_ms)
+{
+    for (int ch = 0; ch < PC_AN_CH_COUNT; ch++) {
+        const struct an_state *st = &an_state[ch];
+        uint8_t kind = st->kind;
+
+        if ((kind == PC_AN_JUMP || kind == PC_AN_DRIFT) &&
+            now_ms >= st->held_until_ms) {
+            kind = PC_AN_NONE;
+        }
+        kinds[ch] = kind;
+    }
+}
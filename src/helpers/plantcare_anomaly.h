@@ -0,0 +1,55 @@
+#ifndef PLANTCARE_ANOMALY_H
+#define PLANTCARE_ANOMALY_H
+
+#include <stdint.h>
+
+#include "plantcare_config.h"
+#include "sensors/plant_adc.h"
+
+/*
+ * Streaming anomaly detector, fixed point, O(1) state per channel.
+ *
+ * Runs in the sensor thread on every good read. Per channel it keeps a
+ * fast EWMA mean and variance (z-score test for sudden jumps), a slow
+ * EWMA baseline with a CUSUM on the fast/slow difference (drift), a
+ * repeat counter (stuck-at) and a plausible range (e.g. Si7021 reading
+ * 0xFFFF, soil probe open-circuit at the ADC rail).
+ */
+
+enum plantcare_an_channel {
+    PC_AN_CH_TEMP = 0,      /* °C * 100 */
+    PC_AN_CH_HUM,           /* %RH * 100 */
+    PC_AN_CH_ACCEL,         /* |x|+|y|+|z|, g * 100 */
+    PC_AN_CH_SOIL,          /* raw ADC, plant 0; plant p is SOIL + p */
+    PC_AN_CH_COUNT = PC_AN_CH_SOIL + PLANTCARE_PLANT_COUNT,
+};
+
+enum plantcare_an_kind {
+    PC_AN_NONE = 0,
+    PC_AN_RANGE,            /* outside what the sensor can report */
+    PC_AN_STUCK,            /* same value for too many reads */
+    PC_AN_JUMP,             /* sudden change, many sigma off the mean */
+    PC_AN_DRIFT,            /* slow one-way shift of the baseline */
+};
+
+struct plantcare_data;
+
+/* Run the detectors of sensor group s on the values just read.
+ * Returns -ERANGE if a value is out of range (the read should be treated
+ * as failed), 0 otherwise. For the ADC that is only when every plant's
+ * probe is out of range; a single bad probe shows up as PC_AN_RANGE on
+ * its own soil channel and the other plants keep their readings.
+ */
+int plantcare_anomaly_update(enum plantcare_sensor s,
+                             const struct plantcare_data *d, int64_t now_ms);
+
+/* Current finding per channel. Jumps and drifts are held for
+ * PLANTCARE_ANOMALY_HOLD_MS so slower consumers still see them.
+ */
+#define PLANTCARE_ANOMALY_HOLD_MS  60000
+void plantcare_anomaly_get(uint8_t kinds[PC_AN_CH_COUNT], int64_t now_ms);
+
+const char *plantcare_anomaly_channel_name(enum plantcare_an_channel ch);
+const char *plantcare_anomaly_kind_name(enum plantcare_an_kind kind);
+
+#endif /* PLANTCARE_ANOMALY_H */
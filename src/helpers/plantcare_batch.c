@@ -0,0 +1,214 @@
+// src/helpers/plantcare_batch.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/zbus/zbus.h>
+#include <string.h>
+
+#include "plantcare_batch.h"
+#include "plantcare_bus.h"
+#include "plantcare_units.h"
+#include "plantcare_time.h"
+
+struct batch_plant {
+    int16_t  light_pct_x10;
+    int16_t  soil_pct_x10;
+};
+
+/* 12 + 4 bytes per plant per sample, PLANTCARE_BATCH_MAX of them */
+struct batch_rec {
+    uint32_t t_s;           /* uptime, seconds */
+    int16_t  temp_x100;
+    int16_t  hum_x100;
+    int16_t  acc_max_g100;
+    uint8_t  leaf_class;
+    uint8_t  fresh_mask;
+    struct batch_plant plants[PLANTCARE_PLANT_COUNT];
+};
+
+#define BATCH_FIELDS  (5 + 2 * PLANTCARE_PLANT_COUNT)
+
+static struct batch_rec ring[PLANTCARE_BATCH_MAX];
+static uint16_t head;       /* oldest record */
+static uint16_t count;
+static uint32_t seq;
+static char last_gps[sizeof(((struct plantcare_data *)0)->gps_last_sentence)];
+
+static atomic_t flush_request;
+static atomic_t alarm_raised;
+
+static struct plantcare_batch_stats stats;
+
+static const char *const reason_names[] = {
+    [PC_BATCH_AGE]       = "age",
+    [PC_BATCH_FULL]      = "full",
+    [PC_BATCH_ALARM]     = "alarm",
+    [PC_BATCH_REQUEST]   = "request",
+    [PC_BATCH_MODE_EXIT] = "mode",
+};
+
+/* Listener on pc_alarm_chan: only note it, the mode thread sends */
+static void batch_alarm_event(const struct zbus_channel *chan)
+{
+    const struct plantcare_alarm_event *evt = zbus_chan_const_msg(chan);
+
+    if (evt->active) {
+        atomic_set(&alarm_raised, 1);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(batch_alarm_lis, batch_alarm_event);
+ZBUS_CHAN_ADD_OBS(pc_alarm_chan, batch_alarm_lis, 4);
+
+static int16_t clamp16(int32_t v)
+{
+    return (int16_t)CLAMP(v, INT16_MIN, INT16_MAX);
+}
+
+void plantcare_batch_add(const struct plantcare_data *s, int64_t now_ms)
+{
+    int32_t ax = s->acc_x_g100 < 0 ? -s->acc_x_g100 : s->acc_x_g100;
+    int32_t ay = s->acc_y_g100 < 0 ? -s->acc_y_g100 : s->acc_y_g100;
+    int32_t az = s->acc_z_g100 < 0 ? -s->acc_z_g100 : s->acc_z_g100;
+
+    /* Full ring (batch_size was raised or no poll): drop the oldest */
+    if (count == PLANTCARE_BATCH_MAX) {
+        head = (head + 1U) % PLANTCARE_BATCH_MAX;
+        count--;
+    }
+
+    struct batch_rec *r = &ring[(head + count) % PLANTCARE_BATCH_MAX];
+
+    r->t_s           = (uint32_t)(now_ms / 1000);
+    r->temp_x100     = clamp16(s->temp_x100);
+    r->hum_x100      = clamp16(s->hum_x100);
+    r->acc_max_g100  = clamp16(MAX(ax, MAX(ay, az)));
+    r->leaf_class    = s->leaf_class;
+    r->fresh_mask    = s->fresh_mask;
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        r->plants[p].light_pct_x10 =
+            clamp16(light_raw_to_pct_x10(s->plants[p].light_raw));
+        r->plants[p].soil_pct_x10  =
+            clamp16(soil_raw_to_pct_x10(s->plants[p].soil_raw));
+    }
+    count++;
+
+    if (s->gps_last_sentence[0] != '\0') {
+        memcpy(last_gps, s->gps_last_sentence, sizeof(last_gps));
+    }
+}
+
+static void rec_fields(const struct batch_rec *r, int32_t *f)
+{
+    f[0] = r->temp_x100;
+    f[1] = r->hum_x100;
+    f[2] = r->plants[0].light_pct_x10;
+    f[3] = r->plants[0].soil_pct_x10;
+    f[4] = r->acc_max_g100;
+    f[5] = r->leaf_class;
+    f[6] = r->fresh_mask;
+
+    /* Further plants after the fixed columns */
+    for (int p = 1; p < PLANTCARE_PLANT_COUNT; p++) {
+        f[5 + 2 * p] = r->plants[p].light_pct_x10;
+        f[6 + 2 * p] = r->plants[p].soil_pct_x10;
+    }
+}
+
+/* printk one line and count it */
+static void batch_emit(const char *line, int len)
+{
+    printk("%s", line);
+    stats.bytes += (uint32_t)len;
+}
+
+void plantcare_batch_flush(enum plantcare_batch_reason reason)
+{
+    char line[32 + 8 * BATCH_FIELDS];
+    int32_t prev[BATCH_FIELDS];
+    int32_t cur[BATCH_FIELDS];
+    uint32_t prev_t = 0;
+    int len;
+
+    atomic_clear(&flush_request);
+    atomic_clear(&alarm_raised);
+
+    if (count == 0) {
+        return;
+    }
+
+    seq++;
+    len = snprintk(line, sizeof(line), "#B,%u,%u,%u,%s,%u\n", seq, count,
+                   ring[head].t_s, reason_names[reason],
+                   plantcare_time_at((int64_t)ring[head].t_s * 1000));
+    batch_emit(line, len);
+
+    if (last_gps[0] != '\0') {
+        len = snprintk(line, sizeof(line), "#G,%s\n", last_gps);
+        batch_emit(line, MIN(len, (int)sizeof(line) - 1));
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        const struct batch_rec *r = &ring[(head + i) % PLANTCARE_BATCH_MAX];
+
+        rec_fields(r, cur);
+        len = snprintk(line, sizeof(line), "%u", i ? r->t_s - prev_t : 0U);
+
+        for (int f = 0; f < BATCH_FIELDS; f++) {
+            int32_t v = i ? cur[f] - prev[f] : cur[f];
+
+            if (v != 0 || i == 0) {
+                len += snprintk(line + len, sizeof(line) - len, ",%d", v);
+            } else {
+                line[len++] = ',';
+            }
+        }
+        line[len++] = '\n';
+        line[len] = '\0';
+        batch_emit(line, len);
+
+        memcpy(prev, cur, sizeof(prev));
+        prev_t = r->t_s;
+    }
+
+    len = snprintk(line, sizeof(line), "#E,%u\n", seq);
+    batch_emit(line, len);
+
+    stats.reports++;
+    stats.samples += count;
+    head  = 0;
+    count = 0;
+}
+
+void plantcare_batch_poll(uint16_t batch_size, bool flush_on_alarm,
+                          int64_t now_ms)
+{
+    if (atomic_get(&flush_request)) {
+        plantcare_batch_flush(PC_BATCH_REQUEST);
+    } else if (flush_on_alarm && atomic_get(&alarm_raised)) {
+        plantcare_batch_flush(PC_BATCH_ALARM);
+    } else if (count > 0 &&
+               now_ms / 1000 - ring[head].t_s >= PLANTCARE_BATCH_AGE_S) {
+        plantcare_batch_flush(PC_BATCH_AGE);
+    } else if (count >= MIN(MAX(batch_size, 1U), PLANTCARE_BATCH_MAX)) {
+        plantcare_batch_flush(PC_BATCH_FULL);
+    }
+}
+
+void plantcare_batch_request_flush(void)
+{
+    atomic_set(&flush_request, 1);
+}
+
+void plantcare_batch_get_stats(struct plantcare_batch_stats *out)
+{
+    *out = stats;
+    out->pending = count;
+}
+
+size_t plantcare_batch_ram_bytes(void)
+{
+    return sizeof(ring) + sizeof(last_gps);
+}
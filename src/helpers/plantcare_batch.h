@@ -0,0 +1,80 @@
+#ifndef PLANTCARE_BATCH_H
+#define PLANTCARE_BATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "plantcare_state.h"
+
+/*
+ * Batching stage between the snapshots and the console/uplink.
+ *
+ * Normal mode stores one compact record per sample in a static ring and
+ * the ring is sent as one report when its oldest record is an hour old,
+ * when it holds batch_size records, when an alarm is raised (if
+ * flush-on-alarm is set), on request, or when the mode is left. Samples
+ * come as fast as the sensors are read, 30 s to 5 min apart with
+ * adaptive sampling, so the age trigger is what makes the report hourly
+ * and batch_size only bounds it. Report format, all values integers in
+ * the usual units:
+ *
+ *   #B,<seq>,<n>,<t0_s>,<reason>,<epoch0_s>
+ *   #G,<last NMEA sentence>                        (if any)
+ *   <dt_s>,<temp_x100>,<hum_x100>,<light_pct_x10>,<soil_pct_x10>,
+ *          <acc_max_g100>,<leaf_class>,<fresh_mask>
+ *          [,<light_pct_x10>,<soil_pct_x10> for plant 1, 2, ...]
+ *   ...
+ *   #E,<seq>
+ *
+ * The first row holds absolute values, the next ones the difference to
+ * the row before, with unchanged fields left empty ("30,2,,,,,,").
+ * Light/soil in the fixed columns are plant 0. fresh_mask has bit
+ * BIT(PC_SENSOR_x) set for the groups read for that row; the columns of
+ * the other groups repeat their last reading. t0_s is the uptime of the
+ * first row and epoch0_s the UTC time for it (0 if the clock is not set),
+ * so row times are epoch0_s plus the summed dt_s.
+ */
+
+#define PLANTCARE_BATCH_MAX      120    /* one hour at the 30 s floor */
+#define PLANTCARE_BATCH_DEFAULT  PLANTCARE_BATCH_MAX
+
+/* A report goes out once its oldest record is this old */
+#define PLANTCARE_BATCH_AGE_S    3600
+
+enum plantcare_batch_reason {
+    PC_BATCH_AGE = 0,
+    PC_BATCH_FULL,
+    PC_BATCH_ALARM,
+    PC_BATCH_REQUEST,
+    PC_BATCH_MODE_EXIT,
+};
+
+/* Add one sample (mode thread) */
+void plantcare_batch_add(const struct plantcare_data *s, int64_t now_ms);
+
+/* Send the report if it is due: the oldest record is PLANTCARE_BATCH_AGE_S
+ * old at now_ms, batch_size records are stored, an alarm was raised
+ * (flush_on_alarm), or a flush was requested. Mode thread.
+ */
+void plantcare_batch_poll(uint16_t batch_size, bool flush_on_alarm,
+                          int64_t now_ms);
+
+/* Send whatever is stored now (mode thread) */
+void plantcare_batch_flush(enum plantcare_batch_reason reason);
+
+/* Ask the mode thread to flush at its next poll (any thread) */
+void plantcare_batch_request_flush(void);
+
+struct plantcare_batch_stats {
+    uint32_t pending;       /* records waiting */
+    uint32_t reports;
+    uint32_t samples;       /* records sent */
+    uint32_t bytes;         /* report bytes sent */
+};
+
+void plantcare_batch_get_stats(struct plantcare_batch_stats *out);
+
+/* Static RAM of the record ring, bytes (plantcare_mem.h) */
+size_t plantcare_batch_ram_bytes(void);
+
+#endif /* PLANTCARE_BATCH_H */
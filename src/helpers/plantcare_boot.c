@@ -0,0 +1,192 @@
+// src/helpers/plantcare_boot.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <stdint.h>
+
+#include "plantcare_boot.h"
+#include "plantcare_calib.h"
+#include "plantcare_alarm.h"
+#include "plantcare_time.h"
+
+#include "sensors/plant_adc.h"
+#include "sensors/humidity_sensor.h"
+#include "sensors/accelerometer_sensor.h"
+#include "sensors/rgb_sensor.h"
+#include "sensors/leds.h"
+#include "sensors/led1.h"
+#include "sensors/led2.h"
+#include "sensors/led_anim.h"
+#include "sensors/gps_sensor.h"
+#include "sensors/button.h"
+
+/*
+ * Init graph. A step runs once all its deps are done and, if it has a
+ * settle time, that long after the last dep finished. Steps that are
+ * waiting don't block the others, so e.g. the TCS34725 power-on delay is
+ * spent initialising the rest of the board instead of in k_sleep().
+ *
+ * Everything runs in main's thread: the I2C sensors share one bus and the
+ * rest are register writes, so the only thing worth overlapping is the
+ * waiting. Keep BOOT_RGB_PON near the top so its settle time starts early.
+ */
+enum boot_step_id {
+    BOOT_RGB_PON = 0,
+    BOOT_PLANT_ADC,
+    BOOT_HUMIDITY,
+    BOOT_ACCEL,
+    BOOT_LEDS,
+    BOOT_LED1,
+    BOOT_LED2,
+    BOOT_LED_ANIM,
+    BOOT_GPS,
+    BOOT_TIME,
+    BOOT_BUTTON,
+    BOOT_CALIB,
+    BOOT_ALARM,
+    BOOT_RGB_EN,
+    BOOT_STEP_COUNT,
+};
+
+struct boot_step {
+    const char *name;
+    int (*init)(void);
+    uint32_t deps;          /* BIT(boot_step_id) of steps that must run first */
+    uint16_t settle_ms;     /* minimum time after the last dep finished */
+};
+
+static int led_anim_step(void)
+{
+    /* All LED output goes through the animation engine from here on */
+    led_anim_init();
+    return 0;
+}
+
+static int alarm_step(void)
+{
+    plantcare_alarm_init();
+    return 0;
+}
+
+static const struct boot_step boot_steps[BOOT_STEP_COUNT] = {
+    [BOOT_RGB_PON]  = { "rgb_sensor_power_on",       rgb_sensor_power_on },
+    [BOOT_PLANT_ADC] = { "plant_adc_init",           plant_adc_init },
+    [BOOT_HUMIDITY] = { "humidity_sensor_init_all",  humidity_sensor_init_all },
+    [BOOT_ACCEL]    = { "accelerometer_sensor_init_all",
+                        accelerometer_sensor_init_all },
+    [BOOT_LEDS]     = { "leds_init",                 leds_init },
+    [BOOT_LED1]     = { "led1_init",                 led1_init },
+    [BOOT_LED2]     = { "led2_init",                 led2_init },
+    [BOOT_LED_ANIM] = { "led_anim_init",             led_anim_step,
+                        BIT(BOOT_LEDS) | BIT(BOOT_LED1) | BIT(BOOT_LED2) },
+    [BOOT_GPS]      = { "gps_sensor_init",           gps_sensor_init },
+    [BOOT_TIME]     = { "plantcare_time_init",       plantcare_time_init },
+    [BOOT_BUTTON]   = { "button_init",               button_init },
+    /* Calibration must be applied before the first sample is converted */
+    [BOOT_CALIB]    = { "plantcare_calib_init",      plantcare_calib_init },
+    [BOOT_ALARM]    = { "plantcare_alarm_init",      alarm_step },
+    [BOOT_RGB_EN]   = { "rgb_sensor_enable",         rgb_sensor_enable,
+                        BIT(BOOT_RGB_PON), RGB_SENSOR_PON_SETTLE_MS },
+};
+
+#define BOOT_ALL_STEPS  (BIT(BOOT_STEP_COUNT) - 1)
+
+K_SEM_DEFINE(boot_ready_sem, 0, 1);
+
+static int64_t boot_done_us;
+
+static int64_t boot_now_us(void)
+{
+    return (int64_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+int plantcare_boot_run(void)
+{
+    int64_t done_at_us[BOOT_STEP_COUNT] = { 0 };
+    uint32_t done = 0;
+    uint32_t failed = 0;
+    int64_t start_us = boot_now_us();
+    int64_t settle_us = 0;      /* settle time spent doing other work */
+
+    while (done != BOOT_ALL_STEPS) {
+        int64_t now_us = boot_now_us();
+        int64_t next_us = INT64_MAX;
+        bool ran = false;
+
+        for (int i = 0; i < BOOT_STEP_COUNT; i++) {
+            const struct boot_step *step = &boot_steps[i];
+
+            if ((done & BIT(i)) || (done & step->deps) != step->deps) {
+                continue;
+            }
+
+            if (failed & step->deps) {
+                printk("%s skipped (dependency failed)\n", step->name);
+                done |= BIT(i);
+                failed |= BIT(i);
+                continue;
+            }
+
+            int64_t deps_done_us = 0;
+            for (int d = 0; d < BOOT_STEP_COUNT; d++) {
+                if (step->deps & BIT(d)) {
+                    deps_done_us = MAX(deps_done_us, done_at_us[d]);
+                }
+            }
+
+            int64_t ready_us = deps_done_us + step->settle_ms * 1000LL;
+            if (now_us < ready_us) {
+                next_us = MIN(next_us, ready_us);
+                continue;
+            }
+            if (step->settle_ms) {
+                settle_us += step->settle_ms * 1000LL;
+            }
+
+            int ret = step->init();
+            if (ret) {
+                printk("%s failed: %d\n", step->name, ret);
+                failed |= BIT(i);
+            }
+
+            now_us = boot_now_us();
+            done_at_us[i] = now_us;
+            done |= BIT(i);
+            ran = true;
+        }
+
+        /* Nothing runnable: sleep only what is left of the shortest wait */
+        if (!ran && next_us != INT64_MAX) {
+            int64_t left_us = next_us - now_us;
+
+            settle_us -= left_us;
+            k_sleep(K_USEC(left_us));
+        }
+    }
+
+    boot_done_us = boot_now_us();
+    printk("Boot: %d steps in %u us (%u us of settle time overlapped)\n",
+           BOOT_STEP_COUNT, (uint32_t)(boot_done_us - start_us),
+           (uint32_t)MAX(settle_us, 0));
+
+    return (int)POPCOUNT(failed);
+}
+
+void plantcare_boot_ready(void)
+{
+    k_sem_give(&boot_ready_sem);
+}
+
+void plantcare_boot_wait_ready(void)
+{
+    (void)k_sem_take(&boot_ready_sem, K_FOREVER);
+}
+
+void plantcare_boot_first_sample(void)
+{
+    int64_t now_us = boot_now_us();
+
+    printk("Boot: first sample %u ms after reset (%u ms after init)\n",
+           (uint32_t)(now_us / 1000),
+           (uint32_t)((now_us - boot_done_us) / 1000));
+}
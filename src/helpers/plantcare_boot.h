@@ -0,0 +1,21 @@
+#ifndef PLANTCARE_BOOT_H
+#define PLANTCARE_BOOT_H
+
+#include <zephyr/kernel.h>
+
+/* Run every driver / helper initialiser in dependency order, overlapping
+ * fixed settle times with other work. Failures are printed and counted,
+ * they don't stop the other steps. Returns the number of failed steps.
+ */
+int plantcare_boot_run(void);
+
+/* main(): initial config is published, sensor thread may start */
+void plantcare_boot_ready(void);
+
+/* Sensor thread: block until plantcare_boot_ready() was called */
+void plantcare_boot_wait_ready(void);
+
+/* Sensor thread: first snapshot is out, report boot-to-first-sample time */
+void plantcare_boot_first_sample(void);
+
+#endif /* PLANTCARE_BOOT_H */
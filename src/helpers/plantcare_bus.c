@@ -0,0 +1,43 @@
+// src/helpers/plantcare_bus.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "plantcare_bus.h"
+#include "plantcare_batch.h"
+
+/* Observers are attached where they live (ZBUS_CHAN_ADD_OBS) */
+
+ZBUS_CHAN_DEFINE(pc_config_chan, struct plantcare_mode_cfg,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(.mode = PLANTCARE_MODE_TEST,
+                               .sampling_period_ms = 2000,
+                               .batch_size = PLANTCARE_BATCH_DEFAULT,
+                               .batch_flush_on_alarm = true));
+
+ZBUS_CHAN_DEFINE(pc_button_chan, struct pc_msg_button,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(pc_trigger_chan, struct pc_msg_trigger,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(pc_adc_chan, struct pc_msg_adc,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(pc_climate_chan, struct pc_msg_climate,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(pc_accel_chan, struct pc_msg_accel,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(pc_color_chan, struct pc_msg_color,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(pc_gps_chan, struct pc_msg_gps,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(pc_snapshot_chan, struct plantcare_data,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_DEFINE(pc_alarm_chan, struct plantcare_alarm_event,
+                 NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
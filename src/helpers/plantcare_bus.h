@@ -0,0 +1,88 @@
+#ifndef PLANTCARE_BUS_H
+#define PLANTCARE_BUS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include <stdint.h>
+
+#include "plantcare_config.h"
+#include "plantcare_state.h"
+#include "plantcare_alarm.h"
+
+/*
+ * Message bus (zbus) between PlantCare modules.
+ *
+ * Producers publish, consumers attach themselves with ZBUS_CHAN_ADD_OBS()
+ * in their own file, so a new logger/radio/stats module never has to touch
+ * the sensor thread or the modes.
+ *
+ *   pc_config_chan    struct plantcare_mode_cfg   mode + sampling period
+ *   pc_button_chan    struct pc_msg_button        button press (from ISR)
+ *   pc_trigger_chan   struct pc_msg_trigger       read all sensors now
+ *   pc_adc_chan       struct pc_msg_adc           soil + light + drying, all plants
+ *   pc_climate_chan   struct pc_msg_climate       temp, humidity, dew point, VPD
+ *   pc_accel_chan     struct pc_msg_accel         accelerometer
+ *   pc_color_chan     struct pc_msg_color         colour sensor
+ *   pc_gps_chan       struct pc_msg_gps           new NMEA sentence
+ *   pc_snapshot_chan  struct plantcare_data       full snapshot per cycle
+ *   pc_alarm_chan     struct plantcare_alarm_event alarm raised/cleared
+ *
+ * Climate, accel and colour messages come once per sensor instance (see
+ * the TCA9548A support in sensors/i2c_mux.h); the snapshot holds
+ * instance 0. A per-zone logger subscribes to those channels.
+ *
+ * pc_snapshot_chan is large: readers that only look at a few fields can
+ * use plantcare_state_claim()/plantcare_state_finish() instead of copying.
+ */
+
+struct pc_msg_button {
+    uint32_t uptime_ms;
+    uint32_t cycles;        /* k_cycle_get_32(), for switch latency */
+};
+
+struct pc_msg_trigger {
+    uint32_t uptime_ms;
+};
+
+struct pc_msg_adc {
+    struct plant_adc_sample plants[PLANTCARE_PLANT_COUNT];
+    struct plantcare_drying drying[PLANTCARE_PLANT_COUNT];  /* after this scan */
+};
+
+struct pc_msg_climate {
+    uint8_t inst;
+    int32_t temp_x100;
+    int32_t hum_x100;
+    int32_t dew_x100;
+    int32_t vpd_pa;
+};
+
+struct pc_msg_accel {
+    uint8_t inst;
+    int32_t x_g100;
+    int32_t y_g100;
+    int32_t z_g100;
+    int16_t tilt_cdeg;      /* from the rest pose, instance 0 only, else
+                             * PLANTCARE_TILT_NO_REST
+                             */
+};
+
+struct pc_msg_color {
+    uint8_t inst;
+    uint16_t clr;
+    uint16_t red;
+    uint16_t green;
+    uint16_t blue;
+    struct plantcare_color_result res;
+};
+
+struct pc_msg_gps {
+    char sentence[64];
+};
+
+ZBUS_CHAN_DECLARE(pc_config_chan, pc_button_chan, pc_trigger_chan,
+                  pc_adc_chan, pc_climate_chan, pc_accel_chan,
+                  pc_color_chan, pc_gps_chan,
+                  pc_snapshot_chan, pc_alarm_chan);
+
+#endif /* PLANTCARE_BUS_H */
@@ -0,0 +1,164 @@
+// src/helpers/plantcare_calib.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/printk.h>
+#include <errno.h>
+#include <string.h>
+
+#include "plantcare_calib.h"
+#include "plantcare_units.h"
+#include "plantcare_tilt.h"
+#include "plantcare_drying.h"
+
+/* Bump when struct plantcare_calib changes layout */
+#define CALIB_VERSION   1
+
+struct calib_record {
+    uint32_t version;
+    struct plantcare_calib cal;
+};
+
+static struct calib_record stored;
+static bool stored_valid;
+
+/* Tilt rest pose, x/y/z in accelerometer counts */
+static int16_t stored_rest[3];
+static bool stored_rest_valid;
+
+/* Endpoints closer than this are treated as a failed capture */
+#define CALIB_MIN_SPAN_RAW  50
+
+static bool calib_range_ok(int32_t a, int32_t b)
+{
+    int32_t span = (a > b) ? (a - b) : (b - a);
+
+    return a >= 0 && a <= 4095 && b >= 0 && b <= 4095 &&
+           span >= CALIB_MIN_SPAN_RAW;
+}
+
+static int calib_apply(const struct plantcare_calib *cal)
+{
+    if (!calib_range_ok(cal->soil_raw_dry, cal->soil_raw_wet) ||
+        !calib_range_ok(cal->light_raw_dark, cal->light_raw_bright)) {
+        return -EINVAL;
+    }
+
+    (void)soil_units_set_range(cal->soil_raw_dry, cal->soil_raw_wet);
+    (void)light_units_set_range(cal->light_raw_dark, cal->light_raw_bright);
+    accel_units_set_offset(cal->acc_off_x_g100,
+                           cal->acc_off_y_g100,
+                           cal->acc_off_z_g100);
+    return 0;
+}
+
+static int calib_settings_set(const char *name, size_t len,
+                              settings_read_cb read_cb, void *cb_arg)
+{
+    const char *next;
+
+    if (settings_name_steq(name, "rest", &next) && !next) {
+        if (len != sizeof(stored_rest)) {
+            return -EINVAL;
+        }
+
+        ssize_t rc = read_cb(cb_arg, stored_rest, sizeof(stored_rest));
+        if (rc < 0) {
+            return (int)rc;
+        }
+        stored_rest_valid = (rc == sizeof(stored_rest));
+        return 0;
+    }
+
+    if (!settings_name_steq(name, "cal", &next) || next) {
+        return -ENOENT;
+    }
+
+    if (len != sizeof(stored)) {
+        return -EINVAL;
+    }
+
+    ssize_t rc = read_cb(cb_arg, &stored, sizeof(stored));
+    if (rc < 0) {
+        return (int)rc;
+    }
+
+    stored_valid = (rc == sizeof(stored) && stored.version == CALIB_VERSION);
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(plantcare, "plantcare", NULL,
+                               calib_settings_set, NULL, NULL);
+
+int plantcare_calib_init(void)
+{
+    int ret = settings_subsys_init();
+    if (ret) {
+        printk("calib: settings_subsys_init failed, err=%d\n", ret);
+        return ret;
+    }
+
+    ret = settings_load_subtree("plantcare");
+    if (ret) {
+        printk("calib: settings load failed, err=%d\n", ret);
+        return ret;
+    }
+
+    if (stored_rest_valid && plantcare_tilt_set_rest(stored_rest) < 0) {
+        printk("calib: stored rest pose rejected\n");
+    }
+
+    if (!stored_valid) {
+        printk("calib: no stored calibration, using devicetree defaults\n");
+        return 0;
+    }
+
+    ret = calib_apply(&stored.cal);
+    if (ret) {
+        printk("calib: stored calibration rejected, err=%d\n", ret);
+        return ret;
+    }
+
+    printk("calib: loaded (soil %d..%d, light %d..%d)\n",
+           stored.cal.soil_raw_dry, stored.cal.soil_raw_wet,
+           stored.cal.light_raw_dark, stored.cal.light_raw_bright);
+    return 0;
+}
+
+int plantcare_calib_store(const struct plantcare_calib *cal)
+{
+    int ret = calib_apply(cal);
+    if (ret) {
+        return ret;
+    }
+
+    stored.version = CALIB_VERSION;
+    memcpy(&stored.cal, cal, sizeof(stored.cal));
+    stored_valid = true;
+
+    /* The old fits are in the old scale */
+    plantcare_drying_reset();
+
+    ret = settings_save_one("plantcare/cal", &stored, sizeof(stored));
+    if (ret) {
+        printk("calib: save failed, err=%d\n", ret);
+    }
+    return ret;
+}
+
+int plantcare_calib_store_rest(const int16_t rest[3])
+{
+    int ret = plantcare_tilt_set_rest(rest);
+    if (ret) {
+        return ret;
+    }
+
+    memcpy(stored_rest, rest, sizeof(stored_rest));
+    stored_rest_valid = true;
+
+    ret = settings_save_one("plantcare/rest", stored_rest, sizeof(stored_rest));
+    if (ret) {
+        printk("calib: rest pose save failed, err=%d\n", ret);
+    }
+    return ret;
+}
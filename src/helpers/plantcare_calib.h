@@ -0,0 +1,37 @@
+#ifndef PLANTCARE_CALIB_H
+#define PLANTCARE_CALIB_H
+
+#include <stdint.h>
+
+/* Per-device field calibration, persisted in flash (settings "plantcare/cal").
+ * Raw values are ADC counts, offsets are g*100.
+ */
+struct plantcare_calib {
+    int16_t soil_raw_dry;
+    int16_t soil_raw_wet;
+    int16_t light_raw_dark;
+    int16_t light_raw_bright;
+    int32_t acc_off_x_g100;
+    int32_t acc_off_y_g100;
+    int32_t acc_off_z_g100;
+};
+
+/* Load stored calibration (if any) and apply it to plantcare_units.
+ * Call once at boot, before the sensor thread starts converting.
+ * Returns 0 (also when nothing is stored yet), negative errno on error.
+ */
+int plantcare_calib_init(void);
+
+/* Apply a new calibration and persist it.
+ * Returns 0 on success, -EINVAL if a range is degenerate (nothing changed),
+ * other negative errno if saving to flash failed (still applied in RAM).
+ */
+int plantcare_calib_store(const struct plantcare_calib *cal);
+
+/* Apply a tilt rest pose (plantcare_tilt.h, counts) and persist it under
+ * "plantcare/rest", apart from the calibration above so either can be
+ * redone alone. Same return values as plantcare_calib_store().
+ */
+int plantcare_calib_store_rest(const int16_t rest[3]);
+
+#endif /* PLANTCARE_CALIB_H */
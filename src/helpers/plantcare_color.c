@@ -0,0 +1,232 @@
+// src/helpers/plantcare_color.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include "plantcare_color.h"
+#include "sensors/rgb_sensor.h"
+
+/*
+ * Tuning from the /zephyr,user node of the board overlay:
+ *
+ *   zephyr,user {
+ *       color-ir-subtract;                  remove IR (grow lights, sun)
+ *       color-ga-x100 = <100>;              glass attenuation * 100
+ *       leaf-centroids = <300 450 230       healthy    r g b, ‰ of clear
+ *                         380 430 140       yellowing
+ *                         420 340 190>;     browning
+ *       leaf-max-distance = <150>;          ‰, farther is UNKNOWN
+ *   };
+ *
+ * The default centroids are a starting point for a white-ish light.
+ * Under a grow light, log "pc color" on a few known leaves and set the
+ * centroids from that.
+ */
+
+#define PLANTCARE_USER_NODE DT_PATH(zephyr_user)
+
+#define COLOR_IR_SUBTRACT   DT_NODE_HAS_PROP(PLANTCARE_USER_NODE, color_ir_subtract)
+#define COLOR_GA_X100       DT_PROP_OR(PLANTCARE_USER_NODE, color_ga_x100, 100)
+#define LEAF_MAX_DISTANCE   DT_PROP_OR(PLANTCARE_USER_NODE, leaf_max_distance, 150)
+
+BUILD_ASSERT(COLOR_GA_X100 > 0, "color-ga-x100 must be > 0");
+BUILD_ASSERT(LEAF_MAX_DISTANCE > 0 && LEAF_MAX_DISTANCE <= 1000,
+             "leaf-max-distance must be 1..1000");
+
+/* Below this clear count (after IR removal) there is nothing to classify:
+ * night, or the sensor is covered.
+ */
+#define COLOR_DARK_CLEAR    16
+
+/*
+ * Lux and CCT from the TCS34725 application note (DN40):
+ *   lux = (0.136 R + 1.000 G - 0.444 B) / CPL
+ *   CPL = ATIME_ms * AGAIN / (GA * 310)
+ *   CCT = 3810 * B / R + 1391
+ * The coefficients are in thousandths and the divide by CPL is folded into
+ * one reciprocal-multiply, as in plantcare_units.c.
+ */
+#define LUX_R_MILLI         136
+#define LUX_G_MILLI         1000
+#define LUX_B_MILLI         (-444)
+#define LUX_DF              310
+#define LUX_SHIFT           24
+#define LUX_SCALE                                                        \
+    ((((uint64_t)COLOR_GA_X100 * LUX_DF) << LUX_SHIFT) /                 \
+     ((uint64_t)RGB_SENSOR_ATIME_US * RGB_SENSOR_AGAIN * 100))
+
+#define CCT_COEF            3810
+#define CCT_OFFSET          1391
+
+#define LEAF_CENTROIDS      (PC_LEAF_CLASS_COUNT - 1)
+
+#if DT_NODE_HAS_PROP(PLANTCARE_USER_NODE, leaf_centroids)
+
+BUILD_ASSERT(DT_PROP_LEN(PLANTCARE_USER_NODE, leaf_centroids) ==
+             3 * LEAF_CENTROIDS,
+             "leaf-centroids must have r g b for healthy, yellowing, browning");
+
+#define LEAF_DT(i)  DT_PROP_BY_IDX(PLANTCARE_USER_NODE, leaf_centroids, i)
+#define LEAF_ENTRY(n)  { LEAF_DT(3 * (n)), LEAF_DT(3 * (n) + 1), LEAF_DT(3 * (n) + 2) }
+
+static struct plantcare_leaf_centroid centroids[LEAF_CENTROIDS] = {
+    LEAF_ENTRY(0), LEAF_ENTRY(1), LEAF_ENTRY(2),
+};
+
+#else
+
+static struct plantcare_leaf_centroid centroids[LEAF_CENTROIDS] = {
+    { 300, 450, 230 },      /* healthy */
+    { 380, 430, 140 },      /* yellowing */
+    { 420, 340, 190 },      /* browning */
+};
+
+#endif
+
+/* The shell can replace centroids while the sensor thread classifies */
+K_MUTEX_DEFINE(color_lock);
+
+static uint16_t chroma_pm(int32_t ch, int32_t clear)
+{
+    int32_t pm = (ch * 1000) / clear;
+
+    return (uint16_t)MIN(pm, 1000);
+}
+
+/* HSV hue of the IR-free channels, degrees * 10 */
+static uint16_t hue_x10(int32_t r, int32_t g, int32_t b)
+{
+    int32_t max = MAX(r, MAX(g, b));
+    int32_t min = MIN(r, MIN(g, b));
+    int32_t delta = max - min;
+    int32_t h;
+
+    if (delta == 0) {
+        return 0;
+    }
+
+    if (max == r) {
+        h = (600 * (g - b)) / delta;
+    } else if (max == g) {
+        h = 1200 + (600 * (b - r)) / delta;
+    } else {
+        h = 2400 + (600 * (r - g)) / delta;
+    }
+    if (h < 0) {
+        h += 3600;
+    }
+    return (uint16_t)h;
+}
+
+static uint8_t classify(const struct plantcare_color_result *res)
+{
+    uint32_t best_d2 = UINT32_MAX;
+    uint8_t best = PC_LEAF_UNKNOWN;
+
+    k_mutex_lock(&color_lock, K_FOREVER);
+    for (int i = 0; i < LEAF_CENTROIDS; i++) {
+        int32_t dr = (int32_t)res->r_pm - centroids[i].r_pm;
+        int32_t dg = (int32_t)res->g_pm - centroids[i].g_pm;
+        int32_t db = (int32_t)res->b_pm - centroids[i].b_pm;
+        uint32_t d2 = (uint32_t)(dr * dr + dg * dg + db * db);
+
+        if (d2 < best_d2) {
+            best_d2 = d2;
+            best = (uint8_t)(PC_LEAF_HEALTHY + i);
+        }
+    }
+    k_mutex_unlock(&color_lock);
+
+    if (best_d2 > (uint32_t)LEAF_MAX_DISTANCE * LEAF_MAX_DISTANCE) {
+        return PC_LEAF_UNKNOWN;
+    }
+    return best;
+}
+
+void plantcare_color_process(uint16_t clear, uint16_t red, uint16_t green,
+                             uint16_t blue,
+                             struct plantcare_color_result *out)
+{
+    int32_t c = clear;
+    int32_t r = red;
+    int32_t g = green;
+    int32_t b = blue;
+
+    *out = (struct plantcare_color_result){ 0 };
+    out->saturated = (clear >= RGB_SENSOR_MAX_COUNT);
+
+    if (COLOR_IR_SUBTRACT) {
+        /* DN40: the clear photodiode sees the IR once, R/G/B each see it */
+        int32_t ir = MAX((r + g + b - c) / 2, 0);
+
+        c = MAX(c - ir, 0);
+        r = MAX(r - ir, 0);
+        g = MAX(g - ir, 0);
+        b = MAX(b - ir, 0);
+    }
+
+    int32_t y_milli = LUX_R_MILLI * r + LUX_G_MILLI * g + LUX_B_MILLI * b;
+
+    if (y_milli > 0) {
+        out->lux = (uint32_t)(((uint64_t)y_milli * LUX_SCALE) >> LUX_SHIFT);
+    }
+
+    if (c < COLOR_DARK_CLEAR) {
+        out->leaf_class = PC_LEAF_UNKNOWN;
+        return;
+    }
+
+    out->r_pm    = chroma_pm(r, c);
+    out->g_pm    = chroma_pm(g, c);
+    out->b_pm    = chroma_pm(b, c);
+    out->hue_x10 = hue_x10(r, g, b);
+
+    if (r > 0) {
+        out->cct_k = (uint16_t)MIN((CCT_COEF * b) / r + CCT_OFFSET, UINT16_MAX);
+    }
+
+    /* Clipped channels have wrong ratios, so do not guess */
+    out->leaf_class = out->saturated ? PC_LEAF_UNKNOWN : classify(out);
+}
+
+int plantcare_color_set_centroid(uint8_t cls,
+                                 const struct plantcare_leaf_centroid *c)
+{
+    if (cls < PC_LEAF_HEALTHY || cls >= PC_LEAF_CLASS_COUNT ||
+        c->r_pm > 1000 || c->g_pm > 1000 || c->b_pm > 1000) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&color_lock, K_FOREVER);
+    centroids[cls - PC_LEAF_HEALTHY] = *c;
+    k_mutex_unlock(&color_lock);
+    return 0;
+}
+
+void plantcare_color_get_centroid(uint8_t cls,
+                                  struct plantcare_leaf_centroid *c)
+{
+    if (cls < PC_LEAF_HEALTHY || cls >= PC_LEAF_CLASS_COUNT) {
+        *c = (struct plantcare_leaf_centroid){ 0 };
+        return;
+    }
+
+    k_mutex_lock(&color_lock, K_FOREVER);
+    *c = centroids[cls - PC_LEAF_HEALTHY];
+    k_mutex_unlock(&color_lock);
+}
+
+const char *plantcare_leaf_class_name(uint8_t cls)
+{
+    static const char *const names[PC_LEAF_CLASS_COUNT] = {
+        [PC_LEAF_UNKNOWN]   = "UNKNOWN",
+        [PC_LEAF_HEALTHY]   = "HEALTHY",
+        [PC_LEAF_YELLOWING] = "YELLOWING",
+        [PC_LEAF_BROWNING]  = "BROWNING",
+    };
+
+    return (cls < PC_LEAF_CLASS_COUNT) ? names[cls] : "?";
+}
@@ -0,0 +1,64 @@
+#ifndef PLANTCARE_COLOR_H
+#define PLANTCARE_COLOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Colour pipeline for the TCS34725 (plantcare_color.c), integer only and
+ * a fixed amount of work per sample:
+ *
+ *   raw C/R/G/B -> IR removed (optional) -> chromaticity (‰ of clear)
+ *               -> hue, CCT, lux -> nearest leaf centroid
+ *
+ * The leaf class replaces the old argmax of raw R/G/B, which reported RED
+ * under most grow lights.
+ */
+
+enum plantcare_leaf_class {
+    PC_LEAF_UNKNOWN = 0,    /* too dark, saturated or far from every centroid */
+    PC_LEAF_HEALTHY,
+    PC_LEAF_YELLOWING,
+    PC_LEAF_BROWNING,
+    PC_LEAF_CLASS_COUNT,
+};
+
+struct plantcare_color_result {
+    /* Chromaticity: channel / clear after IR removal, ‰ */
+    uint16_t r_pm;
+    uint16_t g_pm;
+    uint16_t b_pm;
+
+    uint16_t hue_x10;       /* HSV hue, degrees * 10 (0..3599) */
+    uint16_t cct_k;         /* correlated colour temperature, K; 0 if unknown */
+    uint32_t lux;           /* illuminance, lux */
+    uint8_t  leaf_class;    /* enum plantcare_leaf_class */
+    bool     saturated;     /* a channel hit RGB_SENSOR_MAX_COUNT */
+};
+
+/* One classifier entry, chromaticity in ‰ of clear */
+struct plantcare_leaf_centroid {
+    uint16_t r_pm;
+    uint16_t g_pm;
+    uint16_t b_pm;
+};
+
+/* Run the pipeline on one raw sample. Pure apart from reading the
+ * centroid table, so it can also be used on snapshot values.
+ */
+void plantcare_color_process(uint16_t clear, uint16_t red, uint16_t green,
+                             uint16_t blue,
+                             struct plantcare_color_result *out);
+
+/* Classifier table. Defaults come from the leaf-centroids property of the
+ * /zephyr,user node if present (plantcare_color.c). cls is
+ * PC_LEAF_HEALTHY..PC_LEAF_BROWNING.
+ */
+int plantcare_color_set_centroid(uint8_t cls,
+                                 const struct plantcare_leaf_centroid *c);
+void plantcare_color_get_centroid(uint8_t cls,
+                                  struct plantcare_leaf_centroid *c);
+
+const char *plantcare_leaf_class_name(uint8_t cls);
+
+#endif /* PLANTCARE_COLOR_H */
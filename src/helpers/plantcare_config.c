@@ -1,13 +1,175 @@
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include "plantcare_config.h"
+#include "plantcare_bus.h"
+#include "plantcare_batch.h"
 
-/* Default values */
-volatile bool g_sensors_ready        = false;
-volatile uint32_t g_sampling_period_ms = 2000;
+/* The mode thread sleeps on this subscriber: button presses, config
+ * changes so a mode set from the shell is acted on at once, and new
+ * snapshots so a mode works on fresh data rather than on a timer
+ */
+ZBUS_SUBSCRIBER_DEFINE(mode_sub, 8);
+ZBUS_CHAN_ADD_OBS(pc_button_chan, mode_sub, 3);
+ZBUS_CHAN_ADD_OBS(pc_config_chan, mode_sub, 3);
+ZBUS_CHAN_ADD_OBS(pc_snapshot_chan, mode_sub, 3);
 
-/* Start in TEST mode by default */
-volatile plantcare_mode_t g_current_mode = PLANTCARE_MODE_TEST;
+void plantcare_config_get(struct plantcare_mode_cfg *cfg)
+{
+    (void)zbus_chan_read(&pc_config_chan, cfg, K_FOREVER);
+}
 
-/* Button event flag, set by button ISR */
-volatile bool g_button_pressed_event = false;
\ No newline at end of file
+plantcare_mode_t plantcare_config_mode(void)
+{
+    struct plantcare_mode_cfg cfg;
+
+    plantcare_config_get(&cfg);
+    return cfg.mode;
+}
+
+/* Update the config in place (other fields are kept), then notify */
+static struct plantcare_mode_cfg *config_claim(void)
+{
+    if (zbus_chan_claim(&pc_config_chan, K_FOREVER) != 0) {
+        return NULL;
+    }
+    return zbus_chan_msg(&pc_config_chan);
+}
+
+static void config_publish(void)
+{
+    zbus_chan_finish(&pc_config_chan);
+    (void)zbus_chan_notify(&pc_config_chan, K_FOREVER);
+}
+
+void plantcare_config_set(plantcare_mode_t mode, uint32_t sampling_period_ms)
+{
+    struct plantcare_mode_cfg *cfg = config_claim();
+    if (!cfg) {
+        return;
+    }
+
+    cfg->mode = mode;
+    cfg->sampling_period_ms = sampling_period_ms;
+    cfg->adapt_floor_ms = 0;
+    cfg->adapt_ceiling_ms = 0;
+    config_publish();
+}
+
+void plantcare_config_set_mode(plantcare_mode_t mode)
+{
+    struct plantcare_mode_cfg *cfg = config_claim();
+    if (!cfg) {
+        return;
+    }
+
+    cfg->mode = mode;
+    config_publish();
+}
+
+int plantcare_config_set_sensor_period(enum plantcare_sensor sensor,
+                                       uint32_t period_ms)
+{
+    if (sensor >= PC_SENSOR_COUNT) {
+        return -EINVAL;
+    }
+
+    struct plantcare_mode_cfg *cfg = config_claim();
+    if (!cfg) {
+        return -EBUSY;
+    }
+
+    cfg->sensor_period_ms[sensor] = period_ms;
+    config_publish();
+    return 0;
+}
+
+int plantcare_config_set_adaptive(uint32_t floor_ms, uint32_t ceiling_ms)
+{
+    if (ceiling_ms && ceiling_ms < floor_ms) {
+        return -EINVAL;
+    }
+
+    struct plantcare_mode_cfg *cfg = config_claim();
+    if (!cfg) {
+        return -EBUSY;
+    }
+
+    cfg->adapt_floor_ms = floor_ms;
+    cfg->adapt_ceiling_ms = ceiling_ms;
+    config_publish();
+    return 0;
+}
+
+int plantcare_config_set_batch(uint16_t batch_size, bool flush_on_alarm)
+{
+    if (batch_size > PLANTCARE_BATCH_MAX) {
+        return -EINVAL;
+    }
+
+    struct plantcare_mode_cfg *cfg = config_claim();
+    if (!cfg) {
+        return -EBUSY;
+    }
+
+    cfg->batch_size = batch_size;
+    cfg->batch_flush_on_alarm = flush_on_alarm;
+    config_publish();
+    return 0;
+}
+
+void plantcare_config_set_output_format(plantcare_output_t format)
+{
+    struct plantcare_mode_cfg *cfg = config_claim();
+    if (!cfg) {
+        return;
+    }
+
+    cfg->output_format = format;
+    config_publish();
+}
+
+plantcare_output_t plantcare_config_output_format(void)
+{
+    struct plantcare_mode_cfg cfg;
+
+    plantcare_config_get(&cfg);
+    return cfg.output_format;
+}
+
+const char *plantcare_sensor_name(enum plantcare_sensor sensor)
+{
+    static const char *const names[PC_SENSOR_COUNT] = {
+        [PC_SENSOR_ADC]     = "adc",
+        [PC_SENSOR_CLIMATE] = "climate",
+        [PC_SENSOR_ACCEL]   = "accel",
+        [PC_SENSOR_COLOR]   = "color",
+        [PC_SENSOR_GPS]     = "gps",
+    };
+
+    return (sensor < PC_SENSOR_COUNT) ? names[sensor] : "?";
+}
+
+enum plantcare_wake plantcare_wait_event(k_timeout_t timeout,
+                                         uint32_t *press_cycles)
+{
+    const struct zbus_channel *chan;
+    struct pc_msg_button msg;
+
+    if (zbus_sub_wait(&mode_sub, &chan, timeout) != 0) {
+        return PC_WAKE_TIMEOUT;
+    }
+    if (chan == &pc_snapshot_chan) {
+        return PC_WAKE_SNAPSHOT;
+    }
+    if (chan != &pc_button_chan) {
+        return PC_WAKE_CONFIG;
+    }
+    if (press_cycles != NULL) {
+        *press_cycles = (zbus_chan_read(&pc_button_chan, &msg, K_NO_WAIT) == 0) ?
+                        msg.cycles : k_cycle_get_32();
+    }
+    return PC_WAKE_BUTTON;
+}
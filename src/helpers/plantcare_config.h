@@ -1,24 +1,108 @@
 #ifndef PLANTCARE_CONFIG_H
 #define PLANTCARE_CONFIG_H
 
+#include <zephyr/kernel.h>
 #include <stdint.h>
 #include <stdbool.h>
 
-/* Sampling period for background sensor thread (ms) */
-extern volatile uint32_t g_sampling_period_ms;
-
-/* Sensors ready flag */
-extern volatile bool g_sensors_ready;
-
 /* ---- Mode enum ---- */
 typedef enum {
     PLANTCARE_MODE_TEST = 0,
     PLANTCARE_MODE_NORMAL = 1,
+    PLANTCARE_MODE_CALIBRATION = 2,
+    PLANTCARE_MODE_COUNT,
 } plantcare_mode_t;
 
-extern volatile plantcare_mode_t g_current_mode;
+/* ---- Sensor groups read by the background sensor thread ---- */
+enum plantcare_sensor {
+    PC_SENSOR_ADC = 0,      /* soil + light */
+    PC_SENSOR_CLIMATE,      /* Si7021 */
+    PC_SENSOR_ACCEL,        /* MMA8451 */
+    PC_SENSOR_COLOR,        /* TCS34725 */
+    PC_SENSOR_GPS,          /* UART NMEA */
+    PC_SENSOR_COUNT,
+};
+
+/* ---- Console output format of the modes ---- */
+typedef enum {
+    PLANTCARE_OUTPUT_TEXT = 0,
+    PLANTCARE_OUTPUT_CSV  = 1,
+} plantcare_output_t;
+
+/* Current mode + sampling period for the background sensor thread.
+ * Lives on pc_config_chan (plantcare_bus.h); every change is published,
+ * so observers (sensor thread, loggers...) are woken up immediately.
+ */
+struct plantcare_mode_cfg {
+    plantcare_mode_t mode;
+    uint32_t sampling_period_ms;
+
+    /* Per-sensor override of sampling_period_ms, 0 = follow the mode */
+    uint32_t sensor_period_ms[PC_SENSOR_COUNT];
+
+    plantcare_output_t output_format;
+
+    /* Adaptive sampling (plantcare_adapt.h): each sensor's period moves
+     * between adapt_floor_ms (0 = its normal period) and adapt_ceiling_ms.
+     * adapt_ceiling_ms = 0 turns it off.
+     */
+    uint32_t adapt_floor_ms;
+    uint32_t adapt_ceiling_ms;
+
+    /* Normal mode reports (plantcare_batch.h): most samples per report,
+     * which goes out hourly anyway; 0 = print every sample as it comes.
+     * Raised alarms can flush early.
+     */
+    uint16_t batch_size;
+    bool batch_flush_on_alarm;
+};
+
+void plantcare_config_get(struct plantcare_mode_cfg *cfg);
+plantcare_mode_t plantcare_config_mode(void);
+
+/* Publish a new mode and sampling period. Adaptive sampling is turned
+ * off; a mode that wants it enables it afterwards.
+ */
+void plantcare_config_set(plantcare_mode_t mode, uint32_t sampling_period_ms);
+
+/* Publish a new mode, keep the sampling period */
+void plantcare_config_set_mode(plantcare_mode_t mode);
+
+/* Per-sensor period override (0 = follow the mode's sampling period).
+ * Returns 0 or -EINVAL.
+ */
+int plantcare_config_set_sensor_period(enum plantcare_sensor sensor,
+                                       uint32_t period_ms);
+
+/* Enable adaptive sampling between floor_ms and ceiling_ms
+ * (ceiling_ms = 0 disables it). Returns 0 or -EINVAL.
+ */
+int plantcare_config_set_adaptive(uint32_t floor_ms, uint32_t ceiling_ms);
+
+/* Samples per normal-mode report (0 = per-sample output) and whether a
+ * raised alarm sends the report right away. Returns 0 or -EINVAL.
+ */
+int plantcare_config_set_batch(uint16_t batch_size, bool flush_on_alarm);
+
+void plantcare_config_set_output_format(plantcare_output_t format);
+plantcare_output_t plantcare_config_output_format(void);
+
+const char *plantcare_sensor_name(enum plantcare_sensor sensor);
+
+/* ---- Button events (published from ISR on pc_button_chan) ---- */
+
+enum plantcare_wake {
+    PC_WAKE_TIMEOUT = 0,
+    PC_WAKE_BUTTON,
+    PC_WAKE_CONFIG,         /* pc_config_chan was published */
+    PC_WAKE_SNAPSHOT,       /* the sensor thread published a snapshot */
+};
 
-/* ---- Button event flag (set from ISR) ---- */
-extern volatile bool g_button_pressed_event;
+/* Mode thread: wait up to timeout for a button press, a config change or
+ * a new snapshot.
+ * For a press, *press_cycles (if not NULL) is k_cycle_get_32() in the ISR.
+ */
+enum plantcare_wake plantcare_wait_event(k_timeout_t timeout,
+                                         uint32_t *press_cycles);
 
-#endif /* PLANTCARE_CONFIG_H */
\ No newline at end of file
+#endif /* PLANTCARE_CONFIG_H */
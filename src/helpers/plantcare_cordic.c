@@ -0,0 +1,123 @@
+// src/helpers/plantcare_cordic.c
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "plantcare_cordic.h"
+
+/* atan(2^-i), centidegrees * 256 */
+#define ANGLE_FRAC      8
+
+static const int32_t atan_tab[PLANTCARE_CORDIC_ITER] = {
+    1152000,   /* atan(2^-0) */
+     680065,   /* atan(2^-1) */
+     359328,   /* atan(2^-2) */
+     182400,   /* atan(2^-3) */
+      91554,   /* atan(2^-4) */
+      45822,   /* atan(2^-5) */
+      22916,   /* atan(2^-6) */
+      11459,   /* atan(2^-7) */
+       5730,   /* atan(2^-8) */
+       2865,   /* atan(2^-9) */
+       1432,   /* atan(2^-10) */
+        716,   /* atan(2^-11) */
+        358,   /* atan(2^-12) */
+        179,   /* atan(2^-13) */
+         90,   /* atan(2^-14) */
+         45,   /* atan(2^-15) */
+};
+
+/* 1 / prod(sqrt(1 + 2^-2i)), the CORDIC gain after 16 iterations, Q15 */
+#define CORDIC_INV_GAIN_Q15     19898
+
+#define HALF_TURN_CDEG          18000
+
+/*
+ * Larger input lands in [0.5, 1) of Q15, carried with 14 guard bits: the
+ * truncation of every shift then stays far below a centidegree. The gain
+ * (x 1.65) and the 45° of the first step keep it under 2^31.
+ */
+#define GUARD_BITS              14
+#define NORM_LO                 ((int64_t)1 << (14 + GUARD_BITS))
+#define NORM_HI                 ((int64_t)1 << (15 + GUARD_BITS))
+
+int32_t plantcare_cordic_vector(int32_t y, int32_t x, int32_t *mag)
+{
+    /* 64-bit only until scaled, so -INT32_MIN is fine; the loop is 32-bit */
+    int64_t x64 = x;
+    int64_t y64 = y;
+    int32_t base = 0;
+    int shift = 0;
+
+    if (x == 0 && y == 0) {
+        if (mag) {
+            *mag = 0;
+        }
+        return 0;
+    }
+
+    /* Rotate the left half-plane by 180° so the loop converges */
+    if (x64 < 0) {
+        base = (y64 >= 0) ? HALF_TURN_CDEG : -HALF_TURN_CDEG;
+        x64 = -x64;
+        y64 = -y64;
+    }
+
+    int64_t ay = (y64 < 0) ? -y64 : y64;
+    int64_t m  = (x64 > ay) ? x64 : ay;
+
+    while (m >= NORM_HI) {
+        m >>= 1;
+        shift--;
+    }
+    while (m < NORM_LO) {
+        m <<= 1;
+        shift++;
+    }
+
+    int32_t xs = (int32_t)((shift >= 0) ? x64 << shift : x64 >> -shift);
+    int32_t ys = (int32_t)((shift >= 0) ? y64 << shift : y64 >> -shift);
+    int32_t z = 0;
+
+    for (int i = 0; i < PLANTCARE_CORDIC_ITER; i++) {
+        int32_t xi = xs >> i;
+        int32_t yi = ys >> i;
+
+        if (ys > 0) {
+            xs += yi;
+            ys -= xi;
+            z  += atan_tab[i];
+        } else {
+            xs -= yi;
+            ys += xi;
+            z  -= atan_tab[i];
+        }
+    }
+
+    if (mag) {
+        int64_t r = ((int64_t)xs * CORDIC_INV_GAIN_Q15) >> 15;
+
+        r = (shift >= 0) ? (r + (((int64_t)1 << shift) >> 1)) >> shift
+                         : r << -shift;
+        *mag = (int32_t)((r > INT32_MAX) ? INT32_MAX : r);
+    }
+
+    /* Round to the nearest centidegree, symmetric around 0 */
+    int32_t half = 1 << (ANGLE_FRAC - 1);
+    int32_t cdeg = (z >= 0) ? (z + half) >> ANGLE_FRAC
+                            : -((-z + half) >> ANGLE_FRAC);
+
+    /* Undo the half turn; keep exactly-negative-x on +180° */
+    cdeg += base;
+    if (cdeg > HALF_TURN_CDEG) {
+        cdeg -= 2 * HALF_TURN_CDEG;
+    } else if (cdeg <= -HALF_TURN_CDEG) {
+        cdeg += 2 * HALF_TURN_CDEG;
+    }
+    return cdeg;
+}
+
+int32_t plantcare_cordic_atan2(int32_t y, int32_t x)
+{
+    return plantcare_cordic_vector(y, x, NULL);
+}
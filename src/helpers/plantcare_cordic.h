@@ -0,0 +1,26 @@
+#ifndef PLANTCARE_CORDIC_H
+#define PLANTCARE_CORDIC_H
+
+#include <stdint.h>
+
+/*
+ * CORDIC in vectoring mode (plantcare_cordic.c): shifts and adds only, a
+ * fixed PLANTCARE_CORDIC_ITER iterations per call. Plain C with no Zephyr
+ * includes, so the host tests check it against libm.
+ *
+ * The inputs are first scaled by a power of two so the larger one lies in
+ * [0.5, 1) as Q15 (plus guard bits), so any int32 range works and small
+ * vectors keep their precision. Angles are in centidegrees,
+ * -18000..18000, within 0.7 cdeg of atan2(); tests/host/test_cordic.c
+ * checks that bound.
+ */
+
+#define PLANTCARE_CORDIC_ITER   16
+
+/* atan2(y, x) in centidegrees; 0 for (0, 0) */
+int32_t plantcare_cordic_atan2(int32_t y, int32_t x);
+
+/* atan2(y, x) and, in *mag (if not NULL), sqrt(x² + y²) in input units */
+int32_t plantcare_cordic_vector(int32_t y, int32_t x, int32_t *mag);
+
+#endif /* PLANTCARE_CORDIC_H */
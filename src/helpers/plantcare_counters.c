@@ -0,0 +1,82 @@
+// src/helpers/plantcare_counters.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "plantcare_counters.h"
+#include "plantcare_bus.h"
+
+static atomic_t counters[PC_CNT_COUNT];
+static atomic_t sensor_reads[PC_SENSOR_COUNT];
+static atomic_t sensor_errors[PC_SENSOR_COUNT];
+
+static const char *const counter_names[PC_CNT_COUNT] = {
+    [PC_CNT_CYCLES]        = "cycles",
+    [PC_CNT_SNAPSHOTS]     = "snapshots",
+    [PC_CNT_TRIGGERS]      = "triggers",
+    [PC_CNT_BUTTON]        = "button",
+    [PC_CNT_ALARM_RAISED]  = "alarm_raised",
+    [PC_CNT_ALARM_CLEARED] = "alarm_cleared",
+    [PC_CNT_REINITS]       = "reinits",
+    [PC_CNT_BUS_RECOVERIES] = "bus_recoveries",
+    [PC_CNT_SNAPSHOT_COPIES] = "snapshot_copies",
+};
+
+void plantcare_counter_inc(enum pc_counter c)
+{
+    if (c < PC_CNT_COUNT) {
+        atomic_inc(&counters[c]);
+    }
+}
+
+uint32_t plantcare_counter_get(enum pc_counter c)
+{
+    return (c < PC_CNT_COUNT) ? (uint32_t)atomic_get(&counters[c]) : 0;
+}
+
+const char *plantcare_counter_name(enum pc_counter c)
+{
+    return (c < PC_CNT_COUNT) ? counter_names[c] : "?";
+}
+
+void plantcare_counter_sensor_read(enum plantcare_sensor s, int ret)
+{
+    if (s >= PC_SENSOR_COUNT) {
+        return;
+    }
+
+    atomic_inc(&sensor_reads[s]);
+    if (ret < 0) {
+        atomic_inc(&sensor_errors[s]);
+    }
+}
+
+uint32_t plantcare_counter_sensor_reads(enum plantcare_sensor s)
+{
+    return (s < PC_SENSOR_COUNT) ? (uint32_t)atomic_get(&sensor_reads[s]) : 0;
+}
+
+uint32_t plantcare_counter_sensor_errors(enum plantcare_sensor s)
+{
+    return (s < PC_SENSOR_COUNT) ? (uint32_t)atomic_get(&sensor_errors[s]) : 0;
+}
+
+/* Bus events are counted by listeners, nobody else has to know */
+static void counters_bus_cb(const struct zbus_channel *chan)
+{
+    if (chan == &pc_button_chan) {
+        atomic_inc(&counters[PC_CNT_BUTTON]);
+    } else if (chan == &pc_alarm_chan) {
+        const struct plantcare_alarm_event *evt = zbus_chan_const_msg(chan);
+        atomic_inc(&counters[evt->active ? PC_CNT_ALARM_RAISED
+                                         : PC_CNT_ALARM_CLEARED]);
+    } else if (chan == &pc_snapshot_chan) {
+        atomic_inc(&counters[PC_CNT_SNAPSHOTS]);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(counters_lis, counters_bus_cb);
+ZBUS_CHAN_ADD_OBS(pc_button_chan, counters_lis, 4);
+ZBUS_CHAN_ADD_OBS(pc_alarm_chan, counters_lis, 4);
+ZBUS_CHAN_ADD_OBS(pc_snapshot_chan, counters_lis, 4);
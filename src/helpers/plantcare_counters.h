@@ -0,0 +1,31 @@
+#ifndef PLANTCARE_COUNTERS_H
+#define PLANTCARE_COUNTERS_H
+
+#include <stdint.h>
+
+#include "plantcare_config.h"
+
+/* Instrumentation counters, safe to bump from any thread or ISR */
+enum pc_counter {
+    PC_CNT_CYCLES = 0,      /* sensor thread sampling cycles */
+    PC_CNT_SNAPSHOTS,       /* snapshots published */
+    PC_CNT_TRIGGERS,        /* on-demand reads */
+    PC_CNT_BUTTON,          /* button presses */
+    PC_CNT_ALARM_RAISED,
+    PC_CNT_ALARM_CLEARED,
+    PC_CNT_REINITS,         /* drivers re-initialised after a failure */
+    PC_CNT_BUS_RECOVERIES,  /* I2C bus recoveries attempted */
+    PC_CNT_SNAPSHOT_COPIES, /* whole struct plantcare_data copied in or out */
+    PC_CNT_COUNT,
+};
+
+void plantcare_counter_inc(enum pc_counter c);
+uint32_t plantcare_counter_get(enum pc_counter c);
+const char *plantcare_counter_name(enum pc_counter c);
+
+/* Count one read of a sensor group; ret < 0 also counts an error */
+void plantcare_counter_sensor_read(enum plantcare_sensor s, int ret);
+uint32_t plantcare_counter_sensor_reads(enum plantcare_sensor s);
+uint32_t plantcare_counter_sensor_errors(enum plantcare_sensor s);
+
+#endif /* PLANTCARE_COUNTERS_H */
@@ -0,0 +1,299 @@
+// src/helpers/plantcare_dli.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <string.h>
+
+#include "plantcare_dli.h"
+#include "plantcare_config.h"
+#include "plantcare_state.h"
+#include "plantcare_time.h"
+#include "sensors/rgb_sensor.h"
+
+#define PLANTCARE_USER_NODE DT_PATH(zephyr_user)
+
+#define DLI_LUX_PER_UMOL_X10  DT_PROP_OR(PLANTCARE_USER_NODE, ppfd_lux_per_umol_x10, 540)
+#define DLI_MAX_GAP_MS        (DT_PROP_OR(PLANTCARE_USER_NODE, dli_max_gap_s, 1800) * 1000)
+#define DLI_SAVE_PERIOD_MS    (DT_PROP_OR(PLANTCARE_USER_NODE, dli_save_period_s, 900) * 1000)
+
+BUILD_ASSERT(DLI_LUX_PER_UMOL_X10 >= 50 && DLI_LUX_PER_UMOL_X10 <= 2000,
+             "ppfd-lux-per-umol-x10 out of range");
+
+/* ppfd_x10 = lux * 100 / K_x10, by reciprocal-multiply */
+#define LUX_SHIFT       20
+#define LUX_RECIP       (((100u << LUX_SHIFT) + DLI_LUX_PER_UMOL_X10 / 2) / \
+                         DLI_LUX_PER_UMOL_X10)
+
+/* The accumulator is in ppfd_x10 * ms * 2 (trapezoids without the halving):
+ * one mol/m² * 100 is 2e8 of it. Reading it multiplies by 2^48 / 2e8; a
+ * full day of 3000 µmol/m²/s (4.2e12) times that still fits in 64 bits.
+ */
+#define ACC_SHIFT       48
+#define ACC_RECIP       ((((uint64_t)1 << ACC_SHIFT) + 100000000) / 200000000)
+#define ACC_MAX         (UINT64_MAX / ACC_RECIP)
+
+/* Smallest analog reading and PPFD that give a usable scale */
+#define CAL_MIN_RAW         20
+#define CAL_MIN_PPFD_X10    100
+
+#define DAY_S           86400u
+
+/* Bump when struct dli_record changes layout */
+#define DLI_VERSION     1
+
+struct dli_record {
+    uint32_t version;
+    uint32_t day;           /* local day acc belongs to, 0 if unknown */
+    uint64_t acc;
+    uint32_t analog_q16;
+    uint16_t yesterday_x100;
+    uint16_t reserved;
+};
+
+static struct k_spinlock lock;
+
+static uint64_t acc;
+static uint16_t yesterday_x100;
+static uint32_t analog_q16;
+static uint32_t day;
+static uint32_t next_midnight;
+
+/* Last integrated point */
+static bool prev_valid;
+static int64_t prev_ms;
+static uint32_t prev_ppfd;
+
+static uint32_t samples;
+static uint32_t missing_ms;
+static uint32_t saves;
+static int64_t last_save_ms;
+
+/* Loaded by plantcare_calib_init()'s settings_load_subtree("plantcare");
+ * applied at the first update with a known clock.
+ */
+static struct dli_record restored;
+static bool restored_valid;
+
+static int dli_settings_set(const char *name, size_t len,
+                            settings_read_cb read_cb, void *cb_arg)
+{
+    if (name != NULL && name[0] != '\0') {
+        return -ENOENT;
+    }
+    if (len != sizeof(restored)) {
+        return -EINVAL;
+    }
+
+    ssize_t rc = read_cb(cb_arg, &restored, sizeof(restored));
+    if (rc < 0) {
+        return (int)rc;
+    }
+
+    restored_valid = (rc == sizeof(restored) && restored.version == DLI_VERSION);
+    if (restored_valid) {
+        analog_q16 = restored.analog_q16;
+    }
+    return 0;
+}
+
+/* Longer prefix than calib's "plantcare", so these records come here */
+SETTINGS_STATIC_HANDLER_DEFINE(plantcare_dli, "plantcare/dli", NULL,
+                               dli_settings_set, NULL, NULL);
+
+static uint16_t acc_to_x100(uint64_t a)
+{
+    return (uint16_t)MIN((MIN(a, ACC_MAX) * ACC_RECIP) >> ACC_SHIFT, UINT16_MAX);
+}
+
+/* Local day of epoch_s and the UTC second it ends at. The offset is
+ * looked up again at midnight itself, as DST may change during the day.
+ */
+static void dli_set_day(uint32_t epoch_s)
+{
+    int32_t off = plantcare_time_local_offset_s(epoch_s, NULL);
+    int64_t end;
+
+    day = (uint32_t)(((int64_t)epoch_s + off) / DAY_S);
+    end = (int64_t)(day + 1) * DAY_S;
+    off = plantcare_time_local_offset_s((uint32_t)(end - off), NULL);
+    next_midnight = (uint32_t)(end - off);
+}
+
+/* Take back what was saved before the reset, once the day is known */
+static void dli_restore(void)
+{
+    if (!restored_valid) {
+        return;
+    }
+    restored_valid = false;
+
+    if (restored.day == day) {
+        acc += restored.acc;
+        yesterday_x100 = restored.yesterday_x100;
+    } else if (restored.day + 1 == day) {
+        yesterday_x100 = acc_to_x100(restored.acc);
+    }
+}
+
+static void dli_record_fill(struct dli_record *r)
+{
+    *r = (struct dli_record){
+        .version = DLI_VERSION,
+        .day = day,
+        .acc = acc,
+        .analog_q16 = analog_q16,
+        .yesterday_x100 = yesterday_x100,
+    };
+}
+
+static void dli_save(const struct dli_record *r)
+{
+    int ret = settings_save_one("plantcare/dli", r, sizeof(*r));
+
+    if (ret) {
+        printk("dli: save failed, err=%d\n", ret);
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    saves++;
+    k_spin_unlock(&lock, key);
+}
+
+uint32_t plantcare_dli_ppfd_from_lux(uint32_t lux)
+{
+    return (uint32_t)(((uint64_t)lux * LUX_RECIP) >> LUX_SHIFT);
+}
+
+/* Which sensor this cycle's PPFD comes from */
+static uint8_t dli_source(const struct plantcare_data *s, uint32_t fresh)
+{
+    uint32_t good = fresh & s->valid_mask;
+
+    if ((good & BIT(PC_SENSOR_COLOR)) && s->clr < RGB_SENSOR_MAX_COUNT) {
+        return PC_PPFD_COLOR;
+    }
+    if ((good & BIT(PC_SENSOR_ADC)) && analog_q16 != 0 &&
+        s->plants[0].light_raw > 0) {
+        return PC_PPFD_ANALOG;
+    }
+    return PC_PPFD_NONE;
+}
+
+void plantcare_dli_update(struct plantcare_data *s, uint32_t fresh,
+                          int64_t now_ms)
+{
+    struct dli_record rec;
+    bool save = false;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    uint8_t source = dli_source(s, fresh);
+    bool cross = false;
+    uint64_t after = 0;
+
+    if (day == 0 && s->epoch_s != 0) {
+        dli_set_day(s->epoch_s);
+        dli_restore();
+    } else if (next_midnight != 0 && s->epoch_s >= next_midnight) {
+        cross = true;
+    }
+
+    if (source != PC_PPFD_NONE) {
+        uint32_t ppfd = (source == PC_PPFD_COLOR) ?
+            plantcare_dli_ppfd_from_lux(s->lux) :
+            (uint32_t)(((uint64_t)s->plants[0].light_raw * analog_q16) >> 16);
+
+        if (prev_valid) {
+            uint32_t dt_ms = (uint32_t)MIN(now_ms - prev_ms, (int64_t)UINT32_MAX);
+
+            if (dt_ms > DLI_MAX_GAP_MS) {
+                missing_ms += dt_ms;
+            } else {
+                uint64_t area = (uint64_t)(prev_ppfd + ppfd) * dt_ms;
+
+                if (cross) {
+                    /* The part after midnight, at the new value, is the
+                     * new day's
+                     */
+                    uint64_t after_ms = (uint64_t)(s->epoch_s - next_midnight) * 1000;
+
+                    after = MIN(2 * (uint64_t)ppfd * MIN(after_ms, dt_ms), area);
+                }
+                acc += area - after;
+                samples++;
+            }
+        }
+
+        prev_valid = true;
+        prev_ms = now_ms;
+        prev_ppfd = ppfd;
+        s->dli.ppfd_x10 = ppfd;
+        s->dli.source = source;
+    } else if (!prev_valid || now_ms - prev_ms > DLI_MAX_GAP_MS) {
+        /* Groups not due this cycle keep the last estimate until it is
+         * too old to integrate from
+         */
+        s->dli.ppfd_x10 = 0;
+        s->dli.source = PC_PPFD_NONE;
+    }
+
+    if (cross) {
+        yesterday_x100 = acc_to_x100(acc);
+        acc = after;
+        samples = 0;
+        missing_ms = 0;
+        dli_set_day(s->epoch_s);
+        save = true;
+    }
+
+    if (day != 0 && now_ms - last_save_ms >= DLI_SAVE_PERIOD_MS) {
+        save = true;
+    }
+    if (save) {
+        last_save_ms = now_ms;
+        dli_record_fill(&rec);
+    }
+
+    s->dli.today_x100 = acc_to_x100(acc);
+    s->dli.yesterday_x100 = yesterday_x100;
+    k_spin_unlock(&lock, key);
+
+    /* Flash writes stay outside the lock */
+    if (save) {
+        dli_save(&rec);
+    }
+}
+
+int plantcare_dli_calibrate_analog(uint32_t ppfd_x10, int32_t light_raw)
+{
+    struct dli_record rec;
+
+    if (light_raw < CAL_MIN_RAW || ppfd_x10 < CAL_MIN_PPFD_X10) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    analog_q16 = (uint32_t)(((uint64_t)ppfd_x10 << 16) / (uint32_t)light_raw);
+    dli_record_fill(&rec);
+    k_spin_unlock(&lock, key);
+
+    dli_save(&rec);
+    return 0;
+}
+
+void plantcare_dli_get_stats(struct plantcare_dli_stats *st)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    st->samples = samples;
+    st->missing_s = missing_ms / 1000;
+    st->day = day;
+    st->next_midnight = next_midnight;
+    st->analog_q16 = analog_q16;
+    st->saves = saves;
+    k_spin_unlock(&lock, key);
+}
@@ -0,0 +1,85 @@
+#ifndef PLANTCARE_DLI_H
+#define PLANTCARE_DLI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Photon flux and daily light integral (plantcare_dli.c).
+ *
+ * PPFD (µmol/m²/s, 400..700 nm) is estimated from the TCS34725 lux
+ * (plantcare_color.h). How many lux make one µmol/m²/s depends on the
+ * light source (Thimijan & Heins 1983):
+ *
+ *   sunlight 54, metal halide 71, cool-white fluorescent 74,
+ *   high-pressure sodium 82, red/blue LED grow light about 20..30
+ *
+ * Set it with ppfd-lux-per-umol-x10 in /zephyr,user (default 540,
+ * sunlight). It is folded into a reciprocal at build time. When the colour
+ * sensor is saturated or offline, plant 0's analog light sensor stands
+ * in. Its scale is taken once by "pc dli cal", with both sensors in the
+ * same light, and persisted; the sensor is taken as linear, reading 0 in
+ * the dark. Until that is done there is no fallback.
+ *
+ * DLI (mol/m²/day) is the trapezoid integral of PPFD over the local day.
+ * Each interval is weighted by its own length, so adaptive and irregular
+ * sampling need nothing special. An interval longer than dli-max-gap-s
+ * (default 1800) is not integrated; the sensors or the device were off,
+ * and the time counts as missing. The accumulator is 64-bit, in
+ * PPFD * 10 * ms * 2, so a sample costs one multiply and an add. The
+ * divide to mol/m² happens only when the DLI is read.
+ *
+ * The day ends at local midnight (plantcare_time.h). The boundary is
+ * worked out once per day and each sample only compares against it; an
+ * interval that spans midnight is split there. Until the clock is set
+ * the day is not known, and what was integrated counts towards the first
+ * day the clock reports.
+ *
+ * The running day is saved under "plantcare/dli" every dli-save-period-s
+ * (default 900) and at midnight. At boot it is taken back if it is from
+ * the same local day; the light of the time the device was off is lost.
+ */
+
+enum plantcare_ppfd_source {
+    PC_PPFD_NONE = 0,
+    PC_PPFD_COLOR,          /* TCS34725 lux / K */
+    PC_PPFD_ANALOG,         /* plant 0 light sensor, "pc dli cal" scale */
+};
+
+struct plantcare_dli {
+    uint32_t ppfd_x10;      /* last estimate, µmol/m²/s * 10 */
+    uint16_t today_x100;    /* DLI so far today, mol/m²/day * 100 */
+    uint16_t yesterday_x100;    /* last complete day, 0 if none */
+    uint8_t  source;        /* enum plantcare_ppfd_source */
+};
+
+struct plantcare_dli_stats {
+    uint32_t samples;       /* integrated today */
+    uint32_t missing_s;     /* gaps not integrated today */
+    uint32_t day;           /* local days since 1970, 0 if unknown */
+    uint32_t next_midnight; /* UTC epoch_s, 0 if unknown */
+    uint32_t analog_q16;    /* PPFD * 10 per analog count, Q16; 0 = none */
+    uint32_t saves;
+};
+
+struct plantcare_data;
+
+/* Sensor thread, once per cycle. fresh has BIT(PC_SENSOR_x) set for each
+ * group read successfully this cycle; nothing is integrated unless the
+ * PPFD source is among them. Updates s->dli.
+ */
+void plantcare_dli_update(struct plantcare_data *s, uint32_t fresh,
+                          int64_t now_ms);
+
+/* PPFD * 10 from lux (the colour sensor path alone) */
+uint32_t plantcare_dli_ppfd_from_lux(uint32_t lux);
+
+/* Scale the analog light sensor from the colour sensor: ppfd_x10 and raw
+ * read in the same light. Persisted. -EINVAL if raw or ppfd is too small
+ * to give a usable scale.
+ */
+int plantcare_dli_calibrate_analog(uint32_t ppfd_x10, int32_t light_raw);
+
+void plantcare_dli_get_stats(struct plantcare_dli_stats *st);
+
+#endif /* PLANTCARE_DLI_H */
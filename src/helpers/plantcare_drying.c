@@ -0,0 +1,275 @@
+// src/helpers/plantcare_drying.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "plantcare_drying.h"
+#include "plantcare_state.h"
+#include "plantcare_alarm.h"
+#include "plantcare_anomaly.h"
+#include "plantcare_units.h"
+
+/* Forgetting time constant, and the gap after which the fit restarts */
+#define DRYING_TAU_S        10800
+#define DRYING_MAX_GAP_S    3600
+
+/* A fit needs this many samples, spread (weighted std dev) over at least
+ * DRYING_MIN_SPREAD_S; a line through 20 minutes of readings says little.
+ */
+#define DRYING_MIN_SAMPLES  6
+#define DRYING_MIN_SPREAD_S 600
+
+/* A reading this far above the line is watering: 5.0 % */
+#define DRYING_WATERED_X10  50
+
+/* Slower than 0.05 %/h is not drying */
+#define DRYING_MIN_RATE_X100 5
+
+/* Fixed point: weights Q8 (a new sample is 1.0), times Q4 seconds
+ * relative to the last sample, moisture Q8 of % * 10. The centred sums
+ * are in plain sample weights: at most ~5400 of them (2 s Test-mode
+ * sampling over DRYING_TAU_S) at times within a few tau of now, which
+ * keeps ctt below 2^48 and every product below 2^63. The means carry
+ * MEAN_FRAC more bits: at fast sampling each step moves them by less
+ * than one unit, and truncating that would bias the slope.
+ */
+#define W_ONE           256
+#define T_FRAC          4
+#define Y_FRAC          8
+#define MEAN_FRAC       16
+
+/* Decay factor per sample, Q24 */
+#define F_FRAC          24
+
+/* rate %/h * 100 per unit of slope (Q8 % * 10 per Q4 s):
+ * 100 * 3600 * 16 / (10 * 256)
+ */
+#define RATE_PER_SLOPE  2250
+
+struct drying_state {
+    bool     has_fit;       /* at least one sample since the restart */
+    int64_t  last_ms;
+    uint32_t w;             /* sum of weights, Q8 */
+    int64_t  mt;            /* weighted mean time, Q4 s << MEAN_FRAC, <= 0 */
+    int64_t  my;            /* weighted mean moisture, Q8 % * 10 << MEAN_FRAC */
+    int64_t  ctt;           /* sum w (t - mt)^2 */
+    int64_t  cty;           /* sum w (t - mt)(y - my) */
+    uint32_t samples;
+    uint32_t restarts;
+    int32_t  resid_x10;
+    int32_t  level_x10;
+    int32_t  limit_x10;
+    struct plantcare_drying out;
+};
+
+/* The shell and calibration read and reset from other threads */
+static struct k_spinlock lock;
+static struct drying_state state[PLANTCARE_PLANT_COUNT];
+
+/* v * f >> F_FRAC without overflowing for large v, either sign */
+static int64_t mul_f(int64_t v, uint32_t f)
+{
+    const int64_t one = (int64_t)1 << F_FRAC;
+
+    return (v / one) * f + (v % one) * f / one;
+}
+
+static void drying_restart(struct drying_state *st)
+{
+    uint32_t restarts = st->restarts;
+    int32_t limit = st->limit_x10;
+
+    memset(st, 0, sizeof(*st));
+    st->restarts = restarts;
+    st->limit_x10 = limit;
+    st->out.eta_min = PLANTCARE_DRYING_ETA_MAX_MIN;
+}
+
+/* Age every sample by dt_ms: shift the times, fade the weights by
+ * exp(-dt / tau). dt is well below tau here (DRYING_MAX_GAP_S), so
+ * 1 - x + x^2 / 2 is within 2e-5 of it.
+ */
+static void drying_age(struct drying_state *st, uint32_t dt_ms)
+{
+    uint32_t x = (uint32_t)(((uint64_t)dt_ms << F_FRAC) / (DRYING_TAU_S * 1000U));
+    uint32_t f = (1U << F_FRAC) - x + (uint32_t)(((uint64_t)x * x) >> (F_FRAC + 1));
+
+    st->mt -= (int64_t)(((uint64_t)dt_ms << (T_FRAC + MEAN_FRAC)) / 1000U);
+    st->w = (uint32_t)(((uint64_t)st->w * f) >> F_FRAC);
+    st->ctt = mul_f(st->ctt, f);
+    st->cty = mul_f(st->cty, f);
+}
+
+/* The line's value now (t = 0), Q8 of % * 10 */
+static int32_t drying_level(const struct drying_state *st)
+{
+    int32_t my = (int32_t)(st->my >> MEAN_FRAC);
+
+    if (!st->out.valid) {
+        return my;
+    }
+    return my - (int32_t)(st->out.rate_x100 * (st->mt >> MEAN_FRAC) / RATE_PER_SLOPE);
+}
+
+/* Weighted Welford update with one new sample of weight 1 at t = 0 */
+static void drying_add(struct drying_state *st, int32_t y)
+{
+    uint32_t w_new = st->w + W_ONE;
+    int64_t dt_q = -st->mt;
+    int64_t dy_q = ((int64_t)y << MEAN_FRAC) - st->my;
+    int64_t dt = dt_q >> MEAN_FRAC;
+    int64_t dy = dy_q >> MEAN_FRAC;
+
+    st->ctt += dt * dt * st->w / w_new;
+    st->cty += dt * dy * st->w / w_new;
+    st->mt += dt_q * W_ONE / w_new;
+    st->my += dy_q * W_ONE / w_new;
+    st->w = w_new;
+    st->samples++;
+}
+
+static void drying_fit(struct drying_state *st)
+{
+    struct plantcare_drying *out = &st->out;
+    int64_t spread = (int64_t)DRYING_MIN_SPREAD_S << T_FRAC;
+
+    /* ctt / w is the variance of the sample times */
+    out->valid = st->samples >= DRYING_MIN_SAMPLES && st->ctt > 0 &&
+                 st->ctt * W_ONE / st->w >= spread * spread;
+    if (!out->valid) {
+        out->rate_x100 = 0;
+        out->eta_min = PLANTCARE_DRYING_ETA_MAX_MIN;
+        st->level_x10 = (int32_t)(st->my >> (MEAN_FRAC + Y_FRAC));
+        return;
+    }
+
+    int64_t rate = st->cty * RATE_PER_SLOPE / st->ctt;
+
+    out->rate_x100 = (int16_t)CLAMP(rate, INT16_MIN, INT16_MAX);
+    st->level_x10 = drying_level(st) >> Y_FRAC;
+
+    int32_t left = st->level_x10 - st->limit_x10;
+
+    if (out->rate_x100 > -DRYING_MIN_RATE_X100) {
+        out->eta_min = PLANTCARE_DRYING_ETA_MAX_MIN;
+    } else if (left <= 0) {
+        out->eta_min = 0;
+    } else {
+        /* % * 10 / (%/h * 100) -> minutes: * 10 * 60 */
+        out->eta_min = (uint16_t)MIN((int64_t)left * 600 / -out->rate_x100,
+                                     PLANTCARE_DRYING_ETA_MAX_MIN);
+    }
+}
+
+static void drying_sample(struct drying_state *st, int32_t pct_x10,
+                          int64_t now_ms)
+{
+    int32_t y = pct_x10 << Y_FRAC;
+
+    if (st->has_fit) {
+        int64_t dt = now_ms - st->last_ms;
+
+        if (dt > (int64_t)DRYING_MAX_GAP_S * 1000) {
+            drying_restart(st);
+            st->restarts++;
+        } else {
+            drying_age(st, (uint32_t)dt);
+        }
+    }
+
+    if (st->has_fit) {
+        st->resid_x10 = (y - drying_level(st)) >> Y_FRAC;
+        if (st->resid_x10 > DRYING_WATERED_X10) {
+            drying_restart(st);
+            st->restarts++;
+        }
+    }
+    if (!st->has_fit) {
+        st->has_fit = true;
+        st->resid_x10 = 0;
+    }
+
+    st->last_ms = now_ms;
+    drying_add(st, y);
+    drying_fit(st);
+}
+
+void plantcare_drying_update(struct plantcare_data *s, int64_t now_ms)
+{
+    int32_t limit = plantcare_alarm_low_limit(PC_CH_SOIL);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        struct drying_state *st = &state[p];
+
+        /* A dead probe's reading says nothing about the pot */
+        if (s->anomaly[PC_AN_CH_SOIL + p] == PC_AN_RANGE) {
+            continue;
+        }
+
+        st->limit_x10 = (limit == INT32_MIN) ? 0 : limit;
+        drying_sample(st, soil_raw_to_pct_x10(s->plants[p].soil_raw), now_ms);
+        s->drying[p] = st->out;
+    }
+
+    k_spin_unlock(&lock, key);
+}
+
+bool plantcare_drying_on_track(uint8_t p, int32_t noise_x10)
+{
+    bool on;
+
+    if (p >= PLANTCARE_PLANT_COUNT) {
+        return false;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    on = state[p].out.valid &&
+         state[p].resid_x10 <= noise_x10 && state[p].resid_x10 >= -noise_x10;
+    k_spin_unlock(&lock, key);
+    return on;
+}
+
+void plantcare_drying_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        drying_restart(&state[p]);
+    }
+    k_spin_unlock(&lock, key);
+}
+
+void plantcare_drying_get_stats(uint8_t p, struct plantcare_drying_stats *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (p >= PLANTCARE_PLANT_COUNT) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    const struct drying_state *st = &state[p];
+    int64_t var = st->w ? st->ctt * W_ONE / st->w : 0;
+
+    out->samples = st->samples;
+    out->restarts = st->restarts;
+    out->level_x10 = st->level_x10;
+    out->resid_x10 = st->resid_x10;
+    out->limit_x10 = st->limit_x10;
+    k_spin_unlock(&lock, key);
+
+    /* Integer square root, outside the lock */
+    uint64_t r = 0;
+    for (uint64_t bit = 1ULL << 62; bit; bit >>= 2) {
+        if ((uint64_t)var >= r + bit) {
+            var -= (int64_t)(r + bit);
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+    }
+    out->spread_s = (int32_t)(r >> T_FRAC);
+}
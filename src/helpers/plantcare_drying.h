@@ -0,0 +1,72 @@
+#ifndef PLANTCARE_DRYING_H
+#define PLANTCARE_DRYING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Soil drying rate and time until the soil needs water
+ * (plantcare_drying.c).
+ *
+ * For each plant, a straight line is fitted to the soil moisture of the
+ * last few hours. The fit is exponentially weighted least squares: a
+ * sample's weight halves every DRYING_TAU_S * ln 2 (about 2 h), whatever
+ * the sampling period. The fit is kept as a weight, two weighted means
+ * and two centred sums, so the state per plant is constant. A sample
+ * costs a few 64-bit multiplies and divides, with no float.
+ *
+ *   rate  = slope of the line, %/h, negative while drying
+ *   level = the line's value now
+ *   eta   = (level - lower limit) / -rate
+ *
+ * The lower limit is the SOIL alarm rule's min (plantcare_alarm.h), so
+ * "pc alarm set" moves it. The ETA has its own alarm channel, SOIL
+ * DRYING, raised when the pot will reach that limit within 2 h. It comes
+ * before the SOIL alarm, not after.
+ *
+ * Watering shows as a jump well above the line, and the fit restarts
+ * there. It also restarts after a gap longer than DRYING_MAX_GAP_S.
+ * Until the samples are spread over enough time there is no estimate.
+ *
+ * The adaptive sampler (plantcare_adapt.c) counts a soil reading that
+ * stays on the line as no change. A pot drying steadily is then read at
+ * the ceiling period, not the floor.
+ */
+
+/* ETA cap, also reported when the soil is not drying or there is no fit */
+#define PLANTCARE_DRYING_ETA_MAX_MIN    10080   /* a week */
+
+struct plantcare_drying {
+    int16_t  rate_x100;     /* %/h * 100, 0 without a fit */
+    uint16_t eta_min;       /* minutes until the lower limit */
+    bool     valid;         /* rate and eta come from a fit */
+};
+
+struct plantcare_drying_stats {
+    uint32_t samples;       /* in the current fit */
+    uint32_t restarts;      /* watering or gaps */
+    int32_t  level_x10;     /* fitted moisture now, % * 10 */
+    int32_t  resid_x10;     /* last sample minus its prediction */
+    int32_t  spread_s;      /* weighted std dev of the sample times */
+    int32_t  limit_x10;     /* lower limit used for the ETA */
+};
+
+struct plantcare_data;
+
+/* Sensor thread, after a good ADC scan: fit each plant's soil reading
+ * (skipping probes the anomaly detector flags as out of range) and fill
+ * s->drying[].
+ */
+void plantcare_drying_update(struct plantcare_data *s, int64_t now_ms);
+
+/* True if plant p has a fit and its last reading was within noise_x10
+ * of the line
+ */
+bool plantcare_drying_on_track(uint8_t p, int32_t noise_x10);
+
+/* Forget every fit, e.g. after recalibrating the probes */
+void plantcare_drying_reset(void);
+
+void plantcare_drying_get_stats(uint8_t p, struct plantcare_drying_stats *st);
+
+#endif /* PLANTCARE_DRYING_H */
@@ -0,0 +1,239 @@
+// src/helpers/plantcare_export.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/printk-hooks.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "plantcare_export.h"
+#include "plantcare_log.h"
+
+/* Records per data frame: small enough that a frame lost to line noise
+ * costs little to resend, large enough to amortise the header
+ */
+#define EXPORT_BLOCK        8
+
+/* printk text held back while frames go out; more than this is dropped */
+#define EXPORT_HOLD_SIZE    256
+
+#define REC_SIZE            sizeof(struct plantcare_log_rec)
+
+#define HDR_SIZE            2
+#define CRC_SIZE            4
+#define INFO_BODY           22
+#define DATA_BODY_MAX       (5 + EXPORT_BLOCK * REC_SIZE)
+#define END_BODY            12
+#define PAYLOAD_MAX         (HDR_SIZE + MAX(INFO_BODY, DATA_BODY_MAX) + CRC_SIZE)
+
+/* COBS adds one byte per 254 and the leading code byte */
+#define COBS_MAX(len)       ((len) + (len) / 254 + 1)
+
+BUILD_ASSERT(REC_SIZE <= UINT8_MAX, "rec_size is one byte in the info frame");
+/* Records are copied to the wire as they are in memory */
+BUILD_ASSERT(!IS_ENABLED(CONFIG_BIG_ENDIAN), "log records are little-endian");
+
+/* Only the shell thread exports, one download at a time */
+static uint8_t payload[PAYLOAD_MAX];
+static uint8_t encoded[COBS_MAX(PAYLOAD_MAX) + 1];
+
+/* Any thread, or an ISR, may printk while the hold is in place */
+static struct k_spinlock hold_lock;
+static uint8_t hold_buf[EXPORT_HOLD_SIZE];
+static size_t hold_len;
+static uint32_t hold_dropped;
+static printk_hook_fn_t console_out;
+
+static int hold_char(int c)
+{
+    k_spinlock_key_t key = k_spin_lock(&hold_lock);
+
+    if (hold_len < sizeof(hold_buf)) {
+        hold_buf[hold_len++] = (uint8_t)c;
+    } else {
+        hold_dropped++;
+    }
+    k_spin_unlock(&hold_lock, key);
+    return c;
+}
+
+/* From here on printk goes to hold_buf, not the UART */
+static void console_hold(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&hold_lock);
+
+    hold_len = 0;
+    hold_dropped = 0;
+    k_spin_unlock(&hold_lock, key);
+
+    console_out = __printk_get_hook();
+    __printk_hook_install(hold_char);
+}
+
+/* Back to the UART, then what was held, in the order it came */
+static void console_release(struct plantcare_export_stats *st)
+{
+    __printk_hook_install(console_out);
+
+    k_spinlock_key_t key = k_spin_lock(&hold_lock);
+
+    st->held = hold_len;
+    st->dropped = hold_dropped;
+    k_spin_unlock(&hold_lock, key);
+
+    for (size_t i = 0; i < st->held; i++) {
+        console_out(hold_buf[i]);
+    }
+}
+
+/* The shell's own output (the echo of the command line) leaves by
+ * interrupt from its ring buffer; wait for the last bit, bounded
+ */
+static void console_drain(const struct device *uart)
+{
+    for (int i = 0; i < 50 && uart_irq_tx_complete(uart) == 0; i++) {
+        k_msleep(1);
+    }
+}
+
+static size_t cobs_encode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t code_at = 0;
+    size_t o = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+            continue;
+        }
+        out[o++] = in[i];
+        if (++code == 0xFF) {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+        }
+    }
+    out[code_at] = code;
+    return o;
+}
+
+/* CRC, COBS, delimiter, out. Returns bytes on the wire. */
+static uint32_t send_frame(const struct device *uart, size_t len)
+{
+    sys_put_le32(crc32_ieee(payload, len), &payload[len]);
+    len += CRC_SIZE;
+
+    size_t n = cobs_encode(payload, len, encoded);
+
+    encoded[n++] = 0x00;
+    for (size_t i = 0; i < n; i++) {
+        uart_poll_out(uart, encoded[i]);
+    }
+    return (uint32_t)n;
+}
+
+static size_t frame_start(uint8_t type)
+{
+    payload[0] = 'P';
+    payload[1] = type;
+    return HDR_SIZE;
+}
+
+int plantcare_export_run(const struct device *uart, uint32_t from,
+                         uint32_t count, struct plantcare_export_stats *st)
+{
+    uint32_t oldest, next;
+    int64_t t0 = k_uptime_get();
+    size_t len;
+
+    if (!device_is_ready(uart)) {
+        return -ENODEV;
+    }
+
+    memset(st, 0, sizeof(*st));
+    console_hold();
+    console_drain(uart);
+    plantcare_log_range(&oldest, &next);
+
+    /* Clip to what is held; count 0 = up to the newest */
+    if ((int32_t)(from - oldest) < 0) {
+        from = oldest;
+    }
+    uint32_t avail = ((int32_t)(next - from) > 0) ? next - from : 0;
+
+    count = (count == 0) ? avail : MIN(count, avail);
+
+    /* A lone delimiter ends whatever text came before */
+    uart_poll_out(uart, 0x00);
+    st->bytes = 1;
+
+    len = frame_start('I');
+    payload[len++] = PLANTCARE_EXPORT_VERSION;
+    payload[len++] = (uint8_t)REC_SIZE;
+    sys_put_le16(plantcare_log_capacity(), &payload[len]); len += 2;
+    sys_put_le32(oldest, &payload[len]);                   len += 4;
+    sys_put_le32(next, &payload[len]);                     len += 4;
+    sys_put_le32(from, &payload[len]);                     len += 4;
+    sys_put_le32(count, &payload[len]);                    len += 4;
+    sys_put_le32((uint32_t)(t0 / 1000), &payload[len]);    len += 4;
+    st->bytes += send_frame(uart, len);
+
+    uint32_t seq = from;
+    uint32_t end = from + count;
+
+    while (seq != end) {
+        struct plantcare_log_rec *recs;
+        size_t want = MIN((uint32_t)EXPORT_BLOCK, end - seq);
+        size_t got;
+
+        len = frame_start('D');
+        recs = (struct plantcare_log_rec *)&payload[len + 5];
+        got = plantcare_log_read(seq, recs, want);
+
+        if (got == 0) {
+            /* Overwritten while we were sending: jump to the oldest */
+            plantcare_log_range(&oldest, &next);
+            uint32_t skip = ((int32_t)(oldest - seq) > 0) ? oldest - seq : 0;
+
+            if (skip == 0 || (int32_t)(end - oldest) <= 0) {
+                st->skipped += end - seq;
+                break;
+            }
+            st->skipped += skip;
+            seq = oldest;
+            continue;
+        }
+
+        sys_put_le32(seq, &payload[len]);
+        payload[len + 4] = (uint8_t)got;
+        len += 5 + got * REC_SIZE;
+
+        st->bytes += send_frame(uart, len);
+        st->frames++;
+        st->records += got;
+        seq += got;
+    }
+
+    len = frame_start('E');
+    sys_put_le32(seq, &payload[len]);          len += 4;
+    sys_put_le32(st->frames, &payload[len]);   len += 4;
+    sys_put_le32(st->skipped, &payload[len]);  len += 4;
+    st->bytes += send_frame(uart, len);
+
+    st->elapsed_ms = (uint32_t)(k_uptime_get() - t0);
+    console_release(st);
+    return 0;
+}
+
+size_t plantcare_export_ram_bytes(void)
+{
+    return sizeof(payload) + sizeof(encoded) + sizeof(hold_buf);
+}
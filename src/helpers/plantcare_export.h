@@ -0,0 +1,55 @@
+#ifndef PLANTCARE_EXPORT_H
+#define PLANTCARE_EXPORT_H
+
+#include <zephyr/device.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Binary download of the reading log (plantcare_log.h) over the console
+ * UART, started with "pc export [<from_seq> [<count>]]".
+ *
+ * Every frame is COBS-encoded and ends with 0x00, so the shell text
+ * around it (echo, prompt) can never look like a frame boundary. printk
+ * from other threads is held for the length of the export and written
+ * after the end frame, so it cannot land inside one. Before encoding:
+ *
+ *   'P' <type> <body> <crc32>     crc32: IEEE, little-endian, over all
+ *                                 bytes before it
+ *
+ *   'I' info   u8 version, u8 rec_size, u16 capacity,
+ *              u32 oldest, u32 next, u32 from, u32 count, u32 uptime_s
+ *   'D' data   u32 first_seq, u8 n, n * rec_size bytes of records
+ *   'E' end    u32 next_seq (first seq not sent), u32 data_frames,
+ *              u32 skipped (evicted while sending)
+ *
+ * All integers little-endian. Records go out as stored, without
+ * formatting. To resume, the host asks again from the seq after the last
+ * record it got with a good CRC; "next" in the info frame going backwards
+ * means the device was reset and the log restarted at 0.
+ * scripts/pc_export.py is the host side.
+ */
+
+#define PLANTCARE_EXPORT_VERSION    1
+
+struct plantcare_export_stats {
+    uint32_t records;
+    uint32_t frames;
+    uint32_t bytes;         /* on the wire, framing included */
+    uint32_t skipped;
+    uint32_t elapsed_ms;
+    uint32_t held;          /* printk bytes written after the end frame */
+    uint32_t dropped;       /* printk bytes beyond the hold buffer */
+};
+
+/* Send records [from, from + count) that are still held, blocking until
+ * the last byte is out. count 0 means up to the newest. Returns 0 or
+ * -ENODEV.
+ */
+int plantcare_export_run(const struct device *uart, uint32_t from,
+                         uint32_t count, struct plantcare_export_stats *st);
+
+/* Static RAM of the frame buffers, bytes (plantcare_mem.h) */
+size_t plantcare_export_ram_bytes(void);
+
+#endif /* PLANTCARE_EXPORT_H */
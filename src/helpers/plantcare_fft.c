@@ -0,0 +1,127 @@
+// src/helpers/plantcare_fft.c
+
+#include <stdint.h>
+
+#include "plantcare_fft.h"
+
+#ifdef CONFIG_CMSIS_DSP
+
+#include <arm_const_structs.h>
+
+int plantcare_fft_q15(int16_t *buf, uint16_t n)
+{
+    const arm_cfft_instance_q15 *inst;
+
+    switch (n) {
+    case 16:  inst = &arm_cfft_sR_q15_len16;  break;
+    case 32:  inst = &arm_cfft_sR_q15_len32;  break;
+    case 64:  inst = &arm_cfft_sR_q15_len64;  break;
+    case 128: inst = &arm_cfft_sR_q15_len128; break;
+    case 256: inst = &arm_cfft_sR_q15_len256; break;
+    default:  return -1;
+    }
+
+    arm_cfft_q15(inst, buf, 0, 1);
+    return 0;
+}
+
+#else
+
+/* sin(2π i / PLANTCARE_FFT_MAX) for the first quarter wave, q15 */
+#define SIN_QUARTER     (PLANTCARE_FFT_MAX / 4)
+
+static const int16_t sin_q15[SIN_QUARTER + 1] = {
+        0,   804,  1608,  2411,  3212,  4011,  4808,  5602,
+     6393,  7180,  7962,  8740,  9512, 10279, 11039, 11793,
+    12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+    18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+    23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+    27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+    30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+    32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+    32767,
+};
+
+static inline int16_t sat16(int32_t v)
+{
+    if (v > INT16_MAX) return INT16_MAX;
+    if (v < INT16_MIN) return INT16_MIN;
+    return (int16_t)v;
+}
+
+/* cos and sin of 2π m / PLANTCARE_FFT_MAX, m < PLANTCARE_FFT_MAX / 2 */
+static inline void twiddle(uint16_t m, int32_t *c, int32_t *s)
+{
+    if (m <= SIN_QUARTER) {
+        *s = sin_q15[m];
+        *c = sin_q15[SIN_QUARTER - m];
+    } else {
+        *s = sin_q15[2 * SIN_QUARTER - m];
+        *c = -sin_q15[m - SIN_QUARTER];
+    }
+}
+
+static void bit_reverse(int16_t *buf, uint16_t n)
+{
+    for (uint16_t i = 1, j = 0; i < n; i++) {
+        uint16_t bit = n >> 1;
+
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j |= bit;
+
+        if (i < j) {
+            int16_t re = buf[2 * i];
+            int16_t im = buf[2 * i + 1];
+
+            buf[2 * i]     = buf[2 * j];
+            buf[2 * i + 1] = buf[2 * j + 1];
+            buf[2 * j]     = re;
+            buf[2 * j + 1] = im;
+        }
+    }
+}
+
+/*
+ * Radix-2 decimation in time. Per butterfly: one complex q15 multiply
+ * (32-bit products) and two halved adds; n/2 * log2(n) butterflies.
+ * Twiddles come from the quarter-wave table, stepping by
+ * PLANTCARE_FFT_MAX / span.
+ */
+int plantcare_fft_q15(int16_t *buf, uint16_t n)
+{
+    if (n < 2 || n > PLANTCARE_FFT_MAX || (n & (n - 1)) != 0) {
+        return -1;
+    }
+
+    bit_reverse(buf, n);
+
+    for (uint16_t span = 2; span <= n; span <<= 1) {
+        uint16_t half = span >> 1;
+        uint16_t step = PLANTCARE_FFT_MAX / span;
+
+        for (uint16_t k = 0; k < half; k++) {
+            int32_t c, s;
+
+            twiddle((uint16_t)(k * step), &c, &s);
+
+            for (uint16_t i = k; i < n; i += span) {
+                int16_t *a = &buf[2 * i];
+                int16_t *b = &buf[2 * (i + half)];
+
+                /* t = b * e^(-jθ) */
+                int32_t tr = (b[0] * c + b[1] * s) >> 15;
+                int32_t ti = (b[1] * c - b[0] * s) >> 15;
+
+                b[0] = sat16((a[0] - tr) >> 1);
+                b[1] = sat16((a[1] - ti) >> 1);
+                a[0] = sat16((a[0] + tr) >> 1);
+                a[1] = sat16((a[1] + ti) >> 1);
+            }
+        }
+    }
+    return 0;
+}
+
+#endif /* CONFIG_CMSIS_DSP */
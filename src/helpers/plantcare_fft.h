@@ -0,0 +1,21 @@
+#ifndef PLANTCARE_FFT_H
+#define PLANTCARE_FFT_H
+
+#include <stdint.h>
+
+/*
+ * Complex q15 FFT (plantcare_fft.c). Plain C with no Zephyr includes, so
+ * the same kernel builds on a host for checking against a float DFT.
+ *
+ * buf holds n complex points as re, im, re, im, ... and is transformed in
+ * place into natural order. Every stage halves, so the output is DFT / n,
+ * the same scaling as CMSIS-DSP arm_cfft_q15 (used instead when
+ * CONFIG_CMSIS_DSP is set).
+ */
+
+#define PLANTCARE_FFT_MAX   256
+
+/* n: power of two, 2..PLANTCARE_FFT_MAX. Returns 0, or -1 for a bad n. */
+int plantcare_fft_q15(int16_t *buf, uint16_t n);
+
+#endif /* PLANTCARE_FFT_H */
@@ -0,0 +1,65 @@
+// src/helpers/plantcare_health.c
+
+#include <zephyr/kernel.h>
+
+#include "plantcare_health.h"
+
+#define HEALTH_BACKOFF_BASE_MS   1000
+#define HEALTH_BACKOFF_MAX_MS    (5 * 60 * 1000)   /* 5 min */
+
+static struct plantcare_sensor_health health[PC_SENSOR_COUNT];
+
+bool plantcare_health_should_try(enum plantcare_sensor s, int64_t now_ms)
+{
+    return health[s].fails == 0 || now_ms >= health[s].retry_at_ms;
+}
+
+bool plantcare_health_needs_init(enum plantcare_sensor s)
+{
+    return health[s].needs_init;
+}
+
+void plantcare_health_report(enum plantcare_sensor s, int ret, int64_t now_ms)
+{
+    struct plantcare_sensor_health *h = &health[s];
+
+    if (ret >= 0) {
+        h->valid      = true;
+        h->needs_init = false;
+        h->fails      = 0;
+        h->last_err   = 0;
+        return;
+    }
+
+    h->valid      = false;
+    h->needs_init = true;
+    h->last_err   = ret;
+    if (h->fails < UINT8_MAX) {
+        h->fails++;
+    }
+
+    /* 1 s, 2 s, 4 s, ... capped at 5 min */
+    uint32_t shift   = MIN(h->fails - 1U, 16U);
+    uint32_t backoff = MIN((uint32_t)HEALTH_BACKOFF_BASE_MS << shift,
+                           (uint32_t)HEALTH_BACKOFF_MAX_MS);
+
+    h->retry_at_ms = now_ms + backoff;
+}
+
+void plantcare_health_get(enum plantcare_sensor s,
+                          struct plantcare_sensor_health *out)
+{
+    *out = health[s];
+}
+
+uint8_t plantcare_health_valid_mask(void)
+{
+    uint8_t mask = 0;
+
+    for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+        if (health[s].valid) {
+            mask |= BIT(s);
+        }
+    }
+    return mask;
+}
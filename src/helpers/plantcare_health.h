@@ -0,0 +1,37 @@
+#ifndef PLANTCARE_HEALTH_H
+#define PLANTCARE_HEALTH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "plantcare_config.h"
+
+/* Per-sensor-group health, owned by the sensor thread.
+ * After a failure the group is retried with exponential backoff
+ * (HEALTH_BACKOFF_BASE_MS doubling up to HEALTH_BACKOFF_MAX_MS) and its
+ * driver is re-initialised before the next read, so a sensor that was
+ * unplugged comes back on its own.
+ */
+struct plantcare_sensor_health {
+    bool     valid;         /* last read succeeded */
+    bool     needs_init;    /* re-run the driver init before next read */
+    uint8_t  fails;         /* consecutive failures */
+    int      last_err;
+    int64_t  retry_at_ms;   /* no attempt before this uptime */
+};
+
+/* True if the group is not backing off at uptime now_ms */
+bool plantcare_health_should_try(enum plantcare_sensor s, int64_t now_ms);
+
+bool plantcare_health_needs_init(enum plantcare_sensor s);
+
+/* Record the result of one attempt (ret < 0 = failure) */
+void plantcare_health_report(enum plantcare_sensor s, int ret, int64_t now_ms);
+
+void plantcare_health_get(enum plantcare_sensor s,
+                          struct plantcare_sensor_health *out);
+
+/* Bit n set if group n currently holds valid data */
+uint8_t plantcare_health_valid_mask(void);
+
+#endif /* PLANTCARE_HEALTH_H */
@@ -0,0 +1,102 @@
+// src/helpers/plantcare_log.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "plantcare_log.h"
+#include "plantcare_units.h"
+
+#define PLANTCARE_USER_NODE DT_PATH(zephyr_user)
+#define LOG_RECORDS         DT_PROP_OR(PLANTCARE_USER_NODE, log_records, 256)
+
+BUILD_ASSERT(LOG_RECORDS >= 16 && LOG_RECORDS <= UINT16_MAX,
+             "log-records must be 16..65535");
+BUILD_ASSERT(sizeof(struct plantcare_log_rec) == 20 + 4 * PLANTCARE_PLANT_COUNT,
+             "plantcare_log_rec is the wire format, keep it packed");
+
+/* Written by the mode thread, read by the export (shell thread) */
+static struct k_spinlock log_lock;
+
+static struct plantcare_log_rec ring[LOG_RECORDS];
+static uint32_t next_seq;       /* seq of the next record written */
+static uint32_t held;           /* records in the ring, <= LOG_RECORDS */
+
+static int16_t clamp16(int32_t v)
+{
+    return (int16_t)CLAMP(v, INT16_MIN, INT16_MAX);
+}
+
+void plantcare_log_add(const struct plantcare_data *s, int64_t now_ms)
+{
+    struct plantcare_log_rec r;
+    int32_t ax = s->acc_x_g100 < 0 ? -s->acc_x_g100 : s->acc_x_g100;
+    int32_t ay = s->acc_y_g100 < 0 ? -s->acc_y_g100 : s->acc_y_g100;
+    int32_t az = s->acc_z_g100 < 0 ? -s->acc_z_g100 : s->acc_z_g100;
+
+    /* Build outside the lock, then one copy in */
+    r.epoch_s      = s->epoch_s;
+    r.uptime_s     = (uint32_t)(now_ms / 1000);
+    r.temp_x100    = clamp16(s->temp_x100);
+    r.hum_x100     = (uint16_t)CLAMP(s->hum_x100, 0, UINT16_MAX);
+    r.acc_max_g100 = clamp16(MAX(ax, MAX(ay, az)));
+    r.tilt_cdeg    = s->tilt.tilt_cdeg;
+    r.lux          = (uint16_t)MIN(s->lux, UINT16_MAX);
+    r.leaf_class   = s->leaf_class;
+    r.valid_mask   = s->valid_mask;
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        r.plants[p].soil_pct_x10  =
+            clamp16(soil_raw_to_pct_x10(s->plants[p].soil_raw));
+        r.plants[p].light_pct_x10 =
+            clamp16(light_raw_to_pct_x10(s->plants[p].light_raw));
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+
+    ring[next_seq % LOG_RECORDS] = r;
+    next_seq++;
+    held = MIN(held + 1, LOG_RECORDS);
+    k_spin_unlock(&log_lock, key);
+}
+
+void plantcare_log_range(uint32_t *oldest, uint32_t *next)
+{
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+
+    *next   = next_seq;
+    *oldest = next_seq - held;
+    k_spin_unlock(&log_lock, key);
+}
+
+size_t plantcare_log_read(uint32_t seq, struct plantcare_log_rec *out,
+                          size_t max)
+{
+    size_t n = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+
+    /* Unsigned distance: also right after next_seq wraps */
+    uint32_t back = next_seq - seq;
+
+    if (back != 0 && back <= held) {
+        n = MIN(max, (size_t)back);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = ring[(seq + i) % LOG_RECORDS];
+        }
+    }
+    k_spin_unlock(&log_lock, key);
+    return n;
+}
+
+size_t plantcare_log_ram_bytes(void)
+{
+    return sizeof(ring);
+}
+
+uint16_t plantcare_log_capacity(void)
+{
+    return LOG_RECORDS;
+}
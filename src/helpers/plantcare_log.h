@@ -0,0 +1,58 @@
+#ifndef PLANTCARE_LOG_H
+#define PLANTCARE_LOG_H
+
+#include <zephyr/kernel.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "plantcare_state.h"
+
+/*
+ * Reading log (plantcare_log.c): one fixed-size binary record per normal
+ * mode sample in a static RAM ring, oldest overwritten first. Records are
+ * numbered by a sequence that only grows (restarts at 0 on reset), so a
+ * reader can ask for "everything from seq N" and see what it missed.
+ *
+ * The ring holds log-records entries (/zephyr,user, default 256), i.e.
+ * about two hours at the 30 s normal mode cadence. The records are sent
+ * as they are stored by the binary export (plantcare_export.h), so the
+ * layout below is the wire format: little-endian, packed.
+ */
+
+struct plantcare_log_plant {
+    int16_t soil_pct_x10;
+    int16_t light_pct_x10;
+} __packed;
+
+struct plantcare_log_rec {
+    uint32_t epoch_s;       /* UTC, 0 if the clock was not set */
+    uint32_t uptime_s;
+    int16_t  temp_x100;
+    uint16_t hum_x100;
+    int16_t  acc_max_g100;  /* largest |axis| */
+    int16_t  tilt_cdeg;     /* from the rest pose, -1 without one */
+    uint16_t lux;           /* clamped to 65535 */
+    uint8_t  leaf_class;
+    uint8_t  valid_mask;
+    struct plantcare_log_plant plants[PLANTCARE_PLANT_COUNT];
+} __packed;
+
+/* Append one sample (mode thread) */
+void plantcare_log_add(const struct plantcare_data *s, int64_t now_ms);
+
+/* Sequence numbers held: [*oldest, *next). Equal if the log is empty. */
+void plantcare_log_range(uint32_t *oldest, uint32_t *next);
+
+/* Copy up to max records starting at seq, as stored. Returns how many
+ * (0 if seq is not held, evicted or not yet written). Any thread.
+ */
+size_t plantcare_log_read(uint32_t seq, struct plantcare_log_rec *out,
+                          size_t max);
+
+/* Ring size in records */
+uint16_t plantcare_log_capacity(void);
+
+/* Static RAM of the ring, bytes (plantcare_mem.h) */
+size_t plantcare_log_ram_bytes(void);
+
+#endif /* PLANTCARE_LOG_H */
@@ -0,0 +1,112 @@
+// src/helpers/plantcare_mem.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+
+#include "plantcare_mem.h"
+#include "plantcare_state.h"
+#include "plantcare_counters.h"
+#include "plantcare_log.h"
+#include "plantcare_alarm.h"
+#include "plantcare_batch.h"
+#include "plantcare_vib.h"
+#include "plantcare_export.h"
+#include "sensors/gps_sensor.h"
+
+#define MEM_STACK_INFO  (IS_ENABLED(CONFIG_INIT_STACKS) &&              \
+                         IS_ENABLED(CONFIG_THREAD_STACK_INFO) &&        \
+                         IS_ENABLED(CONFIG_THREAD_MONITOR))
+
+/* The sensor thread's working copy and the zbus channel's message */
+static size_t snapshot_ram_bytes(void)
+{
+    return 2 * sizeof(struct plantcare_data);
+}
+
+static const struct {
+    const char *name;
+    size_t (*bytes)(void);
+} buffers[] = {
+    { "snapshot x2", snapshot_ram_bytes },
+    { "log ring",    plantcare_log_ram_bytes },
+    { "batch ring",  plantcare_batch_ram_bytes },
+    { "alarms",      plantcare_alarm_ram_bytes },
+    { "vib/fft",     plantcare_vib_ram_bytes },
+    { "export",      plantcare_export_ram_bytes },
+    { "gps rx",      gps_sensor_ram_bytes },
+};
+
+struct thread_walk {
+    plantcare_mem_thread_cb cb;
+    void *user_data;
+    int count;
+};
+
+static void thread_visit(const struct k_thread *thread, void *user_data)
+{
+    struct thread_walk *walk = user_data;
+    struct plantcare_mem_thread t = { 0 };
+    size_t unused = 0;
+
+    t.name = k_thread_name_get((k_tid_t)thread);
+    if (t.name == NULL || t.name[0] == '\0') {
+        t.name = "?";
+    }
+    t.size = thread->stack_info.size;
+    if (k_thread_stack_space_get(thread, &unused) == 0) {
+        t.used = t.size - unused;
+    }
+
+    walk->cb(&t, walk->user_data);
+    walk->count++;
+}
+
+int plantcare_mem_threads(plantcare_mem_thread_cb cb, void *user_data)
+{
+    struct thread_walk walk = { cb, user_data, 0 };
+
+    if (!MEM_STACK_INFO) {
+        return -ENOTSUP;
+    }
+
+    /* Unlocked: scanning a stack is slow, and every thread here is static */
+    k_thread_foreach_unlocked(thread_visit, &walk);
+    return walk.count;
+}
+
+size_t plantcare_mem_buffer_count(void)
+{
+    return ARRAY_SIZE(buffers);
+}
+
+void plantcare_mem_buffer_get(size_t i, struct plantcare_mem_buffer *out)
+{
+    if (i >= ARRAY_SIZE(buffers)) {
+        *out = (struct plantcare_mem_buffer){ "?", 0 };
+        return;
+    }
+    out->name  = buffers[i].name;
+    out->bytes = buffers[i].bytes();
+}
+
+void plantcare_mem_get_copies(struct plantcare_mem_copies *out)
+{
+    static uint32_t last_total;
+    static int64_t last_ms;
+    int64_t now = k_uptime_get();
+    uint32_t total = plantcare_counter_get(PC_CNT_SNAPSHOT_COPIES);
+    uint32_t n = total - last_total;
+    uint32_t window_ms = (uint32_t)(now - last_ms);
+
+    out->total = total;
+    out->window_ms = window_ms;
+    out->snapshot_bytes = sizeof(struct plantcare_data);
+    out->per_s_x100 = window_ms ?
+        (uint32_t)((uint64_t)n * 100000 / window_ms) : 0;
+    out->bytes_per_s = window_ms ?
+        (uint32_t)((uint64_t)n * sizeof(struct plantcare_data) * 1000 / window_ms) : 0;
+
+    last_total = total;
+    last_ms = now;
+}
@@ -0,0 +1,55 @@
+#ifndef PLANTCARE_MEM_H
+#define PLANTCARE_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * RAM budget at runtime (plantcare_mem.c), printed by "pc mem":
+ *
+ *   - stack size and high-water mark of every thread. Zephyr fills each
+ *     stack with 0xaa at thread start (CONFIG_INIT_STACKS), so the mark
+ *     is the deepest use since boot;
+ *   - the large static buffers, each reported by its owner;
+ *   - how often the whole struct plantcare_data is copied, and the bytes
+ *     per second that costs.
+ *
+ * scripts/pc_ram_report.py gives the build-time view from zephyr.map:
+ * RAM per object file, the largest symbols and every thread stack. It
+ * runs after each link (the ram_report target in CMakeLists.txt).
+ */
+
+struct plantcare_mem_thread {
+    const char *name;
+    size_t size;            /* stack, bytes */
+    size_t used;            /* high-water mark, bytes */
+};
+
+typedef void (*plantcare_mem_thread_cb)(const struct plantcare_mem_thread *t,
+                                        void *user_data);
+
+/* Call cb for every thread. Returns the thread count, or -ENOTSUP when
+ * the stack Kconfig options above are off. Walks stacks: shell use only.
+ */
+int plantcare_mem_threads(plantcare_mem_thread_cb cb, void *user_data);
+
+struct plantcare_mem_buffer {
+    const char *name;
+    size_t bytes;
+};
+
+/* Large static buffers, i = 0..plantcare_mem_buffer_count() - 1 */
+size_t plantcare_mem_buffer_count(void);
+void plantcare_mem_buffer_get(size_t i, struct plantcare_mem_buffer *out);
+
+struct plantcare_mem_copies {
+    uint32_t total;         /* since boot */
+    uint32_t per_s_x100;    /* since the previous call (boot on the first) */
+    uint32_t bytes_per_s;
+    uint32_t window_ms;
+    uint16_t snapshot_bytes;
+};
+
+void plantcare_mem_get_copies(struct plantcare_mem_copies *out);
+
+#endif /* PLANTCARE_MEM_H */
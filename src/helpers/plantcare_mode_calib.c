@@ -0,0 +1,220 @@
+// src/helpers/plantcare_mode_calib.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include "plantcare_state.h"
+#include "plantcare_config.h"
+#include "plantcare_calib.h"
+#include "plantcare_units.h"
+#include "plantcare_tilt.h"
+#include "plantcare_modes.h"
+
+#include "sensors/led_anim.h"
+
+/* Faster sampling while calibrating, and how many samples to average */
+#define CAL_SAMPLE_PERIOD_MS   250
+#define CAL_AVG_SAMPLES        8
+
+/* Board lying flat: Z should read +1 g */
+#define CAL_ONE_G_G100         100
+
+struct cal_avg {
+    int32_t soil_raw;
+    int32_t light_raw;
+    int32_t acc_x_g100;
+    int32_t acc_y_g100;
+    int32_t acc_z_g100;
+};
+
+/* The procedure is a list of steps. Each one prompts, waits for a press,
+ * averages CAL_AVG_SAMPLES snapshots (one per tick) and hands the average
+ * to its done() handler. The mode thread is free between events, so the
+ * shell can still switch modes; the old values are kept then.
+ */
+struct cal_step {
+    const char *prompt;
+    void (*done)(const struct cal_avg *avg);
+};
+
+static struct plantcare_calib cal;
+static struct cal_avg sum;
+static uint8_t step;
+static uint8_t captured;
+static bool capturing;
+
+static void cal_soil_dry(const struct cal_avg *avg)
+{
+    cal.soil_raw_dry = (int16_t)avg->soil_raw;
+    printk("  soil dry raw = %d\n", cal.soil_raw_dry);
+}
+
+static void cal_soil_wet(const struct cal_avg *avg)
+{
+    cal.soil_raw_wet = (int16_t)avg->soil_raw;
+    printk("  soil wet raw = %d\n", cal.soil_raw_wet);
+}
+
+static void cal_light_dark(const struct cal_avg *avg)
+{
+    cal.light_raw_dark = (int16_t)avg->light_raw;
+    printk("  light dark raw = %d\n", cal.light_raw_dark);
+}
+
+static void cal_light_bright(const struct cal_avg *avg)
+{
+    cal.light_raw_bright = (int16_t)avg->light_raw;
+    printk("  light bright raw = %d\n", cal.light_raw_bright);
+}
+
+/* Accelerometer: board flat, component side up -> (0, 0, +1 g).
+ * The sensor thread already subtracts the current offsets, so the new
+ * offsets are the old ones plus whatever error is left.
+ */
+static void cal_accel_flat(const struct cal_avg *avg)
+{
+    accel_units_get_offset(&cal.acc_off_x_g100,
+                           &cal.acc_off_y_g100,
+                           &cal.acc_off_z_g100);
+    cal.acc_off_x_g100 += avg->acc_x_g100;
+    cal.acc_off_y_g100 += avg->acc_y_g100;
+    cal.acc_off_z_g100 += avg->acc_z_g100 - CAL_ONE_G_G100;
+    printk("  accel offsets (g*100): x=%d y=%d z=%d\n",
+           cal.acc_off_x_g100, cal.acc_off_y_g100, cal.acc_off_z_g100);
+
+    int ret = plantcare_calib_store(&cal);
+    if (ret == -EINVAL) {
+        printk("Calibration rejected: endpoints too close, keeping old values.\n");
+    } else if (ret) {
+        printk("Calibration applied but NOT saved to flash (err %d).\n", ret);
+    } else {
+        printk("Calibration saved.\n");
+    }
+}
+
+/* Tilt: wherever the pot normally stands. The new offsets are already
+ * in use, and the capture gave the tilt filter time to settle on them.
+ */
+static void cal_rest_pose(const struct cal_avg *avg)
+{
+    int16_t rest[3];
+    int ret;
+
+    ARG_UNUSED(avg);
+
+    ret = plantcare_tilt_get_filtered(rest) ? plantcare_calib_store_rest(rest)
+                                            : -EAGAIN;
+    if (ret == 0) {
+        printk("  rest pose (counts): x=%d y=%d z=%d\n",
+               rest[0], rest[1], rest[2]);
+    } else {
+        printk("Rest pose not saved (err %d), keeping the old one.\n", ret);
+    }
+}
+
+static const struct cal_step cal_steps[] = {
+    /* Soil: dry then wet */
+    { "Step 1/6: put the soil probe in DRY soil (or air).",       cal_soil_dry },
+    { "Step 2/6: put the soil probe in WET soil (or water).",     cal_soil_wet },
+    /* Light: dark then bright */
+    { "Step 3/6: cover the light sensor (DARK).",                 cal_light_dark },
+    { "Step 4/6: point the light sensor at BRIGHT light.",        cal_light_bright },
+    { "Step 5/6: lay the board FLAT and keep it still.",          cal_accel_flat },
+    { "Step 6/6: put the pot in its usual place (REST pose).",    cal_rest_pose },
+};
+
+static void cal_prompt(void)
+{
+    printk("%s\nPress button when ready...\n", cal_steps[step].prompt);
+}
+
+static void cal_enter(void)
+{
+    step = 0;
+    capturing = false;
+    cal_prompt();
+}
+
+static void cal_exit(void)
+{
+    if (step < ARRAY_SIZE(cal_steps)) {
+        printk("Calibration aborted at step %u/%u.\n",
+               step + 1, (unsigned int)ARRAY_SIZE(cal_steps));
+    }
+}
+
+/* One snapshot from the background sensor thread. Soil/light use plant
+ * 0: every plant has the same probe type, so one calibration applies to
+ * all of them.
+ */
+static void cal_capture(void)
+{
+    struct plantcare_data s;
+
+    plantcare_state_get_snapshot(&s);
+    sum.soil_raw   += s.plants[0].soil_raw;
+    sum.light_raw  += s.plants[0].light_raw;
+    sum.acc_x_g100 += s.acc_x_g100;
+    sum.acc_y_g100 += s.acc_y_g100;
+    sum.acc_z_g100 += s.acc_z_g100;
+    captured++;
+}
+
+static int cal_event(enum plantcare_mode_event ev)
+{
+    if (ev == PC_MODE_EV_BUTTON) {
+        /* A press starts the capture; presses during it are bounce */
+        if (!capturing) {
+            capturing = true;
+            captured = 0;
+            sum = (struct cal_avg){0};
+        }
+        return PLANTCARE_MODE_STAY;
+    }
+
+    if (ev != PC_MODE_EV_TICK || !capturing) {
+        return PLANTCARE_MODE_STAY;
+    }
+
+    cal_capture();
+    if (captured < CAL_AVG_SAMPLES) {
+        return PLANTCARE_MODE_STAY;
+    }
+
+    struct cal_avg avg = {
+        .soil_raw   = sum.soil_raw   / CAL_AVG_SAMPLES,
+        .light_raw  = sum.light_raw  / CAL_AVG_SAMPLES,
+        .acc_x_g100 = sum.acc_x_g100 / CAL_AVG_SAMPLES,
+        .acc_y_g100 = sum.acc_y_g100 / CAL_AVG_SAMPLES,
+        .acc_z_g100 = sum.acc_z_g100 / CAL_AVG_SAMPLES,
+    };
+
+    capturing = false;
+    cal_steps[step].done(&avg);
+
+    if (++step < ARRAY_SIZE(cal_steps)) {
+        cal_prompt();
+        return PLANTCARE_MODE_STAY;
+    }
+
+    printk("Returning to TEST MODE.\n");
+    return PLANTCARE_MODE_TEST;
+}
+
+/* LED1 ON, LED2 blinking in Calibration Mode; faster sampling, one
+ * capture sample per tick
+ */
+const struct plantcare_mode_desc plantcare_mode_calib = {
+    .name = "calib",
+    .title = "CALIBRATION",
+    .sampling_period_ms = CAL_SAMPLE_PERIOD_MS,
+    .tick_ms = CAL_SAMPLE_PERIOD_MS,
+    .led1 = LED_ANIM_PATTERN_ON,
+    .led2 = LED_ANIM_PATTERN_SLOW,
+    .enter = cal_enter,
+    .exit = cal_exit,
+    .event = cal_event,
+};
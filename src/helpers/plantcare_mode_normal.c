@@ -1,56 +1,57 @@
 // src/helpers/plantcare_mode_normal.c
 
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/printk.h>
+#include <zephyr/zbus/zbus.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "plantcare_config.h"
+#include "plantcare_modes.h"
 #include "plantcare_state.h"
 #include "plantcare_units.h"
+#include "plantcare_output.h"
+#include "plantcare_alarm.h"
+#include "plantcare_bus.h"
+#include "plantcare_batch.h"
+#include "plantcare_log.h"
+#include "plantcare_time.h"
+#include "plantcare_vib.h"
 
 #include "sensors/button.h"
-#include "sensors/leds.h"
-#include "sensors/led1.h"
-#include "sensors/led2.h"
+#include "sensors/led_anim.h"
 
 // TODO: implement LED2 driver similar to LED1 and include it:
 // #include "sensors/led2.h"
 
 /* ---------- Configuration / thresholds for NORMAL MODE ---------- */
 
-/* NM1/NM2: 30-second cadence */
+/* NM1/NM2: 30-second cadence, at which the sensors start */
 #define NM_SAMPLE_PERIOD_MS    30000   /* 30 s */
 
-/* How many samples in 1 hour at 30 s cadence */
-#define NM_SAMPLES_PER_HOUR    (3600 / 30)    /* 120 */
+/* Quiet sensors back off from NM_SAMPLE_PERIOD_MS up to this */
+#define NM_ADAPT_CEILING_MS    (5 * 60 * 1000)
 
-/* Comfortable ranges (you can tune these) */
-
-/* Temperature in x100 °C (15.0°C – 30.0°C) */
-#define TEMP_MIN_X100          1500
-#define TEMP_MAX_X100          3000
-
-/* Relative humidity in x100 % (30.0% – 70.0%) */
-#define HUM_MIN_X100           3000
-#define HUM_MAX_X100           7000
-
-/* Ambient light: percentage * 10 (10.0% – 80.0%) */
-#define LIGHT_MIN_PCT_X10      100
-#define LIGHT_MAX_PCT_X10      800
-
-/* Soil moisture: percentage * 10 (20.0% – 80.0%) */
-#define SOIL_MIN_PCT_X10       200
-#define SOIL_MAX_PCT_X10       800
+/* How often pending batch reports (e.g. asked for from the shell) are
+ * checked; samples are taken as snapshots arrive
+ */
+#define NM_TICK_MS             1000
 
-/* Acceleration: allowed absolute value in g*100.
- * Example: 200 -> 2.00 g (tune as you like).
+/* A snapshot is a sample if one of these groups was read for it; a GPS
+ * poll alone repeats the rest
  */
-#define ACC_ABS_LIMIT_G100     200
+#define NM_SAMPLE_GROUPS       (BIT(PC_SENSOR_ADC) | BIT(PC_SENSOR_CLIMATE) | \
+                                BIT(PC_SENSOR_ACCEL) | BIT(PC_SENSOR_COLOR))
 
-/* For colour: we assume a healthy leaf is mostly GREEN.
- * If dominant colour is not GREEN, we consider it an "out-of-limit" colour.
+/* NM3: statistics window */
+#define NM_HOUR_MS             (60 * 60 * 1000)
+
+/* Comfortable ranges, hysteresis and dwell times live in the alarm rule
+ * table (plantcare_alarm.c) and can be replaced at runtime.
  */
 
 /* ---------- Simple stats helpers ---------- */
@@ -59,6 +60,7 @@ struct nm_scalar_stats {
     int64_t sum;        /* sum of all samples */
     int32_t min;        /* minimum value */
     int32_t max;        /* maximum value */
+    uint32_t n;         /* samples taken (sensor may have been offline) */
 };
 
 static void nm_scalar_stats_reset(struct nm_scalar_stats *st)
@@ -66,6 +68,7 @@ static void nm_scalar_stats_reset(struct nm_scalar_stats *st)
     st->sum = 0;
     st->min = INT32_MAX;
     st->max = INT32_MIN;
+    st->n   = 0;
 }
 
 static void nm_scalar_stats_add(struct nm_scalar_stats *st, int32_t value)
@@ -73,99 +76,175 @@ static void nm_scalar_stats_add(struct nm_scalar_stats *st, int32_t value)
     st->sum += value;
     if (value < st->min) st->min = value;
     if (value > st->max) st->max = value;
+    st->n++;
+}
+
+static int32_t nm_scalar_stats_mean(const struct nm_scalar_stats *st)
+{
+    return st->n ? (int32_t)(st->sum / st->n) : 0;
+}
+
+/* ---------- Per-plant values ---------- */
+
+struct nm_plant_pct {
+    int32_t light_pct_x10;
+    int32_t soil_pct_x10;
+};
+
+/* A plant counts if the ADC scan worked and its own probe is sane */
+static bool nm_plant_ok(const struct plantcare_data *s, int p)
+{
+    return (s->valid_mask & BIT(PC_SENSOR_ADC)) &&
+           s->anomaly[PC_AN_CH_SOIL + p] != PC_AN_RANGE;
+}
+
+/* "PLANT n " in front of soil/light lines, nothing on one-plant boards */
+static void nm_print_plant_label(int p)
+{
+    if (PLANTCARE_PLANT_COUNT > 1) {
+        printk("PLANT %d ", p);
+    }
 }
 
 /* ---------- Hourly stats storage ---------- */
 
-/* NM3: mean, min, max for temp, humidity, light, soil */
+/* NM3: mean, min, max for temp, humidity, light, soil (per plant) */
 static struct nm_scalar_stats temp_stats;
 static struct nm_scalar_stats hum_stats;
-static struct nm_scalar_stats light_stats;   /* % *10 */
-static struct nm_scalar_stats soil_stats;    /* % *10 */
+static struct nm_scalar_stats dew_stats;   /* °C * 100 */
+static struct nm_scalar_stats vpd_stats;   /* Pa */
+static struct nm_scalar_stats light_stats[PLANTCARE_PLANT_COUNT];  /* % *10 */
+static struct nm_scalar_stats soil_stats[PLANTCARE_PLANT_COUNT];   /* % *10 */
 
 /* NM5: accel axis stats (store in g*100, convert when printing) */
 static struct nm_scalar_stats ax_stats;
 static struct nm_scalar_stats ay_stats;
 static struct nm_scalar_stats az_stats;
 
-/* NM4: dominant colour counts in the last hour */
-static uint32_t dom_red_count   = 0;
-static uint32_t dom_green_count = 0;
-static uint32_t dom_blue_count  = 0;
+/* NM5: orientation (centidegrees); tilt only with a rest pose */
+static struct nm_scalar_stats pitch_stats;
+static struct nm_scalar_stats roll_stats;
+static struct nm_scalar_stats tilt_stats;
+
+/* NM5: vibration band RMS (mg) per batch, and the strongest peak */
+static struct nm_scalar_stats vib_band_stats[PC_VIB_BAND_COUNT];
+static struct plantcare_vib_result vib_max;
+static uint32_t vib_last_seq;
+
+/* NM4: leaf class counts and illuminance in the last hour */
+static uint32_t leaf_count[PC_LEAF_CLASS_COUNT];
+static struct nm_scalar_stats lux_stats;
 
-/* How many samples accumulated in current hour window */
+/* Daily light integral as of the last sample (plantcare_dli.h) */
+static struct plantcare_dli dli_last;
+
+/* How many samples accumulated in current hour window, since when */
 static uint32_t nm_sample_count = 0;
+static int64_t nm_hour_start_ms;
 
 static void nm_reset_hour_window(void)
 {
     nm_scalar_stats_reset(&temp_stats);
     nm_scalar_stats_reset(&hum_stats);
-    nm_scalar_stats_reset(&light_stats);
-    nm_scalar_stats_reset(&soil_stats);
+    nm_scalar_stats_reset(&dew_stats);
+    nm_scalar_stats_reset(&vpd_stats);
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        nm_scalar_stats_reset(&light_stats[p]);
+        nm_scalar_stats_reset(&soil_stats[p]);
+    }
     nm_scalar_stats_reset(&ax_stats);
     nm_scalar_stats_reset(&ay_stats);
     nm_scalar_stats_reset(&az_stats);
 
-    dom_red_count   = 0;
-    dom_green_count = 0;
-    dom_blue_count  = 0;
+    nm_scalar_stats_reset(&pitch_stats);
+    nm_scalar_stats_reset(&roll_stats);
+    nm_scalar_stats_reset(&tilt_stats);
+
+    for (int b = 0; b < PC_VIB_BAND_COUNT; b++) {
+        nm_scalar_stats_reset(&vib_band_stats[b]);
+    }
+    memset(&vib_max, 0, sizeof(vib_max));
+
+    memset(leaf_count, 0, sizeof(leaf_count));
+    nm_scalar_stats_reset(&lux_stats);
 
     nm_sample_count = 0;
+    nm_hour_start_ms = k_uptime_get();
 }
 
 /* Accumulate one new sample into hourly stats */
 static void nm_accumulate_sample(const struct plantcare_data *s,
                                  int32_t temp_x100,
                                  int32_t hum_x100,
-                                 int32_t light_pct_x10,
-                                 int32_t soil_pct_x10)
+                                 const struct nm_plant_pct *pct)
 {
-    /* Scalars */
-    nm_scalar_stats_add(&temp_stats,  temp_x100);
-    nm_scalar_stats_add(&hum_stats,   hum_x100);
-    nm_scalar_stats_add(&light_stats, light_pct_x10);
-    nm_scalar_stats_add(&soil_stats,  soil_pct_x10);
+    /* Only groups read in this snapshot's cycle count towards the hour;
+     * the others repeat their last reading
+     */
+    if (s->fresh_mask & BIT(PC_SENSOR_CLIMATE)) {
+        nm_scalar_stats_add(&temp_stats,  temp_x100);
+        nm_scalar_stats_add(&hum_stats,   hum_x100);
+        nm_scalar_stats_add(&dew_stats,   s->dew_x100);
+        nm_scalar_stats_add(&vpd_stats,   s->vpd_pa);
+    }
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        if ((s->fresh_mask & BIT(PC_SENSOR_ADC)) && nm_plant_ok(s, p)) {
+            nm_scalar_stats_add(&light_stats[p], pct[p].light_pct_x10);
+            nm_scalar_stats_add(&soil_stats[p],  pct[p].soil_pct_x10);
+        }
+    }
 
     /* Acceleration in g*100 */
-    nm_scalar_stats_add(&ax_stats, s->acc_x_g100);
-    nm_scalar_stats_add(&ay_stats, s->acc_y_g100);
-    nm_scalar_stats_add(&az_stats, s->acc_z_g100);
-
-    /* Dominant colour counts */
-    switch (s->dom_color) {
-    case DOM_COLOR_RED:
-        dom_red_count++;
-        break;
-    case DOM_COLOR_GREEN:
-        dom_green_count++;
-        break;
-    case DOM_COLOR_BLUE:
-        dom_blue_count++;
-        break;
-    default:
-        break;
+    if (s->fresh_mask & BIT(PC_SENSOR_ACCEL)) {
+        nm_scalar_stats_add(&ax_stats, s->acc_x_g100);
+        nm_scalar_stats_add(&ay_stats, s->acc_y_g100);
+        nm_scalar_stats_add(&az_stats, s->acc_z_g100);
+
+        nm_scalar_stats_add(&pitch_stats, s->tilt.pitch_cdeg);
+        nm_scalar_stats_add(&roll_stats,  s->tilt.roll_cdeg);
+        if (s->tilt.tilt_cdeg != PLANTCARE_TILT_NO_REST) {
+            nm_scalar_stats_add(&tilt_stats, s->tilt.tilt_cdeg);
+        }
+    }
+
+    /* Batches run less often than samples: count each one once */
+    if (s->vib.seq != 0 && s->vib.seq != vib_last_seq) {
+        vib_last_seq = s->vib.seq;
+        for (int b = 0; b < PC_VIB_BAND_COUNT; b++) {
+            nm_scalar_stats_add(&vib_band_stats[b], s->vib.band_mg[b]);
+        }
+        if (vib_max.seq == 0 || s->vib.peak_mg > vib_max.peak_mg) {
+            vib_max = s->vib;
+        }
     }
 
+    /* Leaf class counts; UNKNOWN (dark, saturated) is counted but never wins */
+    if ((s->fresh_mask & BIT(PC_SENSOR_COLOR)) &&
+        s->leaf_class < PC_LEAF_CLASS_COUNT) {
+        leaf_count[s->leaf_class]++;
+        nm_scalar_stats_add(&lux_stats, (int32_t)MIN(s->lux, INT32_MAX));
+    }
+    dli_last = s->dli;
+
     nm_sample_count++;
 }
 
-/* Decide which colour was dominant most often in the last hour */
-static enum plantcare_dom_color nm_hourly_dominant_color(void)
+/* Decide which leaf class was seen most often in the last hour */
+static uint8_t nm_hourly_leaf_class(void)
 {
-    if (dom_red_count == 0 && dom_green_count == 0 && dom_blue_count == 0) {
-        return DOM_COLOR_UNKNOWN;
-    }
+    uint8_t best = PC_LEAF_UNKNOWN;
+    uint32_t best_n = 0;
 
-    if (dom_red_count >= dom_green_count && dom_red_count >= dom_blue_count) {
-        return DOM_COLOR_RED;
-    } else if (dom_green_count >= dom_red_count && dom_green_count >= dom_blue_count) {
-        return DOM_COLOR_GREEN;
-    } else {
-        return DOM_COLOR_BLUE;
+    for (uint8_t c = PC_LEAF_HEALTHY; c < PC_LEAF_CLASS_COUNT; c++) {
+        if (leaf_count[c] > best_n) {
+            best = c;
+            best_n = leaf_count[c];
+        }
     }
+    return best;
 }
 
-/* Print hourly statistics once we have NM_SAMPLES_PER_HOUR samples */
+/* Print the statistics of the hour that just ended */
 static void nm_print_hourly_stats(void)
 {
     if (nm_sample_count == 0) {
@@ -174,279 +253,439 @@ static void nm_print_hourly_stats(void)
 
     printk("\n----- NORMAL MODE: HOURLY STATISTICS ----\n");
 
-    int32_t temp_mean_x100  = (int32_t)(temp_stats.sum  / nm_sample_count);
-    int32_t hum_mean_x100   = (int32_t)(hum_stats.sum   / nm_sample_count);
-    int32_t light_mean_x10  = (int32_t)(light_stats.sum / nm_sample_count);
-    int32_t soil_mean_x10   = (int32_t)(soil_stats.sum  / nm_sample_count);
-
-    /* Temperature */
-    printk("TEMP: mean=%d.%02d C, min=%d.%02d C, max=%d.%02d C\n",
-           temp_mean_x100 / 100, temp_mean_x100 % 100,
-           temp_stats.min / 100,  temp_stats.min % 100,
-           temp_stats.max / 100,  temp_stats.max % 100);
-
-    /* Humidity */
-    printk("HUMIDITY: mean=%d.%02d %%, min=%d.%02d %%, max=%d.%02d %%\n",
-           hum_mean_x100 / 100, hum_mean_x100 % 100,
-           hum_stats.min  / 100, hum_stats.min  % 100,
-           hum_stats.max  / 100, hum_stats.max  % 100);
-
-    /* Light (percent) */
-    printk("LIGHT: mean=%d.%01d %%, min=%d.%01d %%, max=%d.%01d %%\n",
-           light_mean_x10 / 10, light_mean_x10 % 10,
-           light_stats.min / 10, light_stats.min % 10,
-           light_stats.max / 10, light_stats.max % 10);
-
-    /* Soil moisture (percent) */
-    printk("SOIL: mean=%d.%01d %%, min=%d.%01d %%, max=%d.%01d %%\n",
-           soil_mean_x10 / 10, soil_mean_x10 % 10,
-           soil_stats.min / 10, soil_stats.min % 10,
-           soil_stats.max / 10, soil_stats.max % 10);
+    /* A sensor that was offline the whole hour has nothing to report */
+    if (temp_stats.n > 0) {
+        int32_t temp_mean_x100 = nm_scalar_stats_mean(&temp_stats);
+        int32_t hum_mean_x100  = nm_scalar_stats_mean(&hum_stats);
+
+        /* Temperature */
+        printk("TEMP: mean=%d.%02d C, min=%d.%02d C, max=%d.%02d C\n",
+               temp_mean_x100 / 100, temp_mean_x100 % 100,
+               temp_stats.min / 100,  temp_stats.min % 100,
+               temp_stats.max / 100,  temp_stats.max % 100);
+
+        /* Humidity */
+        printk("HUMIDITY: mean=%d.%02d %%, min=%d.%02d %%, max=%d.%02d %%\n",
+               hum_mean_x100 / 100, hum_mean_x100 % 100,
+               hum_stats.min  / 100, hum_stats.min  % 100,
+               hum_stats.max  / 100, hum_stats.max  % 100);
+    } else {
+        printk("CLIMATE: no valid samples\n");
+    }
+
+    /* Dew point (can be below zero) and VPD in kPa */
+    if (dew_stats.n > 0) {
+        int32_t dew_mean_x100 = nm_scalar_stats_mean(&dew_stats);
+        int32_t vpd_mean_pa   = nm_scalar_stats_mean(&vpd_stats);
+
+        printk("DEW POINT: mean=%s%d.%02d C, min=%s%d.%02d C, max=%s%d.%02d C\n",
+               (dew_mean_x100 < 0) ? "-" : "", abs(dew_mean_x100) / 100,
+               abs(dew_mean_x100) % 100,
+               (dew_stats.min < 0) ? "-" : "", abs(dew_stats.min) / 100,
+               abs(dew_stats.min) % 100,
+               (dew_stats.max < 0) ? "-" : "", abs(dew_stats.max) / 100,
+               abs(dew_stats.max) % 100);
+        printk("VPD: mean=%d.%03d kPa, min=%d.%03d kPa, max=%d.%03d kPa\n",
+               vpd_mean_pa / 1000, vpd_mean_pa % 1000,
+               vpd_stats.min / 1000, vpd_stats.min % 1000,
+               vpd_stats.max / 1000, vpd_stats.max % 1000);
+    }
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        const struct nm_scalar_stats *ls = &light_stats[p];
+        const struct nm_scalar_stats *ss = &soil_stats[p];
+        int32_t light_mean_x10 = nm_scalar_stats_mean(ls);
+        int32_t soil_mean_x10  = nm_scalar_stats_mean(ss);
+
+        if (ss->n == 0) {
+            nm_print_plant_label(p);
+            printk("SOIL/LIGHT: no valid samples\n");
+            continue;
+        }
+
+        /* Light (percent) */
+        nm_print_plant_label(p);
+        printk("LIGHT: mean=%d.%01d %%, min=%d.%01d %%, max=%d.%01d %%\n",
+               light_mean_x10 / 10, light_mean_x10 % 10,
+               ls->min / 10, ls->min % 10,
+               ls->max / 10, ls->max % 10);
+
+        /* Soil moisture (percent) */
+        nm_print_plant_label(p);
+        printk("SOIL: mean=%d.%01d %%, min=%d.%01d %%, max=%d.%01d %%\n",
+               soil_mean_x10 / 10, soil_mean_x10 % 10,
+               ss->min / 10, ss->min % 10,
+               ss->max / 10, ss->max % 10);
+    }
 
     /* Accel: convert g*100 min/max/mean to m/s^2*100 and print */
-    int32_t ax_mean_g100 = (int32_t)(ax_stats.sum / nm_sample_count);
-    int32_t ay_mean_g100 = (int32_t)(ay_stats.sum / nm_sample_count);
-    int32_t az_mean_g100 = (int32_t)(az_stats.sum / nm_sample_count);
-
-    int32_t ax_mean_ms2_x100 = accel_g100_to_ms2_x100(ax_mean_g100);
-    int32_t ay_mean_ms2_x100 = accel_g100_to_ms2_x100(ay_mean_g100);
-    int32_t az_mean_ms2_x100 = accel_g100_to_ms2_x100(az_mean_g100);
-
-    int32_t ax_min_ms2_x100  = accel_g100_to_ms2_x100(ax_stats.min);
-    int32_t ay_min_ms2_x100  = accel_g100_to_ms2_x100(ay_stats.min);
-    int32_t az_min_ms2_x100  = accel_g100_to_ms2_x100(az_stats.min);
-
-    int32_t ax_max_ms2_x100  = accel_g100_to_ms2_x100(ax_stats.max);
-    int32_t ay_max_ms2_x100  = accel_g100_to_ms2_x100(ay_stats.max);
-    int32_t az_max_ms2_x100  = accel_g100_to_ms2_x100(az_stats.max);
-
-    printk("ACCEL X: mean=%d.%02d, min=%d.%02d, max=%d.%02d m/s^2\n",
-           ax_mean_ms2_x100 / 100, ax_mean_ms2_x100 % 100,
-           ax_min_ms2_x100  / 100, ax_min_ms2_x100  % 100,
-           ax_max_ms2_x100  / 100, ax_max_ms2_x100  % 100);
-
-    printk("ACCEL Y: mean=%d.%02d, min=%d.%02d, max=%d.%02d m/s^2\n",
-           ay_mean_ms2_x100 / 100, ay_mean_ms2_x100 % 100,
-           ay_min_ms2_x100  / 100, ay_min_ms2_x100  % 100,
-           ay_max_ms2_x100  / 100, ay_max_ms2_x100  % 100);
-
-    printk("ACCEL Z: mean=%d.%02d, min=%d.%02d, max=%d.%02d m/s^2\n",
-           az_mean_ms2_x100 / 100, az_mean_ms2_x100 % 100,
-           az_min_ms2_x100  / 100, az_min_ms2_x100  % 100,
-           az_max_ms2_x100  / 100, az_max_ms2_x100  % 100);
-
-    /* NM4: dominant colour over last hour */
-    enum plantcare_dom_color hour_dom = nm_hourly_dominant_color();
-    printk("HOURLY DOMINANT COLOUR: ");
-    switch (hour_dom) {
-    case DOM_COLOR_RED:   printk("RED\n");   break;
-    case DOM_COLOR_GREEN: printk("GREEN\n"); break;
-    case DOM_COLOR_BLUE:  printk("BLUE\n");  break;
-    default:              printk("UNKNOWN\n"); break;
+    if (ax_stats.n > 0) {
+        int32_t ax_mean_g100 = nm_scalar_stats_mean(&ax_stats);
+        int32_t ay_mean_g100 = nm_scalar_stats_mean(&ay_stats);
+        int32_t az_mean_g100 = nm_scalar_stats_mean(&az_stats);
+
+        int32_t ax_mean_ms2_x100 = accel_g100_to_ms2_x100(ax_mean_g100);
+        int32_t ay_mean_ms2_x100 = accel_g100_to_ms2_x100(ay_mean_g100);
+        int32_t az_mean_ms2_x100 = accel_g100_to_ms2_x100(az_mean_g100);
+
+        int32_t ax_min_ms2_x100  = accel_g100_to_ms2_x100(ax_stats.min);
+        int32_t ay_min_ms2_x100  = accel_g100_to_ms2_x100(ay_stats.min);
+        int32_t az_min_ms2_x100  = accel_g100_to_ms2_x100(az_stats.min);
+
+        int32_t ax_max_ms2_x100  = accel_g100_to_ms2_x100(ax_stats.max);
+        int32_t ay_max_ms2_x100  = accel_g100_to_ms2_x100(ay_stats.max);
+        int32_t az_max_ms2_x100  = accel_g100_to_ms2_x100(az_stats.max);
+
+        printk("ACCEL X: mean=%d.%02d, min=%d.%02d, max=%d.%02d m/s^2\n",
+               ax_mean_ms2_x100 / 100, ax_mean_ms2_x100 % 100,
+               ax_min_ms2_x100  / 100, ax_min_ms2_x100  % 100,
+               ax_max_ms2_x100  / 100, ax_max_ms2_x100  % 100);
+
+        printk("ACCEL Y: mean=%d.%02d, min=%d.%02d, max=%d.%02d m/s^2\n",
+               ay_mean_ms2_x100 / 100, ay_mean_ms2_x100 % 100,
+               ay_min_ms2_x100  / 100, ay_min_ms2_x100  % 100,
+               ay_max_ms2_x100  / 100, ay_max_ms2_x100  % 100);
+
+        printk("ACCEL Z: mean=%d.%02d, min=%d.%02d, max=%d.%02d m/s^2\n",
+               az_mean_ms2_x100 / 100, az_mean_ms2_x100 % 100,
+               az_min_ms2_x100  / 100, az_min_ms2_x100  % 100,
+               az_max_ms2_x100  / 100, az_max_ms2_x100  % 100);
+    } else {
+        printk("ACCEL: no valid samples\n");
     }
 
+    /* Orientation: mean pose, and how far it leaned at worst */
+    if (pitch_stats.n > 0) {
+        struct plantcare_tilt mean = {
+            .pitch_cdeg = (int16_t)nm_scalar_stats_mean(&pitch_stats),
+            .roll_cdeg  = (int16_t)nm_scalar_stats_mean(&roll_stats),
+            .tilt_cdeg  = tilt_stats.n ?
+                          (int16_t)nm_scalar_stats_mean(&tilt_stats) :
+                          PLANTCARE_TILT_NO_REST,
+        };
+
+        printk("MEAN ");
+        plantcare_output_tilt(&mean);
+        if (tilt_stats.n > 0) {
+            printk("TILT FROM REST: max=%d.%02d deg\n",
+                   tilt_stats.max / 100, tilt_stats.max % 100);
+        }
+    }
+
+    /* Vibration: band RMS over the hour's batches, loudest peak */
+    if (vib_band_stats[0].n > 0) {
+        for (int b = 0; b < PC_VIB_BAND_COUNT; b++) {
+            const struct nm_scalar_stats *vs = &vib_band_stats[b];
+
+            printk("VIB %s: mean=%d mg, min=%d mg, max=%d mg\n",
+                   plantcare_vib_band_name(b), nm_scalar_stats_mean(vs),
+                   vs->min, vs->max);
+        }
+        printk("VIB PEAK: %u mg at %u.%u Hz, tonality %u %% (%u batches "
+               "of %u @ %u Hz)\n",
+               vib_max.peak_mg, vib_max.peak_hz_x10 / 10,
+               vib_max.peak_hz_x10 % 10, vib_max.tonality_pct,
+               vib_band_stats[0].n, vib_max.n, vib_max.odr_hz);
+    }
+
+    /* NM4: leaf colour over last hour */
+    uint8_t hour_leaf = nm_hourly_leaf_class();
+    printk("HOURLY LEAF COLOUR: %s (healthy=%u yellowing=%u browning=%u "
+           "unknown=%u)\n",
+           plantcare_leaf_class_name(hour_leaf),
+           leaf_count[PC_LEAF_HEALTHY], leaf_count[PC_LEAF_YELLOWING],
+           leaf_count[PC_LEAF_BROWNING], leaf_count[PC_LEAF_UNKNOWN]);
+    if (lux_stats.n > 0) {
+        printk("ILLUMINANCE: mean=%d lux, min=%d lux, max=%d lux\n",
+               nm_scalar_stats_mean(&lux_stats), lux_stats.min, lux_stats.max);
+    }
+    printk("DAILY LIGHT INTEGRAL: today so far=%u.%02u mol/m2, "
+           "yesterday=%u.%02u mol/m2\n",
+           dli_last.today_x100 / 100, dli_last.today_x100 % 100,
+           dli_last.yesterday_x100 / 100, dli_last.yesterday_x100 % 100);
+
     printk("----- END OF HOURLY STATISTICS -----\n");
 }
 
 /* ---------- NM7: Limit check + RGB LED indication ---------- */
 
-static void nm_update_alarm_led(int32_t temp_x100,
-                                int32_t hum_x100,
-                                int32_t light_pct_x10,
-                                int32_t soil_pct_x10,
-                                const struct plantcare_data *s)
+/* Each parameter uses a different RGB colour code and blink pattern.
+ * All raised alarms are shown in turn, one per second, most important first.
+ */
+static const struct led_anim_step nm_alarm_steps[PC_CH_COUNT] = {
+    [PC_CH_TEMP]       = { LED_ANIM_RED,     LED_ANIM_PATTERN_LONG   },
+    [PC_CH_HUM]        = { LED_ANIM_BLUE,    LED_ANIM_PATTERN_DOUBLE },
+    [PC_CH_VPD]        = { LED_ANIM_BLUE,    LED_ANIM_PATTERN_SLOW   },
+    [PC_CH_DEW_MARGIN] = { LED_ANIM_BLUE,    LED_ANIM_PATTERN_FAST   },
+    [PC_CH_LIGHT]      = { LED_ANIM_GREEN,   LED_ANIM_PATTERN_SLOW   },
+    [PC_CH_SOIL]       = { LED_ANIM_YELLOW,  LED_ANIM_PATTERN_TRIPLE },
+    [PC_CH_SOIL_DRY]   = { LED_ANIM_YELLOW,  LED_ANIM_PATTERN_SLOW   },
+    [PC_CH_ACCEL]      = { LED_ANIM_CYAN,    LED_ANIM_PATTERN_FAST   },
+    [PC_CH_TILT]       = { LED_ANIM_CYAN,    LED_ANIM_PATTERN_SLOW   },
+    [PC_CH_LEAF]       = { LED_ANIM_MAGENTA, LED_ANIM_PATTERN_SHORT  },
+    [PC_CH_ANOMALY]    = { LED_ANIM_WHITE,   LED_ANIM_PATTERN_DOUBLE },
+};
+
+BUILD_ASSERT(PC_CH_COUNT <= LED_ANIM_MAX_STEPS,
+             "the RGB sequence must fit one step per alarm channel");
+
+/* Set by the listener, the LED sequence is rebuilt by the mode thread */
+static atomic_t nm_alarms_changed;
+
+/* Listener on pc_alarm_chan: runs in the publisher's (sensor) thread.
+ * Alarms are evaluated in every mode (plantcare_alarm_feed.c); only
+ * normal mode reports them.
+ */
+static void nm_alarm_event(const struct zbus_channel *chan)
+{
+    const struct plantcare_alarm_event *evt = zbus_chan_const_msg(chan);
+
+    atomic_set(&nm_alarms_changed, 1);
+
+    if (plantcare_config_mode() != PLANTCARE_MODE_NORMAL) {
+        return;
+    }
+
+    /* Per-plant channels say which plant */
+    char inst[8] = "";
+    if (plantcare_alarm_channel_instances(evt->channel) > 1) {
+        snprintk(inst, sizeof(inst), "[%u]", evt->inst);
+    }
+
+    printk("ALARM %s%s %s (value=%d)\n",
+           plantcare_alarm_channel_name(evt->channel), inst,
+           evt->active ? "RAISED" : "CLEARED",
+           evt->value);
+}
+
+ZBUS_LISTENER_DEFINE(nm_alarm_lis, nm_alarm_event);
+ZBUS_CHAN_ADD_OBS(pc_alarm_chan, nm_alarm_lis, 3);
+
+/* NM7: cycle through every raised alarm, LED off if none */
+static void nm_show_alarms(void)
+{
+    uint8_t active[PC_CH_COUNT];
+    struct led_anim_step steps[PC_CH_COUNT];
+    size_t n = plantcare_alarm_active_list(active, ARRAY_SIZE(active));
+
+    for (size_t i = 0; i < n; i++) {
+        steps[i] = nm_alarm_steps[active[i]];
+    }
+    led_anim_rgb_sequence(steps, n);
+}
+
+/* Say which sensor faults appeared or went away */
+static void nm_report_anomalies(const struct plantcare_data *s)
 {
-    bool alarm_temp = (temp_x100 < TEMP_MIN_X100 || temp_x100 > TEMP_MAX_X100);
-    bool alarm_hum  = (hum_x100  < HUM_MIN_X100  || hum_x100  > HUM_MAX_X100);
-    bool alarm_light= (light_pct_x10 < LIGHT_MIN_PCT_X10 ||
-                       light_pct_x10 > LIGHT_MAX_PCT_X10);
-    bool alarm_soil = (soil_pct_x10 < SOIL_MIN_PCT_X10 ||
-                       soil_pct_x10 > SOIL_MAX_PCT_X10);
-
-    bool alarm_accel = false;
-    if (s) {
-        int32_t ax = s->acc_x_g100;
-        int32_t ay = s->acc_y_g100;
-        int32_t az = s->acc_z_g100;
-        if (ax < 0) ax = -ax;
-        if (ay < 0) ay = -ay;
-        if (az < 0) az = -az;
-
-        if (ax > ACC_ABS_LIMIT_G100 ||
-            ay > ACC_ABS_LIMIT_G100 ||
-            az > ACC_ABS_LIMIT_G100) {
-            alarm_accel = true;
+    static uint8_t last_anomaly[PC_AN_CH_COUNT];
+
+    for (int ch = 0; ch < PC_AN_CH_COUNT; ch++) {
+        if (s->anomaly[ch] != last_anomaly[ch]) {
+            printk("SENSOR %s: %s\n", plantcare_anomaly_channel_name(ch),
+                   plantcare_anomaly_kind_name(s->anomaly[ch]));
+            last_anomaly[ch] = s->anomaly[ch];
         }
     }
+}
 
-    /* Colour alarm: assume healthy leaf is mostly GREEN */
-    bool alarm_color = (s && s->dom_color != DOM_COLOR_GREEN);
+/* NM2: Send all measured values (print every 30 seconds) */
+static void nm_print_text(const struct plantcare_data *s,
+                          int32_t temp_x100,
+                          int32_t hum_x100,
+                          const struct nm_plant_pct *pct)
+{
+    printk("\n================ NORMAL MODE =================\n");
+
+    printk("TEMP: %d.%02d C\n",
+           temp_x100 / 100, temp_x100 % 100);
+
+    printk("HUMIDITY: %d.%02d %%\n",
+           hum_x100 / 100, hum_x100 % 100);
+
+    printk("DEW POINT: %s%d.%02d C, VPD: %d.%03d kPa\n",
+           (s->dew_x100 < 0) ? "-" : "", abs(s->dew_x100) / 100,
+           abs(s->dew_x100) % 100,
+           s->vpd_pa / 1000, s->vpd_pa % 1000);
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        nm_print_plant_label(p);
+        printk("LIGHT: %d.%01d %%\n",
+               pct[p].light_pct_x10 / 10, pct[p].light_pct_x10 % 10);
+
+        nm_print_plant_label(p);
+        printk("SOIL: %d.%01d %%\n",
+               pct[p].soil_pct_x10 / 10, pct[p].soil_pct_x10 % 10);
+
+        const struct plantcare_drying *dr = &s->drying[p];
+
+        if (dr->valid && dr->eta_min < PLANTCARE_DRYING_ETA_MAX_MIN) {
+            int32_t rate = -dr->rate_x100;
 
-    /* Priority: TEMP > HUM > LIGHT > SOIL > ACCEL > COLOUR
-     * Each parameter uses a different RGB colour code.
+            nm_print_plant_label(p);
+            printk("SOIL TREND: -%d.%02d %%/h, at limit in %u h %02u min\n",
+                   rate / 100, rate % 100, dr->eta_min / 60, dr->eta_min % 60);
+        }
+    }
+
+    /* Accel instant values in m/s^2 (using helper) */
+    int32_t ax_ms2_x100 = accel_g100_to_ms2_x100(s->acc_x_g100);
+    int32_t ay_ms2_x100 = accel_g100_to_ms2_x100(s->acc_y_g100);
+    int32_t az_ms2_x100 = accel_g100_to_ms2_x100(s->acc_z_g100);
+
+    int32_t ax_abs = (ax_ms2_x100 >= 0) ? ax_ms2_x100 : -ax_ms2_x100;
+    int32_t ay_abs = (ay_ms2_x100 >= 0) ? ay_ms2_x100 : -ay_ms2_x100;
+    int32_t az_abs = (az_ms2_x100 >= 0) ? az_ms2_x100 : -az_ms2_x100;
+
+    printk("ACCEL: X_axis: %s%d.%02d m/s^2, "
+           "Y_axis: %s%d.%02d m/s^2, "
+           "Z_axis: %s%d.%02d m/s^2\n",
+           (ax_ms2_x100 < 0) ? "-" : "", ax_abs / 100, ax_abs % 100,
+           (ay_ms2_x100 < 0) ? "-" : "", ay_abs / 100, ay_abs % 100,
+           (az_ms2_x100 < 0) ? "-" : "", az_abs / 100, az_abs % 100);
+    plantcare_output_tilt(&s->tilt);
+
+    /* Colour sensor instant values */
+    printk("COLOUR SENSOR: Clear=%u, Red=%u, Green=%u, Blue=%u\n",
+           s->clr, s->red, s->green, s->blue);
+    printk("COLOUR: Hue=%u.%u deg, CCT=%u K, Lux=%u, Leaf=%s\n",
+           s->hue_x10 / 10, s->hue_x10 % 10, s->cct_k, s->lux,
+           plantcare_leaf_class_name(s->leaf_class));
+    if (s->dli.source != PC_PPFD_NONE) {
+        printk("LIGHT: PPFD=%u.%u umol/m2/s, DLI today=%u.%02u mol/m2\n",
+               s->dli.ppfd_x10 / 10, s->dli.ppfd_x10 % 10,
+               s->dli.today_x100 / 100, s->dli.today_x100 % 100);
+    }
+
+    /* NM6: GPS position + time every 30 seconds. The time is the GPS-
+     * disciplined clock in the configured zone; the position is still in
+     * the forwarded NMEA sentence.
      */
-    bool r = false, g = false, b = false;
-
-    if (alarm_temp) {
-        /* TEMPERATURE -> RED */
-        r = true;
-    } else if (alarm_hum) {
-        /* HUMIDITY -> BLUE */
-        b = true;
-    } else if (alarm_light) {
-        /* LIGHT -> GREEN */
-        g = true;
-    } else if (alarm_soil) {
-        /* SOIL -> YELLOW (RED + GREEN) */
-        r = true;
-        g = true;
-    } else if (alarm_accel) {
-        /* ACCEL -> CYAN (GREEN + BLUE) */
-        g = true;
-        b = true;
-    } else if (alarm_color) {
-        /* LEAF COLOUR -> MAGENTA (RED + BLUE) */
-        r = true;
-        b = true;
+    char when[40];
+
+    plantcare_time_format_local(s->epoch_s, when, sizeof(when));
+    printk("TIME: %s\n", when);
+
+    if (s->gps_last_sentence[0] != '\0') {
+        printk("GPS (NMEA, UTC): %s\n", s->gps_last_sentence);
     } else {
-        /* No alarms: turn RGB LED OFF (or you could show leaf colour) */
-        r = g = b = false;
+        printk("GPS: (no data yet)\n");
     }
-
-    rgb_set(r, g, b);
 }
 
-/* ---------- NORMAL MODE main function ---------- */
+/* ---------- NORMAL MODE handlers ---------- */
 
-void plantcare_run_normal_mode(void)
+static void nm_enter(void)
+{
+    printk("Press button to switch back to TEST MODE.\n");
+
+    /* NM1: 30-second monitoring cadence, stretched while nothing changes */
+    (void)plantcare_config_set_adaptive(NM_SAMPLE_PERIOD_MS, NM_ADAPT_CEILING_MS);
+
+    /* Reset hourly window */
+    nm_reset_hour_window();
+
+    /* Alarms raised in another mode show at once */
+    atomic_clear(&nm_alarms_changed);
+    nm_show_alarms();
+}
+
+/* NM1/NM2/NM6: send the values of a snapshot with fresh readings. The
+ * sensors set the pace: 30 s, or slower while the adaptive sampler has
+ * them backed off.
+ */
+static void nm_sample(int64_t now)
 {
     struct plantcare_data s;
+    struct plantcare_mode_cfg cfg;
 
-    printk("\n===== ENTERING NORMAL MODE =====\n");
-    printk("Press button to switch back to TEST MODE.\n");
+    plantcare_state_get_snapshot(&s);
+    if (!(s.fresh_mask & NM_SAMPLE_GROUPS)) {
+        return;
+    }
 
-    /* NM1: 30-second monitoring cadence (background thread uses this) */
-    g_current_mode       = PLANTCARE_MODE_NORMAL;
-    g_sampling_period_ms = NM_SAMPLE_PERIOD_MS;
+    /* Convert raw to more readable units */
+    int32_t temp_x100 = s.temp_x100;
+    int32_t hum_x100  = s.hum_x100;
 
-    /* NM8: LED2 (green LED) ON, LED1 OFF in Normal Mode */
-    led1_set(false);
+    struct nm_plant_pct pct[PLANTCARE_PLANT_COUNT];
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        pct[p].light_pct_x10 = light_raw_to_pct_x10(s.plants[p].light_raw);
+        pct[p].soil_pct_x10  = soil_raw_to_pct_x10(s.plants[p].soil_raw);
+    }
 
-    led2_set(true);
+    /* Accumulate into hourly stats (NM3, NM4, NM5) */
+    nm_accumulate_sample(&s,
+                         temp_x100,
+                         hum_x100,
+                         pct);
 
-    /* Reset hourly window */
-    nm_reset_hour_window();
+    /* Kept for "pc export" whatever the console output is */
+    plantcare_log_add(&s, now);
 
-    /* For NM1/NM2/NM6: 30-second periodic sending using uptime */
-    int64_t last_sample_ms = k_uptime_get();
+    /* NM2: Send all measured values, batched into one report an
+     * hour (or per batch_size samples), or one by one if batching is off.
+     */
+    plantcare_config_get(&cfg);
+    if (cfg.batch_size) {
+        plantcare_batch_add(&s, now);
+    } else if (cfg.output_format == PLANTCARE_OUTPUT_CSV) {
+        plantcare_output_csv(&s);
+    } else {
+        nm_print_text(&s, temp_x100, hum_x100, pct);
+    }
 
-    while (g_current_mode == PLANTCARE_MODE_NORMAL) {
+    /* NM7: the limits are checked as the readings come in; report
+     * sensor faults with the sample
+     */
+    nm_report_anomalies(&s);
 
-        /* Handle button event (set by ISR) */
-        if (g_button_pressed_event) {
-            g_button_pressed_event = false;  /* consume event */
+    /* NM3/NM4/NM5: once an hour, print stats */
+    if ((now - nm_hour_start_ms) >= NM_HOUR_MS) {
+        nm_print_hourly_stats();
+        nm_reset_hour_window();
+    }
+}
 
-            printk("Button pressed -> switching to TEST MODE\n");
-            g_current_mode = PLANTCARE_MODE_TEST;
-            break;
-        }
+static int nm_event(enum plantcare_mode_event ev)
+{
+    struct plantcare_mode_cfg cfg;
 
-        int64_t now = k_uptime_get();
-
-        /* NM1/NM2/NM6: every 30 seconds, take snapshot and send values */
-        if ((now - last_sample_ms) >= NM_SAMPLE_PERIOD_MS) {
-            last_sample_ms = now;
-
-            plantcare_state_get_snapshot(&s);
-
-            /* Convert raw to more readable units */
-            int32_t temp_x100 = s.temp_x100;
-            int32_t hum_x100  = s.hum_x100;
-
-            int32_t light_pct_x10 = light_raw_to_pct_x10(s.light_raw);
-            int32_t soil_pct_x10  = soil_raw_to_pct_x10(s.soil_raw);
-
-            /* Accumulate into hourly stats (NM3, NM4, NM5) */
-            nm_accumulate_sample(&s,
-                                 temp_x100,
-                                 hum_x100,
-                                 light_pct_x10,
-                                 soil_pct_x10);
-
-            /* NM2: Send all measured values (print every 30 seconds) */
-            printk("\n================ NORMAL MODE =================\n");
-
-            printk("TEMP: %d.%02d C\n",
-                   temp_x100 / 100, temp_x100 % 100);
-
-            printk("HUMIDITY: %d.%02d %%\n",
-                   hum_x100 / 100, hum_x100 % 100);
-
-            printk("LIGHT: %d.%01d %%\n",
-                   light_pct_x10 / 10, light_pct_x10 % 10);
-
-            printk("SOIL: %d.%01d %%\n",
-                   soil_pct_x10 / 10, soil_pct_x10 % 10);
-
-            /* Accel instant values in m/s^2 (using helper) */
-            int32_t ax_ms2_x100 = accel_g100_to_ms2_x100(s.acc_x_g100);
-            int32_t ay_ms2_x100 = accel_g100_to_ms2_x100(s.acc_y_g100);
-            int32_t az_ms2_x100 = accel_g100_to_ms2_x100(s.acc_z_g100);
-
-            int32_t ax_abs = (ax_ms2_x100 >= 0) ? ax_ms2_x100 : -ax_ms2_x100;
-            int32_t ay_abs = (ay_ms2_x100 >= 0) ? ay_ms2_x100 : -ay_ms2_x100;
-            int32_t az_abs = (az_ms2_x100 >= 0) ? az_ms2_x100 : -az_ms2_x100;
-
-            printk("ACCEL: X_axis: %s%d.%02d m/s^2, "
-                   "Y_axis: %s%d.%02d m/s^2, "
-                   "Z_axis: %s%d.%02d m/s^2\n",
-                   (ax_ms2_x100 < 0) ? "-" : "", ax_abs / 100, ax_abs % 100,
-                   (ay_ms2_x100 < 0) ? "-" : "", ay_abs / 100, ay_abs % 100,
-                   (az_ms2_x100 < 0) ? "-" : "", az_abs / 100, az_abs % 100);
-
-            /* Colour sensor instant values */
-            printk("COLOUR SENSOR: Clear=%u, Red=%u, Green=%u, Blue=%u, Dominant=",
-                   s.clr, s.red, s.green, s.blue);
-            switch (s.dom_color) {
-            case DOM_COLOR_RED:   printk("RED\n");   break;
-            case DOM_COLOR_GREEN: printk("GREEN\n"); break;
-            case DOM_COLOR_BLUE:  printk("BLUE\n");  break;
-            default:              printk("UNKNOWN\n"); break;
-            }
-
-            /* NM6: GPS position + time every 30 seconds.
-             * For now we forward last NMEA sentence, which includes UTC time
-             * and coordinates. Full parsing + local-time conversion could be
-             * added here later.
-             */
-            if (s.gps_last_sentence[0] != '\0') {
-                printk("GPS (NMEA, UTC): %s\n", s.gps_last_sentence);
-            } else {
-                printk("GPS: (no data yet)\n");
-            }
-
-            /* NM7: Check limits and set RGB LED accordingly */
-            nm_update_alarm_led(temp_x100,
-                                hum_x100,
-                                light_pct_x10,
-                                soil_pct_x10,
-                                &s);
-
-            /* NM3/NM4/NM5: if one hour worth of samples passed, print stats */
-            if (nm_sample_count >= NM_SAMPLES_PER_HOUR) {
-                nm_print_hourly_stats();
-                nm_reset_hour_window();
-            }
-        }
+    if (ev == PC_MODE_EV_BUTTON) {
+        printk("Button pressed -> switching to TEST MODE\n");
+        return PLANTCARE_MODE_TEST;
+    }
 
-        /* Small sleep so we don't busy-loop. Button events are latched
-         * by the ISR in g_button_pressed_event, so we won't miss them.
-         */
-        k_sleep(K_MSEC(50));
+    if (ev == PC_MODE_EV_SNAPSHOT) {
+        nm_sample(k_uptime_get());
+    }
+    if (atomic_cas(&nm_alarms_changed, 1, 0)) {
+        nm_show_alarms();
     }
 
-    /* Leaving NORMAL MODE: optional cleanup.
-     * Turn off LED2 here if you turned it on at entry.
+    /* Report due (an hour old, full, alarm raised, or asked for from the
+     * shell)?
      */
-    // led2_set(false);
-}
\ No newline at end of file
+    plantcare_config_get(&cfg);
+    plantcare_batch_poll(cfg.batch_size, cfg.batch_flush_on_alarm,
+                         k_uptime_get());
+    return PLANTCARE_MODE_STAY;
+}
+
+static void nm_exit(void)
+{
+    /* Don't lose the samples of an unfinished report */
+    plantcare_batch_flush(PC_BATCH_MODE_EXIT);
+}
+
+/* NM8: LED2 (green LED) ON, LED1 OFF in Normal Mode */
+const struct plantcare_mode_desc plantcare_mode_normal = {
+    .name = "normal",
+    .title = "NORMAL",
+    .sampling_period_ms = NM_SAMPLE_PERIOD_MS,
+    .tick_ms = NM_TICK_MS,
+    .led1 = LED_ANIM_PATTERN_OFF,
+    .led2 = LED_ANIM_PATTERN_ON,
+    .enter = nm_enter,
+    .exit = nm_exit,
+    .event = nm_event,
+};
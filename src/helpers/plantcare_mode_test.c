@@ -6,120 +6,169 @@
 
 #include "plantcare_state.h"
 #include "plantcare_config.h"
+#include "plantcare_modes.h"
 #include "plantcare_units.h"
+#include "plantcare_output.h"
 
-#include "sensors/led1.h"
-#include "sensors/leds.h"
+#include "sensors/led_anim.h"
 #include "sensors/button.h"
 
-void plantcare_run_test_mode(void)
+/* Holding the button this long in TEST MODE enters CALIBRATION MODE */
+#define TM_LONG_PRESS_MS   2000
+
+/* How often a held button is looked at */
+#define TM_HOLD_POLL_MS    20
+
+/* Uptime of the press being held, 0 if none */
+static int64_t tm_press_ms;
+
+/* TM4: dominant colour from the hue (IR-free, clear-normalised), so a
+ * grow light's red peak no longer wins on raw counts. Off when too dark
+ * to tell (no CCT).
+ */
+static enum led_anim_color tm_hue_color(const struct plantcare_data *s)
 {
-    struct plantcare_data s;
+    if (s->cct_k == 0) {
+        return LED_ANIM_BLACK;
+    }
+    if (s->hue_x10 < 600 || s->hue_x10 >= 3000) {
+        return LED_ANIM_RED;
+    }
+    return (s->hue_x10 < 1800) ? LED_ANIM_GREEN : LED_ANIM_BLUE;
+}
+
+/* TM2/TM3: human-readable dump of one snapshot */
+static void tm_print_text(const struct plantcare_data *s)
+{
+    printk("\n================ TEST MODE =================\n");
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        /* Convert soil + light RAW readings to percentage *10 */
+        int32_t soil_pct_x10  = soil_raw_to_pct_x10(s->plants[p].soil_raw);
+        int32_t light_pct_x10 = light_raw_to_pct_x10(s->plants[p].light_raw);
+
+        if (PLANTCARE_PLANT_COUNT > 1) {
+            printk("PLANT %d\n", p);
+        }
 
-    /* Mark current mode + sampling period for background thread */
-    g_current_mode       = PLANTCARE_MODE_TEST;
-    g_sampling_period_ms = 2000;      /* sensor thread: sample every 2 seconds */
+        printk("SOIL MOISTURE:  %d.%01d%%\n",
+               soil_pct_x10 / 10,
+               soil_pct_x10 % 10);
 
-    /* TM5: LED1 (blue LED) ON in Test Mode */
-    led1_set(true);
+        printk("LIGHT:          %d.%01d%%\n",
+               light_pct_x10 / 10,
+               light_pct_x10 % 10);
+    }
+
+    printk("TEMP/HUM: Temperature: %d.%02d C,  "
+           "Relative Humidity: %d.%02d%%\n",
+           s->temp_x100 / 100, s->temp_x100 % 100,
+           s->hum_x100  / 100, s->hum_x100  % 100);
+
+    /* Accelerometer: g*100 -> (m/s^2)*100 via helper */
+    int32_t ax_ms2_x100 = accel_g100_to_ms2_x100(s->acc_x_g100);
+    int32_t ay_ms2_x100 = accel_g100_to_ms2_x100(s->acc_y_g100);
+    int32_t az_ms2_x100 = accel_g100_to_ms2_x100(s->acc_z_g100);
+
+    int32_t ax_abs = (ax_ms2_x100 >= 0) ? ax_ms2_x100 : -ax_ms2_x100;
+    int32_t ay_abs = (ay_ms2_x100 >= 0) ? ay_ms2_x100 : -ay_ms2_x100;
+    int32_t az_abs = (az_ms2_x100 >= 0) ? az_ms2_x100 : -az_ms2_x100;
+
+    printk("ACCELEROMETERS: X_axis: %s%d.%02d m/s^2, "
+           "Y_axis: %s%d.%02d m/s^2, "
+           "Z_axis: %s%d.%02d m/s^2\n",
+           (ax_ms2_x100 < 0) ? "-" : "", ax_abs / 100, ax_abs % 100,
+           (ay_ms2_x100 < 0) ? "-" : "", ay_abs / 100, ay_abs % 100,
+           (az_ms2_x100 < 0) ? "-" : "", az_abs / 100, az_abs % 100);
+    plantcare_output_tilt(&s->tilt);
+
+    printk("COLOR SENSOR: Clear=%u, Red=%u, Green=%u, Blue=%u\n",
+           s->clr, s->red, s->green, s->blue);
+    printk("COLOR: Hue=%u.%u deg, CCT=%u K, Lux=%u, Leaf=%s\n",
+           s->hue_x10 / 10, s->hue_x10 % 10, s->cct_k, s->lux,
+           plantcare_leaf_class_name(s->leaf_class));
+
+    if (s->gps_last_sentence[0] != '\0') {
+        printk("GPS LAST NMEA: %s\n", s->gps_last_sentence);
+    } else {
+        printk("GPS LAST NMEA: (no data yet)\n");
+    }
+}
 
-    printk("\n===== ENTERING TEST MODE =====\n");
+static void tm_enter(void)
+{
+    tm_press_ms = 0;
     printk("Press button to switch to NORMAL MODE.\n");
+    printk("Hold button for 2 s to enter CALIBRATION MODE.\n");
+}
 
-    /* For "every 2 seconds" behavior using uptime */
-    int64_t last_print_ms = k_uptime_get();
+/* TM2/TM3: one cycle every tick (2 s) */
+static void tm_tick(void)
+{
+    struct plantcare_data s;
 
-    while (g_current_mode == PLANTCARE_MODE_TEST) {
+    /* Take snapshot from background sensor thread */
+    plantcare_state_get_snapshot(&s);
 
-        /* 1) Handle button event if ISR has set the flag */
-        if (g_button_pressed_event) {
-            g_button_pressed_event = false;  /* consume event */
+    /* TM4: RGB LED colored as dominant color from sensor */
+    led_anim_rgb_solid(tm_hue_color(&s));
 
-            printk("Button pressed -> switching to NORMAL MODE\n");
-            g_current_mode = PLANTCARE_MODE_NORMAL;
-            break;  /* leave TEST MODE function */
-        }
+    if (plantcare_config_output_format() == PLANTCARE_OUTPUT_CSV) {
+        plantcare_output_csv(&s);
+    } else {
+        tm_print_text(&s);
+    }
+}
 
-        /* 2) Check if it’s time to print (every ~2000 ms) */
-        int64_t now = k_uptime_get();
-        if ((now - last_print_ms) >= 2000) {
-            last_print_ms = now;
-
-            /* Take snapshot from background sensor thread */
-            plantcare_state_get_snapshot(&s);
-
-            /* TM4: RGB LED colored as dominant color from sensor */
-            bool r = false, g = false, b = false;
-            switch (s.dom_color) {
-            case DOM_COLOR_RED:   r = true; break;
-            case DOM_COLOR_GREEN: g = true; break;
-            case DOM_COLOR_BLUE:  b = true; break;
-            default: break;
-            }
-            rgb_set(r, g, b);
-
-            /* Convert soil + light RAW readings to percentage *10 */
-            int32_t soil_pct_x10  = soil_raw_to_pct_x10(s.soil_raw);
-            int32_t light_pct_x10 = light_raw_to_pct_x10(s.light_raw);
-
-            printk("\n================ TEST MODE =================\n");
-
-            printk("SOIL MOISTURE:  %d.%01d%%\n",
-                   soil_pct_x10 / 10,
-                   soil_pct_x10 % 10);
-
-            printk("LIGHT:          %d.%01d%%\n",
-                   light_pct_x10 / 10,
-                   light_pct_x10 % 10);
-
-            printk("TEMP/HUM: Temperature: %d.%02d C,  "
-                   "Relative Humidity: %d.%02d%%\n",
-                   s.temp_x100 / 100, s.temp_x100 % 100,
-                   s.hum_x100  / 100, s.hum_x100  % 100);
-
-            /* Accelerometer: g*100 -> (m/s^2)*100 via helper */
-            int32_t ax_ms2_x100 = accel_g100_to_ms2_x100(s.acc_x_g100);
-            int32_t ay_ms2_x100 = accel_g100_to_ms2_x100(s.acc_y_g100);
-            int32_t az_ms2_x100 = accel_g100_to_ms2_x100(s.acc_z_g100);
-
-            int32_t ax_abs = (ax_ms2_x100 >= 0) ? ax_ms2_x100 : -ax_ms2_x100;
-            int32_t ay_abs = (ay_ms2_x100 >= 0) ? ay_ms2_x100 : -ay_ms2_x100;
-            int32_t az_abs = (az_ms2_x100 >= 0) ? az_ms2_x100 : -az_ms2_x100;
-
-            printk("ACCELEROMETERS: X_axis: %s%d.%02d m/s^2, "
-                   "Y_axis: %s%d.%02d m/s^2, "
-                   "Z_axis: %s%d.%02d m/s^2\n",
-                   (ax_ms2_x100 < 0) ? "-" : "", ax_abs / 100, ax_abs % 100,
-                   (ay_ms2_x100 < 0) ? "-" : "", ay_abs / 100, ay_abs % 100,
-                   (az_ms2_x100 < 0) ? "-" : "", az_abs / 100, az_abs % 100);
-
-            printk("COLOR SENSOR: Clear=%u, Red=%u, Green=%u, Blue=%u, Dominant=",
-                   s.clr, s.red, s.green, s.blue);
-            switch (s.dom_color) {
-            case DOM_COLOR_RED:   printk("RED\n");   break;
-            case DOM_COLOR_GREEN: printk("GREEN\n"); break;
-            case DOM_COLOR_BLUE:  printk("BLUE\n");  break;
-            default:              printk("UNKNOWN\n"); break;
-            }
-
-            if (s.gps_last_sentence[0] != '\0') {
-                printk("GPS LAST NMEA: %s\n", s.gps_last_sentence);
-            } else {
-                printk("GPS LAST NMEA: (no data yet)\n");
-            }
-
-            /* That completes one "TM2/TM3" cycle (every ~2 seconds). */
-        }
+/* A press is followed with early ticks until the button is released
+ * (NORMAL) or has been held for TM_LONG_PRESS_MS (CALIBRATION)
+ */
+static int tm_hold(void)
+{
+    if (!button_is_pressed()) {
+        tm_press_ms = 0;
+        printk("Button pressed -> switching to NORMAL MODE\n");
+        return PLANTCARE_MODE_NORMAL;
+    }
+    if ((k_uptime_get() - tm_press_ms) >= TM_LONG_PRESS_MS) {
+        tm_press_ms = 0;
+        printk("Button held -> switching to CALIBRATION MODE\n");
+        return PLANTCARE_MODE_CALIBRATION;
+    }
 
-        /* 3) Small sleep so we don't spin at 100% CPU.
-         *    Button detection does NOT depend on this anymore,
-         *    the ISR already latched the event in g_button_pressed_event.
-         */
-        k_sleep(K_MSEC(50));
+    plantcare_mode_tick_after(TM_HOLD_POLL_MS);
+    return PLANTCARE_MODE_STAY;
+}
+
+static int tm_event(enum plantcare_mode_event ev)
+{
+    if (ev == PC_MODE_EV_BUTTON) {
+        /* Contact bounce while held adds nothing */
+        if (tm_press_ms == 0) {
+            tm_press_ms = k_uptime_get();
+        }
+        return tm_hold();
     }
 
-    /* Leaving TEST MODE: optional cleanup (e.g. turn off LED1) */
-    if (g_current_mode != PLANTCARE_MODE_TEST) {
-        led1_set(false);
+    if (ev != PC_MODE_EV_TICK) {
+        return PLANTCARE_MODE_STAY;
+    }
+    if (tm_press_ms != 0) {
+        return tm_hold();
     }
-}
\ No newline at end of file
+
+    tm_tick();
+    return PLANTCARE_MODE_STAY;
+}
+
+/* TM5: LED1 (blue LED) ON in Test Mode; sensor thread samples every 2 s */
+const struct plantcare_mode_desc plantcare_mode_test = {
+    .name = "test",
+    .title = "TEST",
+    .sampling_period_ms = 2000,
+    .tick_ms = 2000,
+    .led1 = LED_ANIM_PATTERN_ON,
+    .led2 = LED_ANIM_PATTERN_OFF,
+    .enter = tm_enter,
+    .event = tm_event,
+};
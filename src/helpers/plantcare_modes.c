@@ -0,0 +1,172 @@
+// src/helpers/plantcare_modes.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+#include "plantcare_modes.h"
+#include "plantcare_config.h"
+
+#include "sensors/led_anim.h"
+
+/* The mode table: one row per plantcare_mode_t */
+static const struct plantcare_mode_desc *const mode_table[] = {
+    [PLANTCARE_MODE_TEST]        = &plantcare_mode_test,
+    [PLANTCARE_MODE_NORMAL]      = &plantcare_mode_normal,
+    [PLANTCARE_MODE_CALIBRATION] = &plantcare_mode_calib,
+};
+
+BUILD_ASSERT(ARRAY_SIZE(mode_table) == PLANTCARE_MODE_COUNT,
+             "every plantcare_mode_t needs a row in mode_table");
+
+static plantcare_mode_t current;
+static int64_t next_tick_ms;
+static bool tick_requested;
+
+/* The last press, until it makes a switch or the mode lets it go */
+static bool press_pending;
+static uint32_t press_isr;
+static uint32_t press_woke;
+
+/* Latency of button-driven switches; the shell reads it */
+static struct k_spinlock lat_lock;
+static struct plantcare_mode_latency lat;
+static uint64_t lat_total_us;
+
+const char *plantcare_mode_name(plantcare_mode_t m)
+{
+    return ((unsigned int)m < PLANTCARE_MODE_COUNT) ? mode_table[m]->name : "?";
+}
+
+static void mode_enter(plantcare_mode_t m)
+{
+    const struct plantcare_mode_desc *d = mode_table[m];
+
+    current = m;
+    plantcare_config_set(m, d->sampling_period_ms);
+
+    led_anim_led1(d->led1);
+    led_anim_led2(d->led2);
+    led_anim_rgb_solid(LED_ANIM_BLACK);
+
+    printk("\n===== ENTERING %s MODE =====\n", d->title);
+    if (d->enter) {
+        d->enter();
+    }
+    next_tick_ms = k_uptime_get() + d->tick_ms;
+}
+
+static void mode_switch(int next)
+{
+    if (next < 0 || next >= PLANTCARE_MODE_COUNT) {
+        next = PLANTCARE_MODE_TEST;
+    }
+    if (mode_table[current]->exit) {
+        mode_table[current]->exit();
+    }
+    mode_enter((plantcare_mode_t)next);
+}
+
+static void latency_record(uint32_t isr, uint32_t woke, uint32_t decided)
+{
+    uint32_t done = k_cycle_get_32();
+    uint32_t wake_us   = k_cyc_to_us_floor32(woke - isr);
+    uint32_t decide_us = k_cyc_to_us_floor32(decided - woke);
+    uint32_t swap_us   = k_cyc_to_us_floor32(done - decided);
+
+    k_spinlock_key_t key = k_spin_lock(&lat_lock);
+
+    lat.switches++;
+    lat.last_wake_us   = wake_us;
+    lat.last_decide_us = decide_us;
+    lat.last_swap_us   = swap_us;
+    lat.max_wake_us    = MAX(lat.max_wake_us, wake_us);
+    lat.max_swap_us    = MAX(lat.max_swap_us, swap_us);
+    lat_total_us      += (uint64_t)wake_us + decide_us + swap_us;
+    lat.mean_total_us  = (uint32_t)(lat_total_us / lat.switches);
+    k_spin_unlock(&lat_lock, key);
+}
+
+void plantcare_mode_tick_after(uint32_t ms)
+{
+    next_tick_ms = k_uptime_get() + ms;
+    tick_requested = true;
+}
+
+/* Dispatch one event. The press stays pending only while the mode is
+ * following it up with early ticks; snapshots do not touch it.
+ */
+static void mode_dispatch(enum plantcare_mode_event ev)
+{
+    bool press_ev = (ev != PC_MODE_EV_SNAPSHOT);
+
+    tick_requested = false;
+
+    int next = mode_table[current]->event(ev);
+
+    if (next == PLANTCARE_MODE_STAY) {
+        if (press_ev && !tick_requested) {
+            press_pending = false;
+        }
+        return;
+    }
+
+    uint32_t decided = k_cycle_get_32();
+    bool timed = press_ev && press_pending;
+
+    press_pending = false;
+    mode_switch(next);
+    if (timed) {
+        latency_record(press_isr, press_woke, decided);
+    }
+}
+
+void plantcare_mode_get_latency(struct plantcare_mode_latency *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&lat_lock);
+
+    *out = lat;
+    k_spin_unlock(&lat_lock, key);
+}
+
+void plantcare_mode_start(plantcare_mode_t initial)
+{
+    mode_enter(((unsigned int)initial < PLANTCARE_MODE_COUNT) ?
+               initial : PLANTCARE_MODE_TEST);
+}
+
+void plantcare_mode_run(void)
+{
+    while (1) {
+        int64_t wait_ms = MAX(next_tick_ms - k_uptime_get(), 0);
+        uint32_t isr = 0;
+
+        plantcare_mode_checkin();
+
+        /* Asleep until something happens; no polling for the button */
+        enum plantcare_wake w = plantcare_wait_event(
+            K_MSEC(MIN(wait_ms, PLANTCARE_MODE_WDT_MS / 2)), &isr);
+        uint32_t woke = k_cycle_get_32();
+
+        /* A mode set from the shell goes first, whatever woke us: the
+         * config already holds it, and the next entry would overwrite it.
+         * Our own entry publishes the mode we are in, which is a no-op.
+         */
+        if (plantcare_config_mode() != current) {
+            press_pending = false;
+            mode_switch(plantcare_config_mode());
+        }
+
+        if (w == PC_WAKE_BUTTON) {
+            press_pending = true;
+            press_isr = isr;
+            press_woke = woke;
+            mode_dispatch(PC_MODE_EV_BUTTON);
+        } else if (w == PC_WAKE_SNAPSHOT) {
+            mode_dispatch(PC_MODE_EV_SNAPSHOT);
+        } else if (w == PC_WAKE_TIMEOUT && k_uptime_get() >= next_tick_ms) {
+            next_tick_ms = k_uptime_get() + mode_table[current]->tick_ms;
+            mode_dispatch(PC_MODE_EV_TICK);
+        }
+    }
+}
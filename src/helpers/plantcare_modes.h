@@ -1,7 +1,97 @@
 #ifndef PLANTCARE_MODES_H
 #define PLANTCARE_MODES_H
 
-void plantcare_run_test_mode(void);
-void plantcare_run_normal_mode(void);
+#include <stdint.h>
 
-#endif /* PLANTCARE_MODES_H */
\ No newline at end of file
+#include "plantcare_config.h"
+
+/*
+ * Mode state machine (plantcare_modes.c), run by the main thread.
+ *
+ * Each mode is a const struct plantcare_mode_desc in its own file, listed
+ * in the mode table in plantcare_modes.c. On entry the machine publishes
+ * the mode's sampling period, sets the board LEDs, prints the banner,
+ * then calls enter(). In between, the mode thread sleeps until a button
+ * press, a config change, a new snapshot or the mode's next tick,
+ * whichever comes first.
+ * A press goes straight to the mode's event handler; a mode change from
+ * the shell is a transition like any other. The mode being left gets its
+ * exit() first.
+ *
+ * Handlers return quickly and never wait for the button themselves: a
+ * multi-step mode keeps its own step and is advanced by the next event.
+ * That way a mode set from the shell is taken at the next wake, whatever
+ * the current mode is doing.
+ *
+ * Adding a mode: a PLANTCARE_MODE_x value, a file with its descriptor,
+ * and a row in the table. main.c does not change.
+ */
+
+enum plantcare_mode_event {
+    PC_MODE_EV_TICK = 0,    /* every tick_ms */
+    PC_MODE_EV_BUTTON,      /* button pressed (the ISR edge) */
+    PC_MODE_EV_SNAPSHOT,    /* sensor thread published; see fresh_mask */
+};
+
+/* Event handler result: stay in the current mode */
+#define PLANTCARE_MODE_STAY     (-1)
+
+struct plantcare_mode_desc {
+    const char *name;               /* "pc mode" name */
+    const char *title;              /* "===== ENTERING <title> MODE =====" */
+    uint32_t sampling_period_ms;    /* published on entry */
+    uint32_t tick_ms;               /* PC_MODE_EV_TICK period, 0 = back to back */
+    uint32_t led1;                  /* LED_ANIM_PATTERN_* on entry */
+    uint32_t led2;
+
+    void (*enter)(void);            /* optional */
+    void (*exit)(void);             /* optional */
+
+    /* Returns the mode to switch to, or PLANTCARE_MODE_STAY */
+    int (*event)(enum plantcare_mode_event ev);
+};
+
+extern const struct plantcare_mode_desc plantcare_mode_test;
+extern const struct plantcare_mode_desc plantcare_mode_normal;
+extern const struct plantcare_mode_desc plantcare_mode_calib;
+
+/* Enter the first mode, which publishes the first configuration. Call
+ * before plantcare_boot_ready().
+ */
+void plantcare_mode_start(plantcare_mode_t initial);
+
+/* Run the machine. Never returns. */
+void plantcare_mode_run(void);
+
+/* From an event handler: next PC_MODE_EV_TICK in ms instead of the
+ * mode's tick_ms, e.g. to watch a button being held. A press the handler
+ * follows up this way still counts for the latency below if a later tick
+ * makes the switch.
+ */
+void plantcare_mode_tick_after(uint32_t ms);
+
+/* Shell name of mode m, "?" if there is no such mode */
+const char *plantcare_mode_name(plantcare_mode_t m);
+
+/* Button-to-mode-switch latency, for every switch made by a press:
+ *   wake    button ISR until the mode thread runs
+ *   decide  press until the handler decided (a long press is in here)
+ *   swap    exit() of the old mode and entry of the new one
+ */
+struct plantcare_mode_latency {
+    uint32_t switches;
+    uint32_t last_wake_us;
+    uint32_t last_decide_us;
+    uint32_t last_swap_us;
+    uint32_t max_wake_us;
+    uint32_t max_swap_us;
+    uint32_t mean_total_us;
+};
+
+void plantcare_mode_get_latency(struct plantcare_mode_latency *out);
+
+/* Mode loops call this at least every PLANTCARE_MODE_WDT_MS (watchdog) */
+#define PLANTCARE_MODE_WDT_MS   5000
+void plantcare_mode_checkin(void);
+
+#endif /* PLANTCARE_MODES_H */
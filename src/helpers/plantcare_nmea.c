@@ -0,0 +1,175 @@
+// src/helpers/plantcare_nmea.c
+
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <string.h>
+
+#include "plantcare_nmea.h"
+
+/*
+ * Minimal NMEA 0183 field parsing, integers only. Lines come from the
+ * sensor thread's GPS reader without CR/LF.
+ */
+
+#define RMC_FIELDS  9       /* the ones we use: up to the date */
+
+static int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+uint8_t plantcare_nmea_checksum(const char *body, size_t len)
+{
+    uint8_t cs = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        cs ^= (uint8_t)body[i];
+    }
+    return cs;
+}
+
+bool plantcare_nmea_checksum_ok(const char *line)
+{
+    const char *star;
+
+    if (line[0] != '$' || (star = strchr(line, '*')) == NULL) {
+        return false;
+    }
+
+    int hi = hex_digit(star[1]);
+    int lo = (hi < 0) ? -1 : hex_digit(star[2]);
+
+    if (lo < 0) {
+        return false;
+    }
+    return plantcare_nmea_checksum(line + 1, star - line - 1) ==
+           (uint8_t)((hi << 4) | lo);
+}
+
+/* n decimal digits at s, -1 if any is not a digit */
+static int32_t digits(const char *s, int n)
+{
+    int32_t v = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return -1;
+        }
+        v = v * 10 + (s[i] - '0');
+    }
+    return v;
+}
+
+/* Field length up to ',' or '*' */
+static int field_len(const char *f)
+{
+    int n = 0;
+
+    while (f[n] != ',' && f[n] != '*' && f[n] != '\0') {
+        n++;
+    }
+    return n;
+}
+
+/* "dddmm.mmmmm" with deg_digits degree digits -> degrees * 1e7 */
+static int parse_coord(const char *f, int len, int deg_digits,
+                       char hemi, int32_t *out)
+{
+    if (len < deg_digits + 2) {
+        return -EINVAL;
+    }
+
+    int32_t deg = digits(f, deg_digits);
+    int32_t min = digits(f + deg_digits, 2);
+
+    if (deg < 0 || min < 0) {
+        return -EINVAL;
+    }
+
+    /* Fraction of a minute, up to 5 digits -> minutes * 1e5 */
+    int32_t min_e5 = min * 100000;
+    const char *p = f + deg_digits + 2;
+
+    if (p < f + len && *p == '.') {
+        int32_t scale = 10000;
+
+        for (p++; p < f + len && scale > 0; p++, scale /= 10) {
+            if (*p < '0' || *p > '9') {
+                return -EINVAL;
+            }
+            min_e5 += (*p - '0') * scale;
+        }
+    }
+
+    /* 1e7 / 60 / 1e5 = 10 / 6 */
+    int32_t v = deg * 10000000 + (min_e5 * 10) / 6;
+
+    *out = (hemi == 'S' || hemi == 'W') ? -v : v;
+    return 0;
+}
+
+int plantcare_nmea_parse_rmc(const char *line, struct plantcare_nmea_rmc *out)
+{
+    const char *f[RMC_FIELDS];
+    const char *p = line;
+
+    if (!plantcare_nmea_checksum_ok(line) || strlen(line) < 7 ||
+        memcmp(line + 3, "RMC,", 4) != 0) {
+        return -EINVAL;
+    }
+
+    /* f[0] is the time field, f[8] the date */
+    for (int i = 0; i < RMC_FIELDS; i++) {
+        p = strchr(p, ',');
+        if (p == NULL) {
+            return -EINVAL;
+        }
+        f[i] = ++p;
+    }
+
+    *out = (struct plantcare_nmea_rmc){ 0 };
+
+    /* hhmmss[.sss] and ddmmyy */
+    if (field_len(f[0]) < 6 || field_len(f[8]) != 6) {
+        return -ENODATA;
+    }
+
+    int32_t hh = digits(f[0], 2), mi = digits(f[0] + 2, 2);
+    int32_t ss = digits(f[0] + 4, 2);
+    int32_t dd = digits(f[8], 2), mo = digits(f[8] + 2, 2);
+    int32_t yy = digits(f[8] + 4, 2);
+
+    if (hh < 0 || hh > 23 || mi < 0 || mi > 59 || ss < 0 || ss > 60 ||
+        dd < 1 || dd > 31 || mo < 1 || mo > 12 || yy < 0) {
+        return -EINVAL;
+    }
+
+    out->utc.year  = (uint16_t)(2000 + yy);
+    out->utc.month = (uint8_t)mo;
+    out->utc.day   = (uint8_t)dd;
+    out->utc.hour  = (uint8_t)hh;
+    out->utc.min   = (uint8_t)mi;
+    out->utc.sec   = (uint8_t)MIN(ss, 59);
+
+    /* Fraction: up to three digits after the point */
+    if (f[0][6] == '.') {
+        int32_t scale = 100;
+
+        for (const char *q = f[0] + 7; *q >= '0' && *q <= '9' && scale > 0;
+             q++, scale /= 10) {
+            out->ms += (uint16_t)((*q - '0') * scale);
+        }
+    }
+
+    out->valid = (*f[1] == 'A');
+    if (out->valid) {
+        if (parse_coord(f[2], field_len(f[2]), 2, *f[3], &out->lat_e7) < 0 ||
+            parse_coord(f[4], field_len(f[4]), 3, *f[5], &out->lon_e7) < 0) {
+            out->valid = false;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef PLANTCARE_NMEA_H
+#define PLANTCARE_NMEA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "plantcare_time.h"
+
+/* Fields of one $--RMC sentence (any talker: GP, GN, ...) */
+struct plantcare_nmea_rmc {
+    bool     valid;             /* status 'A'; time and date may be set anyway */
+    struct plantcare_civil utc;
+    uint16_t ms;                /* fraction of the second */
+    int32_t  lat_e7;            /* degrees * 1e7, north positive */
+    int32_t  lon_e7;            /* degrees * 1e7, east positive */
+};
+
+/* XOR of the characters between '$' and '*' */
+uint8_t plantcare_nmea_checksum(const char *body, size_t len);
+
+/* True if line is "$...*HH" with a matching checksum */
+bool plantcare_nmea_checksum_ok(const char *line);
+
+/* Parse a checksummed RMC line. Returns 0, -EINVAL if it is not RMC or the
+ * checksum is wrong, -ENODATA if it has no time/date yet.
+ */
+int plantcare_nmea_parse_rmc(const char *line, struct plantcare_nmea_rmc *out);
+
+#endif /* PLANTCARE_NMEA_H */
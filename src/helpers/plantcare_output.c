@@ -0,0 +1,54 @@
+// src/helpers/plantcare_output.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "plantcare_output.h"
+#include "plantcare_units.h"
+
+void plantcare_output_csv_header(void)
+{
+    printk("CSV,uptime_ms,epoch_s,soil_pct_x10,light_pct_x10,temp_x100,hum_x100,"
+           "dew_x100,vpd_pa,acc_x_g100,acc_y_g100,acc_z_g100,pitch_cdeg,roll_cdeg,tilt_cdeg,"
+           "clear,red,green,blue,leaf_class,ppfd_x10,dli_x100,"
+           "soil_rate_x100,soil_eta_min");
+    for (int p = 1; p < PLANTCARE_PLANT_COUNT; p++) {
+        printk(",soil%d_pct_x10,light%d_pct_x10", p, p);
+    }
+    printk("\n");
+}
+
+void plantcare_output_csv(const struct plantcare_data *s)
+{
+    printk("CSV,%u,%u,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%u,%u,%u,%u,%d,%u,%u,%d,%u",
+           k_uptime_get_32(), s->epoch_s,
+           soil_raw_to_pct_x10(s->plants[0].soil_raw),
+           light_raw_to_pct_x10(s->plants[0].light_raw),
+           s->temp_x100, s->hum_x100, s->dew_x100, s->vpd_pa,
+           s->acc_x_g100, s->acc_y_g100, s->acc_z_g100,
+           s->tilt.pitch_cdeg, s->tilt.roll_cdeg, s->tilt.tilt_cdeg,
+           s->clr, s->red, s->green, s->blue,
+           (int)s->leaf_class, s->dli.ppfd_x10, s->dli.today_x100,
+           s->drying[0].rate_x100, s->drying[0].eta_min);
+    for (int p = 1; p < PLANTCARE_PLANT_COUNT; p++) {
+        printk(",%d,%d",
+               soil_raw_to_pct_x10(s->plants[p].soil_raw),
+               light_raw_to_pct_x10(s->plants[p].light_raw));
+    }
+    printk("\n");
+}
+
+void plantcare_output_tilt(const struct plantcare_tilt *t)
+{
+    int32_t pitch = (t->pitch_cdeg >= 0) ? t->pitch_cdeg : -t->pitch_cdeg;
+    int32_t roll  = (t->roll_cdeg  >= 0) ? t->roll_cdeg  : -t->roll_cdeg;
+
+    printk("TILT: pitch=%s%d.%01d deg, roll=%s%d.%01d deg",
+           (t->pitch_cdeg < 0) ? "-" : "", pitch / 100, (pitch % 100) / 10,
+           (t->roll_cdeg  < 0) ? "-" : "", roll  / 100, (roll  % 100) / 10);
+    if (t->tilt_cdeg != PLANTCARE_TILT_NO_REST) {
+        printk(", from rest=%d.%01d deg",
+               t->tilt_cdeg / 100, (t->tilt_cdeg % 100) / 10);
+    }
+    printk("\n");
+}
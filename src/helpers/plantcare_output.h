@@ -0,0 +1,24 @@
+#ifndef PLANTCARE_OUTPUT_H
+#define PLANTCARE_OUTPUT_H
+
+#include "plantcare_state.h"
+
+/* Machine-readable output (PLANTCARE_OUTPUT_CSV), one line per snapshot:
+ *   CSV,uptime_ms,epoch_s,soil_pct_x10,light_pct_x10,temp_x100,hum_x100,
+ *       dew_x100,vpd_pa,acc_x_g100,acc_y_g100,acc_z_g100,
+ *       pitch_cdeg,roll_cdeg,tilt_cdeg,clear,red,green,blue,leaf_class,
+ *       ppfd_x10,dli_x100,soil_rate_x100,soil_eta_min
+ * epoch_s is UTC, 0 until the clock is set. dli_x100 is today's so far.
+ * soil_rate_x100 is %/h * 100 (0 without a fit), soil_eta_min the minutes
+ * until the soil alarm's min, capped at a week. tilt_cdeg is -1 without a
+ * rest pose. soil/light are plant 0; with
+ * more plants soilN_pct_x10,lightN_pct_x10 follow at the end for plants
+ * 1, 2, ...
+ */
+void plantcare_output_csv_header(void);
+void plantcare_output_csv(const struct plantcare_data *s);
+
+/* Text modes: "TILT: pitch=.. deg, roll=.. deg[, from rest=.. deg]" */
+void plantcare_output_tilt(const struct plantcare_tilt *t);
+
+#endif /* PLANTCARE_OUTPUT_H */
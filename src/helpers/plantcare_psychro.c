@@ -0,0 +1,118 @@
+// src/helpers/plantcare_psychro.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <stdint.h>
+
+#include "plantcare_psychro.h"
+
+/* es(T) in Pa << SVP_FRAC for T = -40, -39 .. 80 °C (plantcare_psychro.h) */
+static const uint32_t svp_q[] = {
+       303,    337,    373,    413,    456,    504,    556,    613,    675,    743, /* -40 °C */
+       817,    897,    985,   1080,   1183,   1296,   1417,   1549,   1692,   1846, /* -30 °C */
+      2013,   2193,   2387,   2597,   2823,   3066,   3328,   3610,   3913,   4239, /* -20 °C */
+      4588,   4963,   5365,   5796,   6257,   6751,   7278,   7842,   8445,   9089, /* -10 °C */
+      9775,  10507,  11287,  12119,  13003,  13945,  14946,  16011,  17141,  18342, /*   0 °C */
+     19616,  20968,  22401,  23920,  25529,  27232,  29034,  30940,  32956,  35085, /*  10 °C */
+     37335,  39710,  42217,  44861,  47649,  50588,  53684,  56944,  60376,  63988, /*  20 °C */
+     67786,  71780,  75978,  80388,  85019,  89881,  94983, 100335, 105948, 111831, /*  30 °C */
+    117995, 124453, 131215, 138293, 145699, 153447, 161549, 170018, 178868, 188114, /*  40 °C */
+    197769, 207849, 218370, 229346, 240795, 252733, 265176, 278143, 291652, 305720, /*  50 °C */
+    320368, 335614, 351479, 367982, 385145, 402990, 421537, 440810, 460832, 481627, /*  60 °C */
+    503217, 525629, 548887, 573017, 598045, 623999, 650906, 678794, 707692, 737629, /*  70 °C */
+    768635,                                                                         /*  80 °C */
+};
+
+#define SVP_N           ARRAY_SIZE(svp_q)
+#define SVP_STEP_X100   100
+
+BUILD_ASSERT(PLANTCARE_PSYCHRO_T_MIN_X100 + (SVP_N - 1) * SVP_STEP_X100 ==
+             PLANTCARE_PSYCHRO_T_MAX_X100, "svp_q does not match its range");
+
+/* Pressures are kept in Pa << SVP_FRAC throughout, so the Pa rounding
+ * happens once at the end and the low end of the table (19 Pa at -40 °C)
+ * still has resolution.
+ */
+#define SVP_FRAC        4
+#define SVP_Q(i)        svp_q[i]
+
+/* ea = es * RH_x100 / 10000 by reciprocal-multiply, as in plantcare_units.c:
+ * es is below 2^20 and RH_x100 below 2^14, so the product times
+ * RH_RECIP (27 bits) still fits in 64 bits.
+ */
+#define RH_SHIFT        40
+#define RH_RECIP        ((((uint64_t)1 << RH_SHIFT) + 5000) / 10000)
+
+static uint32_t calls;
+static uint32_t cycles;
+
+static uint32_t svp_at(int32_t temp_x100)
+{
+    int32_t t = CLAMP(temp_x100, PLANTCARE_PSYCHRO_T_MIN_X100,
+                      PLANTCARE_PSYCHRO_T_MAX_X100) - PLANTCARE_PSYCHRO_T_MIN_X100;
+    uint32_t i = (uint32_t)t / SVP_STEP_X100;
+    uint32_t frac = (uint32_t)t % SVP_STEP_X100;
+
+    if (i >= SVP_N - 1) {
+        return SVP_Q(SVP_N - 1);
+    }
+
+    uint32_t lo = SVP_Q(i);
+    uint32_t hi = SVP_Q(i + 1);
+
+    return lo + ((hi - lo) * frac + SVP_STEP_X100 / 2) / SVP_STEP_X100;
+}
+
+/* Inverse of svp_at(): the temperature at which es would be ea */
+static int32_t dew_x100(uint32_t ea)
+{
+    uint32_t lo = 0;
+    uint32_t hi = SVP_N - 1;
+
+    if (ea <= SVP_Q(0)) {
+        return PLANTCARE_PSYCHRO_T_MIN_X100;
+    }
+    if (ea >= SVP_Q(SVP_N - 1)) {
+        return PLANTCARE_PSYCHRO_T_MAX_X100;
+    }
+
+    /* Largest lo with svp_q[lo] <= ea; the table is increasing */
+    while (hi - lo > 1) {
+        uint32_t mid = (lo + hi) / 2;
+
+        if (SVP_Q(mid) <= ea) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    uint32_t a = SVP_Q(lo);
+    uint32_t span = SVP_Q(lo + 1) - a;
+
+    return PLANTCARE_PSYCHRO_T_MIN_X100 + (int32_t)(lo * SVP_STEP_X100) +
+           (int32_t)(((ea - a) * SVP_STEP_X100 + span / 2) / span);
+}
+
+void plantcare_psychro_compute(int32_t temp_x100, int32_t hum_x100,
+                               struct plantcare_psychro *out)
+{
+    uint32_t t0 = k_cycle_get_32();
+    uint32_t rh = (uint32_t)CLAMP(hum_x100, 0, 10000);
+    uint32_t es = svp_at(temp_x100);
+    uint32_t ea = (uint32_t)(((uint64_t)es * rh * RH_RECIP +
+                              ((uint64_t)1 << (RH_SHIFT - 1))) >> RH_SHIFT);
+
+    out->es_pa    = (int32_t)((es + (1u << (SVP_FRAC - 1))) >> SVP_FRAC);
+    out->vpd_pa   = (int32_t)((es - ea + (1u << (SVP_FRAC - 1))) >> SVP_FRAC);
+    out->dew_x100 = MIN(dew_x100(ea), temp_x100);
+
+    cycles += k_cycle_get_32() - t0;
+    calls++;
+}
+
+void plantcare_psychro_get_cost(uint32_t *n, uint32_t *cyc)
+{
+    *n = calls;
+    *cyc = cycles;
+}
@@ -0,0 +1,882 @@
+// src/helpers/plantcare_shell.c
+//
+// "pc" shell commands on the console UART. The shell runs in its own
+// low-priority thread; every command works on copies taken with short
+// locks, so printing never holds anything the sensor thread needs.
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "plantcare_config.h"
+#include "plantcare_modes.h"
+#include "plantcare_state.h"
+#include "plantcare_units.h"
+#include "plantcare_alarm.h"
+#include "plantcare_counters.h"
+#include "plantcare_output.h"
+#include "plantcare_adapt.h"
+#include "plantcare_batch.h"
+#include "plantcare_color.h"
+#include "plantcare_time.h"
+#include "plantcare_vib.h"
+#include "plantcare_tilt.h"
+#include "plantcare_calib.h"
+#include "plantcare_log.h"
+#include "plantcare_export.h"
+#include "plantcare_mem.h"
+#include "plantcare_psychro.h"
+#include "plantcare_dli.h"
+#include "plantcare_drying.h"
+#include "sensor_thread.h"
+#include "sensors/plant_adc.h"
+#include "sensors/i2c_mux.h"
+#include "sensors/gps_sensor.h"
+
+static bool parse_long(const char *str, long *out)
+{
+    char *end;
+
+    *out = strtol(str, &end, 0);
+    return (end != str && *end == '\0');
+}
+
+static void print_snapshot(const struct shell *sh, const struct plantcare_data *s)
+{
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        const struct plant_adc_sample *pl = &s->plants[p];
+        int32_t soil_pct_x10  = soil_raw_to_pct_x10(pl->soil_raw);
+        int32_t light_pct_x10 = light_raw_to_pct_x10(pl->light_raw);
+
+        shell_print(sh, "plant %d soil:  raw=%d mv=%d pct=%d.%01d", p,
+                    pl->soil_raw, pl->soil_mv,
+                    soil_pct_x10 / 10, soil_pct_x10 % 10);
+        shell_print(sh, "plant %d light: raw=%d mv=%d pct=%d.%01d", p,
+                    pl->light_raw, pl->light_mv,
+                    light_pct_x10 / 10, light_pct_x10 % 10);
+    }
+    shell_print(sh, "temp_x100=%d hum_x100=%d dew_x100=%d vpd_pa=%d",
+                s->temp_x100, s->hum_x100, s->dew_x100, s->vpd_pa);
+    shell_print(sh, "accel_g100: x=%d y=%d z=%d",
+                s->acc_x_g100, s->acc_y_g100, s->acc_z_g100);
+    shell_print(sh, "tilt_cdeg: pitch=%d roll=%d from_rest=%d",
+                s->tilt.pitch_cdeg, s->tilt.roll_cdeg, s->tilt.tilt_cdeg);
+    shell_print(sh, "color: c=%u r=%u g=%u b=%u hue_x10=%u cct=%u lux=%u leaf=%s",
+                s->clr, s->red, s->green, s->blue, s->hue_x10, s->cct_k,
+                s->lux, plantcare_leaf_class_name(s->leaf_class));
+    shell_print(sh, "dli: ppfd_x10=%u today_x100=%u yesterday_x100=%u",
+                s->dli.ppfd_x10, s->dli.today_x100, s->dli.yesterday_x100);
+    shell_print(sh, "epoch_s: %u", s->epoch_s);
+    shell_print(sh, "gps: %s",
+                s->gps_last_sentence[0] ? s->gps_last_sentence : "(no data yet)");
+    shell_print(sh, "valid: 0x%02x fresh: 0x%02x", s->valid_mask, s->fresh_mask);
+    for (int ch = 0; ch < PC_AN_CH_COUNT; ch++) {
+        if (s->anomaly[ch] != PC_AN_NONE) {
+            shell_print(sh, "anomaly: %s %s", plantcare_anomaly_channel_name(ch),
+                        plantcare_anomaly_kind_name(s->anomaly[ch]));
+        }
+    }
+}
+
+static int cmd_snapshot(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_data s;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    plantcare_state_get_snapshot(&s);
+    print_snapshot(sh, &s);
+    return 0;
+}
+
+static int cmd_read(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    uint32_t before = plantcare_counter_get(PC_CNT_CYCLES);
+    sensor_thread_trigger();
+
+    /* Wait (bounded) for the sensor thread to finish one cycle */
+    for (int i = 0; i < 100; i++) {
+        if (plantcare_counter_get(PC_CNT_CYCLES) != before) {
+            return cmd_snapshot(sh, 0, NULL);
+        }
+        k_msleep(10);
+    }
+
+    shell_error(sh, "no new sample within 1 s");
+    return -ETIMEDOUT;
+}
+
+static int cmd_counters(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    for (int c = 0; c < PC_CNT_COUNT; c++) {
+        shell_print(sh, "%-14s %u", plantcare_counter_name(c),
+                    plantcare_counter_get(c));
+    }
+    for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+        shell_print(sh, "%-8s reads=%u errors=%u", plantcare_sensor_name(s),
+                    plantcare_counter_sensor_reads(s),
+                    plantcare_counter_sensor_errors(s));
+    }
+
+    struct i2c_mux_stats mux;
+    uint32_t cycles = plantcare_counter_get(PC_CNT_CYCLES);
+
+    i2c_mux_get_stats(&mux);
+    uint32_t per_100 = cycles ? (uint32_t)((uint64_t)mux.switches * 100 / cycles) : 0;
+
+    shell_print(sh, "i2c_mux  switches=%u cached=%u errors=%u (%u.%02u per cycle)",
+                mux.switches, mux.cached, mux.errors,
+                per_100 / 100, per_100 % 100);
+    return 0;
+}
+
+static int cmd_mode(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_mode_cfg cfg;
+    struct plantcare_mode_latency lat;
+
+    if (argc < 2) {
+        plantcare_config_get(&cfg);
+        plantcare_mode_get_latency(&lat);
+        shell_print(sh, "mode=%s period=%u ms format=%s",
+                    plantcare_mode_name(cfg.mode), cfg.sampling_period_ms,
+                    cfg.output_format == PLANTCARE_OUTPUT_CSV ? "csv" : "text");
+        shell_print(sh, "switches=%u last: wake=%u decide=%u swap=%u us",
+                    lat.switches, lat.last_wake_us, lat.last_decide_us,
+                    lat.last_swap_us);
+        shell_print(sh, "max: wake=%u swap=%u us, mean total=%u us",
+                    lat.max_wake_us, lat.max_swap_us, lat.mean_total_us);
+        return 0;
+    }
+
+    for (int m = 0; m < PLANTCARE_MODE_COUNT; m++) {
+        if (strcmp(argv[1], plantcare_mode_name((plantcare_mode_t)m)) == 0) {
+            plantcare_config_set_mode((plantcare_mode_t)m);
+            return 0;
+        }
+    }
+
+    shell_error(sh, "unknown mode '%s'", argv[1]);
+    return -EINVAL;
+}
+
+static int cmd_period(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_mode_cfg cfg;
+    long ms;
+
+    if (argc < 2) {
+        plantcare_config_get(&cfg);
+        for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+            shell_print(sh, "%-8s %u ms%s", plantcare_sensor_name(s),
+                        cfg.sensor_period_ms[s] ? cfg.sensor_period_ms[s]
+                                                : cfg.sampling_period_ms,
+                        cfg.sensor_period_ms[s] ? "" : " (mode)");
+        }
+        return 0;
+    }
+
+    if (argc < 3 || !parse_long(argv[2], &ms) || ms < 0) {
+        shell_error(sh, "usage: pc period <sensor|all> <ms, 0 = mode default>");
+        return -EINVAL;
+    }
+
+    for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+        if (strcmp(argv[1], "all") == 0 ||
+            strcmp(argv[1], plantcare_sensor_name(s)) == 0) {
+            (void)plantcare_config_set_sensor_period(s, (uint32_t)ms);
+            if (strcmp(argv[1], "all") != 0) {
+                return 0;
+            }
+        }
+    }
+
+    if (strcmp(argv[1], "all") == 0) {
+        return 0;
+    }
+
+    shell_error(sh, "unknown sensor '%s'", argv[1]);
+    return -EINVAL;
+}
+
+/* pc adapt [off | <floor_ms> <ceiling_ms>] */
+static int cmd_adapt(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_mode_cfg cfg;
+    struct plantcare_adapt_stats st;
+    long floor_ms, ceiling_ms;
+
+    if (argc == 2 && strcmp(argv[1], "off") == 0) {
+        return plantcare_config_set_adaptive(0, 0);
+    }
+    if (argc == 3) {
+        if (!parse_long(argv[1], &floor_ms) || floor_ms < 0 ||
+            !parse_long(argv[2], &ceiling_ms) || ceiling_ms < floor_ms) {
+            shell_error(sh, "usage: pc adapt [off | <floor_ms> <ceiling_ms>]");
+            return -EINVAL;
+        }
+        return plantcare_config_set_adaptive((uint32_t)floor_ms,
+                                             (uint32_t)ceiling_ms);
+    }
+
+    plantcare_config_get(&cfg);
+    if (cfg.adapt_ceiling_ms) {
+        shell_print(sh, "adaptive: floor=%u ms%s ceiling=%u ms",
+                    cfg.adapt_floor_ms,
+                    cfg.adapt_floor_ms ? "" : " (sensor period)",
+                    cfg.adapt_ceiling_ms);
+    } else {
+        shell_print(sh, "adaptive: off");
+    }
+
+    uint32_t total_uj = 0;
+    for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+        plantcare_adapt_get_stats(s, &st);
+        shell_print(sh, "%-8s period=%u ms reads=%u (fixed rate: %u) saved=%u uJ",
+                    plantcare_sensor_name(s), st.period_ms, st.reads,
+                    st.floor_reads, st.saved_uj);
+        total_uj += st.saved_uj;
+    }
+    shell_print(sh, "total saved: %u uJ", total_uj);
+    return 0;
+}
+
+/* pc batch [flush | <size> [alarm|noalarm]] */
+static int cmd_batch(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_mode_cfg cfg;
+    struct plantcare_batch_stats st;
+    long size;
+
+    plantcare_config_get(&cfg);
+
+    if (argc >= 2 && strcmp(argv[1], "flush") == 0) {
+        plantcare_batch_request_flush();
+        return 0;
+    }
+    if (argc >= 2) {
+        bool on_alarm = cfg.batch_flush_on_alarm;
+
+        if (!parse_long(argv[1], &size) || size < 0 ||
+            size > PLANTCARE_BATCH_MAX) {
+            shell_error(sh, "usage: pc batch [flush | <0..%d> [alarm|noalarm]]",
+                        PLANTCARE_BATCH_MAX);
+            return -EINVAL;
+        }
+        if (argc >= 3) {
+            on_alarm = (strcmp(argv[2], "alarm") == 0);
+        }
+        return plantcare_config_set_batch((uint16_t)size, on_alarm);
+    }
+
+    plantcare_batch_get_stats(&st);
+    shell_print(sh, "batch size=%u%s flush-on-alarm=%s",
+                cfg.batch_size, cfg.batch_size ? "" : " (per-sample output)",
+                cfg.batch_flush_on_alarm ? "on" : "off");
+    shell_print(sh, "pending=%u reports=%u samples=%u bytes=%u (%u per sample)",
+                st.pending, st.reports, st.samples, st.bytes,
+                st.samples ? st.bytes / st.samples : 0);
+    return 0;
+}
+
+static int cmd_plants(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    shell_print(sh, "plants: %d, ADC channels: %u, last scan: %u us",
+                PLANTCARE_PLANT_COUNT, plant_adc_channel_count(),
+                plant_adc_last_scan_us());
+    shell_print(sh, "snapshot: %u B (%u B per plant)",
+                (unsigned)sizeof(struct plantcare_data),
+                (unsigned)sizeof(struct plant_adc_sample));
+    return 0;
+}
+
+/* pc color [<class> <r_pm> <g_pm> <b_pm>] */
+static int cmd_color(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_leaf_centroid c;
+    struct plantcare_color_result res;
+    struct plantcare_data s;
+    long r, g, b;
+
+    if (argc >= 2) {
+        uint8_t cls = PC_LEAF_UNKNOWN;
+
+        for (uint8_t i = PC_LEAF_HEALTHY; i < PC_LEAF_CLASS_COUNT; i++) {
+            if (strcasecmp(argv[1], plantcare_leaf_class_name(i)) == 0) {
+                cls = i;
+            }
+        }
+        if (argc != 5 || cls == PC_LEAF_UNKNOWN ||
+            !parse_long(argv[2], &r) || !parse_long(argv[3], &g) ||
+            !parse_long(argv[4], &b) || r < 0 || g < 0 || b < 0) {
+            shell_error(sh, "usage: pc color [<healthy|yellowing|browning> "
+                        "<r_pm> <g_pm> <b_pm>]");
+            return -EINVAL;
+        }
+        c = (struct plantcare_leaf_centroid){ r, g, b };
+        return plantcare_color_set_centroid(cls, &c);
+    }
+
+    /* Re-run the pipeline on the snapshot to show the chromaticity */
+    plantcare_state_get_snapshot(&s);
+    plantcare_color_process(s.clr, s.red, s.green, s.blue, &res);
+
+    shell_print(sh, "chroma r=%u g=%u b=%u pm%s, hue=%u.%u deg, cct=%u K, "
+                "lux=%u, leaf=%s",
+                res.r_pm, res.g_pm, res.b_pm,
+                res.saturated ? " (saturated)" : "",
+                res.hue_x10 / 10, res.hue_x10 % 10, res.cct_k, res.lux,
+                plantcare_leaf_class_name(res.leaf_class));
+    for (uint8_t i = PC_LEAF_HEALTHY; i < PC_LEAF_CLASS_COUNT; i++) {
+        plantcare_color_get_centroid(i, &c);
+        shell_print(sh, "%-10s r=%u g=%u b=%u pm",
+                    plantcare_leaf_class_name(i), c.r_pm, c.g_pm, c.b_pm);
+    }
+    return 0;
+}
+
+/* pc time [<zone>] */
+static int cmd_time(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_time_stats st;
+    char when[40];
+
+    if (argc >= 2) {
+        if (plantcare_time_set_zone(argv[1]) < 0) {
+            shell_error(sh, "unknown zone, one of:");
+            for (size_t i = 0; plantcare_time_zone_list(i); i++) {
+                shell_fprintf(sh, SHELL_NORMAL, " %s",
+                              plantcare_time_zone_list(i));
+            }
+            shell_print(sh, "");
+            return -EINVAL;
+        }
+    }
+
+    uint32_t now = plantcare_time_now();
+
+    plantcare_time_format_local(now, when, sizeof(when));
+    plantcare_time_get_stats(&st);
+
+    shell_print(sh, "%s (epoch %u)", when, now);
+    shell_print(sh, "source=%s fixes=%u steps=%u last fix %u s ago",
+                !st.synced ? "none" : (st.from_gps ? "gps" : "rtc"),
+                st.fixes, st.steps, st.since_fix_s);
+    shell_print(sh, "drift=%d ppb, last error=%d ms",
+                st.drift_ppb, st.last_error_ms);
+    return 0;
+}
+
+static int cmd_gps(const struct shell *sh, size_t argc, char **argv)
+{
+    struct gps_sensor_stats st;
+    uint32_t up_ms = k_uptime_get_32();
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    gps_sensor_get_stats(&st);
+
+    uint32_t isr_us   = k_cyc_to_us_floor32(st.isr_cycles);
+    uint32_t parse_us = k_cyc_to_us_floor32(st.parse_cycles);
+
+    shell_print(sh, "gps %s, awake %u of %u s, wakes=%u",
+                gps_sensor_is_awake() ? "awake" : "standby",
+                st.awake_ms / 1000, up_ms / 1000, st.wakes);
+    shell_print(sh, "rx=%u B (%u B/s awake) dropped=%u",
+                st.rx_bytes,
+                st.awake_ms ? (uint32_t)((uint64_t)st.rx_bytes * 1000 / st.awake_ms) : 0,
+                st.dropped);
+    shell_print(sh, "cpu: isr=%u us parse=%u us (%u us per s of uptime)",
+                isr_us, parse_us,
+                up_ms ? (uint32_t)((uint64_t)(isr_us + parse_us) * 1000 / up_ms) : 0);
+    return 0;
+}
+
+/* pc export [<from_seq> [<count>]]: binary frames, see plantcare_export.h */
+static int cmd_export(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *uart = DEVICE_DT_GET(DT_CHOSEN(zephyr_shell_uart));
+    struct plantcare_export_stats st;
+    uint32_t oldest, next;
+    long from = -1, count = 0;
+
+    if ((argc >= 2 && (!parse_long(argv[1], &from) || from < 0)) ||
+        (argc >= 3 && (!parse_long(argv[2], &count) || count < 0))) {
+        shell_error(sh, "usage: pc export [<from_seq> [<count>]]");
+        return -EINVAL;
+    }
+
+    plantcare_log_range(&oldest, &next);
+    if (from < 0) {
+        from = oldest;
+    }
+
+    int ret = plantcare_export_run(uart, (uint32_t)from, (uint32_t)count, &st);
+    if (ret < 0) {
+        shell_error(sh, "export failed (%d)", ret);
+        return ret;
+    }
+
+    shell_print(sh, "");
+    shell_print(sh, "export: %u records in %u frames, %u B in %u ms "
+                "(%u B/s), skipped %u; log holds %u..%u of %u; "
+                "console held %u B, dropped %u B",
+                st.records, st.frames, st.bytes, st.elapsed_ms,
+                st.elapsed_ms ? (uint32_t)((uint64_t)st.bytes * 1000 / st.elapsed_ms) : 0,
+                st.skipped, oldest, next, plantcare_log_capacity(),
+                st.held, st.dropped);
+    return 0;
+}
+
+static void print_thread(const struct plantcare_mem_thread *t, void *user_data)
+{
+    const struct shell *sh = user_data;
+
+    shell_print(sh, "  %-16s %5u / %5u B (%u%%)", t->name,
+                (unsigned int)t->used, (unsigned int)t->size,
+                t->size ? (unsigned int)(t->used * 100 / t->size) : 0);
+}
+
+/* pc mem: stack high-water marks, static buffers, snapshot copy rate */
+static int cmd_mem(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_mem_buffer buf;
+    struct plantcare_mem_copies cp;
+    size_t total = 0;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    shell_print(sh, "stacks (high-water / size):");
+    if (plantcare_mem_threads(print_thread, (void *)sh) < 0) {
+        shell_print(sh, "  n/a, needs CONFIG_INIT_STACKS, "
+                    "CONFIG_THREAD_STACK_INFO and CONFIG_THREAD_MONITOR");
+    }
+
+    shell_print(sh, "static buffers:");
+    for (size_t i = 0; i < plantcare_mem_buffer_count(); i++) {
+        plantcare_mem_buffer_get(i, &buf);
+        shell_print(sh, "  %-16s %5u B", buf.name, (unsigned int)buf.bytes);
+        total += buf.bytes;
+    }
+    shell_print(sh, "  %-16s %5u B", "total", (unsigned int)total);
+
+    plantcare_mem_get_copies(&cp);
+    shell_print(sh, "snapshot: %u B, %u copies, %u.%02u/s = %u B/s over the last %u s",
+                cp.snapshot_bytes, cp.total,
+                cp.per_s_x100 / 100, cp.per_s_x100 % 100,
+                cp.bytes_per_s, cp.window_ms / 1000);
+    return 0;
+}
+
+/* pc vpd: derived climate values and what they cost */
+static int cmd_vpd(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_data s;
+    uint32_t calls, cycles;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    /* From the snapshot: only the sensor thread computes, so the cost
+     * counters are its own
+     */
+    plantcare_state_get_snapshot(&s);
+    plantcare_psychro_get_cost(&calls, &cycles);
+
+    shell_print(sh, "temp_x100=%d hum_x100=%d -> dew_x100=%d (margin %d) "
+                "vpd=%d Pa",
+                s.temp_x100, s.hum_x100, s.dew_x100,
+                s.temp_x100 - s.dew_x100, s.vpd_pa);
+    shell_print(sh, "%u calls, %u cycles each (%u ns)", calls,
+                calls ? cycles / calls : 0,
+                calls ? (uint32_t)((uint64_t)cycles * 1000000000U /
+                                   sys_clock_hw_cycles_per_sec() / calls) : 0);
+    return 0;
+}
+
+static const char *const ppfd_source_names[] = {
+    [PC_PPFD_NONE]   = "none",
+    [PC_PPFD_COLOR]  = "colour",
+    [PC_PPFD_ANALOG] = "analog",
+};
+
+/* pc dli [cal] */
+static int cmd_dli(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_dli_stats st;
+    struct plantcare_data s;
+    char when[32];
+
+    plantcare_state_get_snapshot(&s);
+
+    if (argc >= 2) {
+        if (strcmp(argv[1], "cal") != 0) {
+            shell_error(sh, "usage: pc dli [cal]");
+            return -EINVAL;
+        }
+        /* Both sensors in the same light, colour sensor not saturated */
+        if (!(s.valid_mask & BIT(PC_SENSOR_COLOR)) ||
+            !(s.valid_mask & BIT(PC_SENSOR_ADC)) ||
+            s.dli.source != PC_PPFD_COLOR) {
+            shell_error(sh, "needs a good colour and ADC reading");
+            return -EAGAIN;
+        }
+        int ret = plantcare_dli_calibrate_analog(
+            plantcare_dli_ppfd_from_lux(s.lux), s.plants[0].light_raw);
+        if (ret == -EINVAL) {
+            shell_error(sh, "too dark to calibrate");
+        }
+        return ret;
+    }
+
+    plantcare_dli_get_stats(&st);
+
+    shell_print(sh, "ppfd=%u.%u umol/m2/s (%s)", s.dli.ppfd_x10 / 10,
+                s.dli.ppfd_x10 % 10,
+                s.dli.source < ARRAY_SIZE(ppfd_source_names) ?
+                ppfd_source_names[s.dli.source] : "?");
+    shell_print(sh, "dli today=%u.%02u yesterday=%u.%02u mol/m2",
+                s.dli.today_x100 / 100, s.dli.today_x100 % 100,
+                s.dli.yesterday_x100 / 100, s.dli.yesterday_x100 % 100);
+    shell_print(sh, "%u samples today, %u s missing, %u saves",
+                st.samples, st.missing_s, st.saves);
+    if (st.next_midnight != 0) {
+        plantcare_time_format_local(st.next_midnight, when, sizeof(when));
+        shell_print(sh, "day %u ends %s", st.day, when);
+    } else {
+        shell_print(sh, "clock not set, day unknown");
+    }
+    if (st.analog_q16 != 0) {
+        uint32_t at_1000 = (uint32_t)(((uint64_t)st.analog_q16 * 1000) >> 16);
+
+        shell_print(sh, "analog fallback: %u.%u umol/m2/s at raw 1000",
+                    at_1000 / 10, at_1000 % 10);
+    } else {
+        shell_print(sh, "analog fallback: none, \"pc dli cal\" in steady light");
+    }
+    return 0;
+}
+
+/* pc drying: per-plant drying line and time until the soil limit */
+static int cmd_drying(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_drying_stats st;
+    struct plantcare_data s;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    plantcare_state_get_snapshot(&s);
+
+    for (uint8_t p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        const struct plantcare_drying *dr = &s.drying[p];
+
+        plantcare_drying_get_stats(p, &st);
+        shell_print(sh, "plant %u: level=%d.%d%% limit=%d.%d%% resid=%d "
+                    "samples=%u spread=%d s restarts=%u",
+                    p, st.level_x10 / 10, st.level_x10 % 10,
+                    st.limit_x10 / 10, st.limit_x10 % 10, st.resid_x10,
+                    st.samples, st.spread_s, st.restarts);
+        if (!dr->valid) {
+            shell_print(sh, "  no fit yet");
+        } else if (dr->eta_min >= PLANTCARE_DRYING_ETA_MAX_MIN) {
+            shell_print(sh, "  rate=%d %%/h * 100, not drying towards the limit",
+                        dr->rate_x100);
+        } else {
+            shell_print(sh, "  rate=%d %%/h * 100, limit in %u h %02u min",
+                        dr->rate_x100, dr->eta_min / 60, dr->eta_min % 60);
+        }
+    }
+    return 0;
+}
+
+/* pc tilt [rest] */
+static int cmd_tilt(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_tilt_stats st;
+    struct plantcare_data s;
+    int16_t g[3], rest[3];
+
+    if (argc >= 2) {
+        if (strcmp(argv[1], "rest") != 0) {
+            shell_error(sh, "usage: pc tilt [rest]");
+            return -EINVAL;
+        }
+        /* The current low-passed vector becomes the rest pose */
+        if (!plantcare_tilt_get_filtered(g)) {
+            shell_error(sh, "no accelerometer sample yet");
+            return -EAGAIN;
+        }
+        int ret = plantcare_calib_store_rest(g);
+        if (ret == -EINVAL) {
+            shell_error(sh, "not at rest (|g| off by more than 0.5 g)");
+        }
+        return ret;
+    }
+
+    plantcare_state_get_snapshot(&s);
+    plantcare_tilt_get_stats(&st);
+
+    shell_print(sh, "pitch=%d roll=%d from rest=%d cdeg",
+                s.tilt.pitch_cdeg, s.tilt.roll_cdeg, s.tilt.tilt_cdeg);
+    if (plantcare_tilt_get_filtered(g)) {
+        shell_print(sh, "filtered g: x=%d y=%d z=%d counts", g[0], g[1], g[2]);
+    }
+    if (plantcare_tilt_get_rest(rest)) {
+        shell_print(sh, "rest pose:  x=%d y=%d z=%d counts",
+                    rest[0], rest[1], rest[2]);
+    } else {
+        shell_print(sh, "no rest pose: calibrate, or \"pc tilt rest\"");
+    }
+    shell_print(sh, "updates=%u cost last=%u max=%u cycles (%u Hz clock)",
+                st.updates, st.last_cycles, st.max_cycles,
+                sys_clock_hw_cycles_per_sec());
+    return 0;
+}
+
+/* Last batch from the snapshot: the shell must not drive the I2C bus */
+static int cmd_vib(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_data s;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    plantcare_state_get_snapshot(&s);
+
+    const struct plantcare_vib_result *v = &s.vib;
+
+    if (v->seq == 0) {
+        shell_print(sh, "no vibration batch yet (N=%u)",
+                    plantcare_vib_batch_size());
+        return 0;
+    }
+
+    shell_print(sh, "batch #%u: N=%u @ %u Hz, capture=%u ms, fft=%u us",
+                v->seq, v->n, v->odr_hz, v->capture_ms, v->fft_us);
+    for (uint8_t b = 0; b < PC_VIB_BAND_COUNT; b++) {
+        shell_print(sh, "%-8s %u mg", plantcare_vib_band_name(b),
+                    v->band_mg[b]);
+    }
+    shell_print(sh, "total=%u mg, peak=%u mg at %u.%u Hz, tonality=%u %%",
+                v->rms_mg, v->peak_mg, v->peak_hz_x10 / 10,
+                v->peak_hz_x10 % 10, v->tonality_pct);
+    return 0;
+}
+
+static int cmd_format(const struct shell *sh, size_t argc, char **argv)
+{
+    if (strcmp(argv[1], "text") == 0) {
+        plantcare_config_set_output_format(PLANTCARE_OUTPUT_TEXT);
+    } else if (strcmp(argv[1], "csv") == 0) {
+        plantcare_config_set_output_format(PLANTCARE_OUTPUT_CSV);
+        plantcare_output_csv_header();
+    } else {
+        shell_error(sh, "format must be text or csv");
+        return -EINVAL;
+    }
+    return 0;
+}
+
+static int cmd_alarm_list(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_alarm_rule rules[PLANTCARE_ALARM_MAX_RULES];
+    size_t n = plantcare_alarm_get_rules(rules, ARRAY_SIZE(rules));
+    uint32_t active = plantcare_alarm_active_mask();
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    for (size_t i = 0; i < n; i++) {
+        shell_print(sh, "%2u %-12s prio=%u min=%d max=%d hyst=%d dwell=%u ms%s",
+                    (unsigned)i, plantcare_alarm_channel_name(rules[i].channel),
+                    rules[i].priority, rules[i].min, rules[i].max,
+                    rules[i].hysteresis, rules[i].dwell_ms,
+                    (active & BIT(rules[i].channel)) ? " [ACTIVE]" : "");
+    }
+    return 0;
+}
+
+/* pc alarm set <idx> <min> <max> [hysteresis] [dwell_ms] */
+static int cmd_alarm_set(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_alarm_rule rules[PLANTCARE_ALARM_MAX_RULES];
+    size_t n = plantcare_alarm_get_rules(rules, ARRAY_SIZE(rules));
+    long idx, min, max, hyst = 0, dwell = 0;
+
+    if (!parse_long(argv[1], &idx) || idx < 0 || (size_t)idx >= n ||
+        !parse_long(argv[2], &min) || !parse_long(argv[3], &max) ||
+        min > max ||
+        (argc > 4 && (!parse_long(argv[4], &hyst) || hyst < 0)) ||
+        (argc > 5 && (!parse_long(argv[5], &dwell) || dwell < 0))) {
+        shell_error(sh, "usage: pc alarm set <idx> <min> <max> [hyst] [dwell_ms]");
+        return -EINVAL;
+    }
+
+    rules[idx].min = (int32_t)min;
+    rules[idx].max = (int32_t)max;
+    if (argc > 4) {
+        rules[idx].hysteresis = (int32_t)hyst;
+    }
+    if (argc > 5) {
+        rules[idx].dwell_ms = (uint32_t)dwell;
+    }
+
+    return plantcare_alarm_set_rules(rules, n);
+}
+
+/* pc alarm prio <idx> <priority> */
+static int cmd_alarm_prio(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_alarm_rule rules[PLANTCARE_ALARM_MAX_RULES];
+    size_t n = plantcare_alarm_get_rules(rules, ARRAY_SIZE(rules));
+    long idx, prio;
+
+    ARG_UNUSED(argc);
+
+    if (!parse_long(argv[1], &idx) || idx < 0 || (size_t)idx >= n ||
+        !parse_long(argv[2], &prio) || prio < 0 || prio > UINT8_MAX) {
+        shell_error(sh, "usage: pc alarm prio <idx> <0..255>, 0 most important");
+        return -EINVAL;
+    }
+
+    rules[idx].priority = (uint8_t)prio;
+    return plantcare_alarm_set_rules(rules, n);
+}
+
+/* A channel by name as pc alarm list prints it, any case, quoted if it
+ * has a space; or by number
+ */
+static bool parse_channel(const char *str, long *out)
+{
+    if (parse_long(str, out)) {
+        return (*out >= 0 && *out < PC_CH_COUNT);
+    }
+    for (int ch = 0; ch < PC_CH_COUNT; ch++) {
+        if (strcasecmp(str, plantcare_alarm_channel_name(ch)) == 0) {
+            *out = ch;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* pc alarm add <channel> <priority> <min> <max> [hysteresis] [dwell_ms] */
+static int cmd_alarm_add(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_alarm_rule rules[PLANTCARE_ALARM_MAX_RULES];
+    size_t n = plantcare_alarm_get_rules(rules, ARRAY_SIZE(rules));
+    long ch, prio, min, max, hyst = 0, dwell = 0;
+
+    if (n == ARRAY_SIZE(rules)) {
+        shell_error(sh, "rule table full (%d rules)", PLANTCARE_ALARM_MAX_RULES);
+        return -ENOMEM;
+    }
+    if (!parse_channel(argv[1], &ch) ||
+        !parse_long(argv[2], &prio) || prio < 0 || prio > UINT8_MAX ||
+        !parse_long(argv[3], &min) || !parse_long(argv[4], &max) ||
+        min > max ||
+        (argc > 5 && (!parse_long(argv[5], &hyst) || hyst < 0)) ||
+        (argc > 6 && (!parse_long(argv[6], &dwell) || dwell < 0))) {
+        shell_error(sh, "usage: pc alarm add <channel> <prio> <min> <max> "
+                    "[hyst] [dwell_ms]");
+        return -EINVAL;
+    }
+
+    rules[n] = (struct plantcare_alarm_rule){
+        .channel    = (uint8_t)ch,
+        .priority   = (uint8_t)prio,
+        .min        = (int32_t)min,
+        .max        = (int32_t)max,
+        .hysteresis = (int32_t)hyst,
+        .dwell_ms   = (uint32_t)dwell,
+    };
+    return plantcare_alarm_set_rules(rules, n + 1);
+}
+
+/* pc alarm del <idx>: the rules after it move down one index */
+static int cmd_alarm_del(const struct shell *sh, size_t argc, char **argv)
+{
+    struct plantcare_alarm_rule rules[PLANTCARE_ALARM_MAX_RULES];
+    size_t n = plantcare_alarm_get_rules(rules, ARRAY_SIZE(rules));
+    long idx;
+
+    ARG_UNUSED(argc);
+
+    if (!parse_long(argv[1], &idx) || idx < 0 || (size_t)idx >= n) {
+        shell_error(sh, "usage: pc alarm del <idx>");
+        return -EINVAL;
+    }
+
+    memmove(&rules[idx], &rules[idx + 1],
+            (n - (size_t)idx - 1) * sizeof(rules[0]));
+    return plantcare_alarm_set_rules(rules, n - 1);
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_pc_alarm,
+    SHELL_CMD(list, NULL, "List alarm rules", cmd_alarm_list),
+    SHELL_CMD_ARG(set, NULL,
+                  "Change a rule: <idx> <min> <max> [hyst] [dwell_ms]",
+                  cmd_alarm_set, 4, 2),
+    SHELL_CMD_ARG(prio, NULL, "Change a rule's priority: <idx> <prio>",
+                  cmd_alarm_prio, 3, 0),
+    SHELL_CMD_ARG(add, NULL,
+                  "Add a rule: <channel> <prio> <min> <max> [hyst] [dwell_ms]",
+                  cmd_alarm_add, 5, 2),
+    SHELL_CMD_ARG(del, NULL, "Remove a rule: <idx>", cmd_alarm_del, 2, 0),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_pc,
+    SHELL_CMD(snapshot, NULL, "Dump the latest snapshot", cmd_snapshot),
+    SHELL_CMD(read, NULL, "Read all sensors now and dump", cmd_read),
+    SHELL_CMD(counters, NULL, "Dump instrumentation counters", cmd_counters),
+    SHELL_CMD_ARG(mode, NULL, "Show or set mode: [test|normal|calib]",
+                  cmd_mode, 1, 1),
+    SHELL_CMD_ARG(period, NULL,
+                  "Show or set sampling period: [<sensor|all> <ms>]",
+                  cmd_period, 1, 2),
+    SHELL_CMD_ARG(adapt, NULL,
+                  "Adaptive sampling: [off | <floor_ms> <ceiling_ms>]",
+                  cmd_adapt, 1, 2),
+    SHELL_CMD_ARG(batch, NULL,
+                  "Normal mode reports: [flush | <size> [alarm|noalarm]]",
+                  cmd_batch, 1, 2),
+    SHELL_CMD(plants, NULL, "Plant count and ADC scan time", cmd_plants),
+    SHELL_CMD_ARG(color, NULL,
+                  "Colour pipeline and leaf centroids: [<class> <r> <g> <b>]",
+                  cmd_color, 1, 4),
+    SHELL_CMD_ARG(time, NULL, "Wall clock and drift: [<zone>]",
+                  cmd_time, 1, 1),
+    SHELL_CMD(gps, NULL, "GPS duty cycle, bytes/s and CPU time", cmd_gps),
+    SHELL_CMD(vib, NULL, "Last vibration spectrum", cmd_vib),
+    SHELL_CMD_ARG(export, NULL,
+                  "Binary log download: [<from_seq> [<count>]]",
+                  cmd_export, 1, 2),
+    SHELL_CMD_ARG(tilt, NULL, "Pitch/roll, tilt from rest: [rest]",
+                  cmd_tilt, 1, 1),
+    SHELL_CMD(drying, NULL, "Soil drying rate and time to water", cmd_drying),
+    SHELL_CMD(vpd, NULL, "Dew point, VPD and their cycle cost", cmd_vpd),
+    SHELL_CMD_ARG(dli, NULL, "PPFD and daily light integral: [cal]",
+                  cmd_dli, 1, 1),
+    SHELL_CMD(mem, NULL, "Stack high-water marks and RAM use", cmd_mem),
+    SHELL_CMD_ARG(format, NULL, "Output format: <text|csv>", cmd_format, 2, 0),
+    SHELL_CMD(alarm, &sub_pc_alarm, "Alarm rules", NULL),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(pc, &sub_pc, "PlantCare commands", NULL);
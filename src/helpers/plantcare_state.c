@@ -1,26 +1,31 @@
-#include "plantcare_state.h"
+#include <zephyr/zbus/zbus.h>
 
-static struct plantcare_data g_buf[2];
-static volatile uint32_t g_version;  /* starts at 0 by default */
+#include "plantcare_state.h"
+#include "plantcare_bus.h"
+#include "plantcare_counters.h"
 
 void plantcare_state_publish(const struct plantcare_data *src)
 {
-    uint32_t next = g_version + 1U;
-
-    /* Copy entire struct into buffer 0 or 1 */
-    g_buf[next & 1U] = *src;
-
-    /* Single 32-bit write “publishes” the new data */
-    g_version = next;
+    /* One copy into the channel, then observers are notified */
+    (void)zbus_chan_pub(&pc_snapshot_chan, src, K_FOREVER);
+    plantcare_counter_inc(PC_CNT_SNAPSHOT_COPIES);
 }
 
 void plantcare_state_get_snapshot(struct plantcare_data *dst)
 {
-    uint32_t v1, v2;
+    (void)zbus_chan_read(&pc_snapshot_chan, dst, K_FOREVER);
+    plantcare_counter_inc(PC_CNT_SNAPSHOT_COPIES);
+}
+
+const struct plantcare_data *plantcare_state_claim(void)
+{
+    if (zbus_chan_claim(&pc_snapshot_chan, K_FOREVER) != 0) {
+        return NULL;
+    }
+    return zbus_chan_const_msg(&pc_snapshot_chan);
+}
 
-    do {
-        v1 = g_version;
-        *dst = g_buf[v1 & 1U];
-        v2 = g_version;
-    } while (v1 != v2);
-}
\ No newline at end of file
+void plantcare_state_finish(void)
+{
+    (void)zbus_chan_finish(&pc_snapshot_chan);
+}
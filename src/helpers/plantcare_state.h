@@ -5,44 +5,90 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-enum plantcare_dom_color {
-    DOM_COLOR_UNKNOWN = 0,
-    DOM_COLOR_RED,
-    DOM_COLOR_GREEN,
-    DOM_COLOR_BLUE,
-};
+#include "plantcare_anomaly.h"
+#include "plantcare_color.h"
+#include "plantcare_dli.h"
+#include "plantcare_drying.h"
+#include "plantcare_tilt.h"
+#include "plantcare_vib.h"
+#include "sensors/plant_adc.h"
 
 struct plantcare_data {
-    /* Soil + light (ADC) */
-    int16_t soil_raw;
-    int32_t soil_mv;
-    int16_t light_raw;
-    int32_t light_mv;
+    /* Soil + light (ADC), one entry per plant in devicetree order */
+    struct plant_adc_sample plants[PLANTCARE_PLANT_COUNT];
+
+    /* Soil drying rate and time to water, per plant (plantcare_drying.h) */
+    struct plantcare_drying drying[PLANTCARE_PLANT_COUNT];
 
     /* Temp / humidity (Si7021) */
     int32_t temp_x100;   /* °C * 100 */
     int32_t hum_x100;    /* %RH * 100 */
 
+    /* Derived from the two above (plantcare_psychro.h) */
+    int32_t dew_x100;    /* dew point, °C * 100 */
+    int32_t vpd_pa;      /* vapour-pressure deficit, Pa */
+
     /* Accelerometer (MMA8451, g * 100) */
     int32_t acc_x_g100;
     int32_t acc_y_g100;
     int32_t acc_z_g100;
 
+    /* Low-passed orientation, centidegrees (plantcare_tilt.h) */
+    struct plantcare_tilt tilt;
+
+    /* Spectrum of the last vibration batch (plantcare_vib.h), seq 0 = none */
+    struct plantcare_vib_result vib;
+
     /* Color sensor (TCS34725) */
     uint16_t clr;
     uint16_t red;
     uint16_t green;
     uint16_t blue;
-    enum plantcare_dom_color dom_color;
+    uint8_t  leaf_class;    /* enum plantcare_leaf_class */
+    uint16_t hue_x10;       /* degrees * 10 */
+    uint16_t cct_k;         /* K, 0 if too dark */
+    uint32_t lux;
+
+    /* PPFD and daily light integral (plantcare_dli.h) */
+    struct plantcare_dli dli;
+
+    /* UTC seconds since 1970 when published, 0 until the clock is set
+     * (plantcare_time.h)
+     */
+    uint32_t epoch_s;
 
     /* GPS: for Test Mode we just store the last NMEA sentence (truncated) */
     char gps_last_sentence[64];
+
+    /* Bit BIT(PC_SENSOR_x) set if that group's fields hold a good reading
+     * (see plantcare_health.h). Cleared bits mean the values are the last
+     * good ones, or zero if the sensor never answered.
+     */
+    uint8_t valid_mask;
+
+    /* Bit BIT(PC_SENSOR_x) set if that group was read, successfully, in
+     * the cycle that published this snapshot. Groups not due this cycle
+     * (or backing off) repeat their last values with the bit cleared.
+     */
+    uint8_t fresh_mask;
+
+    /* enum plantcare_an_kind per plantcare_an_channel */
+    uint8_t anomaly[PC_AN_CH_COUNT];
 };
 
-/* Called by the worker thread after computing new values */
+/* Called by the worker thread after computing new values.
+ * Publishes on pc_snapshot_chan (plantcare_bus.h).
+ */
 void plantcare_state_publish(const struct plantcare_data *src);
 
-/* Called by the UI thread to get a stable snapshot */
+/* Called by the UI thread to get a stable snapshot (copy) */
 void plantcare_state_get_snapshot(struct plantcare_data *dst);
 
+/* Zero-copy access: lock the latest snapshot in place and read it.
+ * Keep the claim short, the sensor thread cannot publish meanwhile.
+ * Returns NULL on error; otherwise plantcare_state_finish() must follow.
+ */
+const struct plantcare_data *plantcare_state_claim(void);
+void plantcare_state_finish(void);
+
 #endif /* PLANTCARE_STATE_H */
\ No newline at end of file
@@ -0,0 +1,138 @@
+// src/helpers/plantcare_tilt.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "plantcare_tilt.h"
+#include "plantcare_cordic.h"
+#include "sensors/accelerometer_sensor.h"
+
+/*
+ * Low-pass: f += (x - f) / 2^TILT_LPF_SHIFT, with TILT_FRAC fraction bits
+ * so small steps are not lost. Shift 2 settles to 1/e in 4 samples: two
+ * minutes at the normal mode cadence, 10 ms at 400 Hz.
+ */
+#define TILT_LPF_SHIFT      2
+#define TILT_FRAC           4
+
+/* Rest poses with |g| outside 0.5..1.5 g were taken while moving */
+#define REST_MIN_COUNTS     (ACCELEROMETER_COUNTS_PER_G / 2)
+#define REST_MAX_COUNTS     (ACCELEROMETER_COUNTS_PER_G * 3 / 2)
+
+/* The sensor thread updates, the shell and calibration set the rest pose */
+static struct k_spinlock tilt_lock;
+
+static int32_t filt[3];             /* counts << TILT_FRAC */
+static bool    filt_valid;
+static int16_t rest_pose[3];
+static bool    rest_valid;
+static struct plantcare_tilt_stats stats;
+
+static int16_t angle_between(const int32_t g[3], const int16_t r[3])
+{
+    /* |g|, |r| <= 2 g = 8192 counts: products and sums fit in 32 bits */
+    int32_t cx = g[1] * r[2] - g[2] * r[1];
+    int32_t cy = g[2] * r[0] - g[0] * r[2];
+    int32_t cz = g[0] * r[1] - g[1] * r[0];
+    int32_t dot = g[0] * r[0] + g[1] * r[1] + g[2] * r[2];
+    int32_t cxy, cross;
+
+    (void)plantcare_cordic_vector(cy, cx, &cxy);
+    (void)plantcare_cordic_vector(cz, cxy, &cross);
+    return (int16_t)plantcare_cordic_atan2(cross, dot);
+}
+
+void plantcare_tilt_update(const int16_t xyz[3], struct plantcare_tilt *out)
+{
+    uint32_t start = k_cycle_get_32();
+    int32_t f[3];           /* counts << TILT_FRAC, for pitch and roll */
+    int32_t g[3];           /* rounded to counts, for the products */
+    int16_t rest[3];
+    int32_t yz;
+
+    /* Lock for the state only, the CORDIC work runs unlocked */
+    k_spinlock_key_t key = k_spin_lock(&tilt_lock);
+
+    for (int i = 0; i < 3; i++) {
+        int32_t x = (int32_t)xyz[i] << TILT_FRAC;
+
+        filt[i] = filt_valid ? filt[i] + ((x - filt[i]) >> TILT_LPF_SHIFT) : x;
+        f[i] = filt[i];
+        g[i] = (filt[i] + (1 << (TILT_FRAC - 1))) >> TILT_FRAC;
+        rest[i] = rest_pose[i];
+    }
+    filt_valid = true;
+
+    bool have_rest = rest_valid;
+
+    k_spin_unlock(&tilt_lock, key);
+
+    out->roll_cdeg = (int16_t)plantcare_cordic_atan2(f[1], f[2]);
+    (void)plantcare_cordic_vector(f[2], f[1], &yz);
+    out->pitch_cdeg = (int16_t)plantcare_cordic_atan2(-f[0], yz);
+    out->tilt_cdeg = have_rest ? angle_between(g, rest)
+                               : PLANTCARE_TILT_NO_REST;
+
+    uint32_t cycles = k_cycle_get_32() - start;
+
+    key = k_spin_lock(&tilt_lock);
+    stats.updates++;
+    stats.last_cycles = cycles;
+    stats.max_cycles  = MAX(stats.max_cycles, cycles);
+    k_spin_unlock(&tilt_lock, key);
+}
+
+int plantcare_tilt_set_rest(const int16_t rest[3])
+{
+    int32_t xy, len;
+
+    (void)plantcare_cordic_vector(rest[1], rest[0], &xy);
+    (void)plantcare_cordic_vector(rest[2], xy, &len);
+    if (len < REST_MIN_COUNTS || len > REST_MAX_COUNTS) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&tilt_lock);
+
+    for (int i = 0; i < 3; i++) {
+        rest_pose[i] = rest[i];
+    }
+    rest_valid = true;
+    k_spin_unlock(&tilt_lock, key);
+    return 0;
+}
+
+bool plantcare_tilt_get_rest(int16_t rest[3])
+{
+    k_spinlock_key_t key = k_spin_lock(&tilt_lock);
+    bool ok = rest_valid;
+
+    for (int i = 0; i < 3; i++) {
+        rest[i] = rest_pose[i];
+    }
+    k_spin_unlock(&tilt_lock, key);
+    return ok;
+}
+
+bool plantcare_tilt_get_filtered(int16_t xyz[3])
+{
+    k_spinlock_key_t key = k_spin_lock(&tilt_lock);
+    bool ok = filt_valid;
+
+    for (int i = 0; i < 3; i++) {
+        xyz[i] = (int16_t)((filt[i] + (1 << (TILT_FRAC - 1))) >> TILT_FRAC);
+    }
+    k_spin_unlock(&tilt_lock, key);
+    return ok;
+}
+
+void plantcare_tilt_get_stats(struct plantcare_tilt_stats *st)
+{
+    k_spinlock_key_t key = k_spin_lock(&tilt_lock);
+
+    *st = stats;
+    k_spin_unlock(&tilt_lock, key);
+}
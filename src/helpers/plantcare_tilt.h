@@ -0,0 +1,56 @@
+#ifndef PLANTCARE_TILT_H
+#define PLANTCARE_TILT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Pot orientation from accelerometer instance 0 (plantcare_tilt.c).
+ *
+ * Each sample (raw counts, offsets removed) goes into a first-order
+ * low-pass on the gravity vector; filtering the vector rather than the
+ * angles has no wrap-around at ±180°. Pitch, roll and the angle to a
+ * stored rest pose then come from CORDIC (plantcare_cordic.h):
+ *
+ *   roll  = atan2(y, z)
+ *   pitch = atan2(-x, sqrt(y² + z²))
+ *   tilt  = atan2(|g × rest|, g · rest)     0..180°, any direction
+ *
+ * Six CORDIC calls and a few multiplies per sample, no divide: cheap
+ * enough to run at the FIFO rate. The cost is measured in the stats.
+ *
+ * The rest pose is taken in calibration mode or with "pc tilt rest" and
+ * persisted by plantcare_calib.c.
+ */
+
+#define PLANTCARE_TILT_NO_REST  (-1)
+
+struct plantcare_tilt {
+    int16_t pitch_cdeg;     /* +x end up, -9000..9000 */
+    int16_t roll_cdeg;      /* +y side down, -18000..18000 */
+    int16_t tilt_cdeg;      /* from the rest pose, PLANTCARE_TILT_NO_REST if unset */
+};
+
+struct plantcare_tilt_stats {
+    uint32_t updates;
+    uint32_t last_cycles;   /* filter + angles of the last sample */
+    uint32_t max_cycles;
+};
+
+/* Feed one sample (counts, offsets removed); fills out from the filtered
+ * vector. The first sample initialises the filter.
+ */
+void plantcare_tilt_update(const int16_t xyz[3], struct plantcare_tilt *out);
+
+/* Rest pose as a gravity vector in counts. Rejected (-EINVAL) unless its
+ * length is between 0.5 and 1.5 g (board moving, or no sample yet).
+ */
+int plantcare_tilt_set_rest(const int16_t rest[3]);
+bool plantcare_tilt_get_rest(int16_t rest[3]);
+
+/* Current filtered gravity vector, counts; false before the first sample */
+bool plantcare_tilt_get_filtered(int16_t xyz[3]);
+
+void plantcare_tilt_get_stats(struct plantcare_tilt_stats *st);
+
+#endif /* PLANTCARE_TILT_H */
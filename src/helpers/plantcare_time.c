@@ -0,0 +1,429 @@
+// src/helpers/plantcare_time.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <string.h>
+
+#if defined(CONFIG_RTC)
+#include <zephyr/drivers/rtc.h>
+#endif
+
+#include "plantcare_time.h"
+
+/*
+ * Clock model: utc(up) = anchor_utc + dt + dt * drift_ppb / 1e9, with
+ * dt = up - anchor_up. Every fix measures the error of that prediction.
+ *   - more than TIME_STEP_MS off: step to the GPS time, keep the drift
+ *   - otherwise, once TIME_DISCIPLINE_MS have passed since the anchor:
+ *     the error over that span is a rate error; fold it into drift_ppb
+ *     (1/TIME_DRIFT_GAIN of it, all of it the first time) and re-anchor.
+ * Short spans are skipped because the fix-to-'\n' latency jitter would
+ * dominate the rate estimate.
+ */
+#define TIME_STEP_MS            2000
+#define TIME_DISCIPLINE_MS      (10 * 60 * 1000)
+#define TIME_DRIFT_GAIN         4
+#define TIME_DRIFT_MAX_PPB      500000      /* 500 ppm: LSI worst case */
+
+#define PLANTCARE_USER_NODE     DT_PATH(zephyr_user)
+#define TIME_DEFAULT_ZONE       DT_PROP_OR(PLANTCARE_USER_NODE, timezone, "UTC")
+
+struct clock_state {
+    bool     synced;
+    bool     from_gps;
+    bool     has_drift;
+    int64_t  anchor_up_ms;
+    int64_t  anchor_utc_ms;
+    int64_t  last_fix_up_ms;
+    int32_t  drift_ppb;
+    int32_t  last_error_ms;
+    uint32_t fixes;
+    uint32_t steps;
+};
+
+static struct clock_state clk;
+static struct k_spinlock clk_lock;
+
+/* ---------- Civil date <-> days (H. Hinnant's algorithms) ---------- */
+
+static int32_t days_from_civil(int32_t y, int32_t m, int32_t d)
+{
+    y -= (m <= 2);
+    int32_t era = y / 400;
+    int32_t yoe = y - era * 400;
+    int32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+static void civil_from_days(int32_t z, struct plantcare_civil *c)
+{
+    z += 719468;
+    int32_t era = z / 146097;
+    int32_t doe = z - era * 146097;
+    int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int32_t mp  = (5 * doy + 2) / 153;
+    int32_t m   = mp + (mp < 10 ? 3 : -9);
+
+    c->year  = (uint16_t)(yoe + era * 400 + (m <= 2));
+    c->month = (uint8_t)m;
+    c->day   = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+}
+
+/* 0 = Sunday; 1970-01-01 was a Thursday */
+static int32_t weekday(int32_t days)
+{
+    return (days + 4) % 7;
+}
+
+uint32_t plantcare_time_from_civil(const struct plantcare_civil *c)
+{
+    int32_t days = days_from_civil(c->year, c->month, c->day);
+
+    return (uint32_t)days * 86400U + c->hour * 3600U + c->min * 60U + c->sec;
+}
+
+void plantcare_time_to_civil(uint32_t epoch_s, struct plantcare_civil *c)
+{
+    uint32_t sod = epoch_s % 86400U;
+
+    civil_from_days((int32_t)(epoch_s / 86400U), c);
+    c->hour = (uint8_t)(sod / 3600U);
+    c->min  = (uint8_t)((sod / 60U) % 60U);
+    c->sec  = (uint8_t)(sod % 60U);
+}
+
+/* ---------- Time zones ---------- */
+
+/* A DST switch: the week-th Sunday (5 = last) of month at minute_of_day,
+ * in UTC or in local standard time.
+ */
+struct dst_switch {
+    uint8_t  month;
+    uint8_t  week;
+    uint16_t minute;
+    bool     utc;
+};
+
+struct dst_rule {
+    struct dst_switch start;
+    struct dst_switch end;
+};
+
+enum { DST_NONE = 0, DST_EU, DST_US, DST_AU };
+
+static const struct dst_rule dst_rules[] = {
+    [DST_NONE] = { { 0 } },
+    /* Last Sunday of March / October, 01:00 UTC */
+    [DST_EU]   = { { 3, 5, 60, true },   { 10, 5, 60, true } },
+    /* Second Sunday of March 02:00 / first Sunday of November 02:00 DST */
+    [DST_US]   = { { 3, 2, 120, false }, { 11, 1, 60, false } },
+    /* First Sunday of October 02:00 / first Sunday of April 03:00 DST */
+    [DST_AU]   = { { 10, 1, 120, false }, { 4, 1, 120, false } },
+};
+
+/* Offsets in quarter hours, so every real zone fits in an int8_t */
+struct tz_entry {
+    const char *name;
+    const char *dst_name;
+    int8_t      std_qh;
+    uint8_t     rule;
+};
+
+static const struct tz_entry tz_table[] = {
+    { "UTC",  "UTC",  0,   DST_NONE },
+    { "GMT",  "BST",  0,   DST_EU },
+    { "CET",  "CEST", 4,   DST_EU },
+    { "EET",  "EEST", 8,   DST_EU },
+    { "MSK",  "MSK",  12,  DST_NONE },
+    { "IST",  "IST",  22,  DST_NONE },
+    { "CST",  "CST",  32,  DST_NONE },    /* China */
+    { "JST",  "JST",  36,  DST_NONE },
+    { "AEST", "AEDT", 40,  DST_AU },
+    { "EST",  "EDT",  -20, DST_US },
+    { "CST6", "CDT",  -24, DST_US },      /* US central */
+    { "MST",  "MDT",  -28, DST_US },
+    { "PST",  "PDT",  -32, DST_US },
+};
+
+static const struct tz_entry *zone = &tz_table[0];
+
+/* Switch times for one year are computed once and cached */
+static struct {
+    const struct tz_entry *zone;
+    uint16_t year;
+    uint32_t start;
+    uint32_t end;
+} dst_cache;
+
+static uint32_t dst_switch_time(const struct dst_switch *sw, uint16_t year,
+                                int32_t std_s)
+{
+    int32_t day;
+
+    if (sw->week == 5) {
+        /* Last Sunday: back from the last day of the month */
+        int32_t last = days_from_civil(year + (sw->month == 12),
+                                       sw->month % 12 + 1, 1) - 1;
+        day = last - weekday(last);
+    } else {
+        int32_t first = days_from_civil(year, sw->month, 1);
+        day = first + (7 - weekday(first)) % 7 + 7 * (sw->week - 1);
+    }
+
+    return (uint32_t)((int64_t)day * 86400 + sw->minute * 60 -
+                      (sw->utc ? 0 : std_s));
+}
+
+int32_t plantcare_time_local_offset_s(uint32_t epoch_s, bool *dst)
+{
+    const struct tz_entry *z = zone;
+    const struct dst_rule *rule = &dst_rules[z->rule];
+    int32_t std_s = z->std_qh * 15 * 60;
+    bool in_dst = false;
+
+    if (z->rule != DST_NONE && epoch_s != 0) {
+        struct plantcare_civil c;
+
+        plantcare_time_to_civil(epoch_s, &c);
+
+        /* Mode thread and shell both ask */
+        k_spinlock_key_t key = k_spin_lock(&clk_lock);
+
+        if (dst_cache.zone != z || dst_cache.year != c.year) {
+            dst_cache.zone  = z;
+            dst_cache.year  = c.year;
+            dst_cache.start = dst_switch_time(&rule->start, c.year, std_s);
+            dst_cache.end   = dst_switch_time(&rule->end, c.year, std_s);
+        }
+
+        if (dst_cache.start < dst_cache.end) {
+            in_dst = epoch_s >= dst_cache.start && epoch_s < dst_cache.end;
+        } else {
+            /* Southern hemisphere: DST spans the new year */
+            in_dst = epoch_s >= dst_cache.start || epoch_s < dst_cache.end;
+        }
+        k_spin_unlock(&clk_lock, key);
+    }
+
+    if (dst) {
+        *dst = in_dst;
+    }
+    return std_s + (in_dst ? 3600 : 0);
+}
+
+int plantcare_time_format_local(uint32_t epoch_s, char *buf, size_t len)
+{
+    struct plantcare_civil c;
+    bool dst;
+
+    if (epoch_s == 0) {
+        return snprintk(buf, len, "(no time yet)");
+    }
+
+    int32_t off = plantcare_time_local_offset_s(epoch_s, &dst);
+
+    plantcare_time_to_civil((uint32_t)((int64_t)epoch_s + off), &c);
+    return snprintk(buf, len, "%04u-%02u-%02u %02u:%02u:%02u %s",
+                    c.year, c.month, c.day, c.hour, c.min, c.sec,
+                    plantcare_time_zone_name(dst));
+}
+
+int plantcare_time_set_zone(const char *name)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(tz_table); i++) {
+        if (strcmp(tz_table[i].name, name) == 0) {
+            zone = &tz_table[i];
+            return 0;
+        }
+    }
+    return -ENOENT;
+}
+
+const char *plantcare_time_zone_name(bool dst)
+{
+    return dst ? zone->dst_name : zone->name;
+}
+
+const char *plantcare_time_zone_list(size_t idx)
+{
+    return (idx < ARRAY_SIZE(tz_table)) ? tz_table[idx].name : NULL;
+}
+
+/* ---------- Hardware RTC ---------- */
+
+#if defined(CONFIG_RTC) && DT_NODE_HAS_STATUS(DT_NODELABEL(rtc), okay)
+
+static const struct device *const rtc_dev = DEVICE_DT_GET(DT_NODELABEL(rtc));
+
+static void rtc_store(uint32_t epoch_s)
+{
+    struct plantcare_civil c;
+    struct rtc_time t = { 0 };
+
+    plantcare_time_to_civil(epoch_s, &c);
+    t.tm_year  = c.year - 1900;
+    t.tm_mon   = c.month - 1;
+    t.tm_mday  = c.day;
+    t.tm_hour  = c.hour;
+    t.tm_min   = c.min;
+    t.tm_sec   = c.sec;
+    t.tm_wday  = weekday((int32_t)(epoch_s / 86400U));
+    t.tm_yday  = -1;
+    t.tm_isdst = -1;
+
+    if (device_is_ready(rtc_dev)) {
+        (void)rtc_set_time(rtc_dev, &t);
+    }
+}
+
+static uint32_t rtc_load(void)
+{
+    struct rtc_time t;
+    struct plantcare_civil c;
+
+    if (!device_is_ready(rtc_dev) || rtc_get_time(rtc_dev, &t) < 0 ||
+        t.tm_year < 100) {
+        return 0;       /* never set, or set before 2000: ignore */
+    }
+
+    c.year  = (uint16_t)(t.tm_year + 1900);
+    c.month = (uint8_t)(t.tm_mon + 1);
+    c.day   = (uint8_t)t.tm_mday;
+    c.hour  = (uint8_t)t.tm_hour;
+    c.min   = (uint8_t)t.tm_min;
+    c.sec   = (uint8_t)t.tm_sec;
+    return plantcare_time_from_civil(&c);
+}
+
+#else
+
+static void rtc_store(uint32_t epoch_s)
+{
+    ARG_UNUSED(epoch_s);
+}
+
+static uint32_t rtc_load(void)
+{
+    return 0;
+}
+
+#endif
+
+/* ---------- Clock ---------- */
+
+static int64_t utc_ms_at(const struct clock_state *c, int64_t up_ms)
+{
+    int64_t dt = up_ms - c->anchor_up_ms;
+
+    return c->anchor_utc_ms + dt + (dt * c->drift_ppb) / 1000000000;
+}
+
+uint32_t plantcare_time_at(int64_t uptime_ms)
+{
+    k_spinlock_key_t key = k_spin_lock(&clk_lock);
+    int64_t ms = clk.synced ? utc_ms_at(&clk, uptime_ms) : 0;
+
+    k_spin_unlock(&clk_lock, key);
+    return (ms > 0) ? (uint32_t)(ms / 1000) : 0;
+}
+
+void plantcare_time_gps_fix(uint32_t epoch_s, uint16_t ms, int64_t uptime_ms)
+{
+    int64_t gps_ms = (int64_t)epoch_s * 1000 + ms;
+    bool store = false;
+
+    k_spinlock_key_t key = k_spin_lock(&clk_lock);
+
+    clk.fixes++;
+    clk.last_fix_up_ms = uptime_ms;
+
+    if (!clk.synced || !clk.from_gps) {
+        /* First GPS time: whatever the RTC said, GPS wins */
+        clk.synced = true;
+        clk.from_gps = true;
+        clk.anchor_up_ms = uptime_ms;
+        clk.anchor_utc_ms = gps_ms;
+        clk.last_error_ms = 0;
+        clk.steps++;
+        store = true;
+        goto out;
+    }
+
+    int64_t err = gps_ms - utc_ms_at(&clk, uptime_ms);
+    int64_t dt = uptime_ms - clk.anchor_up_ms;
+
+    clk.last_error_ms = (int32_t)CLAMP(err, INT32_MIN, INT32_MAX);
+
+    if (err > TIME_STEP_MS || err < -TIME_STEP_MS) {
+        clk.anchor_up_ms = uptime_ms;
+        clk.anchor_utc_ms = gps_ms;
+        clk.steps++;
+        store = true;
+        goto out;
+    }
+
+    if (dt < TIME_DISCIPLINE_MS) {
+        goto out;
+    }
+
+    /* Error over dt is a rate error of err/dt on top of drift_ppb */
+    int64_t rate_ppb = (err * 1000000000) / dt;
+    int64_t drift = clk.drift_ppb +
+                    (clk.has_drift ? rate_ppb / TIME_DRIFT_GAIN : rate_ppb);
+
+    clk.drift_ppb = (int32_t)CLAMP(drift, -TIME_DRIFT_MAX_PPB,
+                                   TIME_DRIFT_MAX_PPB);
+    clk.has_drift = true;
+    clk.anchor_up_ms = uptime_ms;
+    clk.anchor_utc_ms = gps_ms;
+    store = true;
+
+out:
+    k_spin_unlock(&clk_lock, key);
+
+    if (store) {
+        rtc_store(epoch_s);
+    }
+}
+
+void plantcare_time_get_stats(struct plantcare_time_stats *st)
+{
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&clk_lock);
+
+    st->synced        = clk.synced;
+    st->from_gps      = clk.from_gps;
+    st->fixes         = clk.fixes;
+    st->steps         = clk.steps;
+    st->drift_ppb     = clk.drift_ppb;
+    st->last_error_ms = clk.last_error_ms;
+    st->since_fix_s   = clk.fixes ? (uint32_t)((now - clk.last_fix_up_ms) / 1000) : 0;
+
+    k_spin_unlock(&clk_lock, key);
+}
+
+int plantcare_time_init(void)
+{
+    if (plantcare_time_set_zone(TIME_DEFAULT_ZONE) < 0) {
+        printk("time: unknown zone %s, using UTC\n", TIME_DEFAULT_ZONE);
+    }
+
+    /* The RTC keeps running through a reset: start from it until GPS */
+    uint32_t rtc_s = rtc_load();
+
+    if (rtc_s != 0) {
+        k_spinlock_key_t key = k_spin_lock(&clk_lock);
+
+        clk.synced = true;
+        clk.anchor_up_ms = k_uptime_get();
+        clk.anchor_utc_ms = (int64_t)rtc_s * 1000;
+        k_spin_unlock(&clk_lock, key);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef PLANTCARE_TIME_H
+#define PLANTCARE_TIME_H
+
+#include <zephyr/kernel.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Wall clock (plantcare_time.c): k_uptime disciplined by GPS RMC fixes,
+ * with the uptime clock's drift tracked between fixes so the time stays
+ * good while the GPS is off. The hardware RTC, if enabled, is set from
+ * it and seeds it at boot.
+ *
+ * Times are UTC seconds since 1970-01-01 in a uint32_t (good until 2106);
+ * 0 means "not known yet".
+ */
+
+struct plantcare_civil {
+    uint16_t year;
+    uint8_t  month;     /* 1..12 */
+    uint8_t  day;       /* 1..31 */
+    uint8_t  hour;
+    uint8_t  min;
+    uint8_t  sec;
+};
+
+uint32_t plantcare_time_from_civil(const struct plantcare_civil *c);
+void plantcare_time_to_civil(uint32_t epoch_s, struct plantcare_civil *c);
+
+/* Boot step: time zone from devicetree, seed from the RTC if it has time */
+int plantcare_time_init(void);
+
+/* One GPS fix: UTC time of the fix and the uptime it was received at */
+void plantcare_time_gps_fix(uint32_t epoch_s, uint16_t ms, int64_t uptime_ms);
+
+/* UTC at a given uptime, drift compensated; 0 if never set */
+uint32_t plantcare_time_at(int64_t uptime_ms);
+
+static inline uint32_t plantcare_time_now(void)
+{
+    return plantcare_time_at(k_uptime_get());
+}
+
+/* Local time: offset of the selected zone at epoch_s, DST included */
+int32_t plantcare_time_local_offset_s(uint32_t epoch_s, bool *dst);
+
+/* "YYYY-MM-DD hh:mm:ss ZONE" in local time, or "(no time yet)" */
+int plantcare_time_format_local(uint32_t epoch_s, char *buf, size_t len);
+
+/* Zone by name ("UTC", "CET", "EST", ... see plantcare_time.c) */
+int plantcare_time_set_zone(const char *name);
+const char *plantcare_time_zone_name(bool dst);
+const char *plantcare_time_zone_list(size_t idx);
+
+struct plantcare_time_stats {
+    bool     synced;            /* set from GPS or RTC at least once */
+    bool     from_gps;          /* last set from GPS (vs RTC at boot) */
+    uint32_t fixes;             /* RMC fixes seen */
+    uint32_t steps;             /* clock stepped instead of slewed */
+    int32_t  drift_ppb;         /* uptime clock is slow by this much */
+    int32_t  last_error_ms;     /* GPS minus our clock at the last fix */
+    uint32_t since_fix_s;       /* 0 if no GPS fix yet */
+};
+
+void plantcare_time_get_stats(struct plantcare_time_stats *st);
+
+#endif /* PLANTCARE_TIME_H */
@@ -1,71 +1,216 @@
 // src/helpers/plantcare_units.c
 
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include "plantcare_units.h"
+#include "sensors/accelerometer_sensor.h"
 
 /*
  * Calibration constants (RAW ADC values).
  *
- * Start simple:
- *  - Map full ADC range 0..4095 to 0.0..100.0 %
- *  - Then, after you see real readings in the terminal,
- *    you can narrow these ranges to better match your sensors.
+ * These come from the /zephyr,user node of the board overlay, so each
+ * board can carry its own calibration without touching this file:
  *
- * Later you can do, for example:
- *   - LIGHT_RAW_MIN = raw in dark
- *   - LIGHT_RAW_MAX = raw in very bright light
- *   - SOIL_RAW_MIN  = raw in very dry soil
- *   - SOIL_RAW_MAX  = raw in very wet soil
+ *   zephyr,user {
+ *       light-raw-min = <0>;     raw in dark
+ *       light-raw-max = <400>;   raw in very bright light
+ *       soil-raw-min  = <0>;     raw in very dry soil
+ *       soil-raw-max  = <4095>;  raw in very wet soil
+ *   };
+ *
+ * If a property is missing we fall back to the defaults below.
+ */
+
+#define PLANTCARE_USER_NODE DT_PATH(zephyr_user)
+
+#define LIGHT_RAW_MIN   DT_PROP_OR(PLANTCARE_USER_NODE, light_raw_min, 0)
+#define LIGHT_RAW_MAX   DT_PROP_OR(PLANTCARE_USER_NODE, light_raw_max, 400)
+
+#define SOIL_RAW_MIN    DT_PROP_OR(PLANTCARE_USER_NODE, soil_raw_min, 0)
+#define SOIL_RAW_MAX    DT_PROP_OR(PLANTCARE_USER_NODE, soil_raw_max, 4095)
+
+BUILD_ASSERT(LIGHT_RAW_MAX > LIGHT_RAW_MIN, "light-raw-max must be > light-raw-min");
+BUILD_ASSERT(SOIL_RAW_MAX > SOIL_RAW_MIN, "soil-raw-max must be > soil-raw-min");
+
+/*
+ * Reciprocal-multiply: instead of 1000 * num / den at runtime we use
+ * (num * PCT_X10_SCALE(den)) >> 24, with the scale folded by the compiler.
+ * With the scale rounded up and a 24-bit shift this gives exactly the same
+ * result as the old 64-bit divide for every den in 1..4095 and 0 <= num <= den.
  */
+#define PCT_X10_SHIFT           24
+#define PCT_X10_SCALE(den)      \
+    ((((uint64_t)1000 << PCT_X10_SHIFT) + (den) - 1) / (den))
 
-#define LIGHT_RAW_MIN   0    
-#define LIGHT_RAW_MAX   400 
+#define LIGHT_SCALE     PCT_X10_SCALE(LIGHT_RAW_MAX - LIGHT_RAW_MIN)
+#define SOIL_SCALE      PCT_X10_SCALE(SOIL_RAW_MAX - SOIL_RAW_MIN)
 
-#define SOIL_RAW_MIN    0       /* adjust later after measuring */
-#define SOIL_RAW_MAX    4095    /* 12-bit ADC max */
+/*
+ * Active calibration. Starts from the devicetree values above and can be
+ * replaced at runtime by the field calibration (plantcare_calib.c). The
+ * scale is recomputed only when the range changes, so a conversion costs
+ * the same as with compile-time constants: clamp, multiply, shift.
+ */
+struct range_cal {
+    int32_t  raw_min;
+    int32_t  raw_max;
+    uint64_t scale;
+    bool     inverted;   /* true: raw_min maps to 100 %, raw_max to 0 % */
+};
+
+static struct range_cal light_cal = {
+    .raw_min = LIGHT_RAW_MIN,
+    .raw_max = LIGHT_RAW_MAX,
+    .scale   = LIGHT_SCALE,
+};
+
+static struct range_cal soil_cal = {
+    .raw_min = SOIL_RAW_MIN,
+    .raw_max = SOIL_RAW_MAX,
+    .scale   = SOIL_SCALE,
+};
+
+/* Set once soil_cal comes from a field calibration instead of devicetree */
+static bool soil_cal_runtime;
+
+static int32_t acc_off_x_g100;
+static int32_t acc_off_y_g100;
+static int32_t acc_off_z_g100;
 
 /* Map [raw_min, raw_max] -> [0.0, 100.0] %, result scaled *10 */
-static int32_t pct_x10_from_range(int32_t raw,
-                                  int32_t raw_min,
-                                  int32_t raw_max)
+static inline int32_t pct_x10_from_range(int32_t raw,
+                                         const struct range_cal *cal)
 {
     /* Clamp into range */
-    if (raw < raw_min) raw = raw_min;
-    if (raw > raw_max) raw = raw_max;
+    if (raw < cal->raw_min) raw = cal->raw_min;
+    if (raw > cal->raw_max) raw = cal->raw_max;
 
-    int32_t den = raw_max - raw_min;
-    if (den <= 0) {
-        /* Misconfiguration: avoid division by zero */
-        return 0;
+    uint64_t num = (uint64_t)(raw - cal->raw_min);
+    int32_t pct  = (int32_t)((num * cal->scale) >> PCT_X10_SHIFT);
+
+    return cal->inverted ? (1000 - pct) : pct;
+}
+
+static int range_cal_set(struct range_cal *cal, int32_t raw_lo, int32_t raw_hi)
+{
+    bool inverted = (raw_lo > raw_hi);
+    int32_t raw_min = inverted ? raw_hi : raw_lo;
+    int32_t raw_max = inverted ? raw_lo : raw_hi;
+
+    if (raw_min < 0 || raw_max > 4095 || raw_max <= raw_min) {
+        return -EINVAL;
     }
 
-    int32_t num = raw - raw_min;
+    cal->raw_min  = raw_min;
+    cal->raw_max  = raw_max;
+    cal->scale    = PCT_X10_SCALE((uint32_t)(raw_max - raw_min));
+    cal->inverted = inverted;
+    return 0;
+}
+
+int light_units_set_range(int32_t raw_dark, int32_t raw_bright)
+{
+    return range_cal_set(&light_cal, raw_dark, raw_bright);
+}
+
+int soil_units_set_range(int32_t raw_dry, int32_t raw_wet)
+{
+    int ret = range_cal_set(&soil_cal, raw_dry, raw_wet);
+    if (ret == 0) {
+        soil_cal_runtime = true;
+    }
+    return ret;
+}
+
+void accel_units_set_offset(int32_t off_x_g100, int32_t off_y_g100,
+                            int32_t off_z_g100)
+{
+    acc_off_x_g100 = off_x_g100;
+    acc_off_y_g100 = off_y_g100;
+    acc_off_z_g100 = off_z_g100;
+}
+
+void accel_units_get_offset(int32_t *off_x_g100, int32_t *off_y_g100,
+                            int32_t *off_z_g100)
+{
+    *off_x_g100 = acc_off_x_g100;
+    *off_y_g100 = acc_off_y_g100;
+    *off_z_g100 = acc_off_z_g100;
+}
+
+void accel_apply_offset(int32_t *x_g100, int32_t *y_g100, int32_t *z_g100)
+{
+    *x_g100 -= acc_off_x_g100;
+    *y_g100 -= acc_off_y_g100;
+    *z_g100 -= acc_off_z_g100;
+}
+
+void accel_apply_offset_raw(int16_t xyz[3])
+{
+    const int32_t off[3] = { acc_off_x_g100, acc_off_y_g100, acc_off_z_g100 };
+
+    for (int i = 0; i < 3; i++) {
+        int32_t v = xyz[i] - off[i] * ACCELEROMETER_COUNTS_PER_G / 100;
 
-    /* percentage * 10 = 1000 * num / den */
-    return (int32_t)((int64_t)num * 1000 / den);
+        xyz[i] = (int16_t)CLAMP(v, INT16_MIN, INT16_MAX);
+    }
 }
 
 int32_t light_raw_to_pct_x10(int32_t raw)
 {
-    /* Assume higher RAW = more light */
-    return pct_x10_from_range(raw, LIGHT_RAW_MIN, LIGHT_RAW_MAX);
+    /* Higher RAW = more light, unless the calibration says otherwise */
+    return pct_x10_from_range(raw, &light_cal);
 }
 
+#if DT_NODE_HAS_PROP(PLANTCARE_USER_NODE, soil_pct_lut)
+
+/*
+ * Non-linear soil probes: the overlay gives 17 breakpoints (percentage * 10)
+ * at raw = 0, 256, 512, ..., 4096. We interpolate linearly between them,
+ * using only shifts, so there is still no divide per sample.
+ * A field calibration (soil_units_set_range) takes precedence.
+ */
+#define SOIL_LUT_SHIFT  8
+#define SOIL_LUT_POINTS ((4096 >> SOIL_LUT_SHIFT) + 1)
+
+BUILD_ASSERT(DT_PROP_LEN(PLANTCARE_USER_NODE, soil_pct_lut) == SOIL_LUT_POINTS,
+             "soil-pct-lut must have 17 entries (raw step 256)");
+
+static const int16_t soil_pct_lut[SOIL_LUT_POINTS] =
+    DT_PROP(PLANTCARE_USER_NODE, soil_pct_lut);
+
 int32_t soil_raw_to_pct_x10(int32_t raw)
 {
-    /* Assume higher RAW = "more" of whatever we call 100% (wet or dry).
-     * If your sensor is reversed, you will later swap SOIL_RAW_MIN/MAX.
-     */
-    return pct_x10_from_range(raw, SOIL_RAW_MIN, SOIL_RAW_MAX);
+    if (soil_cal_runtime) {
+        return pct_x10_from_range(raw, &soil_cal);
+    }
+
+    if (raw < 0) raw = 0;
+    if (raw > 4095) raw = 4095;
+
+    uint32_t idx  = (uint32_t)raw >> SOIL_LUT_SHIFT;
+    int32_t  frac = raw & ((1 << SOIL_LUT_SHIFT) - 1);
+    int32_t  y0   = soil_pct_lut[idx];
+    int32_t  y1   = soil_pct_lut[idx + 1];
+
+    return y0 + (((y1 - y0) * frac) >> SOIL_LUT_SHIFT);
 }
 
-// src/helpers/plantcare_units.c
-#include <stdbool.h>
-#include <stdint.h>
-#include "plantcare_units.h"
+#else
 
-/* ... existing LIGHT/ SOIL code ... */
+int32_t soil_raw_to_pct_x10(int32_t raw)
+{
+    /* Higher RAW = "more" of whatever we call 100% (wet or dry).
+     * A reversed probe is handled by the field calibration (dry > wet),
+     * or describe it with soil-pct-lut in the overlay.
+     */
+    return pct_x10_from_range(raw, &soil_cal);
+}
+
+#endif
 
 int32_t accel_g100_to_ms2_x100(int32_t g100)
 {
@@ -74,6 +219,9 @@ int32_t accel_g100_to_ms2_x100(int32_t g100)
      *
      * Example:
      *   g100 = 100   => 1.00 g  => ~9.81 m/s^2 => 981 in return value
+     *
+     * The divisor is a constant, so the compiler already turns this into
+     * a multiply-shift.
      */
     return (g100 * 981) / 100;
-}
\ No newline at end of file
+}
@@ -20,4 +20,23 @@ int32_t soil_raw_to_pct_x10(int32_t raw);
  */
 int32_t accel_g100_to_ms2_x100(int32_t g100);
 
+/*
+ * Runtime calibration (see plantcare_calib.c).
+ * Endpoints are RAW ADC values; either order is accepted, so a probe that
+ * reads higher when dry works too. Return 0 or -EINVAL on a bad range,
+ * in which case the previous calibration stays active.
+ */
+int light_units_set_range(int32_t raw_dark, int32_t raw_bright);
+int soil_units_set_range(int32_t raw_dry, int32_t raw_wet);
+
+/* Zero-g offsets in g*100, subtracted from every accelerometer reading */
+void accel_units_set_offset(int32_t off_x_g100, int32_t off_y_g100,
+                            int32_t off_z_g100);
+void accel_units_get_offset(int32_t *off_x_g100, int32_t *off_y_g100,
+                            int32_t *off_z_g100);
+void accel_apply_offset(int32_t *x_g100, int32_t *y_g100, int32_t *z_g100);
+
+/* Same offsets on raw accelerometer counts (tilt estimator input) */
+void accel_apply_offset_raw(int16_t xyz[3]);
+
 #endif /* PLANTCARE_UNITS_H */
\ No newline at end of file
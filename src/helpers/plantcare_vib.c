@@ -0,0 +1,229 @@
+// src/helpers/plantcare_vib.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "plantcare_vib.h"
+#include "plantcare_fft.h"
+#include "sensors/accelerometer_sensor.h"
+
+#define VIB_NODE        DT_INST(0, plantcare_mma8451)
+#define VIB_N           DT_PROP_OR(VIB_NODE, vibration_batch, 64)
+#define VIB_BINS        (VIB_N / 2 + 1)
+
+BUILD_ASSERT(VIB_N >= 32 && VIB_N <= PLANTCARE_FFT_MAX && (VIB_N & (VIB_N - 1)) == 0,
+             "vibration-batch must be a power of two, 32..256");
+
+/*
+ * Samples go in shifted left by one after the mean is removed: 1 g is
+ * then 8192 LSB and ±4 g of swing still fits in q15. The FFT output is
+ * DFT / N, so a sine of amplitude A shows as A / 2 in bins k and N - k
+ * and its one-sided power 2 * (re² + im²) is A² / 2, the RMS².
+ */
+#define VIB_IN_SHIFT    1
+#define VIB_LSB_PER_G   (ACCELEROMETER_COUNTS_PER_G << VIB_IN_SHIFT)
+
+/* Upper band edges in Hz; the last band runs to the Nyquist bin */
+static const uint16_t band_hi_hz[PC_VIB_BAND_COUNT - 1] = { 10, 40, 80 };
+
+static int16_t  xyz[VIB_N][3];
+static int16_t  work[2 * VIB_N];
+static uint32_t power[VIB_BINS];
+
+static uint32_t sat_add_u32(uint32_t a, uint32_t b)
+{
+    uint32_t s = a + b;
+
+    return (s < a) ? UINT32_MAX : s;
+}
+
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t r = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+/* RMS in mg of a sum of one-sided bin powers (re² + im², not doubled) */
+static uint16_t power_to_mg(uint64_t p)
+{
+    uint32_t rms = isqrt64(2 * p);
+
+    return (uint16_t)MIN((uint64_t)rms * 1000 / VIB_LSB_PER_G, UINT16_MAX);
+}
+
+static void axis_power(int axis)
+{
+    int32_t sum = 0;
+
+    for (int i = 0; i < VIB_N; i++) {
+        sum += xyz[i][axis];
+    }
+
+    int32_t mean = sum / VIB_N;
+
+    for (int i = 0; i < VIB_N; i++) {
+        int32_t v = (xyz[i][axis] - mean) << VIB_IN_SHIFT;
+
+        work[2 * i]     = (int16_t)CLAMP(v, INT16_MIN, INT16_MAX);
+        work[2 * i + 1] = 0;
+    }
+
+    (void)plantcare_fft_q15(work, VIB_N);
+
+    /* Real input: bins 1..N/2 carry everything; the Nyquist bin is its
+     * own mirror, so it is counted once (halved to match the doubling).
+     */
+    for (int k = 1; k < VIB_BINS; k++) {
+        int32_t re = work[2 * k];
+        int32_t im = work[2 * k + 1];
+        uint32_t p = (uint32_t)(re * re) + (uint32_t)(im * im);
+
+        if (k == VIB_N / 2) {
+            p >>= 1;
+        }
+        power[k] = sat_add_u32(power[k], p);
+    }
+}
+
+/* Centre of bin k, Hz * 10 */
+static uint32_t bin_hz_x10(int k, uint16_t odr)
+{
+    return (uint32_t)k * odr * 10 / VIB_N;
+}
+
+/* Offset of a tone from peak bin k, in thousandths of a bin. With no
+ * window a tone at k + d has magnitudes in the ratio 1/|d| : 1/|1 - d| in
+ * bins k and k + 1, so d = |X[k+1]| / (|X[k]| + |X[k+1]|), taken toward
+ * the larger neighbour. A parabola through the powers is off by up to a
+ * quarter bin here.
+ */
+static int32_t peak_offset_milli(int k)
+{
+    if (k <= 1 || k >= VIB_BINS - 1) {
+        return 0;
+    }
+
+    bool right = power[k + 1] >= power[k - 1];
+    int64_t c = isqrt64(power[k]);
+    int64_t n = isqrt64(power[right ? k + 1 : k - 1]);
+
+    if (c + n == 0) {
+        return 0;
+    }
+
+    int32_t d = (int32_t)MIN(n * 1000 / (c + n), 500);
+
+    return right ? d : -d;
+}
+
+static void analyse(struct plantcare_vib_result *out, uint16_t odr)
+{
+    uint64_t band[PC_VIB_BAND_COUNT] = { 0 };
+    uint64_t total = 0;
+    int peak = 1;
+
+    for (int k = 1; k < VIB_BINS; k++) {
+        uint32_t hz_x10 = bin_hz_x10(k, odr);
+        int b = 0;
+
+        while (b < PC_VIB_BAND_COUNT - 1 && hz_x10 >= band_hi_hz[b] * 10U) {
+            b++;
+        }
+        band[b] += power[k];
+        total   += power[k];
+
+        if (power[k] > power[peak]) {
+            peak = k;
+        }
+    }
+
+    for (int b = 0; b < PC_VIB_BAND_COUNT; b++) {
+        out->band_mg[b] = power_to_mg(band[b]);
+    }
+    out->rms_mg = power_to_mg(total);
+
+    /* A stationary tone leaks into the neighbouring bins */
+    uint64_t peak_p = power[peak];
+
+    if (peak > 1) {
+        peak_p += power[peak - 1];
+    }
+    if (peak < VIB_BINS - 1) {
+        peak_p += power[peak + 1];
+    }
+
+    int64_t pos_milli = (int64_t)peak * 1000 + peak_offset_milli(peak);
+
+    out->peak_hz_x10  = (uint16_t)(pos_milli * odr * 10 / ((int64_t)VIB_N * 1000));
+    out->peak_mg      = power_to_mg(peak_p);
+    out->tonality_pct = total ? (uint8_t)(peak_p * 100 / total) : 0;
+}
+
+int plantcare_vib_run(struct plantcare_vib_result *out)
+{
+    static uint32_t seq;
+    uint16_t odr = accelerometer_sensor_odr_hz(0);
+    int64_t t0 = k_uptime_get();
+
+    int ret = accelerometer_sensor_read_batch(0, xyz, VIB_N);
+    if (ret < 0) {
+        return ret;
+    }
+
+    uint32_t capture_ms = (uint32_t)(k_uptime_get() - t0);
+    uint32_t c0 = k_cycle_get_32();
+
+    memset(power, 0, sizeof(power));
+    for (int axis = 0; axis < 3; axis++) {
+        axis_power(axis);
+    }
+
+    analyse(out, odr);
+
+    out->fft_us     = k_cyc_to_us_floor32(k_cycle_get_32() - c0);
+    out->capture_ms = capture_ms;
+    out->n          = VIB_N;
+    out->odr_hz     = odr;
+    out->seq        = ++seq;
+    return 0;
+}
+
+uint16_t plantcare_vib_batch_size(void)
+{
+    return VIB_N;
+}
+
+size_t plantcare_vib_ram_bytes(void)
+{
+    return sizeof(xyz) + sizeof(work) + sizeof(power);
+}
+
+const char *plantcare_vib_band_name(uint8_t band)
+{
+    static const char *const names[PC_VIB_BAND_COUNT] = {
+        [PC_VIB_BAND_LOW]  = "<10Hz",
+        [PC_VIB_BAND_MID]  = "10-40Hz",
+        [PC_VIB_BAND_HIGH] = "40-80Hz",
+        [PC_VIB_BAND_TOP]  = ">80Hz",
+    };
+
+    return (band < PC_VIB_BAND_COUNT) ? names[band] : "?";
+}
@@ -0,0 +1,66 @@
+#ifndef PLANTCARE_VIB_H
+#define PLANTCARE_VIB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Vibration spectrum of accelerometer instance 0 (plantcare_vib.c).
+ *
+ * A batch of N samples is read through the MMA8451 FIFO at the node's
+ * odr-hz, the mean (gravity, tilt) is removed per axis and each axis goes
+ * through a q15 FFT (plantcare_fft.h). The power of the three axes is
+ * summed per bin and reduced to a few bands and the strongest peak, so a
+ * fan or pump (narrow, steady peak) can be told apart from a knock
+ * (broad, low tonality).
+ *
+ * N is the vibration-batch property of the first plantcare,mma8451 node.
+ * Bounds per batch, all static (no heap, nothing on the stack):
+ *
+ *     N     RAM      capture @400 Hz   butterflies (3 axes)
+ *     32     388 B    80 ms              240
+ *     64     772 B   160 ms              576
+ *    128    1540 B   320 ms             1344
+ *    256    3076 B   640 ms             3072
+ *
+ * RAM is N * 6 (samples) + N * 4 (complex work) + (N / 2 + 1) * 4 (power).
+ * Capture time is N / odr-hz and the sensor thread sleeps through it.
+ * The FFT work is 3 * N/2 * log2(N) butterflies; its time on the target
+ * is measured on every batch and reported in fft_us ("pc vib").
+ */
+
+enum plantcare_vib_band {
+    PC_VIB_BAND_LOW = 0,    /* odr-hz / N..10 Hz: sway, knocks, steps */
+    PC_VIB_BAND_MID,        /* 10..40 Hz: fans, mains-driven pumps */
+    PC_VIB_BAND_HIGH,       /* 40..80 Hz */
+    PC_VIB_BAND_TOP,        /* 80 Hz..odr-hz / 2 */
+    PC_VIB_BAND_COUNT,
+};
+
+struct plantcare_vib_result {
+    uint32_t seq;           /* batches analysed since boot, 0 = none yet */
+    uint16_t n;             /* samples per batch */
+    uint16_t odr_hz;
+    uint16_t band_mg[PC_VIB_BAND_COUNT];    /* RMS per band, x+y+z, mg */
+    uint16_t rms_mg;        /* RMS of the whole batch without DC, mg */
+    uint16_t peak_hz_x10;   /* strongest bin, interpolated, Hz * 10 */
+    uint16_t peak_mg;       /* RMS of the peak (bin and neighbours), mg */
+    uint8_t  tonality_pct;  /* share of the power in the peak, % */
+    uint32_t capture_ms;
+    uint32_t fft_us;        /* FFT of the 3 axes and reduction, µs */
+};
+
+/* Capture and analyse one batch. Blocks for about N / odr-hz.
+ * Returns 0, or the driver's error (out is then unchanged).
+ */
+int plantcare_vib_run(struct plantcare_vib_result *out);
+
+/* Samples per batch (compile-time, from devicetree) */
+uint16_t plantcare_vib_batch_size(void);
+
+/* Static RAM of the sample, FFT and power buffers, bytes */
+size_t plantcare_vib_ram_bytes(void);
+
+const char *plantcare_vib_band_name(uint8_t band);
+
+#endif /* PLANTCARE_VIB_H */
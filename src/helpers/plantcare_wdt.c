@@ -0,0 +1,167 @@
+// src/helpers/plantcare_wdt.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/watchdog.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/printk.h>
+#include <string.h>
+
+#include "plantcare_wdt.h"
+
+/* The supervisor runs every WDT_CHECK_MS; the IWDG must survive a couple
+ * of missed checks so that only a real hang resets the board.
+ */
+#define WDT_CHECK_MS        1000
+#define WDT_HW_TIMEOUT_MS   4000
+
+#define WDT_NAME_LEN        12
+#define CRASH_MAGIC         0x57445443u   /* "WDTC" */
+
+static const struct device *const hw_wdt = DEVICE_DT_GET(DT_ALIAS(watchdog0));
+static int hw_wdt_channel = -1;
+
+struct wdt_channel {
+    const char *name;
+    uint32_t    deadline_ms;
+    int64_t     last_feed_ms;
+};
+
+static struct wdt_channel channels[PLANTCARE_WDT_MAX_CHANNELS];
+static int channel_count;
+static bool expired;
+static struct k_spinlock wdt_lock;
+
+/* Survives the IWDG reset (not a power cycle). Guarded by magic + CRC
+ * because no-init RAM holds garbage after power-up.
+ */
+struct crash_record {
+    uint32_t magic;
+    char     channel[WDT_NAME_LEN];
+    uint32_t deadline_ms;
+    uint32_t silent_ms;     /* time since the channel last checked in */
+    uint32_t uptime_ms;
+    uint32_t crc;
+};
+
+static __noinit struct crash_record crash;
+
+static uint32_t crash_crc(const struct crash_record *rec)
+{
+    return crc32_ieee((const uint8_t *)rec, offsetof(struct crash_record, crc));
+}
+
+static void crash_record_save(const struct wdt_channel *ch, int64_t now)
+{
+    memset(&crash, 0, sizeof(crash));
+    crash.magic = CRASH_MAGIC;
+    strncpy(crash.channel, ch->name, sizeof(crash.channel) - 1);
+    crash.deadline_ms = ch->deadline_ms;
+    crash.silent_ms   = (uint32_t)(now - ch->last_feed_ms);
+    crash.uptime_ms   = (uint32_t)now;
+    crash.crc         = crash_crc(&crash);
+}
+
+static void crash_record_report(void)
+{
+    if (crash.magic != CRASH_MAGIC || crash.crc != crash_crc(&crash)) {
+        return;
+    }
+
+    printk("*** Last reset by watchdog: '%s' silent for %u ms "
+           "(deadline %u ms) at uptime %u ms ***\n",
+           crash.channel, crash.silent_ms, crash.deadline_ms, crash.uptime_ms);
+
+    crash.magic = 0;
+}
+
+/* Timer (ISR) context */
+static void wdt_check(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&wdt_lock);
+
+    for (int i = 0; i < channel_count && !expired; i++) {
+        if (now - channels[i].last_feed_ms > channels[i].deadline_ms) {
+            crash_record_save(&channels[i], now);
+            expired = true;
+            printk("WDT: channel '%s' missed its deadline, resetting\n",
+                   channels[i].name);
+        }
+    }
+
+    /* Once a channel expired we stop feeding and let the IWDG bite */
+    if (!expired && hw_wdt_channel >= 0) {
+        wdt_feed(hw_wdt, hw_wdt_channel);
+    }
+
+    k_spin_unlock(&wdt_lock, key);
+}
+
+K_TIMER_DEFINE(wdt_timer, wdt_check, NULL);
+
+int plantcare_wdt_init(void)
+{
+    crash_record_report();
+
+    if (!device_is_ready(hw_wdt)) {
+        printk("WDT: %s not ready, running without hardware watchdog\n",
+               hw_wdt->name);
+        return -ENODEV;
+    }
+
+    struct wdt_timeout_cfg cfg = {
+        .window.min = 0,
+        .window.max = WDT_HW_TIMEOUT_MS,
+        .callback   = NULL,
+        .flags      = WDT_FLAG_RESET_SOC,
+    };
+
+    int ret = wdt_install_timeout(hw_wdt, &cfg);
+    if (ret < 0) {
+        printk("WDT: install timeout failed (err %d)\n", ret);
+        return ret;
+    }
+    hw_wdt_channel = ret;
+
+    /* Don't reset while the core is halted by a debugger */
+    ret = wdt_setup(hw_wdt, WDT_OPT_PAUSE_HALTED_BY_DBG);
+    if (ret < 0) {
+        printk("WDT: setup failed (err %d)\n", ret);
+        hw_wdt_channel = -1;
+        return ret;
+    }
+
+    k_timer_start(&wdt_timer, K_MSEC(WDT_CHECK_MS), K_MSEC(WDT_CHECK_MS));
+    return 0;
+}
+
+int plantcare_wdt_add(const char *name, uint32_t deadline_ms)
+{
+    int id = -ENOMEM;
+    k_spinlock_key_t key = k_spin_lock(&wdt_lock);
+
+    if (channel_count < PLANTCARE_WDT_MAX_CHANNELS) {
+        id = channel_count++;
+        channels[id].name         = name;
+        channels[id].deadline_ms  = deadline_ms;
+        channels[id].last_feed_ms = k_uptime_get();
+    }
+
+    k_spin_unlock(&wdt_lock, key);
+    return id;
+}
+
+void plantcare_wdt_feed(int id)
+{
+    if (id < 0 || id >= PLANTCARE_WDT_MAX_CHANNELS) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&wdt_lock);
+    channels[id].last_feed_ms = k_uptime_get();
+    k_spin_unlock(&wdt_lock, key);
+}
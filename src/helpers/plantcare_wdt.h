@@ -0,0 +1,31 @@
+#ifndef PLANTCARE_WDT_H
+#define PLANTCARE_WDT_H
+
+#include <stdint.h>
+
+/* Task watchdog on top of the IWDG.
+ *
+ * Every thread that must not hang registers a channel with its own
+ * deadline and checks in with plantcare_wdt_feed() more often than that.
+ * A supervisor timer feeds the IWDG only while every channel is within
+ * its deadline. When one misses, its name is written to a crash record
+ * in no-init RAM and the IWDG is left to reset the chip; the record is
+ * printed by plantcare_wdt_init() on the next boot.
+ */
+
+#define PLANTCARE_WDT_MAX_CHANNELS  8
+
+/* Report the previous crash (if any) and start the IWDG.
+ * Call once, first thing in main().
+ */
+int plantcare_wdt_init(void);
+
+/* Register a channel, returns its id (>= 0) or negative errno.
+ * The deadline starts counting from now.
+ */
+int plantcare_wdt_add(const char *name, uint32_t deadline_ms);
+
+/* Check in for channel id (any thread, any time) */
+void plantcare_wdt_feed(int id);
+
+#endif /* PLANTCARE_WDT_H */
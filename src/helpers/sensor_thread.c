@@ -1,33 +1,90 @@
 #include <zephyr/kernel.h>
 #include <zephyr/sys/printk.h>
+#include <zephyr/zbus/zbus.h>
+#include <string.h>
 
 #include "plantcare_config.h"
 #include "plantcare_state.h"
+#include "plantcare_bus.h"
+#include "plantcare_units.h"
+#include "plantcare_counters.h"
+#include "plantcare_health.h"
+#include "plantcare_wdt.h"
+#include "plantcare_boot.h"
+#include "plantcare_adapt.h"
+#include "plantcare_anomaly.h"
+#include "plantcare_color.h"
+#include "plantcare_nmea.h"
+#include "plantcare_time.h"
+#include "plantcare_tilt.h"
+#include "plantcare_vib.h"
+#include "plantcare_psychro.h"
+#include "plantcare_dli.h"
+#include "plantcare_drying.h"
+#include "sensor_thread.h"
 
 /* Sensors are under sensors/ */
-#include "sensors/soil_sensor.h"
-#include "sensors/light_sensor.h"
+#include "sensors/plant_adc.h"
 #include "sensors/humidity_sensor.h"
 #include "sensors/accelerometer_sensor.h"
 #include "sensors/rgb_sensor.h"
-#include "sensors/gps_sensor.h"   /* uses gps_sensor_init + gps_sensor_read_char */
+#include "sensors/gps_sensor.h"
+#include "sensors/i2c_bus.h"
+#include "sensors/i2c_mux.h"
 
+/* Right-size from the high-water mark in "pc mem" (plantcare_mem.h) */
 #define SENSOR_THREAD_STACK_SIZE 2048
 #define SENSOR_THREAD_PRIORITY   5
 
-/* Small helper to drain GPS UART and keep last NMEA line */
-static void gps_update(struct plantcare_data *data)
+/* One sampling cycle must finish within SENSOR_WDT_DEADLINE_MS; between
+ * cycles the thread wakes at least every SENSOR_WDT_FEED_MS to check in,
+ * however long the sampling period is.
+ */
+#define SENSOR_WDT_DEADLINE_MS   10000
+#define SENSOR_WDT_FEED_MS       2000
+
+/* The GPS RX ring (gps_sensor.c) holds 512 bytes */
+#define GPS_DRAIN_MAX            512
+
+/* GPS duty cycle: with a period of at least GPS_STANDBY_MIN_MS the
+ * receiver is in standby between fixes. When due it is woken and polled
+ * every GPS_AWAKE_POLL_MS until a valid RMC arrives (or GPS_FIX_TIMEOUT_MS
+ * passes without one), then put back to standby.
+ */
+#define GPS_STANDBY_MIN_MS       10000
+#define GPS_AWAKE_POLL_MS        2000
+#define GPS_FIX_TIMEOUT_MS       60000
+
+/* Vibration batches block the thread for N / odr-hz (plantcare_vib.h):
+ * at most one per VIB_MIN_INTERVAL_MS, however fast the accel is read.
+ */
+#define VIB_MIN_INTERVAL_MS      10000
+
+static int64_t vib_due_ms;
+
+static int64_t gps_woken_ms;
+static bool gps_fix;
+
+/* Small helper to drain GPS UART and keep last NMEA line.
+ * RMC lines also set the wall clock (plantcare_time.c).
+ * Returns true if a valid RMC fix was seen.
+ */
+static bool gps_update(struct plantcare_data *data)
 {
-    static char line[64];
+    /* NMEA allows 82 characters; RMC is usually over 63 */
+    static char line[83];
+    struct plantcare_nmea_rmc rmc;
     static size_t idx = 0;
 
     uint8_t ch;
     int ret;
     int iterations = 0;
+    bool fix = false;
+    uint32_t start = k_cycle_get_32();
 
-    /* Try to read a limited number of chars, so we don't block forever */
-    while (iterations < 200) {
-        ret = gps_sensor_read_char(&ch);   /* your existing function */
+    /* Read at most one ring's worth, so we don't block forever */
+    while (iterations < GPS_DRAIN_MAX) {
+        ret = gps_sensor_read_char(&ch);
         if (ret != 0) {
             break;  /* no more data right now */
         }
@@ -43,11 +100,27 @@ static void gps_update(struct plantcare_data *data)
             /* End of NMEA sentence */
             line[idx] = '\0';
 
+            if (plantcare_nmea_parse_rmc(line, &rmc) == 0 && rmc.valid) {
+                plantcare_time_gps_fix(plantcare_time_from_civil(&rmc.utc),
+                                       rmc.ms, gps_sensor_line_end_ms());
+                fix = true;
+            }
+
             /* Copy into shared struct (truncated) */
             for (size_t i = 0; i < sizeof(data->gps_last_sentence); i++) {
                 data->gps_last_sentence[i] = line[i];
                 if (line[i] == '\0') break;
             }
+            data->gps_last_sentence[sizeof(data->gps_last_sentence) - 1] = '\0';
+
+            /* Large payload: fill the channel buffer in place */
+            if (zbus_chan_claim(&pc_gps_chan, K_MSEC(10)) == 0) {
+                struct pc_msg_gps *msg = zbus_chan_msg(&pc_gps_chan);
+                memcpy(msg->sentence, line, sizeof(msg->sentence));
+                msg->sentence[sizeof(msg->sentence) - 1] = '\0';
+                zbus_chan_finish(&pc_gps_chan);
+                zbus_chan_notify(&pc_gps_chan, K_MSEC(10));
+            }
 
             idx = 0;
         } else {
@@ -60,60 +133,522 @@ static void gps_update(struct plantcare_data *data)
             }
         }
     }
+
+    gps_sensor_count_parse(k_cycle_get_32() - start);
+    return fix;
 }
 
-static void sensor_thread_entry(void *p1, void *p2, void *p3)
+/* Woken on every config change (mode / periods) and on-demand trigger */
+ZBUS_SUBSCRIBER_DEFINE(sensor_cfg_sub, 4);
+ZBUS_CHAN_ADD_OBS(pc_config_chan, sensor_cfg_sub, 1);
+ZBUS_CHAN_ADD_OBS(pc_trigger_chan, sensor_cfg_sub, 1);
+
+/* Last value of every sensor; groups that are not due keep their value */
+static struct plantcare_data data;
+static int64_t next_due_ms[PC_SENSOR_COUNT];
+
+void sensor_thread_trigger(void)
 {
-    struct plantcare_data data;
+    struct pc_msg_trigger msg = { .uptime_ms = k_uptime_get_32() };
 
-    while (1) {
-        /* Wait until main() says sensors are initialized */
-        if (!g_sensors_ready) {
-            k_msleep(100);
+    (void)zbus_chan_pub(&pc_trigger_chan, &msg, K_MSEC(100));
+}
+
+static uint32_t sensor_period_ms(const struct plantcare_mode_cfg *cfg,
+                                 enum plantcare_sensor s)
+{
+    uint32_t p = cfg->sensor_period_ms[s];
+
+    return p ? p : cfg->sampling_period_ms;
+}
+
+/* Each reader fills a local copy first and only commits it to the
+ * snapshot (and publishes it) when the whole group was read correctly,
+ * so a failed read never leaves stale or half-written values behind.
+ * I2C readers take an instance; only instance 0 goes into the snapshot,
+ * every instance is published on the group's channel.
+ *
+ * Instance 0 goes through the anomaly detector before it is published:
+ * an out-of-range value (e.g. Si7021 0xFFFF) is a failed read, and what
+ * listens on the channel (the alarm feed) only sees checked values.
+ */
+static int read_adc(uint8_t inst)
+{
+    struct pc_msg_adc adc;
+
+    ARG_UNUSED(inst);
+
+    /* --- Soil + light (ADC), every plant in one scan --- */
+    int ret = plant_adc_read_all(adc.plants);
+    if (ret < 0) {
+        return ret;
+    }
+
+    memcpy(data.plants, adc.plants, sizeof(data.plants));
+
+    int64_t now = k_uptime_get();
+    ret = plantcare_anomaly_update(PC_SENSOR_ADC, &data, now);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* The drying fit skips probes found out of range just now. Before
+     * the adaptive period: it asks whether soil is on trend.
+     */
+    plantcare_anomaly_get(data.anomaly, now);
+    plantcare_drying_update(&data, now);
+    memcpy(adc.drying, data.drying, sizeof(adc.drying));
+
+    zbus_chan_pub(&pc_adc_chan, &adc, K_MSEC(10));
+    return 0;
+}
+
+static int read_climate(uint8_t inst)
+{
+    struct pc_msg_climate climate = { .inst = inst };
+    struct plantcare_psychro psy;
+
+    /* --- Temp / humidity (Si7021) --- */
+    int ret = humidity_sensor_read(inst, &climate.hum_x100, &climate.temp_x100);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* Dew point and VPD go out with the reading they come from */
+    plantcare_psychro_compute(climate.temp_x100, climate.hum_x100, &psy);
+    climate.dew_x100 = psy.dew_x100;
+    climate.vpd_pa   = psy.vpd_pa;
+
+    if (inst == 0) {
+        data.temp_x100 = climate.temp_x100;
+        data.hum_x100  = climate.hum_x100;
+        data.dew_x100  = climate.dew_x100;
+        data.vpd_pa    = climate.vpd_pa;
+
+        ret = plantcare_anomaly_update(PC_SENSOR_CLIMATE, &data, k_uptime_get());
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    zbus_chan_pub(&pc_climate_chan, &climate, K_MSEC(10));
+    return 0;
+}
+
+static int read_accel(uint8_t inst)
+{
+    struct pc_msg_accel accel = {
+        .inst = inst,
+        .tilt_cdeg = PLANTCARE_TILT_NO_REST,
+    };
+    int16_t raw[3];
+
+    /* --- Accelerometer (MMA8451) --- */
+    int ret = accelerometer_sensor_read_raw(inst, raw);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* The field calibration is for the board's own accelerometer */
+    if (inst == 0) {
+        accel_apply_offset_raw(raw);
+        plantcare_tilt_update(raw, &data.tilt);
+    }
+
+    accel.x_g100 = accelerometer_counts_to_g100(raw[0]);
+    accel.y_g100 = accelerometer_counts_to_g100(raw[1]);
+    accel.z_g100 = accelerometer_counts_to_g100(raw[2]);
+
+    if (inst == 0) {
+        data.acc_x_g100 = accel.x_g100;
+        data.acc_y_g100 = accel.y_g100;
+        data.acc_z_g100 = accel.z_g100;
+        accel.tilt_cdeg = data.tilt.tilt_cdeg;
+
+        int64_t now = k_uptime_get();
+        ret = plantcare_anomaly_update(PC_SENSOR_ACCEL, &data, now);
+        if (ret < 0) {
+            return ret;
+        }
+
+        /* A failed batch keeps the last spectrum, the g reading stands */
+        if (now >= vib_due_ms) {
+            vib_due_ms = now + VIB_MIN_INTERVAL_MS;
+            (void)plantcare_vib_run(&data.vib);
+        }
+    }
+    zbus_chan_pub(&pc_accel_chan, &accel, K_MSEC(10));
+    return 0;
+}
+
+static int read_color(uint8_t inst)
+{
+    struct pc_msg_color color = { .inst = inst };
+
+    /* --- Color sensor (TCS34725) --- */
+    int ret = rgb_sensor_read(inst, &color.clr, &color.red, &color.green,
+                              &color.blue);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* Chromaticity, hue/CCT/lux and leaf class (plantcare_color.c) */
+    plantcare_color_process(color.clr, color.red, color.green, color.blue,
+                            &color.res);
+
+    if (inst == 0) {
+        data.clr        = color.clr;
+        data.red        = color.red;
+        data.green      = color.green;
+        data.blue       = color.blue;
+        data.leaf_class = color.res.leaf_class;
+        data.hue_x10    = color.res.hue_x10;
+        data.cct_k      = color.res.cct_k;
+        data.lux        = color.res.lux;
+    }
+    zbus_chan_pub(&pc_color_chan, &color, K_MSEC(10));
+    return 0;
+}
+
+static int read_gps(uint8_t inst)
+{
+    ARG_UNUSED(inst);
+
+    /* --- GPS: wake it if it sleeps, else update last NMEA sentence --- */
+    if (!gps_sensor_is_awake()) {
+        gps_woken_ms = k_uptime_get();
+        gps_fix = false;
+        return gps_sensor_wake();
+    }
+    gps_fix |= gps_update(&data);
+    return 0;
+}
+
+/* After a GPS read: back to standby once it has a fix, and when to look
+ * again. Short periods keep it awake and just poll often enough for the
+ * RX ring.
+ */
+static uint32_t gps_next_period(uint32_t period, int64_t now)
+{
+    if (period < GPS_STANDBY_MIN_MS) {
+        gps_woken_ms = now;
+        return MIN(period, GPS_AWAKE_POLL_MS);
+    }
+
+    int64_t awake_ms = now - gps_woken_ms;
+
+    if (!gps_fix && awake_ms < GPS_FIX_TIMEOUT_MS) {
+        return GPS_AWAKE_POLL_MS;
+    }
+
+    (void)gps_sensor_standby();
+    return (uint32_t)MAX((int64_t)period - awake_ms, GPS_AWAKE_POLL_MS);
+}
+
+static int init_adc(uint8_t inst)
+{
+    ARG_UNUSED(inst);
+
+    return plant_adc_init();
+}
+
+struct sensor_ops {
+    int (*read)(uint8_t inst);
+    int (*init)(uint8_t inst);          /* re-run after a failure (hot-plug) */
+    uint8_t (*count)(void);             /* NULL: one instance */
+    uint8_t (*mux_channel)(uint8_t inst);
+    bool on_i2c;                        /* failures may come from a stuck I2C bus */
+};
+
+static const struct sensor_ops sensor_ops[PC_SENSOR_COUNT] = {
+    [PC_SENSOR_ADC]     = { read_adc,     init_adc },
+    [PC_SENSOR_CLIMATE] = { read_climate, humidity_sensor_init,
+                            humidity_sensor_count,
+                            humidity_sensor_mux_channel,      true },
+    [PC_SENSOR_ACCEL]   = { read_accel,   accelerometer_sensor_init,
+                            accelerometer_sensor_count,
+                            accelerometer_sensor_mux_channel, true },
+    [PC_SENSOR_COLOR]   = { read_color,   rgb_sensor_init,
+                            rgb_sensor_count,
+                            rgb_sensor_mux_channel,           true },
+    [PC_SENSOR_GPS]     = { read_gps,     NULL },
+};
+
+/* Second failure in a row on an I2C sensor: try to free the bus */
+#define I2C_RECOVER_AFTER_FAILS  2
+
+/* Extra instances (1..n) that failed and are re-initialised before their
+ * next read. Instance 0 goes through the group's health/backoff instead.
+ */
+static uint8_t inst_failed[PC_SENSOR_COUNT];
+
+static uint8_t sensor_count(enum plantcare_sensor s)
+{
+    return sensor_ops[s].count ? sensor_ops[s].count() : 1;
+}
+
+static uint8_t sensor_mux_channel(enum plantcare_sensor s, uint8_t inst)
+{
+    return sensor_ops[s].mux_channel ? sensor_ops[s].mux_channel(inst)
+                                     : I2C_MUX_ANY;
+}
+
+/* Start a group, honouring its backoff. Returns 0 if it should be read,
+ * -EAGAIN if it is backing off, or the error of a failed re-init.
+ */
+static int sensor_begin(enum plantcare_sensor s)
+{
+    const struct sensor_ops *ops = &sensor_ops[s];
+    int64_t now = k_uptime_get();
+    int ret = 0;
+
+    if (!plantcare_health_should_try(s, now)) {
+        return -EAGAIN;     /* backing off, costs nothing this cycle */
+    }
+
+    if (plantcare_health_needs_init(s) && ops->init) {
+        ret = ops->init(0);
+        if (ret == 0) {
+            plantcare_counter_inc(PC_CNT_REINITS);
+        }
+    }
+    return ret;
+}
+
+/* One instance of group s; returns instance 0's read result */
+static int sensor_read_inst(enum plantcare_sensor s, uint8_t inst)
+{
+    const struct sensor_ops *ops = &sensor_ops[s];
+    int ret = 0;
+
+    if (inst == 0) {
+        return ops->read(0);
+    }
+
+    if ((inst_failed[s] & BIT(inst)) && ops->init) {
+        ret = ops->init(inst);
+    }
+    if (ret == 0) {
+        ret = ops->read(inst);
+    }
+
+    if (ret < 0) {
+        if (!(inst_failed[s] & BIT(inst))) {
+            printk("sensor %s %u: read failed (err %d)\n",
+                   plantcare_sensor_name(s), inst, ret);
+        }
+        inst_failed[s] |= (uint8_t)BIT(inst);
+    } else {
+        inst_failed[s] &= (uint8_t)~BIT(inst);
+    }
+    return 0;
+}
+
+/* Mux channel as a bit: 0..7, I2C_MUX_OFF is bit 8 */
+static uint16_t mux_bit(uint8_t ch)
+{
+    return (ch == I2C_MUX_OFF) ? BIT(8) : BIT(ch);
+}
+
+/* Read every instance of the groups in due. Sensors that need no mux
+ * channel go first; then each channel is opened once, starting with the
+ * one left open by the last cycle, and everything behind it is read
+ * before moving on. ret[s] gets instance 0's result.
+ */
+static void sensor_read_due(uint32_t due, int *ret)
+{
+    uint16_t chans = 0;
+
+    for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+        if (!(due & BIT(s))) {
             continue;
         }
+        for (uint8_t i = 0; i < sensor_count(s); i++) {
+            uint8_t ch = sensor_mux_channel(s, i);
 
-        /* Now it is safe to talk to sensors */
+            if (ch == I2C_MUX_ANY) {
+                int r = sensor_read_inst(s, i);
+                if (i == 0) {
+                    ret[s] = r;
+                }
+            } else {
+                chans |= mux_bit(ch);
+            }
+        }
+    }
+
+    uint8_t cur = i2c_mux_current();
+    uint16_t first = (cur != I2C_MUX_ANY) ? (chans & mux_bit(cur)) : 0;
+
+    while (chans) {
+        uint16_t bit = first ? first : (uint16_t)(chans & -chans);
+
+        first = 0;
+        chans &= (uint16_t)~bit;
 
-        data.gps_last_sentence[0] = '\0';
-        /* --- Soil + light (ADC) --- */
-        soil_sensor_read(&data.soil_raw,  &data.soil_mv);
-        light_sensor_read(&data.light_raw, &data.light_mv);
+        for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+            if (!(due & BIT(s))) {
+                continue;
+            }
+            for (uint8_t i = 0; i < sensor_count(s); i++) {
+                uint8_t ch = sensor_mux_channel(s, i);
 
-        /* --- Temp / humidity (Si7021) --- */
-        humidity_sensor_read(&data.hum_x100, &data.temp_x100);
+                if (ch != I2C_MUX_ANY && mux_bit(ch) == bit) {
+                    int r = sensor_read_inst(s, i);
+                    if (i == 0) {
+                        ret[s] = r;
+                    }
+                }
+            }
+        }
+    }
+}
 
-        /* --- Accelerometer (MMA8451) --- */
-        accelerometer_sensor_read(&data.acc_x_g100,
-                                  &data.acc_y_g100,
-                                  &data.acc_z_g100);
+/* Finish a group that was tried: counters, health */
+static int sensor_end(enum plantcare_sensor s, int ret)
+{
+    const struct sensor_ops *ops = &sensor_ops[s];
+    struct plantcare_sensor_health h;
+    int64_t now = k_uptime_get();
 
-        /* --- Color sensor (TCS34725) --- */
-        rgb_sensor_read(&data.clr, &data.red, &data.green, &data.blue);
+    plantcare_counter_sensor_read(s, ret);
+    plantcare_health_report(s, ret, now);
 
-        /* Compute dominant color */
-        data.dom_color = DOM_COLOR_UNKNOWN;
-        if (data.red >= data.green && data.red >= data.blue) {
-            data.dom_color = DOM_COLOR_RED;
-        } else if (data.green >= data.red && data.green >= data.blue) {
-            data.dom_color = DOM_COLOR_GREEN;
-        } else if (data.blue >= data.red && data.blue >= data.green) {
-            data.dom_color = DOM_COLOR_BLUE;
+    if (ret < 0) {
+        plantcare_health_get(s, &h);
+        printk("sensor %s: read failed (err %d), retry in %d ms\n",
+               plantcare_sensor_name(s), ret, (int)(h.retry_at_ms - now));
+
+        if (ops->on_i2c && h.fails == I2C_RECOVER_AFTER_FAILS) {
+            plantcare_counter_inc(PC_CNT_BUS_RECOVERIES);
+            (void)i2c_sensors_recover_bus();
         }
+    }
+    return ret;
+}
+
+/* Fixed period, or the adaptive controller's choice after a good read */
+static uint32_t sensor_next_period(const struct plantcare_mode_cfg *cfg,
+                                   enum plantcare_sensor s, int ret,
+                                   int64_t now)
+{
+    uint32_t period = sensor_period_ms(cfg, s);
 
-        /* --- GPS: update last NMEA sentence --- */
-        gps_update(&data);
+    if (s == PC_SENSOR_GPS) {
+        return gps_next_period(period, now);
+    }
+    if (cfg->adapt_ceiling_ms == 0) {
+        return period;
+    }
+
+    uint32_t floor = cfg->adapt_floor_ms ? cfg->adapt_floor_ms : period;
+    if (ret < 0) {
+        return floor;
+    }
+    return plantcare_adapt_next_period(s, &data, floor,
+                                       cfg->adapt_ceiling_ms, now);
+}
+
+static void sensor_thread_entry(void *p1, void *p2, void *p3)
+{
+    struct plantcare_mode_cfg cfg;
+    const struct zbus_channel *chan;
+    bool read_all = true;
+    bool first = true;
+    int wdt_id;
+
+    /* main() gives the semaphore once sensors are initialized and the
+     * first configuration is published; drop that publication's
+     * notification, the first cycle reads everything anyway.
+     */
+    plantcare_boot_wait_ready();
+    while (zbus_sub_wait(&sensor_cfg_sub, &chan, K_NO_WAIT) == 0) {
+    }
 
-        /* If no sentence yet, ensure string is null-terminated */
-        if (data.gps_last_sentence[0] == '\0') {
-            data.gps_last_sentence[0] = '\0';
+    wdt_id = plantcare_wdt_add("sensor", SENSOR_WDT_DEADLINE_MS);
+
+    while (1) {
+        /* Now it is safe to talk to sensors */
+        plantcare_config_get(&cfg);
+
+        /* Read every sensor group that is due (all of them after a
+         * config change or an on-demand trigger).
+         */
+        int64_t now = k_uptime_get();
+        int result[PC_SENSOR_COUNT];
+        uint32_t tried = 0;
+        uint32_t due = 0;
+        uint32_t fresh = 0;
+
+        for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+            if (read_all || now >= next_due_ms[s]) {
+                result[s] = sensor_begin(s);
+                tried |= BIT(s);
+                if (result[s] == 0) {
+                    due |= BIT(s);
+                }
+            }
+        }
+
+        /* I2C reads grouped by mux channel across all due groups */
+        sensor_read_due(due, result);
+
+        for (int s = 0; s < PC_SENSOR_COUNT; s++) {
+            if (!(tried & BIT(s))) {
+                continue;
+            }
+            if (result[s] != -EAGAIN) {
+                result[s] = sensor_end(s, result[s]);
+            }
+            if (result[s] == 0) {
+                fresh |= BIT(s);
+            }
+            /* From the cycle's start, not the end of this group's read:
+             * groups due together stay together, one snapshot for all
+             */
+            next_due_ms[s] = now + sensor_next_period(&cfg, s, result[s], now);
         }
 
+        data.valid_mask = plantcare_health_valid_mask();
+        data.fresh_mask = (uint8_t)fresh;
+        plantcare_anomaly_get(data.anomaly, k_uptime_get());
+        data.epoch_s = plantcare_time_now();
+        plantcare_dli_update(&data, fresh, k_uptime_get());
+
         /* Publish to shared state */
         plantcare_state_publish(&data);
+        plantcare_counter_inc(PC_CNT_CYCLES);
+
+        if (first) {
+            plantcare_boot_first_sample();
+            first = false;
+        }
 
-        /* Sleep according to current mode (2s Test, 30s Normal later) */
-        k_msleep(g_sampling_period_ms);
+        /* Sleep until the next sensor group is due (2s Test, 30s Normal
+         * by default), but wake up right away if the config changes or
+         * someone asks for a read.
+         */
+        int64_t next = next_due_ms[0];
+        for (int s = 1; s < PC_SENSOR_COUNT; s++) {
+            next = MIN(next, next_due_ms[s]);
+        }
+        int64_t wait_ms;
+        int ret;
+
+        do {
+            plantcare_wdt_feed(wdt_id);
+            wait_ms = MAX(next - k_uptime_get(), 0);
+            ret = zbus_sub_wait(&sensor_cfg_sub, &chan,
+                                K_MSEC(MIN(wait_ms, SENSOR_WDT_FEED_MS)));
+        } while (ret != 0 && k_uptime_get() < next);
+
+        read_all = (ret == 0);
+        if (read_all && chan == &pc_config_chan) {
+            /* New periods: adaptive controllers start again at the floor */
+            plantcare_adapt_reset();
+        }
+        if (read_all && chan == &pc_trigger_chan) {
+            plantcare_counter_inc(PC_CNT_TRIGGERS);
+        }
     }
 }
 
@@ -0,0 +1,9 @@
+#ifndef SENSOR_THREAD_H
+#define SENSOR_THREAD_H
+
+/* Ask the background sensor thread to read every sensor now.
+ * Returns immediately; the new snapshot is published when done.
+ */
+void sensor_thread_trigger(void);
+
+#endif /* SENSOR_THREAD_H */
@@ -3,18 +3,16 @@
 
 #include "plantcare_modes.h"
 
-/* Sensors in sensors/ */
-#include "sensors/soil_sensor.h"
-#include "sensors/light_sensor.h"
-#include "sensors/humidity_sensor.h"
-#include "sensors/accelerometer_sensor.h"
-#include "sensors/rgb_sensor.h"
-#include "sensors/leds.h"
-#include "sensors/gps_sensor.h"
-#include "sensors/button.h"
 #include "helpers/plantcare_config.h"
-#include "sensors/led2.h"
-#include "sensors/led1.h"
+#include "helpers/plantcare_boot.h"
+#include "helpers/plantcare_wdt.h"
+
+static int mode_wdt = -1;
+
+void plantcare_mode_checkin(void)
+{
+    plantcare_wdt_feed(mode_wdt);
+}
 
 void main(void)
 {
@@ -22,55 +20,19 @@ void main(void)
 
     printk("PlantCare booting...\n");
 
-    /* ---- Initialize all sensors and LEDs (TM1) ---- */
-
-    ret = soil_sensor_init();
-    if (ret) printk("soil_sensor_init failed: %d\n", ret);
-
-    ret = light_sensor_init();
-    if (ret) printk("light_sensor_init failed: %d\n", ret);
-
-    ret = humidity_sensor_init();
-    if (ret) printk("humidity_sensor_init failed: %d\n", ret);
+    /* Watchdog first: a driver that hangs during init is caught too */
+    ret = plantcare_wdt_init();
+    if (ret) printk("plantcare_wdt_init failed: %d\n", ret);
 
-    ret = accelerometer_sensor_init();
-    if (ret) printk("accelerometer_sensor_init failed: %d\n", ret);
+    mode_wdt = plantcare_wdt_add("mode", PLANTCARE_MODE_WDT_MS);
 
-    ret = rgb_sensor_init();
-    if (ret) printk("rgb_sensor_init failed: %d\n", ret);
-
-    ret = leds_init();
-    if (ret) printk("leds_init failed: %d\n", ret);
-
-    ret = led1_init();
-    if (ret) printk("led1_init failed: %d\n", ret);
-
-    ret = led2_init();
-    if (ret) printk("led2_init failed: %d\n", ret);
-
-    ret = gps_sensor_init();
-    if (ret) printk("gps_sensor_init failed: %d\n", ret);
-
-    ret = button_init();
-    if (ret) printk("buttonr_init failed: %d\n", ret);
-
-    g_sensors_ready = true;
-    printk("Initialization done. Entering TEST MODE.\n");
+    /* ---- Initialize all sensors and LEDs (TM1) ---- */
+    plantcare_boot_run();
 
-    /* Start in TEST MODE */
-    g_current_mode = PLANTCARE_MODE_TEST;
+    /* Start in TEST MODE, then let the sensor thread go */
+    plantcare_mode_start(PLANTCARE_MODE_TEST);
+    plantcare_boot_ready();
+    printk("Initialization done.\n");
 
-    while (1) {
-        switch (g_current_mode) {
-        case PLANTCARE_MODE_TEST:
-            plantcare_run_test_mode();
-            break;
-        case PLANTCARE_MODE_NORMAL:
-            plantcare_run_normal_mode();   // stub for now
-            break;
-        default:
-            g_current_mode = PLANTCARE_MODE_TEST;
-            break;
-        }
-    }
+    plantcare_mode_run();
 }
\ No newline at end of file
@@ -3,46 +3,208 @@
 #include <zephyr/drivers/i2c.h>
 #include <stdint.h>
 #include "i2c_helpers.h"
+#include "i2c_mux.h"
 #include "accelerometer_sensor.h"
 
-/* Under the hood: MMA8451 */
-static const struct i2c_dt_spec accel_i2c =
-    I2C_DT_SPEC_GET(DT_NODELABEL(mma8451));
+/* Under the hood: MMA8451, one per "plantcare,mma8451" node */
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(plantcare_mma8451) >= 1,
+             "need a plantcare,mma8451 node");
 
-#define REG_CTRL_REG1     0x2A
-#define REG_XYZ_DATA_CFG  0x0E
+static struct i2c_mux_dev mma8451[] = {
+    DT_FOREACH_STATUS_OKAY(plantcare_mma8451, I2C_MUX_DT_DEV)
+};
+
+#define ODR_HZ(node)  DT_PROP_OR(node, odr_hz, 400),
+
+static const uint16_t mma8451_odr_hz[] = {
+    DT_FOREACH_STATUS_OKAY(plantcare_mma8451, ODR_HZ)
+};
+
+#define REG_F_STATUS      0x00
 #define REG_OUT_X_MSB     0x01
+#define REG_F_SETUP       0x09
+#define REG_XYZ_DATA_CFG  0x0E
+#define REG_CTRL_REG1     0x2A
+
+#define CTRL_REG1_ACTIVE  0x01
+#define CTRL_REG1_DR_MASK 0x38
+#define F_SETUP_OFF       0x00
+#define F_SETUP_FILL      0x80      /* stop accepting samples when full */
+#define F_STATUS_CNT_MASK 0x3F
+
+#define FIFO_DEPTH        32
+/* Drain before the FIFO is full, so a batch has no gaps */
+#define FIFO_CHUNK        24
+
+BUILD_ASSERT(FIFO_CHUNK < FIFO_DEPTH, "FIFO_CHUNK must leave headroom in the FIFO");
+
+uint8_t accelerometer_sensor_count(void)
+{
+    return ARRAY_SIZE(mma8451);
+}
+
+uint8_t accelerometer_sensor_mux_channel(uint8_t inst)
+{
+    return mma8451[inst].mux_channel;
+}
 
-int accelerometer_sensor_init(void)
+uint16_t accelerometer_sensor_odr_hz(uint8_t inst)
+{
+    return mma8451_odr_hz[inst];
+}
+
+/* CTRL_REG1 DR[2:0]: 800 Hz >> DR */
+static uint8_t odr_bits(uint16_t hz)
+{
+    uint8_t dr = 0;
+
+    while (dr < 4 && (800U >> dr) > hz) {
+        dr++;
+    }
+    return (uint8_t)(dr << 3);
+}
+
+int accelerometer_sensor_init(uint8_t inst)
 {
     uint8_t val;
-    int ret = i2c_read_u8_dt(&accel_i2c, REG_CTRL_REG1, &val);
+
+    if (inst >= ARRAY_SIZE(mma8451)) {
+        return -EINVAL;
+    }
+
+    i2c_mux_isolate_direct(mma8451, ARRAY_SIZE(mma8451));
+
+    const struct i2c_dt_spec *spec = &mma8451[inst].spec;
+    int ret = i2c_mux_select(&mma8451[inst]);
+    if (ret < 0) return ret;
+
+    ret = i2c_read_u8_dt(spec, REG_CTRL_REG1, &val);
     if (ret < 0) return ret;
 
     /* standby */
-    i2c_write_u8_dt(&accel_i2c, REG_CTRL_REG1, val & ~0x01);
-    /* ±2g range */
-    i2c_write_u8_dt(&accel_i2c, REG_XYZ_DATA_CFG, 0x00);
-    /* active */
-    i2c_write_u8_dt(&accel_i2c, REG_CTRL_REG1, val | 0x01);
+    val &= ~CTRL_REG1_ACTIVE;
+    i2c_write_u8_dt(spec, REG_CTRL_REG1, val);
+    /* ±2g range, FIFO off */
+    i2c_write_u8_dt(spec, REG_XYZ_DATA_CFG, 0x00);
+    i2c_write_u8_dt(spec, REG_F_SETUP, F_SETUP_OFF);
+    /* data rate (can only change in standby), then active */
+    val = (val & ~CTRL_REG1_DR_MASK) | odr_bits(mma8451_odr_hz[inst]);
+    i2c_write_u8_dt(spec, REG_CTRL_REG1, val | CTRL_REG1_ACTIVE);
 
-    printk("Accelerometer sensor initialized\n");
+    printk("Accelerometer sensor %u initialized\n", inst);
     return 0;
 }
 
-int accelerometer_sensor_read(int32_t *x_g100, int32_t *y_g100, int32_t *z_g100)
+int accelerometer_sensor_init_all(void)
+{
+    int ret0 = accelerometer_sensor_init(0);
+
+    for (uint8_t i = 1; i < ARRAY_SIZE(mma8451); i++) {
+        (void)accelerometer_sensor_init(i);
+    }
+    return ret0;
+}
+
+int accelerometer_sensor_read_raw(uint8_t inst, int16_t xyz[3])
 {
     uint8_t buf[6];
-    int ret = i2c_burst_read_dt_checked(&accel_i2c, REG_OUT_X_MSB, buf, sizeof(buf));
+
+    if (inst >= ARRAY_SIZE(mma8451)) {
+        return -EINVAL;
+    }
+
+    int ret = i2c_mux_select(&mma8451[inst]);
+    if (ret < 0) return ret;
+
+    ret = i2c_burst_read_dt_checked(&mma8451[inst].spec, REG_OUT_X_MSB,
+                                    buf, sizeof(buf));
     if (ret < 0) return ret;
 
-    int16_t raw_x = (int16_t)((buf[0] << 8) | buf[1]) >> 2;
-    int16_t raw_y = (int16_t)((buf[2] << 8) | buf[3]) >> 2;
-    int16_t raw_z = (int16_t)((buf[4] << 8) | buf[5]) >> 2;
+    xyz[0] = (int16_t)((buf[0] << 8) | buf[1]) >> 2;
+    xyz[1] = (int16_t)((buf[2] << 8) | buf[3]) >> 2;
+    xyz[2] = (int16_t)((buf[4] << 8) | buf[5]) >> 2;
+
+    return 0;
+}
+
+int32_t accelerometer_counts_to_g100(int16_t counts)
+{
+    /* Round, so ±0.0049 g does not all become 0 and -1 g is not -0.99 g */
+    return DIV_ROUND_CLOSEST((int32_t)counts * 100, ACCELEROMETER_COUNTS_PER_G);
+}
+
+int accelerometer_sensor_read(uint8_t inst,
+                              int32_t *x_g100, int32_t *y_g100, int32_t *z_g100)
+{
+    int16_t xyz[3];
 
-    *x_g100 = (int32_t)raw_x * 100 / 4096;
-    *y_g100 = (int32_t)raw_y * 100 / 4096;
-    *z_g100 = (int32_t)raw_z * 100 / 4096;
+    int ret = accelerometer_sensor_read_raw(inst, xyz);
+    if (ret < 0) return ret;
+
+    *x_g100 = accelerometer_counts_to_g100(xyz[0]);
+    *y_g100 = accelerometer_counts_to_g100(xyz[1]);
+    *z_g100 = accelerometer_counts_to_g100(xyz[2]);
 
     return 0;
-}
\ No newline at end of file
+}
+
+int accelerometer_sensor_read_batch(uint8_t inst, int16_t (*xyz)[3], size_t n)
+{
+    static uint8_t buf[FIFO_CHUNK * 6];
+
+    if (inst >= ARRAY_SIZE(mma8451)) {
+        return -EINVAL;
+    }
+
+    const struct i2c_dt_spec *spec = &mma8451[inst].spec;
+    uint32_t odr = mma8451_odr_hz[inst];
+    int64_t deadline = k_uptime_get() + 2 * (int64_t)n * 1000 / odr + 50;
+    size_t got = 0;
+    uint8_t st;
+
+    int ret = i2c_mux_select(&mma8451[inst]);
+    if (ret < 0) return ret;
+
+    /* Leaving mode 00 flushes the FIFO: the batch starts now */
+    ret = i2c_write_u8_dt(spec, REG_F_SETUP, F_SETUP_OFF);
+    if (ret == 0) {
+        ret = i2c_write_u8_dt(spec, REG_F_SETUP, F_SETUP_FILL);
+    }
+
+    while (ret == 0 && got < n) {
+        size_t want = MIN(n - got, (size_t)FIFO_CHUNK);
+
+        k_msleep((int32_t)((want * 1000 + odr - 1) / odr));
+
+        ret = i2c_read_u8_dt(spec, REG_F_STATUS, &st);
+        if (ret < 0) {
+            break;
+        }
+
+        /* In FIFO mode a burst from OUT_X_MSB wraps every 6 bytes */
+        size_t cnt = MIN((size_t)(st & F_STATUS_CNT_MASK), want);
+        if (cnt > 0) {
+            ret = i2c_burst_read_dt_checked(spec, REG_OUT_X_MSB, buf, cnt * 6);
+            if (ret < 0) {
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < cnt; i++, got++) {
+            const uint8_t *b = &buf[i * 6];
+
+            xyz[got][0] = (int16_t)((b[0] << 8) | b[1]) >> 2;
+            xyz[got][1] = (int16_t)((b[2] << 8) | b[3]) >> 2;
+            xyz[got][2] = (int16_t)((b[4] << 8) | b[5]) >> 2;
+        }
+
+        if (got < n && k_uptime_get() > deadline) {
+            ret = -ETIMEDOUT;
+        }
+    }
+
+    /* Back to direct reads of the newest sample */
+    int off = i2c_write_u8_dt(spec, REG_F_SETUP, F_SETUP_OFF);
+
+    return (ret < 0) ? ret : off;
+}
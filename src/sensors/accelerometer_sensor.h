@@ -1,9 +1,37 @@
 #ifndef ACCELEROMETER_SENSOR_H
 #define ACCELEROMETER_SENSOR_H
 
+#include <stddef.h>
 #include <stdint.h>
 
-int accelerometer_sensor_init(void);
-int accelerometer_sensor_read(int32_t *x_g100, int32_t *y_g100, int32_t *z_g100);
+/* One instance per "plantcare,mma8451" node, in devicetree order; several
+ * can sit behind a TCA9548A (i2c_mux.h). Instance 0 is the snapshot one.
+ */
+uint8_t accelerometer_sensor_count(void);
+uint8_t accelerometer_sensor_mux_channel(uint8_t inst);
+
+int accelerometer_sensor_init(uint8_t inst);
+int accelerometer_sensor_read(uint8_t inst,
+                              int32_t *x_g100, int32_t *y_g100, int32_t *z_g100);
+
+/* Counts per g of the raw samples below (±2 g range, 14 bit) */
+#define ACCELEROMETER_COUNTS_PER_G  4096
+
+/* Newest x/y/z sample in raw counts */
+int accelerometer_sensor_read_raw(uint8_t inst, int16_t xyz[3]);
+
+/* Raw counts to g * 100, rounded */
+int32_t accelerometer_counts_to_g100(int16_t counts);
+
+/* Output data rate from the node's odr-hz property */
+uint16_t accelerometer_sensor_odr_hz(uint8_t inst);
+
+/* n consecutive raw x/y/z samples through the 32-sample FIFO. Blocks for
+ * about n / ODR, sleeping while the FIFO fills.
+ */
+int accelerometer_sensor_read_batch(uint8_t inst, int16_t (*xyz)[3], size_t n);
+
+/* Boot: every instance. Returns instance 0's result. */
+int accelerometer_sensor_init_all(void);
 
 #endif /* ACCELEROMETER_SENSOR_H */
\ No newline at end of file
@@ -5,7 +5,7 @@
 #include <zephyr/sys/printk.h>
 
 #include "button.h"
-#include "plantcare_config.h"
+#include "plantcare_bus.h"
 
 /*
  * We use the board's user button alias "sw0".
@@ -30,8 +30,12 @@ static void button_isr(const struct device *dev,
     ARG_UNUSED(cb);
     ARG_UNUSED(pins);
 
-    /* Just set a global event flag, keep ISR tiny. */
-    g_button_pressed_event = true;
+    /* Just publish the event, keep ISR tiny (no waiting in ISR). */
+    struct pc_msg_button msg = {
+        .uptime_ms = k_uptime_get_32(),
+        .cycles = k_cycle_get_32(),
+    };
+    (void)zbus_chan_pub(&pc_button_chan, &msg, K_NO_WAIT);
 }
 
 int button_init(void)
@@ -2,15 +2,135 @@
 #include <zephyr/device.h>
 #include <zephyr/drivers/uart.h>
 #include <zephyr/sys/printk.h>
+#include <zephyr/sys/ring_buffer.h>
 #include <errno.h>
+#include <stdbool.h>
 
 #include "gps_sensor.h"
 
 /* Using USART1 (D0/D1) as set in your overlay */
 #define GPS_UART_NODE DT_NODELABEL(usart1)
 
+/* Power-up speed of the MTK3339, also the overlay's current-speed */
+#define GPS_BOOT_BAUD       9600
+
+/* RMC + GGA at 1 Hz is ~140 B/s; the ring holds a few seconds of it */
+#define GPS_RX_RING_SIZE    512
+
 static const struct device *gps_uart;
 
+RING_BUF_DECLARE(gps_rx_ring, GPS_RX_RING_SIZE);
+
+/* Uptime of every '\n' put in the ring, so a fix is timed by when its line
+ * arrived rather than by when the sensor thread got to it. The ring holds
+ * at most eight RMC/GGA lines.
+ */
+#define GPS_EOL_SLOTS       16
+
+static int64_t eol_ms[GPS_EOL_SLOTS];
+static uint32_t eol_head;           /* ISR */
+static uint32_t eol_tail;           /* reader */
+static int64_t line_end_ms;
+
+static struct gps_sensor_stats stats;
+static bool awake;
+static int64_t awake_since_ms;
+
+/*
+ * PMTK commands with their NMEA checksum folded at compile time: XOR of
+ * every character of the body. Bodies over PMTK_MAX_BODY characters fail
+ * to build (negative array size) rather than get a wrong checksum.
+ */
+#define PMTK_MAX_BODY       64
+
+#define PMTK_C(s, i)        \
+    ((i) < sizeof(s) - 1 ? (uint8_t)(s)[(i) < sizeof(s) ? (i) : 0] : 0)
+#define PMTK_C4(s, i)       \
+    (PMTK_C(s, i) ^ PMTK_C(s, i + 1) ^ PMTK_C(s, i + 2) ^ PMTK_C(s, i + 3))
+#define PMTK_C16(s, i)      \
+    (PMTK_C4(s, i) ^ PMTK_C4(s, i + 4) ^ PMTK_C4(s, i + 8) ^ PMTK_C4(s, i + 12))
+#define PMTK_CHECKSUM(s)    \
+    (PMTK_C16(s, 0) ^ PMTK_C16(s, 16) ^ PMTK_C16(s, 32) ^ PMTK_C16(s, 48))
+
+struct pmtk_cmd {
+    const char *body;       /* between '$' and '*' */
+    uint8_t     checksum;
+};
+
+#define PMTK_CMD(s)                                                     \
+    { s, PMTK_CHECKSUM(s) +                                             \
+         0 * sizeof(char[(sizeof(s) - 1 <= PMTK_MAX_BODY) ? 1 : -1]) }
+
+/* Output only GLL=0 RMC=1 VTG=0 GGA=1 GSA=0 GSV=0 ... */
+static const struct pmtk_cmd pmtk_rmc_gga =
+    PMTK_CMD("PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0");
+/* Fix interval 1000 ms */
+static const struct pmtk_cmd pmtk_rate_1hz = PMTK_CMD("PMTK220,1000");
+static const struct pmtk_cmd pmtk_baud = PMTK_CMD("PMTK251,115200");
+static const struct pmtk_cmd pmtk_standby = PMTK_CMD("PMTK161,0");
+
+BUILD_ASSERT(GPS_SENSOR_BAUD == 115200, "update pmtk_baud with GPS_SENSOR_BAUD");
+
+static void gps_send(const struct pmtk_cmd *cmd)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    uart_poll_out(gps_uart, '$');
+    for (const char *p = cmd->body; *p != '\0'; p++) {
+        uart_poll_out(gps_uart, (unsigned char)*p);
+    }
+    uart_poll_out(gps_uart, '*');
+    uart_poll_out(gps_uart, hex[cmd->checksum >> 4]);
+    uart_poll_out(gps_uart, hex[cmd->checksum & 0x0F]);
+    uart_poll_out(gps_uart, '\r');
+    uart_poll_out(gps_uart, '\n');
+}
+
+static void gps_uart_isr(const struct device *dev, void *user_data)
+{
+    uint32_t start = k_cycle_get_32();
+    int64_t now = k_uptime_get();
+    uint8_t buf[16];
+
+    ARG_UNUSED(user_data);
+
+    if (!uart_irq_update(dev)) {
+        return;
+    }
+
+    while (uart_irq_rx_ready(dev)) {
+        int n = uart_fifo_read(dev, buf, sizeof(buf));
+        if (n <= 0) {
+            break;
+        }
+
+        uint32_t put = ring_buf_put(&gps_rx_ring, buf, n);
+
+        for (uint32_t i = 0; i < put; i++) {
+            if (buf[i] == '\n') {
+                eol_ms[eol_head++ % GPS_EOL_SLOTS] = now;
+            }
+        }
+
+        stats.rx_bytes += n;
+        stats.dropped  += n - put;
+    }
+
+    stats.isr_cycles += k_cycle_get_32() - start;
+}
+
+static int gps_set_baud(uint32_t baud)
+{
+    struct uart_config cfg;
+    int ret = uart_config_get(gps_uart, &cfg);
+
+    if (ret < 0) {
+        return ret;
+    }
+    cfg.baudrate = baud;
+    return uart_configure(gps_uart, &cfg);
+}
+
 int gps_sensor_init(void)
 {
     gps_uart = DEVICE_DT_GET(GPS_UART_NODE);
@@ -20,27 +140,126 @@ int gps_sensor_init(void)
         return -ENODEV;
     }
 
+    /* The receiver may still be at GPS_SENSOR_BAUD from before an MCU
+     * reset, or at its power-up speed: send the switch at both, so it ends
+     * up at GPS_SENSOR_BAUD either way. ~60 bytes of TX, once.
+     */
+    int ret = gps_set_baud(GPS_SENSOR_BAUD);
+    if (ret == 0) {
+        gps_send(&pmtk_baud);
+        ret = gps_set_baud(GPS_BOOT_BAUD);
+    }
+    if (ret == 0) {
+        gps_send(&pmtk_baud);
+        k_msleep(20);   /* let the last bytes leave at 9600 */
+        ret = gps_set_baud(GPS_SENSOR_BAUD);
+    }
+    if (ret < 0) {
+        /* No runtime UART reconfiguration: stay at the overlay speed */
+        printk("gps_sensor: baud change failed (%d), staying at %d\n",
+               ret, GPS_BOOT_BAUD);
+    }
+
+    gps_send(&pmtk_rmc_gga);
+    gps_send(&pmtk_rate_1hz);
+
+    ring_buf_reset(&gps_rx_ring);
+    eol_head = eol_tail = 0;
+    uart_irq_callback_user_data_set(gps_uart, gps_uart_isr, NULL);
+    uart_irq_rx_enable(gps_uart);
+
+    awake = true;
+    awake_since_ms = k_uptime_get();
+
     printk("gps_sensor: init OK\n");
     return 0;
 }
 
 int gps_sensor_read_char(uint8_t *out_char)
 {
-    if (!gps_uart || !device_is_ready(gps_uart)) {
-        /* GPS not initialized or device not ready yet */
+    if (!gps_uart) {
+        /* GPS not initialized yet */
         return -EAGAIN;
     }
 
     uint8_t c;
-    int ret = uart_poll_in(gps_uart, &c);
 
-    if (ret == 0) {
-        if (out_char) {
-            *out_char = c;
+    if (ring_buf_get(&gps_rx_ring, &c, 1) == 0) {
+        return -EAGAIN;
+    }
+    if (c == '\n') {
+        unsigned int key = irq_lock();
+
+        if (eol_head - eol_tail > GPS_EOL_SLOTS) {
+            eol_tail = eol_head - GPS_EOL_SLOTS;
+        }
+        if (eol_tail != eol_head) {
+            line_end_ms = eol_ms[eol_tail++ % GPS_EOL_SLOTS];
         }
-        return 0;               /* got a byte */
+        irq_unlock(key);
+    }
+    if (out_char) {
+        *out_char = c;
     }
+    return 0;               /* got a byte */
+}
 
-    /* uart_poll_in returns -1 when no data; we map that to -EAGAIN */
-    return -EAGAIN;
-}
\ No newline at end of file
+int64_t gps_sensor_line_end_ms(void)
+{
+    return line_end_ms;
+}
+
+int gps_sensor_standby(void)
+{
+    if (!gps_uart) {
+        return -ENODEV;
+    }
+    if (awake) {
+        gps_send(&pmtk_standby);
+        stats.awake_ms += (uint32_t)(k_uptime_get() - awake_since_ms);
+        awake = false;
+    }
+    return 0;
+}
+
+int gps_sensor_wake(void)
+{
+    if (!gps_uart) {
+        return -ENODEV;
+    }
+    if (!awake) {
+        /* Any byte wakes it; resending the output filter is harmless */
+        gps_send(&pmtk_rmc_gga);
+        awake = true;
+        awake_since_ms = k_uptime_get();
+        stats.wakes++;
+    }
+    return 0;
+}
+
+bool gps_sensor_is_awake(void)
+{
+    return awake;
+}
+
+void gps_sensor_count_parse(uint32_t cycles)
+{
+    stats.parse_cycles += cycles;
+}
+
+size_t gps_sensor_ram_bytes(void)
+{
+    return GPS_RX_RING_SIZE + sizeof(eol_ms);
+}
+
+void gps_sensor_get_stats(struct gps_sensor_stats *st)
+{
+    unsigned int key = irq_lock();
+
+    *st = stats;
+    irq_unlock(key);
+
+    if (awake) {
+        st->awake_ms += (uint32_t)(k_uptime_get() - awake_since_ms);
+    }
+}
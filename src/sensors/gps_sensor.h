@@ -1,13 +1,19 @@
 #ifndef GPS_SENSOR_H
 #define GPS_SENSOR_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
-/* Init UART for the GPS (USART1 on D0/D1).
+/* Init UART for the GPS (USART1 on D0/D1) and configure the receiver:
+ * RMC + GGA only at 1 Hz, link raised to GPS_SENSOR_BAUD.
  * Returns 0 on success, negative errno on failure.
  */
 int gps_sensor_init(void);
 
+/* Link speed after init; the receiver powers up at the overlay's 9600 */
+#define GPS_SENSOR_BAUD  115200
+
 /* Non-blocking read of one byte from GPS.
  * Returns:
  *   0        -> one character read, stored in *out_char
@@ -16,4 +22,33 @@ int gps_sensor_init(void);
  */
 int gps_sensor_read_char(uint8_t *out_char);
 
-#endif /* GPS_SENSOR_H */
\ No newline at end of file
+/* Uptime, in ms, at which the last '\n' returned by gps_sensor_read_char()
+ * was received; stamped in the RX interrupt
+ */
+int64_t gps_sensor_line_end_ms(void);
+
+/* Standby (PMTK161) keeps the ephemeris for a hot start; any byte on the
+ * UART wakes the receiver again.
+ */
+int gps_sensor_standby(void);
+int gps_sensor_wake(void);
+bool gps_sensor_is_awake(void);
+
+struct gps_sensor_stats {
+    uint32_t rx_bytes;      /* received since init */
+    uint32_t dropped;       /* lost to a full RX ring */
+    uint32_t isr_cycles;    /* spent in the RX interrupt */
+    uint32_t parse_cycles;  /* spent draining and parsing (caller reported) */
+    uint32_t awake_ms;      /* receiver awake time since init */
+    uint32_t wakes;
+};
+
+void gps_sensor_get_stats(struct gps_sensor_stats *st);
+
+/* Account the caller's time spent on the GPS byte stream */
+void gps_sensor_count_parse(uint32_t cycles);
+
+/* Size of the RX ring and its line stamps, bytes */
+size_t gps_sensor_ram_bytes(void);
+
+#endif /* GPS_SENSOR_H */
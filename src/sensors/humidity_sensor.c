@@ -3,41 +3,96 @@
 #include <zephyr/drivers/i2c.h>
 #include <stdint.h>
 #include "i2c_helpers.h"
+#include "i2c_mux.h"
 #include "humidity_sensor.h"
 
-/* Under the hood: Si7021 */
-static const struct i2c_dt_spec humidity_sensor_i2c =
-    I2C_DT_SPEC_GET(DT_NODELABEL(si7021));
+/* Under the hood: Si7021, one per "plantcare,si7021" node */
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(plantcare_si7021) >= 1,
+             "need a plantcare,si7021 node");
+
+static struct i2c_mux_dev si7021[] = {
+    DT_FOREACH_STATUS_OKAY(plantcare_si7021, I2C_MUX_DT_DEV)
+};
 
 #define CMD_MEAS_RH_HOLD   0xE5
 #define CMD_MEAS_TEMP_HOLD 0xE3
+#define CMD_READ_USER_REG1 0xE7
+
+uint8_t humidity_sensor_count(void)
+{
+    return ARRAY_SIZE(si7021);
+}
+
+uint8_t humidity_sensor_mux_channel(uint8_t inst)
+{
+    return si7021[inst].mux_channel;
+}
 
-int humidity_sensor_init(void)
+int humidity_sensor_init(uint8_t inst)
 {
-    printk("Humidity sensor ready\n");
+    uint8_t user_reg;
+
+    if (inst >= ARRAY_SIZE(si7021)) {
+        return -EINVAL;
+    }
+
+    i2c_mux_isolate_direct(si7021, ARRAY_SIZE(si7021));
+
+    int ret = i2c_mux_select(&si7021[inst]);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* Presence check: the Si7021 has no ID register we need, but reading
+     * user register 1 fails with a NACK if the chip is not on the bus.
+     */
+    ret = i2c_read_u8_dt(&si7021[inst].spec, CMD_READ_USER_REG1, &user_reg);
+    if (ret < 0) {
+        printk("Humidity sensor %u not responding (err %d)\n", inst, ret);
+        return ret;
+    }
+
+    printk("Humidity sensor %u ready\n", inst);
     return 0;
 }
 
-static int read_raw(uint8_t cmd, uint16_t *raw)
+int humidity_sensor_init_all(void)
+{
+    int ret0 = humidity_sensor_init(0);
+
+    for (uint8_t i = 1; i < ARRAY_SIZE(si7021); i++) {
+        (void)humidity_sensor_init(i);
+    }
+    return ret0;
+}
+
+static int read_raw(const struct i2c_dt_spec *spec, uint8_t cmd, uint16_t *raw)
 {
     uint8_t buf[2];
-    int ret = i2c_burst_read_dt_checked(&humidity_sensor_i2c, cmd, buf, sizeof(buf));
+    int ret = i2c_burst_read_dt_checked(spec, cmd, buf, sizeof(buf));
     if (ret < 0) return ret;
     *raw = ((uint16_t)buf[0] << 8) | buf[1];
     return 0;
 }
 
-int humidity_sensor_read(int32_t *humidity_x100, int32_t *temp_x100)
+int humidity_sensor_read(uint8_t inst, int32_t *humidity_x100, int32_t *temp_x100)
 {
     int ret;
     uint16_t raw_rh, raw_t;
 
-    ret = read_raw(CMD_MEAS_RH_HOLD, &raw_rh);
+    if (inst >= ARRAY_SIZE(si7021)) {
+        return -EINVAL;
+    }
+
+    ret = i2c_mux_select(&si7021[inst]);
+    if (ret < 0) return ret;
+
+    ret = read_raw(&si7021[inst].spec, CMD_MEAS_RH_HOLD, &raw_rh);
     if (ret < 0) return ret;
 
     *humidity_x100 = ((int32_t)12500 * raw_rh) / 65536 - 600;
 
-    ret = read_raw(CMD_MEAS_TEMP_HOLD, &raw_t);
+    ret = read_raw(&si7021[inst].spec, CMD_MEAS_TEMP_HOLD, &raw_t);
     if (ret < 0) return ret;
 
     *temp_x100 = ((int32_t)17572 * raw_t) / 65536 - 4685;
@@ -3,7 +3,16 @@
 
 #include <stdint.h>
 
-int humidity_sensor_init(void);
-int humidity_sensor_read(int32_t *humidity_x100, int32_t *temp_x100);
+/* One instance per "plantcare,si7021" node, in devicetree order; several
+ * can sit behind a TCA9548A (i2c_mux.h). Instance 0 is the snapshot one.
+ */
+uint8_t humidity_sensor_count(void);
+uint8_t humidity_sensor_mux_channel(uint8_t inst);
+
+int humidity_sensor_init(uint8_t inst);
+int humidity_sensor_read(uint8_t inst, int32_t *humidity_x100, int32_t *temp_x100);
+
+/* Boot: every instance. Returns instance 0's result. */
+int humidity_sensor_init_all(void);
 
 #endif /* HUMIDITY_SENSOR_H */
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/sys/printk.h>
+
+#include "i2c_bus.h"
+#include "i2c_mux.h"
+
+/* All our I2C sensors sit on the same bus as the Si7021 (maybe via the mux) */
+static const struct device *const i2c_dev =
+    DEVICE_DT_GET(I2C_MUX_DT_CONTROLLER(DT_NODELABEL(si7021)));
+
+int i2c_sensors_recover_bus(void)
+{
+    if (!device_is_ready(i2c_dev)) {
+        return -ENODEV;
+    }
+
+    /* A reset slave may include the mux: its channel is unknown now */
+    i2c_mux_invalidate();
+
+    int ret = i2c_recover_bus(i2c_dev);
+    printk("I2C bus recovery: %s (err %d)\n", ret ? "failed" : "done", ret);
+    return ret;
+}
@@ -0,0 +1,11 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+/* Free a stuck I2C bus (the one shared by the TCS34725, Si7021 and
+ * MMA8451) by clocking SCL until the slave releases SDA, then a STOP.
+ * Returns 0 on success, negative errno on error (-ENOSYS if the driver
+ * has no recovery support).
+ */
+int i2c_sensors_recover_bus(void);
+
+#endif /* I2C_BUS_H */
@@ -0,0 +1,88 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+#include "i2c_mux.h"
+
+/* Sensor drivers only run in the sensor thread (and at boot before it
+ * starts), so the cache needs no lock.
+ */
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(plantcare_tca9548a) <= 1,
+             "only one TCA9548A is supported");
+
+#define HAS_MUX  DT_HAS_COMPAT_STATUS_OKAY(plantcare_tca9548a)
+
+#if HAS_MUX
+static const struct i2c_dt_spec mux_i2c =
+    I2C_DT_SPEC_GET(DT_COMPAT_GET_ANY_STATUS_OKAY(plantcare_tca9548a));
+#endif
+
+static uint8_t open_channel = I2C_MUX_ANY;     /* unknown after reset */
+static struct i2c_mux_stats stats;
+
+void i2c_mux_isolate_direct(struct i2c_mux_dev *devs, size_t n)
+{
+    bool muxed = false;
+
+    for (size_t i = 0; i < n; i++) {
+        muxed |= (devs[i].mux_channel < 8);
+    }
+    if (!muxed) {
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (devs[i].mux_channel == I2C_MUX_ANY) {
+            devs[i].mux_channel = I2C_MUX_OFF;
+        }
+    }
+}
+
+int i2c_mux_select(const struct i2c_mux_dev *dev)
+{
+    uint8_t ch = dev->mux_channel;
+
+    if (ch == I2C_MUX_ANY) {
+        return 0;
+    }
+    if (ch == open_channel) {
+        stats.cached++;
+        return 0;
+    }
+
+#if HAS_MUX
+    /* Control register: one bit per channel, 0 closes all */
+    uint8_t ctrl = (ch == I2C_MUX_OFF) ? 0 : (uint8_t)BIT(ch);
+
+    int ret = i2c_write_dt(&mux_i2c, &ctrl, 1);
+    if (ret < 0) {
+        printk("I2C mux: select %u failed (err %d)\n", ch, ret);
+        open_channel = I2C_MUX_ANY;
+        stats.errors++;
+        return ret;
+    }
+
+    open_channel = ch;
+    stats.switches++;
+    return 0;
+#else
+    return (ch == I2C_MUX_OFF) ? 0 : -ENODEV;
+#endif
+}
+
+uint8_t i2c_mux_current(void)
+{
+    return open_channel;
+}
+
+void i2c_mux_invalidate(void)
+{
+    open_channel = I2C_MUX_ANY;
+}
+
+void i2c_mux_get_stats(struct i2c_mux_stats *out)
+{
+    *out = stats;
+}
@@ -0,0 +1,79 @@
+/* i2c_mux.h */
+#ifndef I2C_MUX_H
+#define I2C_MUX_H
+
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/i2c.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Optional TCA9548A on the sensor bus (dts/bindings/plantcare,tca9548a.yaml),
+ * so several sensors with the same fixed address can be used. Sensors sit
+ * either directly on the I2C controller or below one of its channel nodes.
+ *
+ * The open channel is cached: selecting the channel that is already open
+ * costs no bus transaction. The sensor thread reads all instances behind
+ * one channel together, so a cycle needs at most one switch per channel.
+ */
+
+/* mux_channel of a sensor directly on the controller, no mux involved */
+#define I2C_MUX_ANY     0xFF
+/* Directly on the controller, but a sensor with the same address is
+ * behind the mux: all channels must be closed first.
+ */
+#define I2C_MUX_OFF     0xFE
+
+/* One sensor instance */
+struct i2c_mux_dev {
+    struct i2c_dt_spec spec;    /* controller + 7-bit address */
+    uint8_t mux_channel;        /* 0..7, I2C_MUX_ANY or I2C_MUX_OFF */
+};
+
+#define I2C_MUX_DT_IS_MUXED(node) \
+    DT_NODE_HAS_COMPAT(DT_BUS(node), plantcare_tca9548a_channel)
+
+/* The I2C controller a sensor node is wired to, through the mux or not */
+#define I2C_MUX_DT_CONTROLLER(node)                                 \
+    COND_CODE_1(I2C_MUX_DT_IS_MUXED(node),                          \
+                (DT_BUS(DT_PARENT(DT_BUS(node)))), (DT_BUS(node)))
+
+/* Initializer for struct i2c_mux_dev, with a trailing comma so it can be
+ * used with DT_FOREACH_STATUS_OKAY().
+ */
+#define I2C_MUX_DT_DEV(node)                                        \
+    {                                                               \
+        .spec = {                                                   \
+            .bus  = DEVICE_DT_GET(I2C_MUX_DT_CONTROLLER(node)),     \
+            .addr = DT_REG_ADDR(node),                              \
+        },                                                          \
+        .mux_channel = COND_CODE_1(I2C_MUX_DT_IS_MUXED(node),       \
+                                   (DT_REG_ADDR(DT_BUS(node))),     \
+                                   (I2C_MUX_ANY)),                  \
+    },
+
+/* Mark the direct instances of a table as I2C_MUX_OFF if another instance
+ * of the same table is behind the mux (same chip, same address). Call once
+ * from the driver's init.
+ */
+void i2c_mux_isolate_direct(struct i2c_mux_dev *devs, size_t n);
+
+/* Open the channel dev needs; no transfer if it is already open */
+int i2c_mux_select(const struct i2c_mux_dev *dev);
+
+/* Channel currently open (0..7, I2C_MUX_OFF), or I2C_MUX_ANY if unknown */
+uint8_t i2c_mux_current(void);
+
+/* Forget the cached state, e.g. after a bus recovery */
+void i2c_mux_invalidate(void);
+
+struct i2c_mux_stats {
+    uint32_t switches;      /* control register writes */
+    uint32_t cached;        /* selections that needed no write */
+    uint32_t errors;
+};
+
+void i2c_mux_get_stats(struct i2c_mux_stats *out);
+
+#endif /* I2C_MUX_H */
@@ -0,0 +1,178 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "led_anim.h"
+#include "leds.h"
+#include "led1.h"
+#include "led2.h"
+
+#define PATTERN_MASK  (BIT(LED_ANIM_FRAMES_PER_SLOT) - 1U)
+
+BUILD_ASSERT(LED_ANIM_FRAMES_PER_SLOT <= 32, "pattern is a 32-bit mask");
+
+static struct k_spinlock anim_lock;
+static struct k_timer anim_timer;
+
+static struct led_anim_step rgb_steps[LED_ANIM_MAX_STEPS];
+static size_t   rgb_count;
+static size_t   rgb_step;
+static uint32_t led1_pattern;
+static uint32_t led2_pattern;
+static uint8_t  frame;
+static bool     running;
+
+/* Output for the current frame; only touch GPIOs that changed */
+static uint8_t  out_rgb = 0xFF;
+static int8_t   out_led1 = -1;
+static int8_t   out_led2 = -1;
+
+static inline bool pattern_on(uint32_t pattern, uint8_t f)
+{
+    return (pattern >> f) & 1U;
+}
+
+static inline bool pattern_is_steady(uint32_t pattern)
+{
+    pattern &= PATTERN_MASK;
+    return (pattern == 0U) || (pattern == PATTERN_MASK);
+}
+
+/* Caller holds anim_lock */
+static void anim_render(void)
+{
+    uint8_t rgb = LED_ANIM_BLACK;
+
+    if (rgb_count > 0 && pattern_on(rgb_steps[rgb_step].pattern, frame)) {
+        rgb = rgb_steps[rgb_step].color;
+    }
+
+    if (rgb != out_rgb) {
+        out_rgb = rgb;
+        rgb_set(rgb & LED_ANIM_RED, rgb & LED_ANIM_GREEN, rgb & LED_ANIM_BLUE);
+    }
+
+    int8_t l1 = pattern_on(led1_pattern, frame);
+    if (l1 != out_led1) {
+        out_led1 = l1;
+        led1_set(l1);
+    }
+
+    int8_t l2 = pattern_on(led2_pattern, frame);
+    if (l2 != out_led2) {
+        out_led2 = l2;
+        led2_set(l2);
+    }
+}
+
+/* Runs in timer (ISR) context */
+static void anim_timer_fn(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    k_spinlock_key_t key = k_spin_lock(&anim_lock);
+
+    if (++frame >= LED_ANIM_FRAMES_PER_SLOT) {
+        frame = 0;
+        if (rgb_count > 0) {
+            rgb_step = (rgb_step + 1U) % rgb_count;
+        }
+    }
+    anim_render();
+
+    k_spin_unlock(&anim_lock, key);
+}
+
+/* Caller holds anim_lock. Restart from frame 0 and run the timer only
+ * if something actually blinks or the RGB has more than one step.
+ */
+static void anim_restart(void)
+{
+    bool need_timer = (rgb_count > 1) ||
+                      (rgb_count == 1 && !pattern_is_steady(rgb_steps[0].pattern)) ||
+                      !pattern_is_steady(led1_pattern) ||
+                      !pattern_is_steady(led2_pattern);
+
+    frame = 0;
+    rgb_step = 0;
+    anim_render();
+
+    if (need_timer && !running) {
+        k_timer_start(&anim_timer, K_MSEC(LED_ANIM_FRAME_MS),
+                      K_MSEC(LED_ANIM_FRAME_MS));
+    } else if (!need_timer && running) {
+        k_timer_stop(&anim_timer);
+    }
+    running = need_timer;
+}
+
+void led_anim_init(void)
+{
+    k_timer_init(&anim_timer, anim_timer_fn, NULL);
+
+    k_spinlock_key_t key = k_spin_lock(&anim_lock);
+    anim_restart();
+    k_spin_unlock(&anim_lock, key);
+}
+
+/* Caller holds anim_lock */
+static bool rgb_sequence_equal(const struct led_anim_step *steps, size_t n)
+{
+    if (n != rgb_count) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (steps[i].color != rgb_steps[i].color ||
+            (steps[i].pattern & PATTERN_MASK) != rgb_steps[i].pattern) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void led_anim_rgb_sequence(const struct led_anim_step *steps, size_t n)
+{
+    n = MIN(n, (size_t)LED_ANIM_MAX_STEPS);
+
+    k_spinlock_key_t key = k_spin_lock(&anim_lock);
+
+    /* Same sequence as now: keep running without restarting the slot */
+    if (rgb_sequence_equal(steps, n)) {
+        k_spin_unlock(&anim_lock, key);
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        rgb_steps[i].color   = steps[i].color & LED_ANIM_WHITE;
+        rgb_steps[i].pattern = steps[i].pattern & PATTERN_MASK;
+    }
+    rgb_count = n;
+    anim_restart();
+
+    k_spin_unlock(&anim_lock, key);
+}
+
+void led_anim_rgb_solid(enum led_anim_color color)
+{
+    struct led_anim_step step = {
+        .color   = (uint8_t)color,
+        .pattern = LED_ANIM_PATTERN_ON,
+    };
+
+    led_anim_rgb_sequence(&step, (color == LED_ANIM_BLACK) ? 0 : 1);
+}
+
+void led_anim_led1(uint32_t pattern)
+{
+    k_spinlock_key_t key = k_spin_lock(&anim_lock);
+    led1_pattern = pattern & PATTERN_MASK;
+    anim_restart();
+    k_spin_unlock(&anim_lock, key);
+}
+
+void led_anim_led2(uint32_t pattern)
+{
+    k_spinlock_key_t key = k_spin_lock(&anim_lock);
+    led2_pattern = pattern & PATTERN_MASK;
+    anim_restart();
+    k_spin_unlock(&anim_lock, key);
+}
@@ -0,0 +1,69 @@
+#ifndef LED_ANIM_H
+#define LED_ANIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * LED animation engine.
+ *
+ * All LEDs (RGB, LED1, LED2) are driven from one k_timer callback, so no
+ * thread wakes up per frame. A frame is LED_ANIM_FRAME_MS long and a slot
+ * is LED_ANIM_FRAMES_PER_SLOT frames. A pattern is a bit mask over the
+ * frames of one slot (bit 0 = first frame, 1 = LED on).
+ *
+ * The RGB LED plays a sequence of steps, one step per slot, looping, so
+ * several alarms can be shown one after another with their own colour and
+ * blink pattern. When nothing blinks the timer is stopped.
+ */
+
+#define LED_ANIM_FRAME_MS         50
+#define LED_ANIM_FRAMES_PER_SLOT  20    /* 1 s per slot */
+
+#define LED_ANIM_PATTERN_OFF      0x00000u
+#define LED_ANIM_PATTERN_ON       0xFFFFFu
+/* On for the first 3/4 of the slot, then a gap before the next step */
+#define LED_ANIM_PATTERN_LONG     0x07FFFu
+#define LED_ANIM_PATTERN_SLOW     0x003FFu  /* on 500 ms, off 500 ms */
+#define LED_ANIM_PATTERN_DOUBLE   0x000CFu  /* two blinks */
+#define LED_ANIM_PATTERN_TRIPLE   0x00333u  /* three blinks */
+#define LED_ANIM_PATTERN_FAST     0x33333u  /* 5 Hz flicker */
+#define LED_ANIM_PATTERN_SHORT    0x0000Fu  /* one short flash */
+
+/* Colours as R|G|B bits */
+enum led_anim_color {
+    LED_ANIM_BLACK   = 0,
+    LED_ANIM_RED     = 1,
+    LED_ANIM_GREEN   = 2,
+    LED_ANIM_YELLOW  = 3,
+    LED_ANIM_BLUE    = 4,
+    LED_ANIM_MAGENTA = 5,
+    LED_ANIM_CYAN    = 6,
+    LED_ANIM_WHITE   = 7,
+};
+
+struct led_anim_step {
+    uint8_t  color;     /* enum led_anim_color */
+    uint32_t pattern;   /* LED_ANIM_PATTERN_* or custom mask */
+};
+
+/* Enough for one step per alarm channel (plantcare_alarm.h) */
+#define LED_ANIM_MAX_STEPS  16
+
+/* Start the engine. LED drivers must already be initialized. */
+void led_anim_init(void);
+
+/* Play steps in a loop on the RGB LED (n = 0 turns it off).
+ * Extra steps beyond LED_ANIM_MAX_STEPS are ignored.
+ */
+void led_anim_rgb_sequence(const struct led_anim_step *steps, size_t n);
+
+/* Convenience: one colour, steady on */
+void led_anim_rgb_solid(enum led_anim_color color);
+
+/* Blink pattern for the board LEDs (LED_ANIM_PATTERN_ON/OFF for steady) */
+void led_anim_led1(uint32_t pattern);
+void led_anim_led2(uint32_t pattern);
+
+#endif /* LED_ANIM_H */
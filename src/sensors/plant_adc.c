@@ -0,0 +1,155 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/adc.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+#include "plant_adc.h"
+
+/* Channel specs straight from the plant nodes:
+ *
+ *   plant0: plant_0 {
+ *       compatible = "plantcare,plant";
+ *       io-channels = <&adc1 4>, <&adc1 5>;
+ *       io-channel-names = "soil", "light";
+ *   };
+ *
+ * Gain, reference and acquisition time come from the channel@N child
+ * nodes of the ADC controller.
+ */
+#define PLANT_SOIL_SPEC(node)   ADC_DT_SPEC_GET_BY_NAME(node, soil),
+#define PLANT_LIGHT_SPEC(node)  ADC_DT_SPEC_GET_BY_NAME(node, light),
+
+static const struct adc_dt_spec soil_specs[] = {
+    DT_FOREACH_STATUS_OKAY(plantcare_plant, PLANT_SOIL_SPEC)
+};
+
+static const struct adc_dt_spec light_specs[] = {
+    DT_FOREACH_STATUS_OKAY(plantcare_plant, PLANT_LIGHT_SPEC)
+};
+
+BUILD_ASSERT(ARRAY_SIZE(soil_specs) == PLANTCARE_PLANT_COUNT);
+BUILD_ASSERT(PLANTCARE_PLANT_COUNT >= 1 &&
+             PLANTCARE_PLANT_COUNT <= PLANTCARE_PLANT_MAX,
+             "need 1 to 8 plantcare,plant nodes in the devicetree");
+
+#define ADC_RESOLUTION  12
+#define ADC_MAX_VALUE   ((1 << ADC_RESOLUTION) - 1)
+#define ADC_REF_MV      3300
+
+/* The scan writes one sample per enabled channel, lowest channel first */
+static int16_t scan_buf[2 * PLANTCARE_PLANT_COUNT];
+static uint32_t scan_channels;
+static uint8_t soil_slot[PLANTCARE_PLANT_COUNT];
+static uint8_t light_slot[PLANTCARE_PLANT_COUNT];
+static uint32_t last_scan_us;
+
+/* Position of a channel's sample in scan_buf */
+static uint8_t scan_slot(uint8_t channel_id)
+{
+    return (uint8_t)POPCOUNT(scan_channels & (BIT(channel_id) - 1U));
+}
+
+static int plant_channel_setup(const struct adc_dt_spec *spec)
+{
+    /* One sequence can only scan one converter */
+    if (spec->dev != soil_specs[0].dev) {
+        printk("Plant ADC: all channels must be on the same ADC\n");
+        return -EINVAL;
+    }
+
+    /* Shared channels are set up once */
+    if (scan_channels & BIT(spec->channel_id)) {
+        return 0;
+    }
+
+    int ret = adc_channel_setup_dt(spec);
+    if (ret) {
+        printk("Plant ADC channel %d setup failed, err=%d\n",
+               spec->channel_id, ret);
+        return ret;
+    }
+
+    scan_channels |= BIT(spec->channel_id);
+    return 0;
+}
+
+int plant_adc_init(void)
+{
+    if (!adc_is_ready_dt(&soil_specs[0])) {
+        printk("ADC not ready for plant sensors\n");
+        return -ENODEV;
+    }
+
+    scan_channels = 0;
+
+    for (size_t i = 0; i < PLANTCARE_PLANT_COUNT; i++) {
+        int ret = plant_channel_setup(&soil_specs[i]);
+        if (ret == 0) {
+            ret = plant_channel_setup(&light_specs[i]);
+        }
+        if (ret) {
+            return ret;
+        }
+    }
+
+    /* Slots depend on the whole mask, so map them once it is complete */
+    for (size_t i = 0; i < PLANTCARE_PLANT_COUNT; i++) {
+        soil_slot[i]  = scan_slot(soil_specs[i].channel_id);
+        light_slot[i] = scan_slot(light_specs[i].channel_id);
+    }
+
+    return 0;
+}
+
+static void plant_adc_convert(int16_t sample, int16_t *raw_out, int32_t *mv_out)
+{
+    int32_t raw = sample;
+    if (raw < 0) raw = 0;
+
+    *raw_out = (int16_t)raw;
+    *mv_out  = raw * ADC_REF_MV / ADC_MAX_VALUE;
+}
+
+int plant_adc_read_all(struct plant_adc_sample *out)
+{
+    struct adc_sequence seq = {
+        .channels    = scan_channels,
+        .buffer      = scan_buf,
+        .buffer_size = POPCOUNT(scan_channels) * sizeof(scan_buf[0]),
+        .resolution  = ADC_RESOLUTION,
+    };
+
+    if (scan_channels == 0) {
+        return -ENODEV;
+    }
+
+    uint32_t start = k_cycle_get_32();
+    int ret = adc_read(soil_specs[0].dev, &seq);
+    last_scan_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    if (ret) {
+        printk("Plant adc_read() failed, err=%d\n", ret);
+        return ret;
+    }
+
+    for (size_t i = 0; i < PLANTCARE_PLANT_COUNT; i++) {
+        plant_adc_convert(scan_buf[soil_slot[i]],
+                          &out[i].soil_raw, &out[i].soil_mv);
+        plant_adc_convert(scan_buf[light_slot[i]],
+                          &out[i].light_raw, &out[i].light_mv);
+    }
+
+    return 0;
+}
+
+uint32_t plant_adc_last_scan_us(void)
+{
+    return last_scan_us;
+}
+
+uint8_t plant_adc_channel_count(void)
+{
+    return (uint8_t)POPCOUNT(scan_channels);
+}
@@ -0,0 +1,46 @@
+/* plant_adc.h */
+#ifndef PLANT_ADC_H
+#define PLANT_ADC_H
+
+#include <zephyr/devicetree.h>
+#include <stdint.h>
+
+/* One "plantcare,plant" devicetree node per pot: a soil probe and a light
+ * sensor on ADC inputs (dts/bindings/plantcare,plant.yaml). All plants are
+ * sampled together in one scanned ADC sequence.
+ */
+#define PLANTCARE_PLANT_COUNT   DT_NUM_INST_STATUS_OKAY(plantcare_plant)
+
+/* Tables indexed by plant are sized for this many at most */
+#define PLANTCARE_PLANT_MAX     8
+
+BUILD_ASSERT(PLANTCARE_PLANT_COUNT >= 1 &&
+             PLANTCARE_PLANT_COUNT <= PLANTCARE_PLANT_MAX,
+             "need 1 to 8 plantcare,plant nodes in the devicetree");
+
+struct plant_adc_sample {
+    int16_t soil_raw;
+    int16_t light_raw;
+    int32_t soil_mv;
+    int32_t light_mv;
+};
+
+/* Set up every soil + light channel of every plant.
+ * Returns 0 on success, negative errno on failure.
+ */
+int plant_adc_init(void);
+
+/* Sample all plants in one ADC scan; out[] has PLANTCARE_PLANT_COUNT
+ * entries, in devicetree order.
+ */
+int plant_adc_read_all(struct plant_adc_sample *out);
+
+/* Duration of the last scan (adc_read only), in microseconds */
+uint32_t plant_adc_last_scan_us(void);
+
+/* Number of distinct ADC channels in the scan (plants may share one,
+ * e.g. a single light sensor for the whole rack).
+ */
+uint8_t plant_adc_channel_count(void);
+
+#endif /* PLANT_ADC_H */
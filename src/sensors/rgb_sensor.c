@@ -3,54 +3,118 @@
 #include <zephyr/drivers/i2c.h>
 #include <stdint.h>
 #include "i2c_helpers.h"
+#include "i2c_mux.h"
 #include "rgb_sensor.h"
 
-/* Under the hood: TCS34725 chip */
-static const struct i2c_dt_spec rgb_sensor_i2c =
-    I2C_DT_SPEC_GET(DT_NODELABEL(tcs34725));
+/* Under the hood: TCS34725 chip, one per "plantcare,tcs34725" node */
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(plantcare_tcs34725) >= 1,
+             "need a plantcare,tcs34725 node");
+
+static struct i2c_mux_dev tcs34725[] = {
+    DT_FOREACH_STATUS_OKAY(plantcare_tcs34725, I2C_MUX_DT_DEV)
+};
 
 #define CMD_BIT          0x80
 #define REG_ENABLE       0x00
 #define REG_CDATAL       0x14
 
-static int write_reg(uint8_t reg, uint8_t value)
+uint8_t rgb_sensor_count(void)
 {
-    return i2c_write_u8_dt(&rgb_sensor_i2c, CMD_BIT | reg, value);
+    return ARRAY_SIZE(tcs34725);
 }
 
-int rgb_sensor_init(void)
+uint8_t rgb_sensor_mux_channel(uint8_t inst)
 {
-    int ret;
+    return tcs34725[inst].mux_channel;
+}
 
-    /* Power on (PON) */
-    ret = write_reg(REG_ENABLE, 0x01);
+static int write_reg(uint8_t inst, uint8_t reg, uint8_t value)
+{
+    int ret = i2c_mux_select(&tcs34725[inst]);
     if (ret < 0) {
-        printk("RGB sensor: failed to power on\n");
         return ret;
     }
+    return i2c_write_u8_dt(&tcs34725[inst].spec, CMD_BIT | reg, value);
+}
 
-    k_sleep(K_MSEC(3));
+static int power_on(uint8_t inst)
+{
+    /* Power on (PON) */
+    int ret = write_reg(inst, REG_ENABLE, 0x01);
+    if (ret < 0) {
+        printk("RGB sensor %u: failed to power on\n", inst);
+    }
+    return ret;
+}
 
+static int enable(uint8_t inst)
+{
     /* Enable ADC (AEN) */
-    ret = write_reg(REG_ENABLE, 0x03);
+    int ret = write_reg(inst, REG_ENABLE, 0x03);
     if (ret < 0) {
-        printk("RGB sensor: failed to enable ADC\n");
+        printk("RGB sensor %u: failed to enable ADC\n", inst);
         return ret;
     }
 
-    printk("RGB sensor initialized\n");
+    printk("RGB sensor %u initialized\n", inst);
     return 0;
 }
 
-int rgb_sensor_read(uint16_t *clear, uint16_t *red,
+int rgb_sensor_power_on(void)
+{
+    i2c_mux_isolate_direct(tcs34725, ARRAY_SIZE(tcs34725));
+
+    int ret0 = power_on(0);
+    for (uint8_t i = 1; i < ARRAY_SIZE(tcs34725); i++) {
+        (void)power_on(i);
+    }
+    return ret0;
+}
+
+int rgb_sensor_enable(void)
+{
+    int ret0 = enable(0);
+    for (uint8_t i = 1; i < ARRAY_SIZE(tcs34725); i++) {
+        (void)enable(i);
+    }
+    return ret0;
+}
+
+int rgb_sensor_init(uint8_t inst)
+{
+    if (inst >= ARRAY_SIZE(tcs34725)) {
+        return -EINVAL;
+    }
+
+    i2c_mux_isolate_direct(tcs34725, ARRAY_SIZE(tcs34725));
+
+    int ret = power_on(inst);
+    if (ret < 0) {
+        return ret;
+    }
+
+    k_sleep(K_MSEC(RGB_SENSOR_PON_SETTLE_MS));
+
+    return enable(inst);
+}
+
+int rgb_sensor_read(uint8_t inst, uint16_t *clear, uint16_t *red,
                     uint16_t *green, uint16_t *blue)
 {
     uint8_t buf[8];
     uint8_t reg = CMD_BIT | REG_CDATAL;
 
-    int ret = i2c_burst_read_dt_checked(&rgb_sensor_i2c, reg, buf, sizeof(buf));
+    if (inst >= ARRAY_SIZE(tcs34725)) {
+        return -EINVAL;
+    }
+
+    int ret = i2c_mux_select(&tcs34725[inst]);
+    if (ret == 0) {
+        ret = i2c_burst_read_dt_checked(&tcs34725[inst].spec, reg,
+                                        buf, sizeof(buf));
+    }
     if (ret < 0) {
-        printk("RGB sensor: read failed\n");
+        printk("RGB sensor %u: read failed\n", inst);
         return ret;
     }
 
@@ -3,8 +3,31 @@
 
 #include <stdint.h>
 
-int rgb_sensor_init(void);
-int rgb_sensor_read(uint16_t *clear, uint16_t *red,
+/* The TCS34725 needs 2.4 ms between power-on and enabling the ADC */
+#define RGB_SENSOR_PON_SETTLE_MS  3
+
+/* ATIME and CONTROL are left at their reset values: one 2.4 ms
+ * integration cycle at 1x gain, so every channel saturates at 1024.
+ */
+#define RGB_SENSOR_ATIME_US       2400
+#define RGB_SENSOR_AGAIN          1
+#define RGB_SENSOR_MAX_COUNT      1024
+
+/* One instance per "plantcare,tcs34725" node, in devicetree order; several
+ * can sit behind a TCA9548A (i2c_mux.h). Instance 0 is the snapshot one.
+ */
+uint8_t rgb_sensor_count(void);
+uint8_t rgb_sensor_mux_channel(uint8_t inst);
+
+/* Power on, wait, enable ADC (blocking), one instance */
+int rgb_sensor_init(uint8_t inst);
+
+/* Same in two halves for every instance, so the caller can do other work
+ * during the settle time (see plantcare_boot.c). Return instance 0's result.
+ */
+int rgb_sensor_power_on(void);
+int rgb_sensor_enable(void);
+int rgb_sensor_read(uint8_t inst, uint16_t *clear, uint16_t *red,
                     uint16_t *green, uint16_t *blue);
 
 #endif /* RGB_SENSOR_H */
\ No newline at end of file
@@ -0,0 +1,325 @@
+// tests/host/pc_export_dev.c
+//
+// The device side of "pc export" on a pty, for test_pc_export.py: the
+// firmware's plantcare_log.c and plantcare_export.c, with uart_poll_out
+// and the printk console writing to the pty master. A line of the form
+// "pc export [<from> [<count>]]" on the pty runs plantcare_export_run()
+// as cmd_export does. Commands on stdin steer it:
+//
+//   add <n> [dense]
+//                  append n readings; each record is printed as the CSV
+//                  row pc_export.py should write for it, then "ok".
+//                  Dense records have no zero byte, so a data frame has
+//                  runs longer than one COBS block.
+//   corrupt <k>    flip a byte in data frame k (from 0) of the next export
+//   noise <text>   printk text (\r\n appended) during the next export,
+//                  as another thread would
+//
+// On start it prints "pty <slave path>". EOF on stdin ends it.
+
+#define _GNU_SOURCE
+
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/printk-hooks.h>
+
+#include "plantcare_export.h"
+#include "plantcare_log.h"
+#include "plantcare_state.h"
+#include "plantcare_units.h"
+
+const struct device host_i2c_dev = { "i2c" };
+
+static const struct device pty_uart = { "pty" };
+static int master = -1;
+
+/* Set by "corrupt" and "noise", used once by the next export */
+static int corrupt_frame = -1;
+static char noise[128];
+
+/* Position on the wire within the current export */
+static int frame_no;
+static int frame_pos;
+static bool exporting;
+
+static void pty_write(const void *buf, size_t len)
+{
+    const uint8_t *p = buf;
+
+    while (len > 0) {
+        ssize_t n = write(master, p, len);
+
+        if (n <= 0) {
+            exit(1);
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+}
+
+static int console_char(int c)
+{
+    uint8_t b = (uint8_t)c;
+
+    pty_write(&b, 1);
+    return c;
+}
+
+/* Frame 0 is the lone delimiter, 1 the info frame, 2.. the data frames */
+void uart_poll_out(const struct device *dev, unsigned char c)
+{
+    (void)dev;
+
+    if (exporting && corrupt_frame >= 0 && frame_no == corrupt_frame + 2 &&
+        frame_pos == 5) {
+        c ^= 0x55;
+        c = c ? c : 1;
+        corrupt_frame = -1;
+    }
+    pty_write(&c, 1);
+
+    if (c != 0x00) {
+        frame_pos++;
+        return;
+    }
+    frame_no++;
+    frame_pos = 0;
+
+    /* Printed while the data goes out, so it has to be held */
+    if (exporting && frame_no == 3 && noise[0] != '\0') {
+        printk("%s\r\n", noise);
+        noise[0] = '\0';
+    }
+}
+
+int uart_irq_tx_complete(const struct device *dev)
+{
+    (void)dev;
+    return 1;
+}
+
+static bool nonzero16(int16_t v)
+{
+    return (v & 0xFF) != 0 && (v & 0xFF00) != 0;
+}
+
+/* Every byte of a dense reading is non-zero; the uptime is set to match */
+static void dense_reading(struct plantcare_data *d, uint32_t n)
+{
+    uint32_t k = 1 + n % 14;
+
+    memset(d, 0, sizeof(*d));
+    d->epoch_s = 0x11111111U * k;
+    host_uptime_ms = (int64_t)0x11111111 * k * 1000;
+    d->temp_x100 = 0x0B0B;
+    d->hum_x100 = 0x1515;
+    d->acc_z_g100 = 0x0202;
+    d->tilt.tilt_cdeg = 0x0303;
+    d->lux = 0x0404;
+    d->leaf_class = 1 + n % 3;
+    d->valid_mask = 0x0F;
+
+    /* Raw values whose percentages have no zero byte either */
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        int16_t raw = (int16_t)(1500 + 7 * n + 50 * p);
+
+        while (!nonzero16(soil_raw_to_pct_x10(raw))) {
+            raw++;
+        }
+        d->plants[p].soil_raw = raw;
+        raw = (int16_t)(2500 + 5 * n + 40 * p);
+        while (!nonzero16(light_raw_to_pct_x10(raw))) {
+            raw++;
+        }
+        d->plants[p].light_raw = raw;
+    }
+}
+
+/* Reading n, with zero bytes in it for COBS to replace */
+static void reading(struct plantcare_data *d, uint32_t n)
+{
+    memset(d, 0, sizeof(*d));
+    d->epoch_s = 1700000000 + n * 60;
+    d->temp_x100 = 2000 + (int32_t)n;
+    d->hum_x100 = 5000;
+    d->acc_x_g100 = -3;
+    d->acc_z_g100 = 100;
+    d->tilt.tilt_cdeg = -1;
+    d->lux = n * 10;
+    d->leaf_class = n % 4;
+    d->valid_mask = 0x0F;
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        d->plants[p].soil_raw = (int16_t)(1000 + 37 * n + 100 * p);
+        d->plants[p].light_raw = (int16_t)(n % 3 == 0 ? 0 : 200 + p);
+    }
+}
+
+static void add(uint32_t count, bool dense)
+{
+    static struct plantcare_data d;
+    struct plantcare_log_rec r;
+    uint32_t oldest, next;
+
+    for (uint32_t i = 0; i < count; i++) {
+        plantcare_log_range(&oldest, &next);
+        if (dense) {
+            dense_reading(&d, next);
+        } else {
+            reading(&d, next);
+            host_uptime_ms += 30000;
+        }
+        plantcare_log_add(&d, host_uptime_ms);
+        plantcare_log_read(next, &r, 1);
+
+        printf("%u,%u,%u,%d,%u,%d,%d,%u,%u,%u", next, r.epoch_s, r.uptime_s,
+               r.temp_x100, r.hum_x100, r.acc_max_g100, r.tilt_cdeg, r.lux,
+               r.leaf_class, r.valid_mask);
+        for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+            printf(",%d,%d", r.plants[p].soil_pct_x10,
+                   r.plants[p].light_pct_x10);
+        }
+        printf("\n");
+    }
+    printf("ok\n");
+}
+
+/* cmd_export, with the shell's echo and prompt */
+static void shell_line(char *line)
+{
+    struct plantcare_export_stats st;
+    uint32_t oldest, next;
+    long from = -1, count = 0;
+    char out[256];
+
+    pty_write(line, strlen(line));
+    pty_write("\r\n", 2);
+
+    if (strncmp(line, "pc export", 9) != 0) {
+        pty_write("uart:~$ ", 8);
+        return;
+    }
+    sscanf(line + 9, "%ld %ld", &from, &count);
+
+    plantcare_log_range(&oldest, &next);
+    if (from < 0) {
+        from = oldest;
+    }
+
+    frame_no = 0;
+    frame_pos = 0;
+    exporting = true;
+    plantcare_export_run(&pty_uart, (uint32_t)from, (uint32_t)count, &st);
+    exporting = false;
+
+    int n = snprintf(out, sizeof(out),
+                     "\r\nexport: %u records in %u frames, %u B, skipped %u; "
+                     "console held %u B, dropped %u B\r\nuart:~$ ",
+                     st.records, st.frames, st.bytes, st.skipped, st.held,
+                     st.dropped);
+    pty_write(out, (size_t)n);
+}
+
+static void stdin_line(char *line)
+{
+    unsigned int n;
+    char opt[8] = "";
+
+    if (sscanf(line, "add %u %7s", &n, opt) >= 1) {
+        add(n, strcmp(opt, "dense") == 0);
+    } else if (sscanf(line, "corrupt %u", &n) == 1) {
+        corrupt_frame = (int)n;
+        printf("ok\n");
+    } else if (strncmp(line, "noise ", 6) == 0) {
+        snprintf(noise, sizeof(noise), "%s", line + 6);
+        printf("ok\n");
+    } else {
+        printf("? %s\n", line);
+    }
+}
+
+/* Split buf into lines on \n, \r dropped; keeps the tail */
+static void lines(char *buf, size_t *len, void (*fn)(char *))
+{
+    char *nl;
+
+    while ((nl = memchr(buf, '\n', *len)) != NULL) {
+        size_t used = (size_t)(nl - buf) + 1;
+
+        *nl = '\0';
+        if (nl > buf && nl[-1] == '\r') {
+            nl[-1] = '\0';
+        }
+        if (buf[0] != '\0') {
+            fn(buf);
+        }
+        memmove(buf, nl + 1, *len - used);
+        *len -= used;
+    }
+}
+
+int main(void)
+{
+    static char pty_buf[256], in_buf[256];
+    size_t pty_len = 0, in_len = 0;
+    struct termios t;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) {
+        perror("pty");
+        return 1;
+    }
+
+    /* Held open so the pty stays up between runs of the script */
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+
+    if (slave < 0 || tcgetattr(slave, &t) < 0) {
+        perror("pty slave");
+        return 1;
+    }
+    cfmakeraw(&t);
+    tcsetattr(slave, TCSANOW, &t);
+
+    __printk_hook_install(console_char);
+    printf("pty %s\n", ptsname(master));
+
+    for (;;) {
+        struct pollfd fds[2] = {
+            { .fd = master, .events = POLLIN },
+            { .fd = STDIN_FILENO, .events = POLLIN },
+        };
+
+        if (poll(fds, 2, -1) < 0) {
+            return 1;
+        }
+        if (fds[0].revents & POLLIN) {
+            ssize_t n = read(master, pty_buf + pty_len,
+                             sizeof(pty_buf) - 1 - pty_len);
+
+            if (n > 0) {
+                pty_len += (size_t)n;
+                lines(pty_buf, &pty_len, shell_line);
+            }
+        }
+        if (fds[1].revents & (POLLIN | POLLHUP)) {
+            ssize_t n = read(STDIN_FILENO, in_buf + in_len,
+                             sizeof(in_buf) - 1 - in_len);
+
+            if (n <= 0) {
+                break;
+            }
+            in_len += (size_t)n;
+            lines(in_buf, &in_len, stdin_line);
+        }
+    }
+    close(slave);
+    return 0;
+}
@@ -0,0 +1,45 @@
+// tests/host/shim/host_kernel.c
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk-hooks.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+int64_t host_uptime_ms;
+
+static int host_putchar(int c)
+{
+    return putchar(c);
+}
+
+static printk_hook_fn_t printk_hook = host_putchar;
+
+void __printk_hook_install(printk_hook_fn_t fn)
+{
+    printk_hook = fn;
+}
+
+printk_hook_fn_t __printk_get_hook(void)
+{
+    return printk_hook;
+}
+
+void printk(const char *fmt, ...)
+{
+    va_list ap, ap2;
+
+    va_start(ap, fmt);
+    va_copy(ap2, ap);
+    int n = vsnprintf(NULL, 0, fmt, ap);
+    char *s = malloc(n + 1);
+
+    if (s != NULL) {
+        vsnprintf(s, n + 1, fmt, ap2);
+        for (int i = 0; i < n; i++) {
+            printk_hook((unsigned char)s[i]);
+        }
+        free(s);
+    }
+    va_end(ap2);
+    va_end(ap);
+}
@@ -0,0 +1,37 @@
+/* Host shim: no devicetree. Properties take their defaults; the board is
+ * one TCA9548A at 0x70 on host_i2c_dev, and HOST_PLANTS plants (2 unless
+ * the build sets it).
+ */
+#ifndef HOST_SHIM_DEVICETREE_H
+#define HOST_SHIM_DEVICETREE_H
+
+#include <zephyr/sys/util.h>
+
+#define HOST_DT_NUM_plantcare_tca9548a  1
+#ifndef HOST_PLANTS
+#define HOST_PLANTS                     2
+#endif
+
+#define HOST_DT_NUM_plantcare_plant     HOST_PLANTS
+
+#define DT_PATH(...)                        0
+#define DT_INST(inst, compat)               0
+#define DT_NODELABEL(label)                 0
+#define DT_BUS(node)                        0
+#define DT_PARENT(node)                     0
+#define DT_PROP_OR(node, prop, def)         (def)
+#define DT_NODE_HAS_PROP(node, prop)        0
+#define DT_NODE_HAS_COMPAT(node, compat)    0
+#define DT_NODE_HAS_STATUS(node, status)    0
+#define DT_NUM_INST_STATUS_OKAY(compat)     HOST_DT_NUM_##compat
+#define DT_HAS_COMPAT_STATUS_OKAY(compat)   (HOST_DT_NUM_##compat > 0)
+#define DT_COMPAT_GET_ANY_STATUS_OKAY(c)    0
+
+/* COND_CODE_1 for flags that expand to a literal 0 or 1 */
+#define HOST_DEPAREN(...)                   __VA_ARGS__
+#define HOST_COND_0(a, b)                   HOST_DEPAREN b
+#define HOST_COND_1(a, b)                   HOST_DEPAREN a
+#define HOST_COND(flag, a, b)               HOST_COND_##flag(a, b)
+#define COND_CODE_1(flag, a, b)             HOST_COND(flag, a, b)
+
+#endif
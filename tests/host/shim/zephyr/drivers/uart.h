@@ -0,0 +1,10 @@
+/* Host shim: polled UART out, defined by the program that needs one */
+#ifndef HOST_SHIM_DRIVERS_UART_H
+#define HOST_SHIM_DRIVERS_UART_H
+
+#include <zephyr/device.h>
+
+void uart_poll_out(const struct device *dev, unsigned char out_char);
+int uart_irq_tx_complete(const struct device *dev);
+
+#endif
@@ -0,0 +1,80 @@
+/* Host shim: a single thread and a clock the test moves by hand */
+#ifndef HOST_SHIM_KERNEL_H
+#define HOST_SHIM_KERNEL_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+/* Uptime in ms; k_msleep() advances it */
+extern int64_t host_uptime_ms;
+
+typedef struct {
+    int64_t ms;
+} k_timeout_t;
+
+#define K_MSEC(ms)      ((k_timeout_t){ (ms) })
+
+struct k_spinlock {
+    int unused;
+};
+typedef int k_spinlock_key_t;
+
+/* One thread: a mutex never waits */
+struct k_mutex {
+    int unused;
+};
+
+#define K_MUTEX_DEFINE(name)    struct k_mutex name
+#define K_FOREVER               ((k_timeout_t){ -1 })
+
+static inline int64_t k_uptime_get(void)
+{
+    return host_uptime_ms;
+}
+
+/* No cycle counter: everything takes no time */
+static inline uint32_t k_cycle_get_32(void)
+{
+    return 0;
+}
+
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cycles)
+{
+    return cycles;
+}
+
+static inline int32_t k_msleep(int32_t ms)
+{
+    host_uptime_ms += ms;
+    return 0;
+}
+
+static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
+{
+    (void)l;
+    return 0;
+}
+
+static inline void k_spin_unlock(struct k_spinlock *l, k_spinlock_key_t key)
+{
+    (void)l;
+    (void)key;
+}
+
+static inline int k_mutex_lock(struct k_mutex *m, k_timeout_t timeout)
+{
+    (void)m;
+    (void)timeout;
+    return 0;
+}
+
+static inline int k_mutex_unlock(struct k_mutex *m)
+{
+    (void)m;
+    return 0;
+}
+
+#endif
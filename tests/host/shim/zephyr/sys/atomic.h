@@ -0,0 +1,38 @@
+/* Host shim: one thread, plain loads and stores */
+#ifndef HOST_SHIM_SYS_ATOMIC_H
+#define HOST_SHIM_SYS_ATOMIC_H
+
+#include <stdbool.h>
+
+typedef long atomic_t;
+typedef long atomic_val_t;
+
+static inline atomic_val_t atomic_get(const atomic_t *target)
+{
+    return *target;
+}
+
+static inline atomic_val_t atomic_set(atomic_t *target, atomic_val_t value)
+{
+    atomic_val_t old = *target;
+
+    *target = value;
+    return old;
+}
+
+static inline atomic_val_t atomic_clear(atomic_t *target)
+{
+    return atomic_set(target, 0);
+}
+
+static inline bool atomic_cas(atomic_t *target, atomic_val_t old_value,
+                              atomic_val_t new_value)
+{
+    if (*target != old_value) {
+        return false;
+    }
+    *target = new_value;
+    return true;
+}
+
+#endif
@@ -0,0 +1,19 @@
+/* Host shim */
+#ifndef HOST_SHIM_SYS_BYTEORDER_H
+#define HOST_SHIM_SYS_BYTEORDER_H
+
+#include <stdint.h>
+
+static inline void sys_put_le16(uint16_t val, uint8_t dst[2])
+{
+    dst[0] = (uint8_t)val;
+    dst[1] = (uint8_t)(val >> 8);
+}
+
+static inline void sys_put_le32(uint32_t val, uint8_t dst[4])
+{
+    sys_put_le16((uint16_t)val, dst);
+    sys_put_le16((uint16_t)(val >> 16), &dst[2]);
+}
+
+#endif
@@ -0,0 +1,21 @@
+/* Host shim: bitwise CRC-32 (IEEE 802.3, reflected), as lib/crc */
+#ifndef HOST_SHIM_SYS_CRC_H
+#define HOST_SHIM_SYS_CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static inline uint32_t crc32_ieee(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & -(crc & 1U));
+        }
+    }
+    return ~crc;
+}
+
+#endif
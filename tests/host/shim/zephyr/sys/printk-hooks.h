@@ -0,0 +1,10 @@
+/* Host shim: the printk character hook (host_kernel.c) */
+#ifndef HOST_SHIM_SYS_PRINTK_HOOKS_H
+#define HOST_SHIM_SYS_PRINTK_HOOKS_H
+
+typedef int (*printk_hook_fn_t)(int c);
+
+void __printk_hook_install(printk_hook_fn_t fn);
+printk_hook_fn_t __printk_get_hook(void);
+
+#endif
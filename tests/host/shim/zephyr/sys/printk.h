@@ -0,0 +1,13 @@
+/* Host shim: printk goes through the hook, which is putchar on stdout
+ * until something installs another (sys/printk-hooks.h)
+ */
+#ifndef HOST_SHIM_SYS_PRINTK_H
+#define HOST_SHIM_SYS_PRINTK_H
+
+#include <stdio.h>
+
+void printk(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#define snprintk    snprintf
+
+#endif
@@ -0,0 +1,8 @@
+/* Host shim: GCC and Clang */
+#ifndef HOST_SHIM_TOOLCHAIN_H
+#define HOST_SHIM_TOOLCHAIN_H
+
+#define __packed        __attribute__((__packed__))
+#define __aligned(x)    __attribute__((__aligned__(x)))
+
+#endif
@@ -0,0 +1,349 @@
+// tests/host/test_adapt.c
+//
+// Adaptive sampling over a synthetic day, against the alarm engine it
+// watches. The same 24 h trace is read at a fixed 30 s and adaptively
+// between 30 s and 5 min, feeding the alarms through the real feed as
+// the sensor thread does. The adaptive run must read far less and still
+// raise and clear the same alarms, at most one ceiling period later.
+//
+// The trace: climate on a daily sine with a 36 min heat excursion at
+// 14:00, light at night below its limit, soil drying 1.2 %/h towards its
+// limit and watered at 20:00, a second plant's soil wet and steady.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "plantcare_alarm_feed.c"
+#include "plantcare_adapt.h"
+#include "plantcare_psychro.h"
+
+static int fails;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+            fails++;                                        \
+        }                                                   \
+    } while (0)
+
+#define DAY_MS          (24LL * 60 * 60 * 1000)
+#define FLOOR_MS        30000U
+#define CEILING_MS      300000U
+
+struct zbus_channel pc_adc_chan, pc_climate_chan, pc_accel_chan,
+                    pc_color_chan, pc_snapshot_chan, pc_alarm_chan;
+
+/* Alarm transitions of one run */
+struct transition {
+    uint8_t channel;
+    uint8_t inst;
+    bool    active;
+    int64_t time_ms;
+};
+
+struct run {
+    struct transition tr[64];
+    size_t n_tr;
+    uint32_t adc_reads;
+    uint32_t climate_reads;
+};
+
+static struct run scratch;
+static struct run *cur_run = &scratch;
+
+int zbus_chan_pub(const struct zbus_channel *chan, const void *msg,
+                  k_timeout_t timeout)
+{
+    const struct plantcare_alarm_event *evt = msg;
+
+    (void)timeout;
+    if (chan == &pc_alarm_chan && cur_run->n_tr < ARRAY_SIZE(cur_run->tr)) {
+        cur_run->tr[cur_run->n_tr++] = (struct transition){
+            evt->channel, evt->inst, evt->active, evt->time_ms,
+        };
+    }
+    return 0;
+}
+
+/* No sensor faults in this trace */
+void plantcare_anomaly_get(uint8_t kinds[PC_AN_CH_COUNT], int64_t now_ms)
+{
+    (void)now_ms;
+    memset(kinds, PC_AN_NONE, PC_AN_CH_COUNT);
+}
+
+/* Uniform in [-a, a], the same for the same read in both runs */
+static double noise(double a, int64_t t_ms, unsigned int salt)
+{
+    uint32_t x = (uint32_t)(t_ms / 1000) * 2654435761U + salt * 40503U;
+
+    x ^= x >> 15;
+    x *= 2246822519U;
+    x ^= x >> 13;
+    return ((int)(x % 2001U) - 1000) / 1000.0 * a;
+}
+
+static double hours(int64_t t_ms)
+{
+    return t_ms / 3600000.0;
+}
+
+static double temp_at(int64_t t)
+{
+    double h = hours(t);
+
+    if (h >= 14.0 && h < 14.6) {
+        return 31.5;
+    }
+    return 22.0 + 4.0 * sin((h - 9.0) / 24.0 * 2.0 * M_PI);
+}
+
+static double hum_at(int64_t t)
+{
+    return 55.0 - 8.0 * sin((hours(t) - 9.0) / 24.0 * 2.0 * M_PI);
+}
+
+static double light_at(int64_t t)
+{
+    double h = hours(t);
+
+    if (h < 6.0 || h > 20.0) {
+        return 2.0;
+    }
+    return 2.0 + 70.0 * sin((h - 6.0) / 14.0 * M_PI);
+}
+
+static double soil_at(int64_t t)
+{
+    double h = hours(t);
+
+    return (h >= 20.0) ? 70.0 : 45.0 - 1.2 * h;
+}
+
+static struct plantcare_data data;
+
+/* One ADC scan, as read_adc() in sensor_thread.c does it */
+static void read_adc(int64_t now)
+{
+    static struct pc_msg_adc adc;
+
+    data.plants[0].soil_raw = (int16_t)lround(soil_at(now) * 40.95 +
+                                              noise(4, now, 1));
+    data.plants[1].soil_raw = (int16_t)lround(60.0 * 40.95 + noise(4, now, 2));
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        data.plants[p].light_raw = (int16_t)lround(light_at(now) * 4.0 +
+                                                   noise(1, now, 3 + p));
+    }
+
+    plantcare_anomaly_get(data.anomaly, now);
+    plantcare_drying_update(&data, now);
+    memcpy(adc.plants, data.plants, sizeof(adc.plants));
+    memcpy(adc.drying, data.drying, sizeof(adc.drying));
+
+    pc_adc_chan.msg = &adc;
+    alarm_feed_cb(&pc_adc_chan);
+}
+
+static void read_climate(int64_t now)
+{
+    static struct pc_msg_climate climate;
+    struct plantcare_psychro psy;
+
+    climate.temp_x100 = (int32_t)lround(100.0 * (temp_at(now) +
+                                                 noise(0.05, now, 10)));
+    climate.hum_x100  = (int32_t)lround(100.0 * (hum_at(now) +
+                                                 noise(0.3, now, 11)));
+    plantcare_psychro_compute(climate.temp_x100, climate.hum_x100, &psy);
+    climate.dew_x100 = psy.dew_x100;
+    climate.vpd_pa   = psy.vpd_pa;
+
+    data.temp_x100 = climate.temp_x100;
+    data.hum_x100  = climate.hum_x100;
+    data.dew_x100  = climate.dew_x100;
+    data.vpd_pa    = climate.vpd_pa;
+
+    pc_climate_chan.msg = &climate;
+    alarm_feed_cb(&pc_climate_chan);
+}
+
+/* Next period as sensor_next_period() in sensor_thread.c picks it: fixed
+ * with adaptive sampling off, else the controller's choice
+ */
+static uint32_t next_period(enum plantcare_sensor s, bool adapt, int64_t now)
+{
+    if (!adapt) {
+        return FLOOR_MS;
+    }
+    return plantcare_adapt_next_period(s, &data, FLOOR_MS, CEILING_MS, now);
+}
+
+/* The sensor thread's loop for the two groups: read each when due, then
+ * pick its next period
+ */
+static void replay(struct run *r, bool adapt)
+{
+    int64_t due_adc = 0, due_climate = 0;
+
+    /* Loading the rules clears the last run's alarms: not this run's */
+    cur_run = &scratch;
+    plantcare_alarm_init();
+    memset(r, 0, sizeof(*r));
+    cur_run = r;
+    memset(&data, 0, sizeof(data));
+    plantcare_drying_reset();
+    plantcare_adapt_reset();
+
+    while (MIN(due_adc, due_climate) < DAY_MS) {
+        int64_t now = MIN(due_adc, due_climate);
+
+        host_uptime_ms = now;
+        if (now >= due_adc) {
+            read_adc(now);
+            r->adc_reads++;
+            due_adc = now + next_period(PC_SENSOR_ADC, adapt, now);
+        }
+        if (now >= due_climate) {
+            read_climate(now);
+            r->climate_reads++;
+            due_climate = now + next_period(PC_SENSOR_CLIMATE, adapt, now);
+        }
+    }
+}
+
+static struct run fixed, adaptive;
+
+static void test_reads_saved(void)
+{
+    struct plantcare_adapt_stats adc, climate;
+
+    plantcare_adapt_get_stats(PC_SENSOR_ADC, &adc);
+    plantcare_adapt_get_stats(PC_SENSOR_CLIMATE, &climate);
+
+    printf("fixed:    adc %u reads, climate %u reads\n",
+           fixed.adc_reads, fixed.climate_reads);
+    printf("adaptive: adc %u reads, climate %u reads, %u uJ saved\n",
+           adaptive.adc_reads, adaptive.climate_reads,
+           adc.saved_uj + climate.saved_uj);
+
+    CHECK(fixed.adc_reads == 2880 && fixed.climate_reads == 2880,
+          "fixed run read %u/%u times", fixed.adc_reads, fixed.climate_reads);
+    CHECK(adc.reads == adaptive.adc_reads &&
+          climate.reads == adaptive.climate_reads,
+          "stats count %u/%u reads", adc.reads, climate.reads);
+
+    /* The floor-rate count "pc adapt" shows is what the fixed run did,
+     * give or take the last ceiling period
+     */
+    CHECK(adc.floor_reads + CEILING_MS / FLOOR_MS >= fixed.adc_reads &&
+          adc.floor_reads <= fixed.adc_reads,
+          "adc floor reads %u", adc.floor_reads);
+    CHECK(climate.floor_reads + CEILING_MS / FLOOR_MS >= fixed.climate_reads &&
+          climate.floor_reads <= fixed.climate_reads,
+          "climate floor reads %u", climate.floor_reads);
+
+    /* Under a third of the reads for both groups. The hours VPD spends
+     * near its limit go at the floor rate, and light moves all day.
+     */
+    CHECK(adaptive.climate_reads * 3 < fixed.climate_reads,
+          "climate %u reads", adaptive.climate_reads);
+    CHECK(adaptive.adc_reads * 3 < fixed.adc_reads,
+          "adc %u reads", adaptive.adc_reads);
+    CHECK(climate.saved_uj == (climate.floor_reads - climate.reads) * 30,
+          "climate saved %u uJ", climate.saved_uj);
+    CHECK(adc.saved_uj == (adc.floor_reads - adc.reads) * 15 *
+                          PLANTCARE_PLANT_COUNT,
+          "adc saved %u uJ", adc.saved_uj);
+}
+
+/* Same transitions per channel and instance, in the same order, none
+ * more than one ceiling period later. The drying fit sees fewer points
+ * when adaptive and may cross its limit one read earlier.
+ */
+static void test_same_alarms(void)
+{
+    int64_t worst = 0;
+
+    for (size_t f = 0; f < fixed.n_tr; f++) {
+        const struct transition *tf = &fixed.tr[f];
+
+        printf("  %-12s %u %s at %5.2f h\n",
+               plantcare_alarm_channel_name(tf->channel), tf->inst,
+               tf->active ? "raised " : "cleared", hours(tf->time_ms));
+    }
+
+    CHECK(fixed.n_tr == adaptive.n_tr, "%zu transitions fixed, %zu adaptive",
+          fixed.n_tr, adaptive.n_tr);
+
+    for (size_t f = 0; f < fixed.n_tr; f++) {
+        const struct transition *tf = &fixed.tr[f];
+        size_t seen = 0;
+        bool found = false;
+
+        /* The n-th transition of this channel/instance in both runs */
+        for (size_t i = 0; i < f; i++) {
+            if (fixed.tr[i].channel == tf->channel &&
+                fixed.tr[i].inst == tf->inst) {
+                seen++;
+            }
+        }
+        for (size_t i = 0; i < adaptive.n_tr; i++) {
+            const struct transition *ta = &adaptive.tr[i];
+
+            if (ta->channel != tf->channel || ta->inst != tf->inst) {
+                continue;
+            }
+            if (seen > 0) {
+                seen--;
+                continue;
+            }
+            found = true;
+            CHECK(ta->active == tf->active, "%s %u: %s instead of %s",
+                  plantcare_alarm_channel_name(tf->channel), tf->inst,
+                  ta->active ? "raised" : "cleared",
+                  tf->active ? "raised" : "cleared");
+            CHECK(ta->time_ms + FLOOR_MS >= tf->time_ms &&
+                  ta->time_ms - tf->time_ms <= CEILING_MS,
+                  "%s %u lag %lld ms",
+                  plantcare_alarm_channel_name(tf->channel), tf->inst,
+                  (long long)(ta->time_ms - tf->time_ms));
+            worst = MAX(worst, ta->time_ms - tf->time_ms);
+            break;
+        }
+        CHECK(found, "%s %u: transition %zu missing in the adaptive run",
+              plantcare_alarm_channel_name(tf->channel), tf->inst, f);
+    }
+    printf("adaptive: %zu transitions, worst lag %lld s\n", adaptive.n_tr,
+           (long long)worst / 1000);
+}
+
+/* The trace must exercise what it is meant to */
+static void test_trace_covers(void)
+{
+    uint32_t raised = 0;
+
+    for (size_t f = 0; f < fixed.n_tr; f++) {
+        if (fixed.tr[f].active) {
+            raised |= BIT(fixed.tr[f].channel);
+        }
+    }
+    CHECK(raised & BIT(PC_CH_TEMP), "no heat alarm");
+    CHECK(raised & BIT(PC_CH_LIGHT), "no light alarm");
+    CHECK(raised & BIT(PC_CH_SOIL_DRY), "no drying alarm");
+}
+
+int main(void)
+{
+    replay(&fixed, false);
+    replay(&adaptive, true);
+
+    test_trace_covers();
+    test_reads_saved();
+    test_same_alarms();
+
+    printf("%s: %d failures\n", fails ? "FAILED" : "ok", fails);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,204 @@
+// tests/host/test_alarm.c
+//
+// The alarm engine and its sensor feed: dwell and hysteresis on the
+// default rules, rule tables replaced at runtime reporting every raised
+// alarm as cleared, and a dead soil probe leaving its plant's light
+// alarm alone. The feed is included so its listener can be called
+// directly with a message.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "plantcare_alarm_feed.c"
+
+static int fails;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+            fails++;                                        \
+        }                                                   \
+    } while (0)
+
+struct zbus_channel pc_adc_chan, pc_climate_chan, pc_accel_chan,
+                    pc_color_chan, pc_snapshot_chan, pc_alarm_chan;
+
+/* Events published on pc_alarm_chan since the last take_events() */
+static struct plantcare_alarm_event evts[64];
+static size_t n_evts;
+
+int zbus_chan_pub(const struct zbus_channel *chan, const void *msg,
+                  k_timeout_t timeout)
+{
+    (void)timeout;
+    if (chan == &pc_alarm_chan && n_evts < ARRAY_SIZE(evts)) {
+        evts[n_evts++] = *(const struct plantcare_alarm_event *)msg;
+    }
+    return 0;
+}
+
+static size_t take_events(void)
+{
+    size_t n = n_evts;
+
+    n_evts = 0;
+    return n;
+}
+
+/* The anomaly detector's verdict, set by each test */
+static uint8_t an_kinds[PC_AN_CH_COUNT];
+
+void plantcare_anomaly_get(uint8_t kinds[PC_AN_CH_COUNT], int64_t now_ms)
+{
+    (void)now_ms;
+    memcpy(kinds, an_kinds, sizeof(an_kinds));
+}
+
+/* Index of the first rule on ch in the table loaded now */
+static int rule_index(enum plantcare_channel ch)
+{
+    struct plantcare_alarm_rule rules[PLANTCARE_ALARM_MAX_RULES];
+    size_t n = plantcare_alarm_get_rules(rules, ARRAY_SIZE(rules));
+
+    for (size_t i = 0; i < n; i++) {
+        if (rules[i].channel == ch) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static void test_dwell_and_hysteresis(void)
+{
+    plantcare_alarm_init();
+    take_events();
+
+    /* 31.00 C: raised after the 60 s dwell, not before */
+    plantcare_alarm_update(PC_CH_TEMP, 3100, 0);
+    plantcare_alarm_update(PC_CH_TEMP, 3100, 59999);
+    CHECK(take_events() == 0, "raised before the dwell");
+    plantcare_alarm_update(PC_CH_TEMP, 3100, 60000);
+    CHECK(take_events() == 1 && evts[0].active &&
+          evts[0].channel == PC_CH_TEMP, "not raised after the dwell");
+    CHECK(plantcare_alarm_highest() == PC_CH_TEMP, "highest %d",
+          plantcare_alarm_highest());
+
+    /* 29.80 C is inside the band but within the 0.50 C hysteresis */
+    plantcare_alarm_update(PC_CH_TEMP, 2980, 61000);
+    plantcare_alarm_update(PC_CH_TEMP, 2980, 200000);
+    CHECK(take_events() == 0, "cleared inside the hysteresis");
+
+    plantcare_alarm_update(PC_CH_TEMP, 2900, 201000);
+    plantcare_alarm_update(PC_CH_TEMP, 2900, 261000);
+    CHECK(take_events() == 1 && !evts[0].active, "not cleared");
+    CHECK(plantcare_alarm_active_mask() == 0, "mask %x",
+          (unsigned)plantcare_alarm_active_mask());
+}
+
+static void test_set_rules_clears(void)
+{
+    struct plantcare_alarm_rule rules[PLANTCARE_ALARM_MAX_RULES];
+    size_t n;
+
+    plantcare_alarm_init();
+
+    int temp = rule_index(PC_CH_TEMP);
+    int soil = rule_index(PC_CH_SOIL);
+
+    /* TEMP raised, and SOIL raised for plant 1 only (10.0 %) */
+    plantcare_alarm_update(PC_CH_TEMP, 3200, 0);
+    plantcare_alarm_update_inst(PC_CH_SOIL, 1, 100, 0);
+    plantcare_alarm_update_inst(PC_CH_SOIL, 0, 500, 0);
+    plantcare_alarm_update(PC_CH_TEMP, 3200, 60000);
+    plantcare_alarm_update_inst(PC_CH_SOIL, 1, 100, 60000);
+    CHECK(take_events() == 2, "setup");
+
+    /* Only the temperature limit moves: both alarms are reported
+     * cleared, under the indices they were raised with
+     */
+    n = plantcare_alarm_get_rules(rules, ARRAY_SIZE(rules));
+    rules[temp].max = 3500;
+    host_uptime_ms = 70000;
+    CHECK(plantcare_alarm_set_rules(rules, n) == 0, "set_rules");
+    CHECK(take_events() == 2, "clears %zu", n_evts);
+    CHECK(!evts[0].active && evts[0].rule == temp && evts[0].inst == 0 &&
+          evts[0].value == 3200 && evts[0].time_ms == 70000,
+          "TEMP clear rule %u inst %u value %d", evts[0].rule, evts[0].inst,
+          evts[0].value);
+    CHECK(!evts[1].active && evts[1].rule == soil && evts[1].inst == 1,
+          "SOIL clear rule %u inst %u", evts[1].rule, evts[1].inst);
+    CHECK(plantcare_alarm_active_mask() == 0, "still active");
+
+    /* Still too dry: raised again, once, under the new table */
+    plantcare_alarm_update_inst(PC_CH_SOIL, 1, 100, 71000);
+    plantcare_alarm_update_inst(PC_CH_SOIL, 1, 100, 131000);
+    CHECK(take_events() == 1 && evts[0].active && evts[0].inst == 1,
+          "SOIL not raised again");
+
+    /* A reset reports it too; a second one has nothing to report */
+    plantcare_alarm_reset();
+    CHECK(take_events() == 1 && !evts[0].active, "reset clear");
+    plantcare_alarm_reset();
+    CHECK(take_events() == 0, "reset with nothing raised");
+}
+
+/* Light at 5.0 % (below 10.0 %), soil at 50.0 % */
+static void feed_scan(int64_t now)
+{
+    static struct pc_msg_adc m;
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        m.plants[p].light_raw = 20;
+        m.plants[p].soil_raw  = 2048;
+        m.drying[p].valid     = false;
+    }
+    /* Plant 0's probe reads a short: the soil is not known */
+    m.plants[0].soil_raw = 0;
+
+    pc_adc_chan.msg = &m;
+    host_uptime_ms = now;
+    alarm_feed_cb(&pc_adc_chan);
+}
+
+static void test_dead_soil_probe(void)
+{
+    size_t n;
+    int light_raised = 0;
+
+    plantcare_alarm_init();
+    take_events();
+
+    int light = rule_index(PC_CH_LIGHT);
+
+    memset(an_kinds, PC_AN_NONE, sizeof(an_kinds));
+    an_kinds[PC_AN_CH_SOIL] = PC_AN_RANGE;
+
+    feed_scan(0);
+    feed_scan(60000);
+    n = take_events();
+
+    for (size_t e = 0; e < n; e++) {
+        CHECK(evts[e].channel != PC_CH_SOIL &&
+              evts[e].channel != PC_CH_SOIL_DRY,
+              "%s raised from a dead probe",
+              plantcare_alarm_channel_name(evts[e].channel));
+        if (evts[e].rule == light && evts[e].active) {
+            light_raised |= BIT(evts[e].inst);
+        }
+    }
+    CHECK(light_raised == (int)BIT_MASK(PLANTCARE_PLANT_COUNT),
+          "light raised for %x", (unsigned)light_raised);
+}
+
+int main(void)
+{
+    test_dwell_and_hysteresis();
+    test_set_rules_clears();
+    test_dead_soil_probe();
+
+    printf("%s: %d failures\n", fails ? "FAILED" : "ok", fails);
+    return fails ? 1 : 0;
+}
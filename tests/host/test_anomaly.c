@@ -0,0 +1,272 @@
+// tests/host/test_anomaly.c
+//
+// Replays of normal conditions and sensor faults through the anomaly
+// detector, 30 s per read as in normal mode. Normal conditions must raise
+// nothing; each fault must be reported as its kind, within a bound.
+//
+// The source is included so every scenario starts from clean state.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "plantcare_anomaly.c"
+
+#define READ_MS     30000
+
+static int fails;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+            fails++;                                        \
+        }                                                   \
+    } while (0)
+
+static unsigned int rng = 7;
+
+/* Uniform noise in [-a, a] */
+static int noise(int a)
+{
+    rng = rng * 1103515245u + 12345u;
+    return (int)((rng >> 16) % (2 * a + 1)) - a;
+}
+
+typedef void (*gen_t)(int i, struct plantcare_data *d);
+
+struct outcome {
+    int false_pos;      /* reads flagged before the fault (or at all) */
+    int after;          /* reads from the fault to the first finding, -1 none */
+    uint8_t kind;       /* that finding */
+    int ranged;         /* reads update() failed with -ERANGE */
+};
+
+static struct outcome run(enum plantcare_sensor s, int ch, gen_t gen,
+                          int n, int fault_at)
+{
+    struct plantcare_data d;
+    struct outcome o = { 0, -1, PC_AN_NONE, 0 };
+
+    memset(an_state, 0, sizeof(an_state));
+    memset(&d, 0, sizeof(d));
+    rng = 7;
+
+    for (int i = 0; i < n; i++) {
+        uint8_t kinds[PC_AN_CH_COUNT];
+        int64_t now = (int64_t)i * READ_MS;
+
+        gen(i, &d);
+        if (plantcare_anomaly_update(s, &d, now) == -ERANGE) {
+            o.ranged++;
+        }
+        plantcare_anomaly_get(kinds, now);
+        if (kinds[ch] == PC_AN_NONE) {
+            continue;
+        }
+        if (fault_at < 0 || i < fault_at) {
+            o.false_pos++;
+        } else if (o.after < 0) {
+            o.after = i - fault_at;
+            o.kind = kinds[ch];
+        }
+    }
+    return o;
+}
+
+/* ---- Climate: a day/night cycle, then faults from read 1000 ---- */
+static void t_diurnal(int i, struct plantcare_data *d)
+{
+    double day = sin(i * READ_MS / 86400e3 * 2 * M_PI);
+
+    d->temp_x100 = (int32_t)(2200 + 400 * day) + noise(3);
+    d->hum_x100 = (int32_t)(5500 - 800 * day) + noise(20);
+}
+
+static void t_stuck(int i, struct plantcare_data *d)
+{
+    t_diurnal(i, d);
+    if (i >= 1000) {
+        d->temp_x100 = 2345;
+    }
+}
+
+/* Si7021 answering 0xFFFF */
+static void t_ffff(int i, struct plantcare_data *d)
+{
+    t_diurnal(i, d);
+    if (i >= 1000) {
+        d->temp_x100 = 12886;
+        d->hum_x100 = 11899;
+    }
+}
+
+static void t_step(int i, struct plantcare_data *d)
+{
+    t_diurnal(i, d);
+    if (i >= 1000) {
+        d->temp_x100 += 800;
+    }
+}
+
+/* ---- Soil: drying out, watered at read 1500 ---- */
+static void s_dry(int i, struct plantcare_data *d)
+{
+    int v = (i < 1500) ? 2500 - i / 2 : 3200 - (i - 1500) / 2;
+
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        d->plants[p].soil_raw = (int16_t)(v + noise(6));
+    }
+}
+
+/* Plant 0 only: the other probes keep working */
+static void s_open(int i, struct plantcare_data *d)
+{
+    s_dry(i, d);
+    if (i >= 1000) {
+        d->plants[0].soil_raw = 4095;
+    }
+}
+
+static void s_all_open(int i, struct plantcare_data *d)
+{
+    s_dry(i, d);
+    if (i >= 1000) {
+        for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+            d->plants[p].soil_raw = 4095;
+        }
+    }
+}
+
+static void s_pulled(int i, struct plantcare_data *d)
+{
+    s_dry(i, d);
+    if (i >= 1000) {
+        d->plants[0].soil_raw = (int16_t)(300 + noise(6));
+    }
+}
+
+/* ---- Accelerometer at rest, a knock every 700 reads ---- */
+static void a_rest(int i, struct plantcare_data *d)
+{
+    d->acc_x_g100 = (i % 700 == 0) ? 150 : noise(1);
+    d->acc_y_g100 = noise(1);
+    d->acc_z_g100 = 100 + noise(1);
+}
+
+static void a_drift(int i, struct plantcare_data *d)
+{
+    a_rest(i, d);
+    if (i >= 1000) {
+        d->acc_z_g100 += (i - 1000) / 40;
+    }
+}
+
+static void a_stuck(int i, struct plantcare_data *d)
+{
+    a_rest(i, d);
+    if (i >= 1000) {
+        d->acc_x_g100 = 0;
+        d->acc_y_g100 = 0;
+        d->acc_z_g100 = 100;
+    }
+}
+
+static void test_quiet(void)
+{
+    struct outcome o;
+
+    /* Three days of weather */
+    o = run(PC_SENSOR_CLIMATE, PC_AN_CH_TEMP, t_diurnal, 3 * 2880, -1);
+    CHECK(o.false_pos == 0, "temp: %d false findings", o.false_pos);
+    o = run(PC_SENSOR_CLIMATE, PC_AN_CH_HUM, t_diurnal, 3 * 2880, -1);
+    CHECK(o.false_pos == 0, "hum: %d false findings", o.false_pos);
+
+    /* Watering is a legal upward jump */
+    o = run(PC_SENSOR_ADC, PC_AN_CH_SOIL, s_dry, 3000, -1);
+    CHECK(o.false_pos == 0, "soil: %d false findings", o.false_pos);
+
+    /* Knocks are short, not a drift or a fault */
+    o = run(PC_SENSOR_ACCEL, PC_AN_CH_ACCEL, a_rest, 5000, -1);
+    CHECK(o.false_pos == 0, "accel: %d false findings", o.false_pos);
+}
+
+static void expect(const char *name, struct outcome o, uint8_t kind, int within)
+{
+    CHECK(o.false_pos == 0, "%s: %d false findings", name, o.false_pos);
+    CHECK(o.after >= 0 && o.kind == kind && o.after <= within,
+          "%s: %s after %d reads, want %s within %d", name,
+          plantcare_anomaly_kind_name(o.kind), o.after,
+          plantcare_anomaly_kind_name(kind), within);
+}
+
+static void test_faults(void)
+{
+    struct outcome o;
+
+    expect("temp stuck",
+           run(PC_SENSOR_CLIMATE, PC_AN_CH_TEMP, t_stuck, 2000, 1000),
+           PC_AN_STUCK, 120);
+
+    o = run(PC_SENSOR_CLIMATE, PC_AN_CH_HUM, t_ffff, 2000, 1000);
+    expect("si7021 0xffff", o, PC_AN_RANGE, 0);
+    CHECK(o.ranged == 1000, "0xffff: %d reads failed, want 1000", o.ranged);
+
+    expect("temp +8 C step",
+           run(PC_SENSOR_CLIMATE, PC_AN_CH_TEMP, t_step, 2000, 1000),
+           PC_AN_JUMP, 0);
+
+    /* One open probe is flagged, the read still counts for the others */
+    o = run(PC_SENSOR_ADC, PC_AN_CH_SOIL, s_open, 2000, 1000);
+    expect("soil 0 open", o, PC_AN_RANGE, 0);
+    CHECK(o.ranged == 0, "soil 0 open: %d reads failed", o.ranged);
+
+    o = run(PC_SENSOR_ADC, PC_AN_CH_SOIL + 1, s_all_open, 2000, 1000);
+    expect("all probes open", o, PC_AN_RANGE, 0);
+    CHECK(o.ranged == 1000, "all open: %d reads failed, want 1000", o.ranged);
+
+    expect("soil 0 pulled out",
+           run(PC_SENSOR_ADC, PC_AN_CH_SOIL, s_pulled, 2000, 1000),
+           PC_AN_JUMP, 0);
+
+    expect("accel offset drift",
+           run(PC_SENSOR_ACCEL, PC_AN_CH_ACCEL, a_drift, 3000, 1000),
+           PC_AN_DRIFT, 300);
+
+    expect("accel stuck",
+           run(PC_SENSOR_ACCEL, PC_AN_CH_ACCEL, a_stuck, 2000, 1000),
+           PC_AN_STUCK, 60);
+}
+
+/* A jump stays visible for PLANTCARE_ANOMALY_HOLD_MS, then clears */
+static void test_hold(void)
+{
+    struct plantcare_data d;
+    uint8_t kinds[PC_AN_CH_COUNT];
+    int64_t now = 0;
+
+    memset(an_state, 0, sizeof(an_state));
+    memset(&d, 0, sizeof(d));
+    for (int i = 0; i < 1001; i++, now += READ_MS) {
+        t_step(i, &d);
+        plantcare_anomaly_update(PC_SENSOR_CLIMATE, &d, now);
+    }
+    int64_t jump_ms = now - READ_MS;
+
+    plantcare_anomaly_get(kinds, jump_ms + PLANTCARE_ANOMALY_HOLD_MS - 1);
+    CHECK(kinds[PC_AN_CH_TEMP] == PC_AN_JUMP, "jump not held");
+    plantcare_anomaly_get(kinds, jump_ms + PLANTCARE_ANOMALY_HOLD_MS);
+    CHECK(kinds[PC_AN_CH_TEMP] == PC_AN_NONE, "jump held too long");
+}
+
+int main(void)
+{
+    test_quiet();
+    test_faults();
+    test_hold();
+
+    printf("%s: %d failures\n", fails ? "FAIL" : "ok", fails);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+// tests/host/test_batch.c
+//
+// Normal-mode batching: one report an hour whatever the sample period,
+// batch_size as a cap, and the report size per hour at the periods
+// adaptive sampling uses. Reports are captured from printk and their
+// headers checked.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "plantcare_batch.h"
+#include "plantcare_bus.h"
+
+static int fails;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+            fails++;                                        \
+        }                                                   \
+    } while (0)
+
+/* Clock not set: reports carry epoch 0 */
+uint32_t plantcare_time_at(int64_t uptime_ms)
+{
+    (void)uptime_ms;
+    return 0;
+}
+
+/* Reports printed since the last capture_begin() */
+static char *cap_buf;
+static size_t cap_len;
+static FILE *cap_saved;
+
+static void capture_begin(void)
+{
+    free(cap_buf);
+    cap_saved = stdout;
+    stdout = open_memstream(&cap_buf, &cap_len);
+}
+
+static void capture_end(void)
+{
+    fclose(stdout);
+    stdout = cap_saved;
+}
+
+/* Header of the n-th report in the capture */
+struct report {
+    unsigned int n;
+    unsigned int t0_s;
+    char reason[12];
+};
+
+static int reports_in(struct report *out, int max)
+{
+    int found = 0;
+
+    for (const char *p = cap_buf; p && (p = strstr(p, "#B,")) != NULL; p++) {
+        unsigned int seq;
+
+        if (found < max &&
+            sscanf(p, "#B,%u,%u,%u,%11[a-z]", &seq, &out[found].n,
+                   &out[found].t0_s, out[found].reason) == 4) {
+            found++;
+        }
+    }
+    return found;
+}
+
+static unsigned int rng = 1;
+
+static int jitter(int a)
+{
+    rng = rng * 1103515245U + 12345U;
+    return (int)((rng >> 16) % (2U * a + 1U)) - a;
+}
+
+/* Typical indoor values at uptime t, with sensor noise */
+static void sample_at(struct plantcare_data *d, int64_t t_ms)
+{
+    double h = 10.0 + t_ms / 3600000.0;
+
+    d->temp_x100 = (int32_t)(100 * (22 + 4 * sin((h - 9) / 24 * 2 * M_PI))) +
+                   jitter(3);
+    d->hum_x100  = 5500 - (int32_t)(800 * sin((h - 9) / 24 * 2 * M_PI)) +
+                   jitter(15);
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        d->plants[p].light_raw = (int16_t)(300 + jitter(2));
+        d->plants[p].soil_raw  = (int16_t)(1800 - t_ms / 240000);
+    }
+    d->acc_z_g100 = 100 + jitter(1);
+    d->leaf_class = 0;
+    d->fresh_mask = 0x1f;
+    snprintf(d->gps_last_sentence, sizeof(d->gps_last_sentence),
+             "$GPRMC,101500.00,A,4807.038,N,01131.000,E,0.0,0.0,191026,,,A*6C");
+}
+
+/* Normal mode for hours: a sample every period_s, polled every second as
+ * the mode tick does. Returns the report bytes sent.
+ */
+static uint32_t run(int hours, int period_s, uint16_t batch_size)
+{
+    struct plantcare_data d = { 0 };
+    struct plantcare_batch_stats st0, st;
+
+    plantcare_batch_get_stats(&st0);
+    for (int64_t t = 0; t < (int64_t)hours * 3600; t++) {
+        if (t % period_s == 0) {
+            sample_at(&d, t * 1000);
+            plantcare_batch_add(&d, t * 1000);
+        }
+        plantcare_batch_poll(batch_size, false, t * 1000);
+    }
+    plantcare_batch_get_stats(&st);
+    return st.bytes - st0.bytes;
+}
+
+/* At the 5 min ceiling 120 records take 10 h: the age sends one an hour */
+static void test_hourly_at_ceiling(void)
+{
+    struct report r[32];
+    int n;
+
+    capture_begin();
+    run(24, 300, PLANTCARE_BATCH_DEFAULT);
+    plantcare_batch_flush(PC_BATCH_MODE_EXIT);
+    capture_end();
+
+    /* The last one is what was left when the mode ended */
+    n = reports_in(r, 32) - 1;
+    CHECK(n == 22, "%d reports in 24 h", n);
+    for (int i = 0; i < n; i++) {
+        CHECK(strcmp(r[i].reason, "age") == 0 && r[i].n == 13,
+              "report %d: %s, %u records", i, r[i].reason, r[i].n);
+        CHECK(i == 0 || r[i].t0_s - r[i - 1].t0_s == 3900,
+              "report %d starts at %u s", i, r[i].t0_s);
+    }
+}
+
+/* batch_size still bounds a report */
+static void test_cap(void)
+{
+    struct report r[8];
+    int n;
+
+    capture_begin();
+    run(1, 10, 60);
+    plantcare_batch_flush(PC_BATCH_MODE_EXIT);
+    capture_end();
+
+    n = reports_in(r, 8);
+    CHECK(n == 6, "%d reports", n);
+    for (int i = 0; i < n; i++) {
+        CHECK(strcmp(r[i].reason, "full") == 0 && r[i].n == 60,
+              "report %d: %s, %u records", i, r[i].reason, r[i].n);
+    }
+}
+
+/* Report bytes per hour at the floor, the ceiling and a mean adaptive
+ * day (57 records an hour in the test_adapt.c replay, about 63 s apart)
+ */
+static void test_bytes_per_hour(void)
+{
+    static const int periods_s[] = { 30, 63, 300 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(periods_s); i++) {
+        capture_begin();
+        uint32_t bytes = run(24, periods_s[i], PLANTCARE_BATCH_DEFAULT);
+        plantcare_batch_flush(PC_BATCH_MODE_EXIT);
+        capture_end();
+
+        printf("sample every %3d s: %4u B/h\n", periods_s[i], bytes / 24);
+        CHECK(bytes / 24 <= 2500, "%u B/h at %d s", bytes / 24, periods_s[i]);
+    }
+}
+
+int main(void)
+{
+    test_hourly_at_ceiling();
+    test_cap();
+    test_bytes_per_hour();
+
+    free(cap_buf);
+    printf("%s: %d failures\n", fails ? "FAILED" : "ok", fails);
+    return fails ? 1 : 0;
+}
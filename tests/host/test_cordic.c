@@ -0,0 +1,121 @@
+// tests/host/test_cordic.c
+//
+// CORDIC atan2 and magnitude against libm, over the whole circle at
+// input magnitudes from 1 to INT32_MAX, plus the axes and the extremes.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "plantcare_cordic.h"
+
+/* 0.5 cdeg of rounding to whole centidegrees, plus what is left after 16
+ * iterations: atan(2^-15) = 0.175 cdeg
+ */
+#define ANGLE_MAX_ERR_CDEG  0.7
+/* Half a unit of rounding, plus the Q15 inverse gain */
+#define MAG_MAX_ERR(m)      (0.6 + 4e-5 * (m))
+
+static int fails;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+            fails++;                                        \
+        }                                                   \
+    } while (0)
+
+static int32_t to_i32(double v)
+{
+    return (int32_t)lround(fmax(fmin(v, INT32_MAX), INT32_MIN));
+}
+
+static void test_sweep(void)
+{
+    static const double radius[] = {
+        3, 10, 100, 1000, 4096, 32767, 1e5, 1e7, INT32_MAX,
+    };
+    double worst = 0;
+
+    for (size_t ri = 0; ri < sizeof(radius) / sizeof(radius[0]); ri++) {
+        double r = radius[ri];
+
+        /* Every 0.007°, so no angle is favoured */
+        for (int mdeg = -180000; mdeg <= 180000; mdeg += 7) {
+            double th = mdeg / 1000.0 * M_PI / 180;
+            int32_t x = to_i32(r * cos(th));
+            int32_t y = to_i32(r * sin(th));
+            int32_t mag;
+
+            if (x == 0 && y == 0) {
+                continue;
+            }
+
+            int32_t cdeg = plantcare_cordic_vector(y, x, &mag);
+            double want = atan2(y, x) * 18000 / M_PI;
+            double err = fabs(cdeg - want);
+            double want_mag = hypot(x, y);
+
+            if (err > 18000) {
+                err = 36000 - err;      /* ±180° are the same angle */
+            }
+            worst = fmax(worst, err);
+
+            CHECK(cdeg > -18000 && cdeg <= 18000, "(%d, %d): %d out of range",
+                  x, y, cdeg);
+            CHECK(err <= ANGLE_MAX_ERR_CDEG, "(%d, %d): %d cdeg, atan2 %.3f",
+                  x, y, cdeg, want);
+            CHECK(fabs(mag - want_mag) <= MAG_MAX_ERR(want_mag),
+                  "(%d, %d): magnitude %d, hypot %.1f", x, y, mag, want_mag);
+            CHECK(plantcare_cordic_atan2(y, x) == cdeg, "atan2 != vector");
+            if (fails > 20) {
+                return;
+            }
+        }
+    }
+    printf("worst angle error %.3f cdeg\n", worst);
+}
+
+static void test_edges(void)
+{
+    static const struct {
+        int32_t y, x;
+        int32_t cdeg;
+        double mag;
+    } known[] = {
+        { 0, 0, 0, 0 },
+        { 0, 1, 0, 1 },
+        { 1, 0, 9000, 1 },
+        { 0, -1, 18000, 1 },        /* +180°, not -180° */
+        { -1, 0, -9000, 1 },
+        { 1, 1, 4500, 1 },
+        { -7, -7, -13500, 10 },
+        { 0, INT32_MIN, 18000, 2147483648.0 },
+        { INT32_MIN, 0, -9000, 2147483648.0 },
+        { INT32_MIN, INT32_MIN, -13500, INT32_MAX },    /* saturated */
+        { INT32_MAX, INT32_MAX, 4500, INT32_MAX },
+        { 4096, 0, 9000, 4096 },
+    };
+
+    for (size_t i = 0; i < sizeof(known) / sizeof(known[0]); i++) {
+        int32_t mag;
+        int32_t cdeg = plantcare_cordic_vector(known[i].y, known[i].x, &mag);
+
+        CHECK(cdeg == known[i].cdeg &&
+              fabs(mag - fmin(known[i].mag, INT32_MAX)) <= MAG_MAX_ERR(known[i].mag),
+              "(%d, %d): %d cdeg mag %d, want %d mag %.0f", known[i].x,
+              known[i].y, cdeg, mag, known[i].cdeg, known[i].mag);
+    }
+}
+
+int main(void)
+{
+    test_sweep();
+    test_edges();
+
+    printf("%s: %d failures\n", fails ? "FAIL" : "ok", fails);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+// tests/host/test_drying.c
+//
+// The drying-rate fit on synthetic soil probes: straight dry-downs at
+// several rates and sampling periods with ADC noise, watering, gaps, a
+// pot that is not drying and a dead probe. The rate must come within
+// 0.02 %/h of the true slope, and the ETA within 2 % of the true time
+// to the lower limit.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "plantcare_drying.h"
+#include "plantcare_alarm.h"
+#include "plantcare_state.h"
+
+/* SOIL alarm min: 30.0 % */
+#define LIMIT_X10       300
+
+static int fails;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+            fails++;                                        \
+        }                                                   \
+    } while (0)
+
+int32_t plantcare_alarm_low_limit(enum plantcare_channel ch)
+{
+    (void)ch;
+    return LIMIT_X10;
+}
+
+static unsigned int rng = 5;
+
+/* Uniform noise in [-a, a] ADC counts */
+static int noise(int a)
+{
+    rng = rng * 1103515245u + 12345u;
+    return a ? (int)((rng >> 16) % (2 * a + 1)) - a : 0;
+}
+
+/* Raw reading for a moisture in %, with the default 0..4095 range */
+static int16_t raw_for(double pct, int noise_lsb)
+{
+    return (int16_t)CLAMP(lround(pct * 40.95) + noise(noise_lsb), 0, 4095);
+}
+
+static struct plantcare_data d;
+static int64_t now_ms;
+
+/* One scan of every plant, all at the same moisture */
+static void scan(double pct, int noise_lsb)
+{
+    for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+        d.plants[p].soil_raw = raw_for(pct, noise_lsb);
+    }
+    plantcare_drying_update(&d, now_ms);
+}
+
+/* Dry from start_pct at rate %/h for hours, one scan per period_s.
+ * Returns the moisture reached.
+ */
+static double dry(double start_pct, double rate, double hours,
+                  int period_s, int noise_lsb)
+{
+    int n = (int)(hours * 3600 / period_s);
+    double pct = start_pct;
+
+    for (int i = 0; i < n; i++) {
+        now_ms += period_s * 1000LL;
+        pct = start_pct + rate * (i + 1) * period_s / 3600.0;
+        scan(pct, noise_lsb);
+    }
+    return pct;
+}
+
+static void reset(void)
+{
+    memset(&d, 0, sizeof(d));
+    plantcare_drying_reset();
+    now_ms = 1000000;
+    rng = 5;
+}
+
+static void test_rate_and_eta(void)
+{
+    static const struct {
+        double rate;        /* %/h */
+        int period_s;
+        int noise_lsb;      /* ±, 1 LSB = 0.024 % */
+    } cases[] = {
+        { -0.5, 30,  0 },
+        { -0.5, 30,  4 },
+        { -1.0, 2,   4 },
+        { -1.0, 600, 2 },
+        { -2.0, 30,  8 },
+        { -3.5, 120, 4 },
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+        double rate = cases[i].rate;
+
+        reset();
+        /* Six hours: two time constants of history behind the estimate */
+        double pct = dry(80.0, rate, 6, cases[i].period_s, cases[i].noise_lsb);
+        double eta_min = (pct - LIMIT_X10 / 10.0) / -rate * 60;
+
+        for (int p = 0; p < PLANTCARE_PLANT_COUNT; p++) {
+            const struct plantcare_drying *r = &d.drying[p];
+
+            CHECK(r->valid, "%.1f %%/h every %d s: no fit", rate,
+                  cases[i].period_s);
+            CHECK(fabs(r->rate_x100 / 100.0 - rate) <= 0.02,
+                  "%.1f %%/h every %d s, noise %d: rate %.2f", rate,
+                  cases[i].period_s, cases[i].noise_lsb, r->rate_x100 / 100.0);
+            CHECK(fabs(r->eta_min - eta_min) <= 0.02 * eta_min,
+                  "%.1f %%/h every %d s: eta %u min, want %.0f", rate,
+                  cases[i].period_s, r->eta_min, eta_min);
+        }
+    }
+}
+
+/* No estimate until the samples span enough time */
+static void test_warmup(void)
+{
+    reset();
+    dry(60.0, -1.0, 0.25, 30, 0);
+    CHECK(!d.drying[0].valid && d.drying[0].eta_min == PLANTCARE_DRYING_ETA_MAX_MIN,
+          "fit after 15 min");
+    dry(59.75, -1.0, 0.75, 30, 0);
+    CHECK(d.drying[0].valid, "no fit after an hour");
+}
+
+/* Watering restarts the fit at the new level; so does a long gap */
+static void test_watering_and_gap(void)
+{
+    struct plantcare_drying_stats st;
+
+    reset();
+    double pct = dry(50.0, -1.0, 4, 30, 2);
+
+    now_ms += 30000;
+    scan(pct + 25.0, 2);
+    plantcare_drying_get_stats(0, &st);
+    CHECK(st.restarts == 1 && !d.drying[0].valid, "watering: restarts %u",
+          st.restarts);
+
+    dry(pct + 25.0, -0.8, 5, 30, 2);
+    CHECK(fabs(d.drying[0].rate_x100 / 100.0 + 0.8) <= 0.02,
+          "after watering: rate %.2f", d.drying[0].rate_x100 / 100.0);
+
+    now_ms += 2 * 3600 * 1000LL;
+    scan(pct, 2);
+    plantcare_drying_get_stats(0, &st);
+    CHECK(st.restarts == 2 && !d.drying[0].valid && st.samples == 1,
+          "gap: restarts %u samples %u", st.restarts, st.samples);
+}
+
+/* A pot that holds its moisture never reaches the limit */
+static void test_not_drying(void)
+{
+    reset();
+    dry(45.0, 0.0, 6, 30, 4);
+    CHECK(d.drying[0].valid && abs(d.drying[0].rate_x100) <= 2 &&
+          d.drying[0].eta_min == PLANTCARE_DRYING_ETA_MAX_MIN,
+          "flat: rate %d eta %u", d.drying[0].rate_x100, d.drying[0].eta_min);
+    CHECK(plantcare_drying_on_track(0, 5), "flat pot off the line");
+}
+
+/* Already below the limit and still drying: water now */
+static void test_below_limit(void)
+{
+    reset();
+    dry(33.0, -1.0, 5, 30, 0);
+    CHECK(d.drying[0].valid && d.drying[0].eta_min == 0,
+          "below the limit: eta %u", d.drying[0].eta_min);
+}
+
+/* A probe flagged out of range is skipped; the others carry on */
+static void test_dead_probe(void)
+{
+    struct plantcare_drying_stats st0, st1;
+
+    reset();
+    dry(60.0, -1.0, 3, 30, 0);
+    plantcare_drying_get_stats(0, &st0);
+
+    d.anomaly[PC_AN_CH_SOIL] = PC_AN_RANGE;
+    dry(57.0, -1.0, 1, 30, 0);
+    plantcare_drying_get_stats(0, &st1);
+    CHECK(st1.samples == st0.samples, "dead probe fed: %u -> %u",
+          st0.samples, st1.samples);
+    plantcare_drying_get_stats(1, &st1);
+    CHECK(st1.samples == st0.samples + 120, "live probe: %u samples",
+          st1.samples);
+}
+
+int main(void)
+{
+    test_rate_and_eta();
+    test_warmup();
+    test_watering_and_gap();
+    test_not_drying();
+    test_below_limit();
+    test_dead_probe();
+
+    printf("%s: %d failures\n", fails ? "FAIL" : "ok", fails);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,244 @@
+// tests/host/test_health.c
+//
+// Sensor health and recovery on an emulated I2C bus: a TCA9548A at 0x70
+// and one sensor at 0x40 behind channel 1. The bus can NAK, hold SDA low
+// until recovered, or lose the sensor. cycle() drives one group the way
+// sensor_thread.c does (sensor_begin / read / sensor_end).
+
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/i2c.h>
+
+#include "plantcare_health.h"
+#include "sensors/i2c_bus.h"
+#include "sensors/i2c_mux.h"
+
+#define MUX_ADDR        0x70
+#define SENSOR_ADDR     0x40
+#define SENSOR_CHANNEL  1
+#define RECOVER_AFTER   2       /* I2C_RECOVER_AFTER_FAILS */
+
+const struct device host_i2c_dev = { "i2c" };
+
+/* ---- Emulated bus ---- */
+static uint8_t mux_ctrl;            /* the mux's control register */
+static int mux_naks;                /* NAK the next n mux writes */
+static bool sda_stuck;              /* every transfer fails until recovery */
+static bool sensor_present = true;
+static int mux_writes, recoveries;
+
+int i2c_write_dt(const struct i2c_dt_spec *spec, const uint8_t *buf,
+                 uint32_t num_bytes)
+{
+    if (sda_stuck || num_bytes == 0) {
+        return -EIO;
+    }
+    if (spec->addr == MUX_ADDR) {
+        if (mux_naks > 0) {
+            mux_naks--;
+            return -EIO;
+        }
+        mux_writes++;
+        mux_ctrl = buf[0];
+        return 0;
+    }
+    if (spec->addr == SENSOR_ADDR && sensor_present &&
+        (mux_ctrl & BIT(SENSOR_CHANNEL))) {
+        return 0;
+    }
+    return -EIO;
+}
+
+/* Nine clocks and a STOP free SDA; the mux resets with the slaves */
+int i2c_recover_bus(const struct device *dev)
+{
+    (void)dev;
+    recoveries++;
+    sda_stuck = false;
+    mux_ctrl = 0;
+    return 0;
+}
+
+/* ---- One sensor group, read as sensor_thread.c reads it ---- */
+#define S   PC_SENSOR_CLIMATE
+
+static const struct i2c_mux_dev sensor = {
+    .spec = { .bus = &host_i2c_dev, .addr = SENSOR_ADDR },
+    .mux_channel = SENSOR_CHANNEL,
+};
+static int attempts, inits;
+
+static int sensor_read(void)
+{
+    static const uint8_t reg = 0xE5;
+    int ret = i2c_mux_select(&sensor);
+
+    return ret ? ret : i2c_write_dt(&sensor.spec, &reg, 1);
+}
+
+/* Returns true if the group was attempted */
+static bool cycle(void)
+{
+    int64_t now = k_uptime_get();
+    struct plantcare_sensor_health h;
+    int ret = 0;
+
+    if (!plantcare_health_should_try(S, now)) {
+        return false;
+    }
+    attempts++;
+    if (plantcare_health_needs_init(S)) {
+        inits++;
+        ret = sensor_read();
+    }
+    if (ret == 0) {
+        ret = sensor_read();
+    }
+    plantcare_health_report(S, ret, now);
+    plantcare_health_get(S, &h);
+    if (ret < 0 && h.fails == RECOVER_AFTER) {
+        (void)i2c_sensors_recover_bus();
+    }
+    return true;
+}
+
+static int fails;
+
+#define CHECK(cond, ...)                            \
+    do {                                            \
+        if (!(cond)) {                              \
+            printf("FAIL %s:%d: ", __func__, __LINE__); \
+            printf(__VA_ARGS__);                    \
+            printf("\n");                           \
+            fails++;                                \
+        }                                           \
+    } while (0)
+
+/* 1 s doubling to 5 min, and no overflow once fails saturates */
+static void test_backoff_ladder(void)
+{
+    struct plantcare_sensor_health h;
+    int64_t now = 1000;
+
+    for (int n = 1; n <= 300; n++) {
+        int64_t want = (n <= 9) ? 1000LL << (n - 1) : 300000;
+
+        plantcare_health_report(PC_SENSOR_ACCEL, -EIO, now);
+        plantcare_health_get(PC_SENSOR_ACCEL, &h);
+        CHECK(h.retry_at_ms - now == want, "fail %d: backoff %lld, want %lld",
+              n, (long long)(h.retry_at_ms - now), (long long)want);
+        CHECK(!plantcare_health_should_try(PC_SENSOR_ACCEL, now + want - 1),
+              "fail %d: tried early", n);
+        CHECK(plantcare_health_should_try(PC_SENSOR_ACCEL, now + want),
+              "fail %d: not tried when due", n);
+        CHECK(h.needs_init && !h.valid && h.last_err == -EIO,
+              "fail %d: state", n);
+        now += want;
+    }
+    plantcare_health_get(PC_SENSOR_ACCEL, &h);
+    CHECK(h.fails == UINT8_MAX, "fails %u, want saturated", h.fails);
+    CHECK(!(plantcare_health_valid_mask() & BIT(PC_SENSOR_ACCEL)),
+          "failed group in valid_mask");
+
+    plantcare_health_report(PC_SENSOR_ACCEL, 0, now);
+    plantcare_health_get(PC_SENSOR_ACCEL, &h);
+    CHECK(h.valid && !h.needs_init && h.fails == 0 && h.last_err == 0,
+          "not cleared by a good read");
+    CHECK(plantcare_health_should_try(PC_SENSOR_ACCEL, now),
+          "backoff left after a good read");
+    CHECK(plantcare_health_valid_mask() & BIT(PC_SENSOR_ACCEL),
+          "good group missing from valid_mask");
+}
+
+/* Only a write changes the channel; any doubt about it forces one */
+static void test_mux_cache(void)
+{
+    struct i2c_mux_dev off = { .spec = sensor.spec, .mux_channel = I2C_MUX_OFF };
+    struct i2c_mux_dev any = { .spec = sensor.spec, .mux_channel = I2C_MUX_ANY };
+
+    mux_writes = 0;
+    CHECK(i2c_mux_select(&sensor) == 0 && mux_writes == 1 &&
+          mux_ctrl == BIT(SENSOR_CHANNEL), "first select");
+    CHECK(i2c_mux_select(&sensor) == 0 && mux_writes == 1, "not cached");
+    CHECK(i2c_mux_select(&any) == 0 && mux_writes == 1, "ANY wrote");
+    CHECK(i2c_mux_select(&off) == 0 && mux_writes == 2 && mux_ctrl == 0,
+          "OFF did not close all channels");
+
+    /* A NAKed select leaves the channel unknown */
+    mux_naks = 1;
+    CHECK(i2c_mux_select(&sensor) == -EIO, "NAK not returned");
+    CHECK(i2c_mux_current() == I2C_MUX_ANY, "channel kept after a NAK");
+    CHECK(i2c_mux_select(&sensor) == 0 && mux_writes == 3, "no rewrite");
+
+    /* So does a bus recovery, which may have reset the mux */
+    CHECK(i2c_sensors_recover_bus() == 0, "recovery failed");
+    CHECK(i2c_mux_current() == I2C_MUX_ANY, "cache survived recovery");
+    CHECK(i2c_mux_select(&sensor) == 0 && mux_writes == 4 &&
+          mux_ctrl == BIT(SENSOR_CHANNEL), "channel not reopened");
+}
+
+/* Unplugged for a while, then back: backed-off attempts, one recovery,
+ * and the first attempt after it returns re-inits and reads
+ */
+static void test_device_gone_and_back(void)
+{
+    struct plantcare_sensor_health h;
+    int64_t last = -1, gap_max = 0;
+
+    host_uptime_ms = 1000000;
+    recoveries = inits = attempts = 0;
+    cycle();
+    CHECK(plantcare_health_valid_mask() & BIT(S), "not valid at start");
+
+    sensor_present = false;
+    for (int s = 0; s < 2 * 3600; s++) {
+        k_msleep(1000);
+        if (cycle()) {
+            if (last >= 0) {
+                gap_max = MAX(gap_max, host_uptime_ms - last);
+            }
+            last = host_uptime_ms;
+        }
+    }
+    /* At 1, 2, 4, ... 512 s, then every 300 s: 10 + (7200 - 512) / 300 */
+    CHECK(attempts == 1 + 10 + 22, "%d attempts while gone", attempts - 1);
+    CHECK(gap_max == 300000, "longest gap %lld ms", (long long)gap_max);
+    CHECK(recoveries == 1, "%d recoveries", recoveries);
+
+    sensor_present = true;
+    inits = 0;
+    for (int s = 0; s < 300 && !(plantcare_health_valid_mask() & BIT(S)); s++) {
+        k_msleep(1000);
+        cycle();
+    }
+    plantcare_health_get(S, &h);
+    CHECK(h.valid && !h.needs_init, "did not come back");
+    CHECK(inits == 1, "%d re-inits", inits);
+}
+
+/* SDA held low: two failures, a recovery, and the next attempt must
+ * reopen the channel the recovery closed
+ */
+static void test_stuck_sda(void)
+{
+    int first = recoveries;
+
+    sda_stuck = true;
+    for (int s = 0; s < 10; s++) {
+        k_msleep(1000);
+        cycle();
+    }
+    CHECK(recoveries == first + 1, "%d recoveries", recoveries - first);
+    CHECK(plantcare_health_valid_mask() & BIT(S), "not back after recovery");
+}
+
+int main(void)
+{
+    test_backoff_ladder();
+    test_mux_cache();
+    test_device_gone_and_back();
+    test_stuck_sda();
+
+    printf("%s: %d failures\n", fails ? "FAIL" : "ok", fails);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""scripts/pc_export.py against the firmware's export code on a pty.
+
+pc_export_dev (pc_export_dev.c) is plantcare_log.c and plantcare_export.c
+built for the host, with the console UART on a pty: the frames, CRCs and
+clipping the script sees are the device's own. The device can corrupt a
+data frame, to check that the script resumes from the last good record
+and never writes a record twice, and printk during an export, to check
+that the text is held until after the end frame.
+
+    test_pc_export.py <path to pc_export_dev>
+"""
+
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SCRIPT = os.path.join(HERE, "..", "..", "scripts", "pc_export.py")
+DEVICE = None
+
+
+class Device:
+    """pc_export_dev, steered on its stdin."""
+
+    def __init__(self):
+        self.proc = subprocess.Popen(
+            [DEVICE], stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+            text=True, bufsize=1)
+        line = self.proc.stdout.readline().split()
+        assert line[0] == "pty", line
+        self.pty = line[1]
+        self.rows = []      # CSV row of every record logged, by seq
+
+    def command(self, cmd):
+        """Send one command, return the lines before its "ok"."""
+        self.proc.stdin.write(cmd + "\n")
+        self.proc.stdin.flush()
+        out = []
+        for line in self.proc.stdout:
+            line = line.rstrip("\n")
+            if line == "ok":
+                return out
+            out.append(line)
+        raise RuntimeError("device exited on %r" % cmd)
+
+    def add(self, n, dense=False):
+        self.rows += self.command("add %d%s" % (n, " dense" if dense else ""))
+
+    def close(self):
+        self.proc.stdin.close()
+        self.proc.wait(timeout=5)
+        self.proc.stdout.close()
+
+
+class PcExportTest(unittest.TestCase):
+    def setUp(self):
+        self.dev = Device()
+        self.tmp = tempfile.TemporaryDirectory()
+        self.csv = os.path.join(self.tmp.name, "log.csv")
+        self.state = os.path.join(self.tmp.name, "seq")
+
+    def tearDown(self):
+        self.dev.close()
+        self.tmp.cleanup()
+
+    def run_export(self, *extra):
+        return subprocess.run(
+            [sys.executable, SCRIPT, self.dev.pty,
+             "--state", self.state, "-o", self.csv, "--timeout", "0.3"]
+            + list(extra),
+            capture_output=True, text=True, timeout=30)
+
+    def rows(self):
+        with open(self.csv) as f:
+            return f.read().splitlines()
+
+    def saved_seq(self):
+        with open(self.state) as f:
+            return int(f.read())
+
+    def test_full_download(self):
+        self.dev.add(20)
+        r = self.run_export("--from", "0")
+        self.assertEqual(r.returncode, 0, r.stderr)
+        rows = self.rows()
+        self.assertTrue(rows[0].startswith("seq,epoch_s,"))
+        self.assertEqual(rows[1:], self.dev.rows)
+        self.assertEqual(self.saved_seq(), 20)
+
+    def test_dense_records(self):
+        # No zero byte for hundreds of bytes: COBS blocks of 254
+        self.dev.add(4)
+        self.dev.add(24, dense=True)
+        r = self.run_export("--from", "0")
+        self.assertEqual(r.returncode, 0, r.stderr)
+        self.assertEqual(self.rows()[1:], self.dev.rows)
+
+    def test_count(self):
+        self.dev.add(12)
+        r = self.run_export("--from", "5", "--count", "4")
+        self.assertEqual(r.returncode, 0, r.stderr)
+        self.assertEqual(self.rows()[1:], self.dev.rows[5:9])
+        self.assertEqual(self.saved_seq(), 9)
+
+    def test_clipped_to_held(self):
+        # The ring holds 256: seq 0..43 are gone
+        self.dev.add(300)
+        r = self.run_export("--from", "0")
+        self.assertEqual(r.returncode, 0, r.stderr)
+        self.assertEqual(self.rows()[1:], self.dev.rows[44:])
+
+        # Past the newest is not reported as overwritten
+        r = self.run_export("--from", "290", "--count", "50")
+        self.assertEqual(r.returncode, 0, r.stderr)
+        self.assertNotIn("overwritten", r.stderr)
+        self.assertEqual(self.rows()[1:],
+                         self.dev.rows[44:] + self.dev.rows[290:])
+        self.assertEqual(self.saved_seq(), 300)
+
+    def test_bad_frame_resume(self):
+        self.dev.add(30)
+        self.dev.command("corrupt 1")
+        self.dev.command("noise SOIL 0: 41.5 %")
+        r = self.run_export("--from", "0")
+        self.assertEqual(r.returncode, 0, r.stderr)
+        self.assertIn("frame lost, resuming at 8", r.stderr)
+        self.assertEqual(self.rows()[1:], self.dev.rows)
+        self.assertEqual(self.saved_seq(), 30)
+
+    def test_held_printk(self):
+        self.dev.add(20)
+        self.dev.command("noise SOIL 0: 41.5 %")
+        r = self.run_export("--from", "0")
+        self.assertEqual(r.returncode, 0, r.stderr)
+        self.assertEqual(self.rows()[1:], self.dev.rows)
+
+        # The text comes after the end frame, where the script does not
+        # look: read the pty by hand to see it
+        self.dev.command("noise SOIL 1: 12.0 %")
+        fd = os.open(self.dev.pty, os.O_RDWR | os.O_NOCTTY)
+        try:
+            os.write(fd, b"pc export 0 16\r\n")
+            wire = b""
+            while b"export: 16 records" not in wire:
+                wire += os.read(fd, 4096)
+        finally:
+            os.close(fd)
+        end = wire.rindex(b"\x00")
+        self.assertIn(b"SOIL 1: 12.0 %", wire[end:])
+        self.assertIn(b"console held 16 B, dropped 0 B", wire[end:])
+
+    def test_resume_from_state(self):
+        self.dev.add(10)
+        self.assertEqual(self.run_export("--from", "0").returncode, 0)
+        self.dev.add(15)
+        r = self.run_export()
+        self.assertEqual(r.returncode, 0, r.stderr)
+        self.assertEqual(self.rows()[1:], self.dev.rows)
+        self.assertEqual(self.saved_seq(), 25)
+
+    def test_device_reset(self):
+        with open(self.state, "w") as f:
+            f.write("40\n")
+        self.dev.add(5)
+        r = self.run_export()
+        self.assertEqual(r.returncode, 0, r.stderr)
+        self.assertIn("device log restarted", r.stderr)
+        self.assertEqual(self.rows()[1:], self.dev.rows)
+        self.assertEqual(self.saved_seq(), 5)
+
+
+if __name__ == "__main__":
+    DEVICE = os.path.abspath(sys.argv.pop(1))
+    unittest.main()
@@ -0,0 +1,137 @@
+// tests/host/test_psychro.c
+//
+// The integer psychrometrics against the Magnus formula in double, over
+// the table's range, with the error bounds plantcare_psychro.h states.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "plantcare_psychro.h"
+
+static int fails;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+            fails++;                                        \
+        }                                                   \
+    } while (0)
+
+/* Magnus, Alduchov & Eskridge 1996 */
+static double es_pa(double t)
+{
+    return 610.94 * exp(17.625 * t / (t + 243.04));
+}
+
+static double dew_c(double ea)
+{
+    double l = log(ea / 610.94);
+
+    return 243.04 * l / (17.625 - l);
+}
+
+static void test_sweep(void)
+{
+    double es_lo = 0, es_hi = 0, vpd_lo = 0, vpd_hi = 0;
+    double dew_warm = 0, dew_cold = 0;
+
+    for (int t = -4000; t <= 8000; t += 7) {
+        for (int rh = 50; rh <= 10000; rh += 37) {
+            struct plantcare_psychro p;
+            double tc = t / 100.0;
+            double es = es_pa(tc);
+            double ea = es * rh / 10000.0;
+            /* Below the table the dew point is clamped to its end */
+            double td = fmax(dew_c(ea), -40.0);
+
+            plantcare_psychro_compute(t, rh, &p);
+
+            double e_es = fabs(p.es_pa - es);
+            double e_vpd = fabs(p.vpd_pa - (es - ea));
+
+            if (t <= 4000) {
+                es_lo = fmax(es_lo, e_es);
+                vpd_lo = fmax(vpd_lo, e_vpd);
+            } else {
+                es_hi = fmax(es_hi, e_es);
+                vpd_hi = fmax(vpd_hi, e_vpd);
+            }
+
+            CHECK(p.dew_x100 <= t, "%d %d: dew %d above T", t, rh, p.dew_x100);
+
+            double e_dew = fabs(p.dew_x100 / 100.0 - td);
+
+            if (td >= 0) {
+                dew_warm = fmax(dew_warm, e_dew);
+            } else {
+                dew_cold = fmax(dew_cold, e_dew);
+            }
+        }
+    }
+
+    printf("es %.2f / %.2f Pa, vpd %.2f / %.2f Pa (to 40 C / to 80 C), "
+           "dew %.4f / %.4f C (above / below 0 C)\n",
+           es_lo, es_hi, vpd_lo, vpd_hi, dew_warm, dew_cold);
+
+    CHECK(es_lo <= 3 && vpd_lo <= 3, "to 40 C: es %.2f vpd %.2f Pa, want <= 3",
+          es_lo, vpd_lo);
+    CHECK(es_hi <= 9 && vpd_hi <= 9, "to 80 C: es %.2f vpd %.2f Pa, want <= 9",
+          es_hi, vpd_hi);
+    CHECK(dew_warm <= 0.014, "dew above 0 C off by %.4f, want <= 0.014",
+          dew_warm);
+    CHECK(dew_cold <= 0.06, "dew below 0 C off by %.4f, want <= 0.06",
+          dew_cold);
+}
+
+/* Saturated air: no deficit and the dew point is the temperature */
+static void test_saturated(void)
+{
+    for (int t = -3000; t <= 7000; t += 1000) {
+        struct plantcare_psychro p;
+
+        plantcare_psychro_compute(t, 10000, &p);
+        CHECK(p.vpd_pa == 0 && abs(p.dew_x100 - t) <= 1,
+              "%d: vpd %d dew %d", t, p.vpd_pa, p.dew_x100);
+    }
+}
+
+/* RH outside 0..100 % and T outside the table are clamped */
+static void test_clamping(void)
+{
+    struct plantcare_psychro a, b;
+
+    plantcare_psychro_compute(2500, 10450, &a);
+    plantcare_psychro_compute(2500, 10000, &b);
+    CHECK(a.vpd_pa == b.vpd_pa && a.dew_x100 == b.dew_x100, "RH > 100 %%");
+
+    plantcare_psychro_compute(2500, -30, &a);
+    CHECK(a.vpd_pa == a.es_pa && a.dew_x100 == PLANTCARE_PSYCHRO_T_MIN_X100,
+          "RH < 0: vpd %d es %d dew %d", a.vpd_pa, a.es_pa, a.dew_x100);
+
+    plantcare_psychro_compute(9500, 5000, &a);
+    plantcare_psychro_compute(8000, 5000, &b);
+    CHECK(a.es_pa == b.es_pa && a.vpd_pa == b.vpd_pa, "T above 80 C");
+
+    plantcare_psychro_compute(-5000, 5000, &a);
+    plantcare_psychro_compute(-4000, 5000, &b);
+    CHECK(a.es_pa == b.es_pa && a.dew_x100 <= -5000, "T below -40 C");
+}
+
+int main(void)
+{
+    uint32_t calls, cycles;
+
+    test_sweep();
+    test_saturated();
+    test_clamping();
+
+    plantcare_psychro_get_cost(&calls, &cycles);
+    CHECK(calls > 0, "calls not counted");
+
+    printf("%s: %d failures\n", fails ? "FAIL" : "ok", fails);
+    return fails ? 1 : 0;
+}
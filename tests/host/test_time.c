@@ -0,0 +1,212 @@
+// tests/host/test_time.c
+//
+// GPS discipline of the uptime clock under synthetic skew: a fix once a
+// minute, its line stamped by the RX interrupt 0..20 ms after the second
+// (the receiver's output delay), on an uptime clock that runs fast or
+// slow. After four hours of fixes the drift estimate must be close to the
+// skew, and the clock must hold time through a day without GPS. Also the
+// civil date and DST tables, at known dates.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "plantcare_time.c"
+
+#define BASE_EPOCH      1718000000u     /* 2024-06-10 06:13:20 UTC */
+
+static int fails;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+            fails++;                                        \
+        }                                                   \
+    } while (0)
+
+static unsigned int rng = 1;
+
+static int latency_ms(void)
+{
+    rng = rng * 1103515245u + 12345u;
+    return (int)((rng >> 16) % 21);
+}
+
+/* Uptime after real_ms of real time, on a clock off by skew_ppm */
+static int64_t uptime_at(int64_t real_ms, int32_t skew_ppm)
+{
+    return real_ms + real_ms * skew_ppm / 1000000;
+}
+
+/* Our UTC in ms at real_ms, from plantcare_time_at()'s model */
+static int64_t clock_ms(int64_t real_ms, int32_t skew_ppm)
+{
+    return utc_ms_at(&clk, uptime_at(real_ms, skew_ppm));
+}
+
+static void run_skew(int32_t skew_ppm)
+{
+    struct plantcare_time_stats st;
+    int64_t real_ms = 0;
+
+    memset(&clk, 0, sizeof(clk));
+    rng = 1;
+
+    /* Four hours of fixes, one a minute */
+    for (int i = 0; i <= 4 * 60; i++, real_ms += 60000) {
+        plantcare_time_gps_fix(BASE_EPOCH + (uint32_t)(real_ms / 1000), 0,
+                               uptime_at(real_ms + latency_ms(), skew_ppm));
+    }
+    real_ms -= 60000;
+    plantcare_time_get_stats(&st);
+
+    /* Uptime fast by f ppm: UTC gains f ppm less than it. 20 ms of jitter
+     * over a 10 min span is 33 ppm per estimate; the 1/4 gain averages it
+     * down to a few ppm, under a second a day.
+     */
+    int32_t want_ppb = -skew_ppm * 1000;
+    int32_t drift_err = st.drift_ppb - want_ppb;
+
+    CHECK(st.synced && st.from_gps && st.steps == 1,
+          "skew %d: synced %d gps %d steps %u", skew_ppm, st.synced,
+          st.from_gps, st.steps);
+    CHECK(abs(drift_err) <= 8000, "skew %d ppm: drift %d ppb, want %d +- 8000",
+          skew_ppm, st.drift_ppb, want_ppb);
+
+    /* GPS off for a day */
+    real_ms += 24 * 3600 * 1000LL;
+    int64_t err_ms = clock_ms(real_ms, skew_ppm) -
+                     ((int64_t)BASE_EPOCH * 1000 + real_ms);
+
+    CHECK(err_ms >= -750 && err_ms <= 750,
+          "skew %d ppm: %lld ms off after a day without GPS", skew_ppm,
+          (long long)err_ms);
+    CHECK(plantcare_time_at(uptime_at(real_ms, skew_ppm)) ==
+          (uint32_t)((BASE_EPOCH * 1000LL + real_ms + err_ms) / 1000),
+          "plantcare_time_at disagrees with the model");
+}
+
+static void test_skew(void)
+{
+    static const int32_t skews[] = { 0, 20, -20, 100, -150, 400 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(skews); i++) {
+        run_skew(skews[i]);
+    }
+}
+
+/* More than TIME_STEP_MS off: step, keep the drift; clamp at 500 ppm */
+static void test_step_and_clamp(void)
+{
+    struct plantcare_time_stats st;
+    int64_t up = 0;
+
+    memset(&clk, 0, sizeof(clk));
+    plantcare_time_gps_fix(BASE_EPOCH, 0, up);
+    up += TIME_DISCIPLINE_MS;
+    plantcare_time_gps_fix(BASE_EPOCH + TIME_DISCIPLINE_MS / 1000, 300, up);
+    plantcare_time_get_stats(&st);
+    CHECK(st.drift_ppb == 500000, "drift %d, want 500 ppm (300 ms / 10 min)",
+          st.drift_ppb);
+
+    up += 60000;
+    plantcare_time_gps_fix(BASE_EPOCH + 3600, 0, up);
+    plantcare_time_get_stats(&st);
+    CHECK(st.steps == 2 && st.drift_ppb == 500000, "steps %u drift %d",
+          st.steps, st.drift_ppb);
+    CHECK(plantcare_time_at(up) == BASE_EPOCH + 3600, "not stepped");
+
+    up += 20 * TIME_DISCIPLINE_MS;
+    plantcare_time_gps_fix(BASE_EPOCH + 3600 + 20 * TIME_DISCIPLINE_MS / 1000,
+                           0, up);
+    plantcare_time_get_stats(&st);
+    CHECK(st.steps == 3 && st.last_error_ms == -6000, "steps %u err %d",
+          st.steps, st.last_error_ms);
+
+    memset(&clk, 0, sizeof(clk));
+    CHECK(plantcare_time_at(12345) == 0, "time before any fix");
+}
+
+static void test_civil(void)
+{
+    static const struct {
+        uint32_t epoch;
+        struct plantcare_civil c;
+    } known[] = {
+        { 0,          { 1970, 1, 1, 0, 0, 0 } },
+        { 951782400,  { 2000, 2, 29, 0, 0, 0 } },
+        { 1709251199, { 2024, 2, 29, 23, 59, 59 } },
+        { 4102444800, { 2100, 1, 1, 0, 0, 0 } },
+    };
+    struct plantcare_civil c;
+
+    for (size_t i = 0; i < ARRAY_SIZE(known); i++) {
+        plantcare_time_to_civil(known[i].epoch, &c);
+        CHECK(c.year == known[i].c.year && c.month == known[i].c.month &&
+              c.day == known[i].c.day && c.hour == known[i].c.hour &&
+              c.min == known[i].c.min && c.sec == known[i].c.sec,
+              "%u -> %04u-%02u-%02u %02u:%02u:%02u", known[i].epoch,
+              c.year, c.month, c.day, c.hour, c.min, c.sec);
+        CHECK(plantcare_time_from_civil(&known[i].c) == known[i].epoch,
+              "from_civil %u", known[i].epoch);
+    }
+    /* Every day for 200 years round-trips */
+    for (uint32_t e = 0; e < 4102444800u - 86400; e += 86400 + 3601) {
+        plantcare_time_to_civil(e, &c);
+        CHECK(plantcare_time_from_civil(&c) == e, "round trip %u", e);
+    }
+}
+
+/* The second a zone enters and leaves DST */
+static void test_dst(void)
+{
+    static const struct {
+        const char *zone;
+        uint32_t start;     /* first second of DST, UTC */
+        uint32_t end;       /* first second after it */
+        int32_t std_s;
+    } known[] = {
+        /* 2024-03-31 01:00 UTC, 2024-10-27 01:00 UTC */
+        { "CET",  1711846800, 1729990800, 3600 },
+        /* 2024-03-10 02:00 EST, 2024-11-03 02:00 EDT */
+        { "EST",  1710054000, 1730613600, -5 * 3600 },
+        /* 2024-10-06 02:00 AEST, 2024-04-07 03:00 AEDT */
+        { "AEST", 1728144000, 1712419200, 10 * 3600 },
+    };
+    char buf[40];
+    bool dst;
+
+    for (size_t i = 0; i < ARRAY_SIZE(known); i++) {
+        uint32_t on = known[i].start, off = known[i].end;
+        int32_t std = known[i].std_s;
+
+        CHECK(plantcare_time_set_zone(known[i].zone) == 0, "%s", known[i].zone);
+        CHECK(plantcare_time_local_offset_s(on - 1, &dst) == std && !dst,
+              "%s: DST before %u", known[i].zone, on);
+        CHECK(plantcare_time_local_offset_s(on, &dst) == std + 3600 && dst,
+              "%s: no DST at %u", known[i].zone, on);
+        CHECK(plantcare_time_local_offset_s(off - 1, &dst) == std + 3600 && dst,
+              "%s: no DST before %u", known[i].zone, off);
+        CHECK(plantcare_time_local_offset_s(off, &dst) == std && !dst,
+              "%s: DST at %u", known[i].zone, off);
+    }
+
+    plantcare_time_set_zone("CET");
+    plantcare_time_format_local(1718000000, buf, sizeof(buf));
+    CHECK(strcmp(buf, "2024-06-10 08:13:20 CEST") == 0, "format: %s", buf);
+    CHECK(plantcare_time_set_zone("XYZ") == -ENOENT, "unknown zone taken");
+}
+
+int main(void)
+{
+    test_skew();
+    test_step_and_clamp();
+    test_civil();
+    test_dst();
+
+    printf("%s: %d failures\n", fails ? "FAIL" : "ok", fails);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,65 @@
+// tests/host/test_units.c
+//
+// plantcare_units.c replaced 1000 * num / den with a multiply by
+// PCT_X10_SCALE(den) and a 24-bit shift. Check it gives the divide's
+// result for every range the calibration accepts and every raw in it.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "plantcare_units.h"
+
+static int check(int32_t lo, int32_t hi, long *fails)
+{
+    int32_t den = (hi > lo) ? hi - lo : lo - hi;
+    int32_t base = (hi > lo) ? lo : hi;
+
+    if (light_units_set_range(lo, hi) != 0) {
+        printf("FAIL: range %d..%d rejected\n", lo, hi);
+        return -1;
+    }
+    for (int32_t num = 0; num <= den; num++) {
+        int32_t want = (int32_t)((uint64_t)1000 * num / den);
+        int32_t got = light_raw_to_pct_x10(base + num);
+
+        if (hi < lo) {
+            want = 1000 - want;
+        }
+        if (got != want && (*fails)++ < 10) {
+            printf("FAIL: range %d..%d raw %d: %d, divide gives %d\n",
+                   lo, hi, base + num, got, want);
+        }
+    }
+    return 0;
+}
+
+int main(void)
+{
+    long fails = 0;
+
+    /* Every den the ADC allows, from raw 0 */
+    for (int32_t den = 1; den <= 4095; den++) {
+        check(0, den, &fails);
+    }
+    /* Offset and inverted ranges go through the same scale */
+    check(100, 500, &fails);
+    check(4095, 1, &fails);
+    check(3000, 2999, &fails);
+
+    /* Clamped outside the range */
+    light_units_set_range(100, 500);
+    if (light_raw_to_pct_x10(50) != 0 || light_raw_to_pct_x10(9000) != 1000) {
+        printf("FAIL: clamping\n");
+        fails++;
+    }
+
+    /* Ranges the calibration must refuse */
+    if (light_units_set_range(5, 5) == 0 || light_units_set_range(-1, 10) == 0 ||
+        light_units_set_range(0, 4096) == 0) {
+        printf("FAIL: bad range accepted\n");
+        fails++;
+    }
+
+    printf("%s: %ld mismatches\n", fails ? "FAIL" : "ok", fails);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+// tests/host/test_vib.c
+//
+// The q15 FFT against a double DFT, and the vibration analysis end to end
+// on synthetic accelerometer batches: a known sine must land in its bin,
+// and peak_hz_x10, rms_mg, the bands and the tonality must match what
+// the sine is. Batches are 64 samples at 400 Hz (the devicetree
+// defaults), 6.25 Hz per bin.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "plantcare_fft.h"
+#include "plantcare_vib.h"
+#include "sensors/accelerometer_sensor.h"
+
+#define ODR_HZ      400
+
+static int fails;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("FAIL %s:%d: ", __func__, __LINE__);     \
+            printf(__VA_ARGS__);                            \
+            printf("\n");                                   \
+            fails++;                                        \
+        }                                                   \
+    } while (0)
+
+/* ---- Fake accelerometer: a sine per axis on top of gravity ---- */
+static struct {
+    double dc_g;
+    double amp_g;
+    double hz;
+} axis_sig[3];
+
+uint16_t accelerometer_sensor_odr_hz(uint8_t inst)
+{
+    (void)inst;
+    return ODR_HZ;
+}
+
+int accelerometer_sensor_read_batch(uint8_t inst, int16_t (*xyz)[3], size_t n)
+{
+    (void)inst;
+    for (size_t i = 0; i < n; i++) {
+        for (int a = 0; a < 3; a++) {
+            double g = axis_sig[a].dc_g +
+                       axis_sig[a].amp_g * sin(2 * M_PI * axis_sig[a].hz * i / ODR_HZ);
+
+            xyz[i][a] = (int16_t)lround(g * ACCELEROMETER_COUNTS_PER_G);
+        }
+    }
+    return 0;
+}
+
+static void signal(int axis, double dc_g, double amp_g, double hz)
+{
+    axis_sig[axis].dc_g = dc_g;
+    axis_sig[axis].amp_g = amp_g;
+    axis_sig[axis].hz = hz;
+}
+
+/* ---- FFT against the DFT it stands for (scaled by 1/n) ---- */
+static void test_fft_vs_dft(void)
+{
+    static int16_t buf[2 * PLANTCARE_FFT_MAX];
+    static double in[2 * PLANTCARE_FFT_MAX];
+    unsigned int rng = 3;
+
+    for (uint16_t n = 2; n <= PLANTCARE_FFT_MAX; n *= 2) {
+        double worst = 0;
+
+        for (int i = 0; i < 2 * n; i++) {
+            rng = rng * 1103515245u + 12345u;
+            buf[i] = (int16_t)((int)((rng >> 8) & 0xFFFF) - 32768) / 2;
+            in[i] = buf[i];
+        }
+        CHECK(plantcare_fft_q15(buf, n) == 0, "n %u refused", n);
+
+        for (int k = 0; k < n; k++) {
+            double re = 0, im = 0;
+
+            for (int t = 0; t < n; t++) {
+                double w = -2 * M_PI * k * t / n;
+
+                re += in[2 * t] * cos(w) - in[2 * t + 1] * sin(w);
+                im += in[2 * t] * sin(w) + in[2 * t + 1] * cos(w);
+            }
+            worst = fmax(worst, fabs(buf[2 * k] - re / n));
+            worst = fmax(worst, fabs(buf[2 * k + 1] - im / n));
+        }
+        /* One rounding per stage */
+        CHECK(worst <= log2(n) + 1, "n %u: off by %.1f LSB", n, worst);
+    }
+    CHECK(plantcare_fft_q15(buf, 48) == -1, "n 48 taken");
+    CHECK(plantcare_fft_q15(buf, 2 * PLANTCARE_FFT_MAX) == -1, "n 512 taken");
+}
+
+/* A sine in the middle of bin 8 (50 Hz) */
+static void test_sine_on_bin(void)
+{
+    struct plantcare_vib_result r;
+
+    memset(axis_sig, 0, sizeof(axis_sig));
+    signal(2, 1.0, 0.2, 50.0);
+    CHECK(plantcare_vib_run(&r) == 0, "run failed");
+
+    CHECK(r.n == 64 && r.odr_hz == ODR_HZ, "n %u odr %u", r.n, r.odr_hz);
+    CHECK(r.peak_hz_x10 == 500, "peak %u, want 500", r.peak_hz_x10);
+    /* 0.2 g amplitude is 141 mg RMS, gravity removed */
+    CHECK(abs(r.rms_mg - 141) <= 2, "rms %u mg, want 141", r.rms_mg);
+    CHECK(abs(r.peak_mg - 141) <= 2, "peak %u mg, want 141", r.peak_mg);
+    CHECK(abs(r.band_mg[PC_VIB_BAND_HIGH] - 141) <= 2 &&
+          r.band_mg[PC_VIB_BAND_LOW] <= 2 && r.band_mg[PC_VIB_BAND_MID] <= 2 &&
+          r.band_mg[PC_VIB_BAND_TOP] <= 2, "bands %u %u %u %u",
+          r.band_mg[0], r.band_mg[1], r.band_mg[2], r.band_mg[3]);
+    CHECK(r.tonality_pct >= 99, "tonality %u%%", r.tonality_pct);
+}
+
+/* Between bins the interpolation puts the peak within a tenth of a bin,
+ * and the leaked power still adds up to the sine's RMS
+ */
+static void test_sine_between_bins(void)
+{
+    static const double hz[] = { 14.0, 23.4, 31.0, 47.5, 66.6, 121.9 };
+    struct plantcare_vib_result r;
+
+    for (size_t i = 0; i < sizeof(hz) / sizeof(hz[0]); i++) {
+        memset(axis_sig, 0, sizeof(axis_sig));
+        signal(0, 0.3, 0.1, hz[i]);
+        plantcare_vib_run(&r);
+
+        CHECK(fabs(r.peak_hz_x10 - hz[i] * 10) <= 0.1 * 62.5,
+              "%.1f Hz: peak %u", hz[i], r.peak_hz_x10);
+        CHECK(abs(r.rms_mg - 71) <= 5, "%.1f Hz: rms %u mg, want 71",
+              hz[i], r.rms_mg);
+        CHECK(r.tonality_pct >= 80, "%.1f Hz: tonality %u%%", hz[i],
+              r.tonality_pct);
+    }
+}
+
+/* The axes add in power; the stronger tone is the peak */
+static void test_two_axes(void)
+{
+    struct plantcare_vib_result r;
+
+    memset(axis_sig, 0, sizeof(axis_sig));
+    signal(0, 0.0, 0.1, 12.5);
+    signal(1, 0.0, 0.3, 62.5);
+    signal(2, 1.0, 0.0, 0.0);
+    plantcare_vib_run(&r);
+
+    /* sqrt(0.1^2 / 2 + 0.3^2 / 2) = 224 mg */
+    CHECK(r.peak_hz_x10 == 625, "peak %u, want 625", r.peak_hz_x10);
+    CHECK(abs(r.rms_mg - 224) <= 3, "rms %u mg, want 224", r.rms_mg);
+    CHECK(abs(r.band_mg[PC_VIB_BAND_MID] - 71) <= 2 &&
+          abs(r.band_mg[PC_VIB_BAND_HIGH] - 212) <= 3,
+          "bands %u %u", r.band_mg[PC_VIB_BAND_MID],
+          r.band_mg[PC_VIB_BAND_HIGH]);
+    CHECK(abs(r.tonality_pct - 90) <= 1, "tonality %u%%, want 90",
+          r.tonality_pct);
+}
+
+/* Still: nothing but gravity */
+static void test_still(void)
+{
+    struct plantcare_vib_result r;
+
+    memset(axis_sig, 0, sizeof(axis_sig));
+    signal(2, 1.0, 0.0, 0.0);
+    plantcare_vib_run(&r);
+    CHECK(r.rms_mg == 0 && r.peak_mg == 0 && r.tonality_pct == 0,
+          "rms %u peak %u tonality %u", r.rms_mg, r.peak_mg, r.tonality_pct);
+}
+
+int main(void)
+{
+    test_fft_vs_dft();
+    test_sine_on_bin();
+    test_sine_between_bins();
+    test_two_axes();
+    test_still();
+
+    printf("%s: %d failures\n", fails ? "FAIL" : "ok", fails);
+    return fails ? 1 : 0;
+}